@@ -39,9 +39,9 @@ fi
 ./autogen.sh
 
 
-# link files
-ln -s -F ../../async/wolfcrypt/src/async.c ./wolfcrypt/src/async.c
-ln -s -F ../../async/wolfssl/wolfcrypt/async.h ./wolfssl/wolfcrypt/async.h
+# link files, the async package replaces the software async device
+ln -s -f ../../async/wolfcrypt/src/async.c ./wolfcrypt/src/async.c
+ln -s -f ../../async/wolfssl/wolfcrypt/async.h ./wolfssl/wolfcrypt/async.h
 ln -s -F ../../../../async/wolfcrypt/src/port/intel/quickassist.c ./wolfcrypt/src/port/intel/quickassist.c
 ln -s -F ../../../../async/wolfcrypt/src/port/intel/quickassist_mem.c ./wolfcrypt/src/port/intel/quickassist_mem.c
 ln -s -F ../../../../async/wolfcrypt/src/port/intel/README.md ./wolfcrypt/src/port/intel/README.md
@@ -74,7 +74,9 @@ then
 
     rm -rf ./async
 
-    # restore original README.md files
+    # restore original README.md files and the software async device
     git checkout -- wolfcrypt/src/port/cavium/README.md
     git checkout -- wolfcrypt/src/port/intel/README.md
+    git checkout -- wolfcrypt/src/async.c
+    git checkout -- wolfssl/wolfcrypt/async.h
 fi
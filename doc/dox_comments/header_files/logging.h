@@ -76,3 +76,150 @@ WOLFSSL_API int  wolfSSL_Debugging_ON(void);
     \sa wolfSSL_SetLoggingCb
 */
 WOLFSSL_API void wolfSSL_Debugging_OFF(void);
+
+/*!
+    \ingroup Debug
+
+    \brief If binary tracing has been enabled at build time this function
+    turns on recording of trace events at runtime.  To enable tracing at
+    build time use --enable-trace or define WOLFSSL_TRACE.  Each thread
+    records into its own ring of the last WOLFSSL_TRACE_EVENTS events
+    (default 256), no string formatting or locking is done.
+
+    \return 0 upon success.
+
+    \param none No parameters.
+
+    _Example_
+    \code
+    wolfSSL_Trace_ON();
+    ret = wolfSSL_connect(ssl);
+    wolfSSL_Trace_OFF();
+    \endcode
+
+    \sa wolfSSL_Trace_OFF
+    \sa wolfSSL_Trace_Get
+    \sa wolfSSL_Trace_Export
+*/
+WOLFSSL_API int  wolfSSL_Trace_ON(void);
+
+/*!
+    \ingroup Debug
+
+    \brief This function turns off recording of trace events.  Events
+    already recorded are kept.
+
+    \return none No returns.
+
+    \param none No parameters.
+
+    _Example_
+    \code
+    wolfSSL_Trace_OFF();
+    \endcode
+
+    \sa wolfSSL_Trace_ON
+    \sa wolfSSL_Trace_Clear
+*/
+WOLFSSL_API void wolfSSL_Trace_OFF(void);
+
+/*!
+    \ingroup Debug
+
+    \brief This function discards the trace events recorded by the calling
+    thread.
+
+    \return none No returns.
+
+    \param none No parameters.
+
+    _Example_
+    \code
+    wolfSSL_Trace_Clear();
+    \endcode
+
+    \sa wolfSSL_Trace_ON
+    \sa wolfSSL_Trace_Get
+*/
+WOLFSSL_API void wolfSSL_Trace_Clear(void);
+
+/*!
+    \ingroup Debug
+
+    \brief This function copies the newest trace events recorded by the
+    calling thread, oldest first.  Events about a connection carry the
+    WOLFSSL pointer in obj.
+
+    \return 0 upon success.
+    \return BAD_FUNC_ARG if count is NULL.
+
+    \param events array to copy the events to, or NULL to get the number of
+    events held in count.
+    \param count on input the number of entries in events, on output the
+    number of events copied.
+
+    _Example_
+    \code
+    wc_TraceEvent events[WOLFSSL_TRACE_EVENTS];
+    word32 count = WOLFSSL_TRACE_EVENTS, i;
+
+    if (wolfSSL_Trace_Get(events, &count) == 0) {
+        for (i = 0; i < count; i++) {
+            printf("%s %s %d\n", wolfSSL_Trace_EventName(events[i].id),
+                events[i].name ? events[i].name : "", events[i].arg);
+        }
+    }
+    \endcode
+
+    \sa wolfSSL_Trace_Export
+    \sa wolfSSL_Trace_EventName
+*/
+WOLFSSL_API int  wolfSSL_Trace_Get(wc_TraceEvent* events, word32* count);
+
+/*!
+    \ingroup Debug
+
+    \brief This function encodes the trace events of the calling thread in a
+    portable binary form with the function names included, so they can be
+    written out and decoded later by examples/tracedump.
+
+    \return 0 upon success.
+    \return BAD_FUNC_ARG if outSz is NULL.
+    \return BUFFER_E if out is too small for the events.
+
+    \param out buffer to encode to, or NULL to get the size needed in outSz.
+    \param outSz on input the size of out, on output the size used.
+
+    _Example_
+    \code
+    word32 sz = 0;
+    byte* out;
+
+    wolfSSL_Trace_Export(NULL, &sz);
+    out = (byte*)malloc(sz);
+    if (out != NULL && wolfSSL_Trace_Export(out, &sz) == 0) {
+        fwrite(out, 1, sz, file);
+    }
+    \endcode
+
+    \sa wolfSSL_Trace_Get
+*/
+WOLFSSL_API int  wolfSSL_Trace_Export(byte* out, word32* outSz);
+
+/*!
+    \ingroup Debug
+
+    \brief This function returns a short name for a trace event id.
+
+    \return name of the event, "unknown" for an id that is not valid.
+
+    \param id event id, one of the WC_TRACE_* values.
+
+    _Example_
+    \code
+    printf("%s\n", wolfSSL_Trace_EventName(WC_TRACE_HS_DONE));
+    \endcode
+
+    \sa wolfSSL_Trace_Get
+*/
+WOLFSSL_API const char* wolfSSL_Trace_EventName(int id);
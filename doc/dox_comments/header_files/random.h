@@ -243,6 +243,77 @@ WOLFSSL_API int  wc_RNG_GenerateByte(WC_RNG*, byte*);
 */
 WOLFSSL_API int  wc_FreeRng(WC_RNG*);
 
+/*!
+    \ingroup Random
+
+    \brief Returns the DRBG of the calling thread, instantiating it on first
+    use. Available with WC_THREAD_RNG (--enable-threadrng), where WOLFSSL
+    objects without a device id and wolfSSL_RAND_bytes() draw from it instead
+    of seeding an RNG each. A WOLFSSL object looks up the DRBG of the thread
+    calling into it each time it needs random data. With WOLFSSL_ASYNC_CRYPT,
+    WOLFSSL objects keep an RNG of their own, as async operations may run on
+    other threads. The DRBG is reseeded in a child process after
+    fork(). It is owned by the library, must not be freed and must only be
+    used by the thread it was returned to.
+
+    \return pointer to the thread's RNG on success
+    \return NULL if the RNG could not be set up
+
+    _Example_
+    \code
+    byte nonce[32];
+    WC_RNG* rng = wc_GetThreadRng();
+    if (rng == NULL || wc_RNG_GenerateBlock(rng, nonce, sizeof(nonce)) != 0) {
+        // no random data
+    }
+    \endcode
+
+    \sa wc_InitRng
+    \sa wc_RNG_GenerateBlock
+*/
+WOLFSSL_API WC_RNG* wc_GetThreadRng(void);
+
+/*!
+    \ingroup Random
+
+    \brief Initializes an RNG like wc_InitRng_ex() with the DRBG mechanism
+    chosen. WC_DRBG_HASH is the SHA-256 Hash_DRBG used by default.
+    WC_DRBG_CTR is the AES-256 CTR_DRBG of SP 800-90A with the derivation
+    function, faster for bulk output where AES is accelerated. Requests
+    shorter than WC_CTR_DRBG_BUF_SZ (512) bytes are served from keystream
+    generated ahead, which is held in the RNG until used or until a reseed.
+    Available with WC_RNG_CTR_DRBG (--enable-ctrdrbg). With
+    WC_RNG_CTR_DRBG_DEFAULT (--enable-ctrdrbg=default) wc_InitRng() and the
+    other initializers use the CTR_DRBG.
+
+    \return 0 on success
+    \return BAD_FUNC_ARG rng is NULL or drbgType unknown
+    \return MEMORY_E memory allocation failed
+    \return DRBG_CONT_FIPS_E known answer test failed
+
+    \param rng random number generator to initialize
+    \param drbgType WC_DRBG_HASH or WC_DRBG_CTR
+    \param heap heap hint for allocations
+    \param devId device id, INVALID_DEVID for software
+
+    _Example_
+    \code
+    WC_RNG rng;
+    byte   iv[16];
+
+    if (wc_InitRngDrbg_ex(&rng, WC_DRBG_CTR, NULL, INVALID_DEVID) == 0) {
+        wc_RNG_GenerateBlock(&rng, iv, sizeof(iv));
+        wc_FreeRng(&rng);
+    }
+    \endcode
+
+    \sa wc_InitRng_ex
+    \sa wc_RNG_GenerateBlock
+    \sa wc_RNG_CtrHealthTest
+*/
+WOLFSSL_API int  wc_InitRngDrbg_ex(WC_RNG* rng, int drbgType, void* heap,
+                                   int devId);
+
 /*!
     \ingroup Random
 
@@ -326,3 +397,41 @@ WOLFSSL_API int wc_RNG_HealthTest(int reseed,
                                         const byte* entropyA, word32 entropyASz,
                                         const byte* entropyB, word32 entropyBSz,
                                         byte* output, word32 outputSz);
+
+/*!
+    \ingroup Random
+
+    \brief Known answer test of the AES-256 CTR_DRBG, run the same way as
+    wc_RNG_HealthTest(): instantiate with entropyA, reseed with entropyB when
+    reseed is set, then generate twice and return the second output.
+
+    \return 0 on success
+    \return BAD_FUNC_ARG entropyA and output must not be null. If reseed
+    set entropyB must not be null
+    \return MEMORY_E memory allocation failed
+    \return -1 test failed or outputSz is not 64
+
+    \param reseed if set, will test reseed functionality
+    \param entropyA entropy, and nonce, to instantiate the drbg with
+    \param entropyASz size of entropyA in bytes
+    \param entropyB if reseed set, drbg will be reseeded with entropyB
+    \param entropyBSz size of entropyB in bytes
+    \param output second output of the drbg
+    \param outputSz length of output in bytes, 64
+
+    _Example_
+    \code
+    byte output[64];
+    ret = wc_RNG_CtrHealthTest(0, entropy, sizeof(entropy), NULL, 0,
+                               output, sizeof(output));
+    if (ret != 0 || XMEMCMP(expected, output, sizeof(output)) != 0)
+        return -1; // CTR_DRBG known answer test failed
+    \endcode
+
+    \sa wc_RNG_HealthTest
+    \sa wc_InitRngDrbg_ex
+*/
+WOLFSSL_API int wc_RNG_CtrHealthTest(int reseed,
+                                        const byte* entropyA, word32 entropyASz,
+                                        const byte* entropyB, word32 entropyBSz,
+                                        byte* output, word32 outputSz);
@@ -1914,6 +1914,1119 @@ WOLFSSL_API int  wolfSSL_read(WOLFSSL*, void*, int);
 */
 WOLFSSL_API int  wolfSSL_peek(WOLFSSL*, void*, int);
 
+/*!
+    \ingroup IO
+
+    \brief This function is a zero copy alternative to wolfSSL_read(). Rather
+    than copying the decrypted application data out, it sets data to point at
+    the plaintext of the current record inside the SSL session's internal
+    input buffer. Like wolfSSL_read() it will negotiate the handshake and
+    process records as needed. The data remains valid until released with
+    wolfSSL_read_zero_copy_done(), and no other read may be performed on the
+    session in between. Calling wolfSSL_read_zero_copy() again before
+    releasing everything hands back the unreleased remainder. Only available
+    when wolfSSL is built with WOLFSSL_ZERO_COPY (--enable-zerocopy).
+
+    \return >0 the number of bytes available at data.
+    \return 0 the peer closed the connection. Call wolfSSL_get_error() for the
+    specific error code.
+    \return SSL_FATAL_ERROR will be returned upon failure, including
+    SSL_ERROR_WANT_READ on non-blocking sockets. Use wolfSSL_get_error() to
+    get a specific error code.
+    \return BAD_FUNC_ARG if ssl or data is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param data set to the start of the decrypted application data.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    const unsigned char* data;
+    int sz;
+    ...
+    sz = wolfSSL_read_zero_copy(ssl, &data);
+    if (sz > 0) {
+        // consume "sz" bytes at "data"
+        wolfSSL_read_zero_copy_done(ssl, sz);
+    }
+    \endcode
+
+    \sa wolfSSL_read_zero_copy_done
+    \sa wolfSSL_read
+*/
+WOLFSSL_API int  wolfSSL_read_zero_copy(WOLFSSL*, const unsigned char**);
+
+/*!
+    \ingroup IO
+
+    \brief This function releases sz bytes of the application data returned
+    by wolfSSL_read_zero_copy(). Once all the data of a record has been
+    released the input buffer is recycled for the next record.
+
+    \return SSL_SUCCESS upon success.
+    \return BAD_FUNC_ARG if ssl is NULL, sz is negative or larger than the
+    data outstanding.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param sz number of bytes consumed by the application.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    const unsigned char* data;
+    int sz;
+    ...
+    sz = wolfSSL_read_zero_copy(ssl, &data);
+    if (sz > 0) {
+        wolfSSL_read_zero_copy_done(ssl, sz);
+    }
+    \endcode
+
+    \sa wolfSSL_read_zero_copy
+*/
+WOLFSSL_API int  wolfSSL_read_zero_copy_done(WOLFSSL*, int);
+
+/*!
+    \ingroup IO
+
+    \brief This function is the first half of a zero copy alternative to
+    wolfSSL_write(). It reserves the next application data record in the SSL
+    session's output buffer and sets data to point at the plaintext area of
+    that record, so the application can produce its data directly in place.
+    The record is then encrypted in place and sent with
+    wolfSSL_write_zero_copy_commit(). Any output still buffered from an
+    earlier call is flushed first. No other I/O may be performed on the
+    session between the reserve and the commit, a wolfSSL_write() in between
+    cancels the reservation. Only available when wolfSSL is built with
+    WOLFSSL_ZERO_COPY (--enable-zerocopy).
+
+    \return >0 the number of bytes that may be written at data, at most one
+    maximum sized record.
+    \return SSL_FATAL_ERROR will be returned upon failure, including
+    SSL_ERROR_WANT_WRITE when flushing buffered output would block. Use
+    wolfSSL_get_error() to get a specific error code.
+    \return BAD_FUNC_ARG if ssl or data is NULL.
+    \return BAD_STATE_E if the session uses compression.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param data set to the plaintext area of the reserved record.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    unsigned char* data;
+    int sz;
+    ...
+    sz = wolfSSL_write_zero_copy_reserve(ssl, &data);
+    if (sz > 0) {
+        sz = produce_response(data, sz);
+        if (wolfSSL_write_zero_copy_commit(ssl, sz) != sz) {
+            // check wolfSSL_get_error(), on WANT_WRITE commit again
+        }
+    }
+    \endcode
+
+    \sa wolfSSL_write_zero_copy_commit
+    \sa wolfSSL_write
+*/
+WOLFSSL_API int  wolfSSL_write_zero_copy_reserve(WOLFSSL*, unsigned char**);
+
+/*!
+    \ingroup IO
+
+    \brief This function encrypts, in place, the first sz bytes written into
+    the area returned by wolfSSL_write_zero_copy_reserve() and sends the
+    record. If sending would block the sealed record stays queued and the
+    function should be called again, with the same sz, once the socket is
+    writable. With asynchronous crypto a WC_PENDING_E error keeps the
+    reservation and the data in it; call again with the same sz once the
+    operation completes. Passing a sz of 0 drops the reservation without
+    sending.
+
+    \return sz the number of plaintext bytes sent upon success.
+    \return SSL_FATAL_ERROR upon failure, including SSL_ERROR_WANT_WRITE
+    when the record was sealed but could not be sent yet. Use
+    wolfSSL_get_error() to get a specific error code.
+    \return BAD_FUNC_ARG if ssl is NULL, sz is negative or larger than the
+    reserved area.
+    \return BAD_STATE_E if nothing was reserved or the reservation was
+    invalidated by other output.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param sz number of bytes the application wrote into the reserved area.
+
+    _Example_
+    \code
+    See wolfSSL_write_zero_copy_reserve().
+    \endcode
+
+    \sa wolfSSL_write_zero_copy_reserve
+*/
+WOLFSSL_API int  wolfSSL_write_zero_copy_commit(WOLFSSL*, int);
+
+/*!
+    \ingroup IO
+
+    \brief This function sends sz bytes of the regular file fd, starting at
+    offset, as application data. Each record is read from the file with
+    pread() directly into its plaintext area in the output buffer and
+    encrypted in place, so no intermediate copy is made. When kernel TLS is
+    active for sending (see wolfSSL_UseKTLS()) the kernel's sendfile() is
+    used instead and the data does not pass through user space. The file
+    position of fd is not changed. With a non-blocking socket a short count
+    is returned when sending would block; call again with offset advanced
+    and sz reduced by the count once the socket is writable. Only available
+    when wolfSSL is built with WOLFSSL_SENDFILE (--enable-sendfile).
+
+    \return >0 the number of file bytes sent, less than sz if sending would
+    block or the end of the file was reached.
+    \return 0 if the peer closed the connection.
+    \return SSL_FATAL_ERROR upon failure, including SSL_ERROR_WANT_WRITE when
+    nothing could be sent. Use wolfSSL_get_error() to get a specific error
+    code, FREAD_ERROR means the file could not be read.
+    \return BAD_FUNC_ARG if ssl is NULL, fd, offset or sz is negative, or a
+    resumed call asks for fewer bytes than are already queued.
+    \return BAD_STATE_E if the session uses compression.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param fd descriptor of the file to send, opened for reading.
+    \param offset position in the file of the first byte to send.
+    \param sz number of bytes to send.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    int fd;
+    long off = 0;
+    int left;
+    int ret;
+    ...
+    while (left > 0) {
+        ret = wolfSSL_sendfile(ssl, fd, off, left);
+        if (ret > 0) {
+            off  += ret;
+            left -= ret;
+        }
+        else if (wolfSSL_get_error(ssl, ret) == SSL_ERROR_WANT_WRITE) {
+            // wait for the socket to become writable
+        }
+        else {
+            break;
+        }
+    }
+    \endcode
+
+    \sa wolfSSL_write_zero_copy_reserve
+    \sa wolfSSL_UseKTLS
+    \sa wolfSSL_write
+*/
+WOLFSSL_API int  wolfSSL_sendfile(WOLFSSL*, int fd, long offset, int sz);
+
+/*!
+    \ingroup IO
+
+    \brief This function returns an eventfd that becomes readable when an
+    asynchronous crypto operation of a connection created from ctx has
+    completed. Add it to the application's epoll (or poll) set and call
+    wolfSSL_CTX_AsyncDrain() when it is readable instead of polling each
+    connection. The descriptor is owned by ctx and closed by
+    wolfSSL_CTX_free(). Completions are posted by the async device threads
+    without taking the event queue lock. Only available with the software
+    async device on Linux (--enable-asynccrypt without hardware).
+
+    \return >=0 the eventfd.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return NOT_COMPILED_IN if completions are not posted by the device.
+    \return WC_INIT_E if the eventfd could not be created.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    struct epoll_event ev;
+    int epfd;
+    ...
+    ev.events = EPOLLIN;
+    ev.data.ptr = ctx;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, wolfSSL_CTX_AsyncGetFd(ctx), &ev);
+    \endcode
+
+    \sa wolfSSL_CTX_AsyncDrain
+    \sa wolfSSL_CTX_AsyncPoll
+*/
+WOLFSSL_API int wolfSSL_CTX_AsyncGetFd(WOLFSSL_CTX* ctx);
+
+/*!
+    \ingroup IO
+
+    \brief This function removes up to maxEvents completed asynchronous
+    crypto events of ctx, oldest first, in one call. The context of each
+    event is the WOLFSSL object whose operation completed; call the
+    function that returned WC_PENDING_E on it again to continue. Unlike
+    wolfSSL_CTX_AsyncPoll() the events still pending are not visited. When
+    more events are done than fit, the eventfd of
+    wolfSSL_CTX_AsyncGetFd() stays readable. Without the eventfd support
+    this is wolfSSL_CTX_AsyncPoll() with no filter.
+
+    \return 0 on success, eventCount holds the number of events returned.
+    \return BAD_FUNC_ARG if ctx or events is NULL or maxEvents is not
+    positive.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param events array that receives the completed events.
+    \param maxEvents number of entries in events.
+    \param eventCount receives the number of events returned, may be NULL.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    WOLF_EVENT* events[32];
+    int count, i;
+    ...
+    // eventfd of wolfSSL_CTX_AsyncGetFd() is readable
+    if (wolfSSL_CTX_AsyncDrain(ctx, events, 32, &count) == 0) {
+        for (i = 0; i < count; i++) {
+            WOLFSSL* ssl = (WOLFSSL*)events[i]->context;
+            // resume ssl
+        }
+    }
+    \endcode
+
+    \sa wolfSSL_CTX_AsyncGetFd
+    \sa wolfSSL_CTX_AsyncPoll
+*/
+WOLFSSL_API int wolfSSL_CTX_AsyncDrain(WOLFSSL_CTX* ctx, WOLF_EVENT** events,
+    int maxEvents, int* eventCount);
+
+/*!
+    \ingroup Setup
+
+    \brief This function asks for the record layer of connections created
+    from ctx to be handed to the Linux kernel (kTLS) once their handshake is
+    done. The negotiated keys and sequence numbers are installed on the socket
+    with setsockopt(SOL_TLS) and wolfSSL_write() and wolfSSL_read() then send
+    and receive plain text on the socket, which also lets sendfile() be used
+    on it. Only TLS 1.2 and TLS 1.3 with AES-GCM or ChaCha20-Poly1305 over the
+    default socket I/O callbacks can be offloaded; other connections, or when
+    the kernel tls module is not available, stay in user space. A direction
+    is installed on the first write or read after the handshake that finds
+    nothing buffered for it. Only available when wolfSSL is built with
+    WOLFSSL_KTLS (--enable-ktls).
+
+    \return SSL_SUCCESS upon success.
+    \return BAD_FUNC_ARG if ctx is NULL or dir has unknown bits set.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param dir mask of WOLFSSL_KTLS_TX and WOLFSSL_KTLS_RX, 0 to turn off.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_UseKTLS(ctx, WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX);
+    \endcode
+
+    \sa wolfSSL_UseKTLS
+    \sa wolfSSL_GetKTLS
+*/
+WOLFSSL_API int  wolfSSL_CTX_UseKTLS(WOLFSSL_CTX* ctx, int dir);
+
+/*!
+    \ingroup Setup
+
+    \brief This function hands the record layer of the SSL session to the
+    Linux kernel (kTLS). Called before the handshake is done it behaves like
+    wolfSSL_CTX_UseKTLS() for this session, called after the handshake the
+    requested directions are installed right away. Once installed alerts and
+    TLS 1.3 NewSessionTickets are still handled by wolfSSL, but a TLS 1.3
+    KeyUpdate, post-handshake authentication or renegotiation can no longer
+    be done; a renegotiation request from the peer is declined with a
+    no_renegotiation alert.
+
+    \return SSL_SUCCESS upon success.
+    \return BAD_FUNC_ARG if ssl is NULL or dir has unknown bits set.
+    \return BAD_STATE_E if data is still buffered for a direction, try again
+    after the next write or read.
+    \return KTLS_E if the kernel can't take the session.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param dir mask of WOLFSSL_KTLS_TX and WOLFSSL_KTLS_RX.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    if (wolfSSL_connect(ssl) == SSL_SUCCESS &&
+            wolfSSL_UseKTLS(ssl, WOLFSSL_KTLS_TX) == SSL_SUCCESS) {
+        sendfile(sockfd, filefd, NULL, fileSz);
+    }
+    \endcode
+
+    \sa wolfSSL_CTX_UseKTLS
+    \sa wolfSSL_GetKTLS
+*/
+WOLFSSL_API int  wolfSSL_UseKTLS(WOLFSSL* ssl, int dir);
+
+/*!
+    \ingroup IO
+
+    \brief This function returns the directions of the SSL session the Linux
+    kernel is doing the record layer for.
+
+    \return mask of WOLFSSL_KTLS_TX and WOLFSSL_KTLS_RX, 0 when the session
+    is handled in user space.
+    \return BAD_FUNC_ARG if ssl is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    if (wolfSSL_GetKTLS(ssl) & WOLFSSL_KTLS_TX) {
+        // plain text on the socket is encrypted by the kernel
+    }
+    \endcode
+
+    \sa wolfSSL_UseKTLS
+*/
+WOLFSSL_API int  wolfSSL_GetKTLS(WOLFSSL* ssl);
+
+/*!
+    \ingroup Setup
+
+    \brief Sets the adaptive record size policy for connections created from
+    ctx. Without it every application data record is filled up to the maximum
+    record size, so the first bytes of a response wait on a full 16K record.
+    With it a burst of writes starts out with records of smallSz bytes of plain
+    text, small enough to fit one TCP segment, and moves to full size records
+    once rampBytes have been sent or the burst has lasted rampSec seconds.
+    After idleSec seconds without sending the next burst starts small again.
+    A value of 1400 for smallSz fits a 1500 byte MTU with any cipher suite.
+    The policy is not used with DTLS. Available with --enable-dynrecord.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL or smallSz is larger than the maximum
+    record size.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param smallSz plain text size of the small records, 0 turns the policy
+    off.
+    \param rampBytes bytes sent in a burst before full size records are used,
+    0 to not ramp up on size.
+    \param rampSec seconds of a burst before full size records are used, 0 to
+    not ramp up on time.
+    \param idleSec seconds without sending that start a new burst, 0 to never
+    go back to small records.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_SetDynRecordSize(ctx, 1400, 1024 * 1024, 1, 1);
+    \endcode
+
+    \sa wolfSSL_SetDynRecordSize
+    \sa wolfSSL_GetRecordSizeStats
+*/
+WOLFSSL_API int  wolfSSL_CTX_SetDynRecordSize(WOLFSSL_CTX* ctx,
+    unsigned short smallSz, unsigned int rampBytes, unsigned int rampSec,
+    unsigned int idleSec);
+
+/*!
+    \ingroup Setup
+
+    \brief Sets the adaptive record size policy for ssl, see
+    wolfSSL_CTX_SetDynRecordSize(). The current burst starts over.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl is NULL or smallSz is larger than the maximum
+    record size.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param smallSz plain text size of the small records, 0 turns the policy
+    off.
+    \param rampBytes bytes sent in a burst before full size records are used.
+    \param rampSec seconds of a burst before full size records are used.
+    \param idleSec seconds without sending that start a new burst.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    // streaming a large download, full size records from the start
+    wolfSSL_SetDynRecordSize(ssl, 0, 0, 0, 0);
+    \endcode
+
+    \sa wolfSSL_CTX_SetDynRecordSize
+    \sa wolfSSL_GetRecordSizeStats
+*/
+WOLFSSL_API int  wolfSSL_SetDynRecordSize(WOLFSSL* ssl,
+    unsigned short smallSz, unsigned int rampBytes, unsigned int rampSec,
+    unsigned int idleSec);
+
+/*!
+    \ingroup IO
+
+    \brief Copies out the application data record counters of ssl. records
+    holds how many records were sent by plain text size, the buckets being
+    under 512 bytes, under 1K, under 2K, under 4K, under 8K and up to 16K.
+    smallRecords counts records cut short by the policy, rampUps bursts that
+    grew to full size records and idleResets bursts ended by idle time.
+    Records are counted whether or not the policy is on.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl or stats is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param stats where to put the counters.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    WOLFSSL_RECORD_SIZE_STATS stats;
+    ...
+    if (wolfSSL_GetRecordSizeStats(ssl, &stats) == SSL_SUCCESS) {
+        printf("small records %lu\n", stats.smallRecords);
+    }
+    \endcode
+
+    \sa wolfSSL_CTX_SetDynRecordSize
+*/
+WOLFSSL_API int  wolfSSL_GetRecordSizeStats(WOLFSSL* ssl,
+    WOLFSSL_RECORD_SIZE_STATS* stats);
+
+/*!
+    \ingroup Setup
+
+    \brief Turns on read ahead for connections created from ctx. Once the
+    handshake is done each read asks the transport for as much as fits in an
+    input buffer of sz bytes instead of just the next record header or body,
+    so a burst of small records costs one read instead of two per record.
+    wolfSSL_read() then hands back as many of the buffered records as fit in
+    the caller's buffer. The buffer is kept while data keeps coming and freed
+    when a read finds the transport has nothing, with non-blocking I/O that
+    is when the connection goes idle. wolfSSL_CTX_set_read_ahead() turns this
+    on with a size of WOLFSSL_READ_AHEAD_SZ. Not used with DTLS. Available with
+    --enable-readahead.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param sz size of the read ahead buffer, 0 turns read ahead off. Records
+    that do not fit are read as without read ahead.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_UseReadAhead(ctx, 32 * 1024);
+    \endcode
+
+    \sa wolfSSL_UseReadAhead
+    \sa wolfSSL_has_pending
+*/
+WOLFSSL_API int  wolfSSL_CTX_UseReadAhead(WOLFSSL_CTX* ctx, unsigned int sz);
+
+/*!
+    \ingroup Setup
+
+    \brief Turns on read ahead for ssl, see wolfSSL_CTX_UseReadAhead().
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param sz size of the read ahead buffer, 0 turns read ahead off.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    wolfSSL_UseReadAhead(ssl, 32 * 1024);
+    \endcode
+
+    \sa wolfSSL_CTX_UseReadAhead
+    \sa wolfSSL_has_pending
+*/
+WOLFSSL_API int  wolfSSL_UseReadAhead(WOLFSSL* ssl, unsigned int sz);
+
+/*!
+    \ingroup Setup
+
+    \brief Has connections created from ctx borrow their input and output
+    buffers from a pool shared through ctx. A connection holds a buffer only
+    while a record is being read or waits to be sent, and gives it back once
+    the record is delivered, so the buffers in use follow the active
+    connections and not the open ones, without a malloc and free per record.
+    Up to maxFree buffers of IO_POOL_BUF_SZ bytes are kept for reuse, others
+    are freed when given back. Buffers larger than that, e.g. for a long
+    certificate chain, are allocated as usual. A buffer lent before
+    wolfSSL_set_SSL_CTX() goes back to the pool it came from. Available with
+    --enable-iobufpool.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return BAD_MUTEX_E if the pool lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param maxFree most buffers to keep for reuse, 0 turns the pool off and
+    frees the buffers kept.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_UseIOBufferPool(ctx, 256);
+    \endcode
+
+    \sa wolfSSL_CTX_GetIOBufferPoolStats
+*/
+WOLFSSL_API int  wolfSSL_CTX_UseIOBufferPool(WOLFSSL_CTX* ctx,
+    unsigned int maxFree);
+
+/*!
+    \ingroup Setup
+
+    \brief Gets how many buffers of the ctx pool are lent out to connections
+    and how many are kept free for reuse.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return BAD_MUTEX_E if the pool lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param inUse where to put the buffers lent out, may be NULL.
+    \param idle where to put the free buffers, may be NULL.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    unsigned int inUse, idle;
+    ...
+    wolfSSL_CTX_GetIOBufferPoolStats(ctx, &inUse, &idle);
+    \endcode
+
+    \sa wolfSSL_CTX_UseIOBufferPool
+*/
+WOLFSSL_API int  wolfSSL_CTX_GetIOBufferPoolStats(WOLFSSL_CTX* ctx,
+    unsigned int* inUse, unsigned int* idle);
+
+/*!
+    \ingroup Setup
+
+    \brief Has wolfSSL_free() keep up to maxFree WOLFSSL objects of ctx on a
+    free list instead of freeing them, and wolfSSL_new() take one from there
+    before allocating. A kept object holds on to its RNG, so a new connection
+    skips allocating and instantiating one. The RNG is reseeded when the object
+    is reused, so processes forked after it was kept don't share its output.
+    Everything else the object used is freed and its memory is wiped before
+    it is kept, leaving no keys or secrets behind, and wolfSSL_new()
+    initializes it like a new one. Objects
+    kept don't hold a reference to ctx and are freed with it. Available with
+    --enable-sslpool.
+
+    The pool saves only the object allocation and the RNG instantiation, the
+    reseed on reuse still reads the OS entropy source. The handshake buffers
+    and hashes are allocated by wolfSSL_new() as usual. When connections use
+    a shared RNG, from the CTX or per thread with WC_THREAD_RNG, the pool
+    saves just one allocation, which the free list locking can outweigh, so
+    it is best left off then.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return BAD_MUTEX_E if the pool lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param maxFree most objects to keep for reuse, 0 turns the pool off and
+    frees the objects kept.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_UseSSLPool(ctx, 1024);
+    \endcode
+
+    \sa wolfSSL_CTX_GetSSLPoolStats
+    \sa wolfSSL_new
+    \sa wolfSSL_free
+*/
+WOLFSSL_API int  wolfSSL_CTX_UseSSLPool(WOLFSSL_CTX* ctx, unsigned int maxFree);
+
+/*!
+    \ingroup Setup
+
+    \brief Gets how many wolfSSL_new() calls on ctx reused a pooled object,
+    how many had to allocate one while the pool was on and how many objects
+    are kept free for reuse.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return BAD_MUTEX_E if the pool lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param hits where to put the objects reused, may be NULL.
+    \param misses where to put the objects allocated, may be NULL.
+    \param idle where to put the objects kept, may be NULL.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    unsigned int hits, misses, idle;
+    ...
+    wolfSSL_CTX_GetSSLPoolStats(ctx, &hits, &misses, &idle);
+    \endcode
+
+    \sa wolfSSL_CTX_UseSSLPool
+*/
+WOLFSSL_API int  wolfSSL_CTX_GetSSLPoolStats(WOLFSSL_CTX* ctx,
+    unsigned int* hits, unsigned int* misses, unsigned int* idle);
+
+/*!
+    \ingroup Setup
+
+    \brief Has ctx keep count single use ephemeral key pairs of a named group
+    generated ahead of time. A TLS 1.3 handshake of a connection made from
+    ctx takes a ready key pair for its key share, and a TLS 1.2 server takes
+    one for its ECDHE key, instead of generating it while the peer waits.
+    Each key pair is used once and freed with the connection. When none is
+    ready the key pair is generated as usual. The pool is filled by calling
+    wolfSSL_CTX_RefillKeySharePool(), from a thread of the application or
+    when it is idle. Available with --enable-keysharepool.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL, count is negative or the group is
+    not supported.
+    \return BAD_STATE_E if KEYSHARE_POOL_GROUPS other groups are pooled.
+    \return BAD_MUTEX_E if the pool lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param group named group, e.g. WOLFSSL_ECC_SECP256R1 or WOLFSSL_ECC_X25519.
+    \param count key pairs to keep ready, 0 frees the key pairs of the group
+    and stops pooling it.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_UseKeySharePool(ctx, WOLFSSL_ECC_X25519, 64);
+    wolfSSL_CTX_UseKeySharePool(ctx, WOLFSSL_ECC_SECP256R1, 64);
+    wolfSSL_CTX_RefillKeySharePool(ctx, 0);
+    \endcode
+
+    \sa wolfSSL_CTX_RefillKeySharePool
+    \sa wolfSSL_CTX_GetKeySharePoolCount
+*/
+WOLFSSL_API int  wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, word16 group,
+    int count);
+
+/*!
+    \ingroup Setup
+
+    \brief Generates key pairs for the groups pooled with
+    wolfSSL_CTX_UseKeySharePool() until each has its count ready, or max key
+    pairs were made. The pool is not locked while a key pair is generated so
+    it can be called from a thread while connections take key pairs.
+
+    \return the number of key pairs generated.
+    \return BAD_FUNC_ARG if ctx is NULL or max is negative.
+    \return a negative error if generating a key pair failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param max most key pairs to generate, 0 for no limit.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    // between events of the server loop
+    wolfSSL_CTX_RefillKeySharePool(ctx, 4);
+    \endcode
+
+    \sa wolfSSL_CTX_UseKeySharePool
+*/
+WOLFSSL_API int  wolfSSL_CTX_RefillKeySharePool(WOLFSSL_CTX* ctx, int max);
+
+/*!
+    \ingroup Setup
+
+    \brief Gets the number of key pairs of a named group ready in the ctx
+    pool.
+
+    \return the number of key pairs ready, 0 if the group is not pooled.
+    \return BAD_FUNC_ARG if ctx is NULL.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param group named group.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    if (wolfSSL_CTX_GetKeySharePoolCount(ctx, WOLFSSL_ECC_X25519) < 16)
+        wolfSSL_CTX_RefillKeySharePool(ctx, 0);
+    \endcode
+
+    \sa wolfSSL_CTX_UseKeySharePool
+*/
+WOLFSSL_API int  wolfSSL_CTX_GetKeySharePoolCount(WOLFSSL_CTX* ctx,
+    word16 group);
+
+/*!
+    \ingroup Setup
+
+    \brief Turns handshake timing on or off for connections created from
+    ctx afterwards. Built with --enable-hstiming (WOLFSSL_HANDSHAKE_TIMING).
+    A connection with timing on records an event with a monotonic timestamp
+    for each handshake message written or processed, each public key
+    operation, the peer certificate chain and each wait on the I/O
+    callbacks, see wolfSSL_GetHandshakeEvents(). When its handshake is done,
+    the time it spent per event type is added to histograms kept in ctx,
+    see wolfSSL_CTX_GetHandshakeHistogram(). Turning timing on clears the
+    histograms. Connections with timing off only test a pointer at each
+    event.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+    \return BAD_MUTEX_E if the histogram lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param on 1 to turn timing on, 0 to turn it off.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_SetHandshakeTiming(ctx, 1);
+    \endcode
+
+    \sa wolfSSL_SetHandshakeTiming
+    \sa wolfSSL_CTX_GetHandshakeHistogram
+*/
+WOLFSSL_API int  wolfSSL_CTX_SetHandshakeTiming(WOLFSSL_CTX* ctx, int on);
+
+/*!
+    \ingroup Setup
+
+    \brief Turns handshake timing on or off for one connection, see
+    wolfSSL_CTX_SetHandshakeTiming(). Turning it on starts over, call before
+    the handshake or again before a renegotiation. Turning it off frees what
+    was recorded. The times of the handshake are only added to the CTX
+    histograms when the CTX has timing on.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl is NULL.
+    \return MEMORY_E if the event record could not be allocated.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param on 1 to turn timing on, 0 to turn it off.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    wolfSSL_SetHandshakeTiming(ssl, 1);
+    wolfSSL_connect(ssl);
+    \endcode
+
+    \sa wolfSSL_GetHandshakeEvents
+    \sa wolfSSL_GetHandshakeTime
+*/
+WOLFSSL_API int  wolfSSL_SetHandshakeTiming(WOLFSSL* ssl, int on);
+
+/*!
+    \ingroup Setup
+
+    \brief Copies the timing events of the handshake of ssl in the order
+    they ended. An event has its type (WOLFSSL_HST_*), the handshake message
+    type for WOLFSSL_HST_MSG_SEND and WOLFSSL_HST_MSG_RECV, its start in
+    microseconds since the first event of the handshake and its duration.
+    Messages written have no duration. A wait on I/O runs from the call that
+    got WANT_READ or WANT_WRITE to the call that got data through, so it
+    includes the time until the application called again. Public key
+    operations are also part of processing the message they are made for.
+    Events past the capacity of the record (WOLFSSL_HS_TIMING_MAX_EVENTS,
+    48 by default) are only counted in the times per type.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl or count is NULL.
+    \return SSL_FAILURE if timing is off for ssl.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param events where to copy the events, NULL to get the number recorded.
+    \param count the number of events that fit in events, set to the number
+    copied.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    WOLFSSL_HS_TIMING_EVENT events[48];
+    unsigned int i, count = 48;
+    ...
+    wolfSSL_GetHandshakeEvents(ssl, events, &count);
+    for (i = 0; i < count; i++) {
+        printf("%u +%u type %d msg %d\n", events[i].start, events[i].duration,
+               events[i].type, events[i].msgType);
+    }
+    \endcode
+
+    \sa wolfSSL_SetHandshakeTiming
+    \sa wolfSSL_GetHandshakeTime
+*/
+WOLFSSL_API int  wolfSSL_GetHandshakeEvents(WOLFSSL* ssl,
+    WOLFSSL_HS_TIMING_EVENT* events, unsigned int* count);
+
+/*!
+    \ingroup Setup
+
+    \brief Gets the time in microseconds the handshake of ssl spent in
+    events of a type. WOLFSSL_HST_CRYPTO sums the public key operations,
+    WOLFSSL_HST_NETWORK the waits on I/O and WOLFSSL_HST_TOTAL is the time
+    from the first event to the end of the handshake. These three are set
+    when the handshake is done.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl or us is NULL or type is out of range.
+    \return SSL_FAILURE if timing is off for ssl.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param type a WOLFSSL_HST_* value.
+    \param us where to put the time.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    unsigned int total, crypto, network;
+    ...
+    wolfSSL_GetHandshakeTime(ssl, WOLFSSL_HST_TOTAL, &total);
+    wolfSSL_GetHandshakeTime(ssl, WOLFSSL_HST_CRYPTO, &crypto);
+    wolfSSL_GetHandshakeTime(ssl, WOLFSSL_HST_NETWORK, &network);
+    \endcode
+
+    \sa wolfSSL_GetHandshakeEvents
+*/
+WOLFSSL_API int  wolfSSL_GetHandshakeTime(WOLFSSL* ssl, int type,
+    unsigned int* us);
+
+/*!
+    \ingroup Setup
+
+    \brief Copies the histogram of an event type from ctx. Bucket n counts
+    the finished handshakes that spent between 2^(n-1) and 2^n microseconds
+    in events of the type, bucket 0 those under a microsecond and the last
+    of WOLFSSL_HST_BUCKETS buckets those longer. Every finished handshake is
+    counted in every histogram, so a percentile taken from the
+    WOLFSSL_HST_TOTAL histogram can be compared with the same percentile of
+    WOLFSSL_HST_CRYPTO, WOLFSSL_HST_NETWORK or WOLFSSL_HST_CERT_VERIFY.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if an argument is NULL or type is out of range.
+    \return BAD_MUTEX_E if the histogram lock failed.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param type a WOLFSSL_HST_* value.
+    \param buckets where to copy the buckets.
+    \param count the number of buckets that fit, set to the number copied.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    unsigned int buckets[WOLFSSL_HST_BUCKETS];
+    unsigned int count = WOLFSSL_HST_BUCKETS;
+    ...
+    wolfSSL_CTX_GetHandshakeHistogram(ctx, WOLFSSL_HST_NETWORK, buckets,
+                                      &count);
+    \endcode
+
+    \sa wolfSSL_CTX_SetHandshakeTiming
+*/
+WOLFSSL_API int  wolfSSL_CTX_GetHandshakeHistogram(WOLFSSL_CTX* ctx,
+    int type, unsigned int* buckets, unsigned int* count);
+
+/*!
+    \ingroup Setup
+
+    \brief Copies the operational counters of ctx, summed over the
+    connections made from it: full and resumed handshakes by protocol
+    version (WOLFSSL_STAT_* index), ticket and session ID resumptions,
+    HelloRetryRequests, early data accepted and rejected, failed handshakes
+    by reason (WOLFSSL_STAT_FAIL_*), alerts sent and received by code, and
+    bytes and records in and out. A handshake that ended with an error is
+    counted when its WOLFSSL object is freed. Records sent through kernel
+    TLS aren't counted. Threads count into their own shard of the counters
+    without locks, the shards are summed here while other threads keep
+    counting so each counter is current but they aren't read at one instant.
+    Available with --enable-ctxstats (WOLFSSL_CTX_STATS).
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx or stats is NULL.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param stats where to copy the counters.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    WOLFSSL_STATS stats;
+    ...
+    if (wolfSSL_CTX_GetStats(ctx, &stats) == SSL_SUCCESS) {
+        printf("TLS 1.3 resumed %llu\n",
+            (unsigned long long)stats.resumed[WOLFSSL_STAT_TLSV1_3]);
+    }
+    \endcode
+
+    \sa wolfSSL_CTX_ClearStats
+*/
+WOLFSSL_API int  wolfSSL_CTX_GetStats(WOLFSSL_CTX* ctx,
+    WOLFSSL_STATS* stats);
+
+/*!
+    \ingroup Setup
+
+    \brief Sets the operational counters of ctx to zero. Counts made by
+    other threads while clearing may be lost.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_ClearStats(ctx);
+    \endcode
+
+    \sa wolfSSL_CTX_GetStats
+*/
+WOLFSSL_API int  wolfSSL_CTX_ClearStats(WOLFSSL_CTX* ctx);
+
+/*!
+    \ingroup Setup
+
+    \brief Releases the memory an established connection does not need to
+    protect its records: what is freed at the end of the handshake, plus
+    extensions only used to negotiate, and the input and output buffers when
+    nothing is pending in them. SNI and ALPN stay available. State needed
+    for secure renegotiation or TLS 1.3 post-handshake authentication is
+    kept. Useful on connections left idle, e.g. keep-alive or WebSocket
+    connections.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl is NULL.
+    \return BAD_STATE_E if the handshake is not done.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param retained where to put the approximate bytes still held by the
+    connection, including the WOLFSSL object, may be NULL.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    unsigned int retained;
+    ...
+    if (wolfSSL_CompactResources(ssl, &retained) == SSL_SUCCESS)
+        printf("idle connection holds %u bytes\n", retained);
+    \endcode
+
+    \sa wolfSSL_CTX_SetAutoCompact
+    \sa wolfSSL_FreeHandshakeResources
+*/
+WOLFSSL_API int wolfSSL_CompactResources(WOLFSSL* ssl, unsigned int* retained);
+
+/*!
+    \ingroup Setup
+
+    \brief Has connections created from ctx compact their resources, as
+    wolfSSL_CompactResources() does, when the handshake is done. Connections
+    that keep their handshake resources are not compacted.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ctx is NULL.
+
+    \param ctx pointer to the SSL context, created with wolfSSL_CTX_new().
+    \param on 1 to compact, 0 to only free the handshake resources.
+
+    _Example_
+    \code
+    WOLFSSL_CTX* ctx;
+    ...
+    wolfSSL_CTX_SetAutoCompact(ctx, 1);
+    \endcode
+
+    \sa wolfSSL_SetAutoCompact
+    \sa wolfSSL_CompactResources
+*/
+WOLFSSL_API int wolfSSL_CTX_SetAutoCompact(WOLFSSL_CTX* ctx, int on);
+
+/*!
+    \ingroup Setup
+
+    \brief Has the connection compact its resources, as
+    wolfSSL_CompactResources() does, when the handshake is done.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param on 1 to compact, 0 to only free the handshake resources.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    wolfSSL_SetAutoCompact(ssl, 1);
+    \endcode
+
+    \sa wolfSSL_CTX_SetAutoCompact
+    \sa wolfSSL_CompactResources
+*/
+WOLFSSL_API int wolfSSL_SetAutoCompact(WOLFSSL* ssl, int on);
+
+/*!
+    \ingroup IO
+
+    \brief Reports the memory held by a connection, split by what it is used
+    for: the WOLFSSL object, its session copy (with the peer certificate
+    chain when built with SESSION_CERTS), the decoded peer certificate
+    (KEEP_PEER_CERT), handshake state not freed yet, cipher contexts, the
+    RNG, dynamic input and output buffers and the TLS extension list. Sizes
+    are of the structures allocated, memory held inside them, such as the
+    data of an extension, is not counted.
+
+    To keep idle connections small, build with --enable-leanconn
+    (WOLFSSL_LEAN_CONN). Connections then compact their resources when the
+    handshake is done, see wolfSSL_CTX_SetAutoCompact(), and the session copy
+    only keeps the peer's own certificate of its chain
+    (MAX_SESSION_CHAIN_DEPTH of 1). With SESSION_CERTS the session copy is
+    most of the object, the profile cuts it from about 37 KB to 4.5 KB.
+
+    \return SSL_SUCCESS on success.
+    \return BAD_FUNC_ARG if ssl or fp is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+    \param fp filled with the bytes per category and their total.
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    WOLFSSL_MEM_FOOTPRINT fp;
+    ...
+    if (wolfSSL_GetMemFootprint(ssl, &fp) == SSL_SUCCESS) {
+        printf("%u bytes, %u in ciphers, %u in buffers\n", fp.total,
+               fp.ciphers, fp.buffers);
+    }
+    \endcode
+
+    \sa wolfSSL_CompactResources
+*/
+WOLFSSL_API int wolfSSL_GetMemFootprint(WOLFSSL* ssl,
+                                        WOLFSSL_MEM_FOOTPRINT* fp);
+
 /*!
     \ingroup IO
 
@@ -2607,6 +3720,35 @@ WOLFSSL_API void wolfSSL_SetCertCbCtx(WOLFSSL*, void*);
 */
 WOLFSSL_API int  wolfSSL_pending(WOLFSSL*);
 
+/*!
+    \ingroup IO
+
+    \brief This function tells whether the SSL object holds data that a call
+    to wolfSSL_read() can use without the socket being readable, either
+    decrypted data or records not yet processed. With read ahead on, records
+    can be waiting in the SSL object when wolfSSL_pending() returns 0, so
+    check this before waiting on the socket with select() or poll().
+
+    \return 1 if data or records are buffered.
+    \return 0 if nothing is buffered or ssl is NULL.
+
+    \param ssl pointer to the SSL session, created with wolfSSL_new().
+
+    _Example_
+    \code
+    WOLFSSL* ssl;
+    ...
+    if (!wolfSSL_has_pending(ssl)) {
+        // wait for the socket to be readable
+    }
+    ret = wolfSSL_read(ssl, buf, sizeof(buf));
+    \endcode
+
+    \sa wolfSSL_pending
+    \sa wolfSSL_UseReadAhead
+*/
+WOLFSSL_API int  wolfSSL_has_pending(const WOLFSSL*);
+
 /*!
     \ingroup Debug
 
@@ -3114,7 +4256,10 @@ WOLFSSL_API int  wolfSSL_CTX_get_cert_cache_memsize(WOLFSSL_CTX*);
     "DHE-RSA-AES256-SHA256:DHE-RSA-AES128-SHA256:AES256-SHA256" Valid cipher
     values are the full name values from the cipher_names[] array in
     src/internal.c (for a definite list of valid cipher values check
-    src/internal.c)
+    src/internal.c) When built with WOLFSSL_SHARED_SUITES
+    (--enable-sharedsuites) the list is shared by the WOLFSSL objects of the
+    context rather than copied into each, so it should be set before they are
+    created and not changed while they are in use.
 
     \return SSL_SUCCESS will be returned upon successful function completion.
     \return SSL_FAILURE will be returned on failure.
@@ -0,0 +1,177 @@
+/* tracedump.c
+ *
+ * Copyright (C) 2006-2021 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+/*
+Decodes the output of wolfSSL_Trace_Export() saved to a file
+./examples/tracedump/tracedump trace.bin
+*/
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/wolfcrypt/logging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WOLFSSL_TRACE
+
+/* big endian sz byte value at in */
+static word64 DecodeBE(const byte* in, int sz)
+{
+    word64 v = 0;
+
+    while (sz-- > 0)
+        v = (v << 8) | *in++;
+
+    return v;
+}
+
+static void PrintArg(int id, int arg)
+{
+    switch (id) {
+        case WC_TRACE_LEAVE:
+            printf(" ret=%d", arg);
+            break;
+        case WC_TRACE_ERROR:
+            printf(" %d", arg);
+            break;
+        case WC_TRACE_HS_SEND:
+        case WC_TRACE_HS_RECV:
+            printf(" type=%d", arg);
+            break;
+        case WC_TRACE_HS_DONE:
+            printf(" resumed=%d", arg);
+            break;
+        case WC_TRACE_ALERT_SEND:
+        case WC_TRACE_ALERT_RECV:
+            printf(" level=%d code=%d", (arg >> 8) & 0xff, arg & 0xff);
+            break;
+        case WC_TRACE_RECORD_IN:
+            printf(" type=%d length=%d", (arg >> 16) & 0xff, arg & 0xffff);
+            break;
+        default:
+            break;
+    }
+}
+
+/* print the events in, times are us after the first event */
+static int Decode(const byte* in, long sz)
+{
+    word32 count, i;
+    word64 base = 0;
+    long   idx = WC_TRACE_HDR_SZ;
+
+    if (sz < WC_TRACE_HDR_SZ || memcmp(in, WC_TRACE_MAGIC, 4) != 0) {
+        fprintf(stderr, "not a wolfSSL trace\n");
+        return -1;
+    }
+    if (DecodeBE(in + 4, 4) != WC_TRACE_VERSION) {
+        fprintf(stderr, "unsupported trace version %u\n",
+                (unsigned int)DecodeBE(in + 4, 4));
+        return -1;
+    }
+    count = (word32)DecodeBE(in + 8, 4);
+
+    for (i = 0; i < count; i++) {
+        const byte* ev = in + idx;
+        word64 time;
+        int    id, arg, len;
+
+        if (idx + WC_TRACE_EVENT_SZ > sz) {
+            fprintf(stderr, "trace cut short at event %u\n", i);
+            return -1;
+        }
+        time = DecodeBE(ev, 8);
+        arg  = (int)(word32)DecodeBE(ev + 16, 4);
+        id   = (int)DecodeBE(ev + 20, 2);
+        len  = (int)DecodeBE(ev + 22, 2);
+        if (idx + WC_TRACE_EVENT_SZ + len > sz) {
+            fprintf(stderr, "trace cut short at event %u\n", i);
+            return -1;
+        }
+        if (i == 0)
+            base = time;
+
+        printf("%12.3f 0x%016llx %-10s %.*s", (double)(time - base) / 1000,
+               (unsigned long long)DecodeBE(ev + 8, 8),
+               wolfSSL_Trace_EventName(id), len,
+               (const char*)ev + WC_TRACE_EVENT_SZ);
+        PrintArg(id, arg);
+        printf("\n");
+
+        idx += WC_TRACE_EVENT_SZ + len;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    FILE* f;
+    byte* buf;
+    long  sz;
+    int   ret;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <trace file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL) {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    fseek(f, 0, SEEK_END);
+    sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = (byte*)malloc(sz > 0 ? (size_t)sz : 1);
+    if (buf == NULL || sz < 0 || fread(buf, 1, (size_t)sz, f) != (size_t)sz) {
+        fprintf(stderr, "can't read %s\n", argv[1]);
+        free(buf);
+        fclose(f);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+
+    ret = Decode(buf, sz);
+    free(buf);
+
+    return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(void)
+{
+    fprintf(stderr, "tracedump requires wolfSSL built with --enable-trace\n");
+    return EXIT_FAILURE;
+}
+
+#endif /* WOLFSSL_TRACE */
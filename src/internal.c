@@ -111,6 +111,10 @@
     #include <sys/filio.h>
 #endif
 
+#if defined(WOLFSSL_HANDSHAKE_TIMING) && !defined(WOLFSSL_HS_TIMING_NOW)
+    #include <time.h>
+#endif
+
 
 #define ERROR_OUT(err, eLabel) { ret = (err); goto eLabel; }
 
@@ -1695,6 +1699,34 @@ int InitSSL_Ctx(WOLFSSL_CTX* ctx, WOLFSSL_METHOD* method, void* heap)
         ctx->err = CTX_INIT_MUTEX_E;
         return BAD_MUTEX_E;
     }
+#ifdef WOLFSSL_IO_POOL
+    if (wc_InitMutex(&ctx->ioPool.lock) < 0) {
+        WOLFSSL_MSG("Mutex error on CTX init");
+        ctx->err = CTX_INIT_MUTEX_E;
+        return BAD_MUTEX_E;
+    }
+#endif
+#ifdef WOLFSSL_SSL_POOL
+    if (wc_InitMutex(&ctx->sslPool.lock) < 0) {
+        WOLFSSL_MSG("Mutex error on CTX init");
+        ctx->err = CTX_INIT_MUTEX_E;
+        return BAD_MUTEX_E;
+    }
+#endif
+#ifdef WOLFSSL_KEYSHARE_POOL
+    if (wc_InitMutex(&ctx->ksPool.lock) < 0) {
+        WOLFSSL_MSG("Mutex error on CTX init");
+        ctx->err = CTX_INIT_MUTEX_E;
+        return BAD_MUTEX_E;
+    }
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    if (wc_InitMutex(&ctx->hsHist.lock) < 0) {
+        WOLFSSL_MSG("Mutex error on CTX init");
+        ctx->err = CTX_INIT_MUTEX_E;
+        return BAD_MUTEX_E;
+    }
+#endif
 
 #ifndef NO_CERTS
     ctx->privateKeyDevId = INVALID_DEVID;
@@ -1877,6 +1909,23 @@ int InitSSL_Ctx(WOLFSSL_CTX* ctx, WOLFSSL_METHOD* method, void* heap)
 
     ctx->heap = heap; /* wolfSSL_CTX_load_static_memory sets */
     ctx->verifyDepth = MAX_CHAIN_DEPTH;
+#ifdef WOLFSSL_LEAN_CONN
+    ctx->autoCompact = 1;
+#endif
+
+#ifdef WOLFSSL_CTX_STATS
+    if (ret == 0) {
+        ctx->stats = (CtxStatsShard*)XMALLOC(
+                             sizeof(CtxStatsShard) * WOLFSSL_CTX_STATS_SHARDS,
+                             heap, DYNAMIC_TYPE_CTX);
+        if (ctx->stats == NULL) {
+            WOLFSSL_MSG("ctx->stats memory error");
+            return MEMORY_E;
+        }
+        XMEMSET(ctx->stats, 0,
+                sizeof(CtxStatsShard) * WOLFSSL_CTX_STATS_SHARDS);
+    }
+#endif
 
     return ret;
 }
@@ -1893,6 +1942,19 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
 #ifdef HAVE_WOLF_EVENT
     wolfEventQueue_Free(&ctx->event_queue);
 #endif /* HAVE_WOLF_EVENT */
+#ifdef WOLFSSL_IO_POOL
+    IOPoolFree(ctx);
+#endif
+#ifdef WOLFSSL_SSL_POOL
+    SSLPoolFree(ctx);
+#endif
+#ifdef WOLFSSL_KEYSHARE_POOL
+    TLSX_KeySharePool_Free(ctx);
+#endif
+#ifdef WOLFSSL_CTX_STATS
+    XFREE(ctx->stats, ctx->heap, DYNAMIC_TYPE_CTX);
+    ctx->stats = NULL;
+#endif
 
 #ifdef WOLFSSL_STATIC_MEMORY
     if (ctx->onHeap == 1) {
@@ -1926,6 +1988,9 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
 #endif /* SINGLE_THREADED */
 
 #ifndef NO_CERTS
+#ifdef WOLFSSL_PRIVKEY_CACHE
+    FreeCtxPrivateKeyCache(ctx);
+#endif
     FreeDer(&ctx->privateKey);
     FreeDer(&ctx->certificate);
     #ifdef KEEP_OUR_CERT
@@ -1935,6 +2000,9 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
         }
     #endif /* KEEP_OUR_CERT */
     FreeDer(&ctx->certChain);
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+    FreeDer(&ctx->certMsg);
+    #endif
     wolfSSL_CertManagerFree(ctx->cm);
     ctx->cm = NULL;
     #ifdef OPENSSL_EXTRA
@@ -2047,6 +2115,18 @@ void FreeSSL_Ctx(WOLFSSL_CTX* ctx)
         TicketEncCbCtx_Free(&ctx->ticketKeyCtx);
 #endif
         wc_FreeMutex(&ctx->countMutex);
+#ifdef WOLFSSL_IO_POOL
+        wc_FreeMutex(&ctx->ioPool.lock);
+#endif
+#ifdef WOLFSSL_SSL_POOL
+        wc_FreeMutex(&ctx->sslPool.lock);
+#endif
+#ifdef WOLFSSL_KEYSHARE_POOL
+        wc_FreeMutex(&ctx->ksPool.lock);
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+        wc_FreeMutex(&ctx->hsHist.lock);
+#endif
 #ifdef WOLFSSL_STATIC_MEMORY
         if (ctx->onHeap == 0) {
             heap = NULL;
@@ -2338,6 +2418,80 @@ void InitSuitesHashSigAlgo(Suites* suites, int haveECDSAsig, int haveRSAsig,
     suites->hashSigAlgoSz = idx;
 }
 
+#ifdef WOLFSSL_SUITE_MAP
+/* Row of the suite map for the first cipher suite byte, -1 when none. */
+static WC_INLINE int SuitesMapRow(byte first)
+{
+    switch (first) {
+        case CIPHER_BYTE:
+            return 0;
+        case ECC_BYTE:
+            return 1;
+        case CHACHA_BYTE:
+            return 2;
+        case TLS13_BYTE:
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+/* Set the bit of each suite held so that a suite is looked up in one step.
+ *
+ * suites  The cipher suites to map.
+ */
+void InitSuitesMap(Suites* suites)
+{
+    word16 i;
+
+    XMEMSET(suites->map, 0, sizeof(suites->map));
+    suites->mapOther = 0;
+
+    for (i = 0; i + 1 < suites->suiteSz; i += SUITE_LEN) {
+        int    row = SuitesMapRow(suites->suites[i]);
+        word32 bit;
+
+        if (row < 0) {
+            suites->mapOther = 1;
+            continue;
+        }
+        bit = (word32)row * 256 + suites->suites[i + 1];
+        suites->map[bit / WOLFSSL_BIT_SIZE] |=
+                                        (byte)(1 << (bit % WOLFSSL_BIT_SIZE));
+    }
+
+    suites->mapSet = 1;
+}
+
+/* Check whether the cipher suite is in the list.
+ *
+ * suites  The mapped cipher suites.
+ * first   The first byte of the cipher suite.
+ * second  The second byte of the cipher suite.
+ * returns 1 when held, 0 otherwise.
+ */
+int SuitesMapHas(const Suites* suites, byte first, byte second)
+{
+    int    row = SuitesMapRow(first);
+    word32 bit;
+    word16 i;
+
+    if (row >= 0) {
+        bit = (word32)row * 256 + second;
+        return (suites->map[bit / WOLFSSL_BIT_SIZE] >>
+                                                (bit % WOLFSSL_BIT_SIZE)) & 1;
+    }
+    if (!suites->mapOther)
+        return 0;
+
+    for (i = 0; i + 1 < suites->suiteSz; i += SUITE_LEN) {
+        if (suites->suites[i] == first && suites->suites[i + 1] == second)
+            return 1;
+    }
+    return 0;
+}
+#endif /* WOLFSSL_SUITE_MAP */
+
 void InitSuites(Suites* suites, ProtocolVersion pv, int keySz, word16 haveRSA,
                 word16 havePSK, word16 haveDH, word16 haveNTRU,
                 word16 haveECDSAsig, word16 haveECC,
@@ -3339,6 +3493,9 @@ void InitSuites(Suites* suites, ProtocolVersion pv, int keySz, word16 haveRSA,
 #endif /* !WOLFSSL_NO_TLS12 */
 
     suites->suiteSz = idx;
+#ifdef WOLFSSL_SUITE_MAP
+    InitSuitesMap(suites);
+#endif
 
     InitSuitesHashSigAlgo(suites, haveECDSAsig | haveECC, haveRSAsig | haveRSA,
                                                               0, tls1_2, keySz);
@@ -3762,6 +3919,7 @@ int RsaSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     (void)hashAlgo;
 
     WOLFSSL_ENTER("RsaSign");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SIGN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -3792,7 +3950,7 @@ int RsaSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     #endif
         {
             ret = wc_RsaPSS_Sign(in, inSz, out, *outSz, hashType, mgf, key,
-                                                                      ssl->rng);
+                                                                GetSslRng(ssl));
         }
     }
     else
@@ -3805,7 +3963,7 @@ int RsaSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     }
     else
 #endif /*HAVE_PK_CALLBACKS */
-        ret = wc_RsaSSL_Sign(in, inSz, out, *outSz, key, ssl->rng);
+        ret = wc_RsaSSL_Sign(in, inSz, out, *outSz, key, GetSslRng(ssl));
 
     /* Handle async pending response */
 #ifdef WOLFSSL_ASYNC_CRYPT
@@ -3820,6 +3978,7 @@ int RsaSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
         ret = 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SIGN, 0, 0);
     WOLFSSL_LEAVE("RsaSign", ret);
 
     return ret;
@@ -3846,6 +4005,7 @@ int RsaVerify(WOLFSSL* ssl, byte* in, word32 inSz, byte** out, int sigAlgo,
     (void)hashAlgo;
 
     WOLFSSL_ENTER("RsaVerify");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_VERIFY);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -3893,6 +4053,7 @@ int RsaVerify(WOLFSSL* ssl, byte* in, word32 inSz, byte** out, int sigAlgo,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_VERIFY, 0, 0);
     WOLFSSL_LEAVE("RsaVerify", ret);
 
     return ret;
@@ -3922,6 +4083,7 @@ int VerifyRsaSign(WOLFSSL* ssl, byte* verifySig, word32 sigSz,
     (void)hashAlgo;
 
     WOLFSSL_ENTER("VerifyRsaSign");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SIGN);
 
     if (verifySig == NULL || plain == NULL) {
         return BAD_FUNC_ARG;
@@ -4025,6 +4187,7 @@ int VerifyRsaSign(WOLFSSL* ssl, byte* verifySig, word32 sigSz,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SIGN, 0, 0);
     WOLFSSL_LEAVE("VerifyRsaSign", ret);
 
     return ret;
@@ -4051,6 +4214,7 @@ int RsaDec(WOLFSSL* ssl, byte* in, word32 inSz, byte** out, word32* outSz,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("RsaDec");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4068,7 +4232,7 @@ int RsaDec(WOLFSSL* ssl, byte* in, word32 inSz, byte** out, word32* outSz,
 #endif /* HAVE_PK_CALLBACKS */
     {
         #ifdef WC_RSA_BLINDING
-            ret = wc_RsaSetRNG(key, ssl->rng);
+            ret = wc_RsaSetRNG(key, GetSslRng(ssl));
             if (ret != 0)
                 return ret;
         #endif
@@ -4088,6 +4252,7 @@ int RsaDec(WOLFSSL* ssl, byte* in, word32 inSz, byte** out, word32* outSz,
         ret = 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("RsaDec", ret);
 
     return ret;
@@ -4112,6 +4277,7 @@ int RsaEnc(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out, word32* outSz,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("RsaEnc");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4128,7 +4294,7 @@ int RsaEnc(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out, word32* outSz,
     else
 #endif /* HAVE_PK_CALLBACKS */
     {
-        ret = wc_RsaPublicEncrypt(in, inSz, out, *outSz, key, ssl->rng);
+        ret = wc_RsaPublicEncrypt(in, inSz, out, *outSz, key, GetSslRng(ssl));
     }
 
     /* Handle async pending response */
@@ -4144,6 +4310,7 @@ int RsaEnc(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out, word32* outSz,
         ret = 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("RsaEnc", ret);
 
     return ret;
@@ -4173,6 +4340,7 @@ int EccSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("EccSign");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SIGN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4192,7 +4360,7 @@ int EccSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     else
 #endif /* HAVE_PK_CALLBACKS */
     {
-        ret = wc_ecc_sign_hash(in, inSz, out, outSz, ssl->rng, key);
+        ret = wc_ecc_sign_hash(in, inSz, out, outSz, GetSslRng(ssl), key);
     }
 
     /* Handle async pending response */
@@ -4202,6 +4370,7 @@ int EccSign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SIGN, 0, 0);
     WOLFSSL_LEAVE("EccSign", ret);
 
     return ret;
@@ -4225,6 +4394,7 @@ int EccVerify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* out,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("EccVerify");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_VERIFY);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4256,6 +4426,7 @@ int EccVerify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* out,
         ret = (ret != 0 || ssl->eccVerifyRes == 0) ? VERIFY_SIGN_ERROR : 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_VERIFY, 0, 0);
     WOLFSSL_LEAVE("EccVerify", ret);
 
     return ret;
@@ -4333,6 +4504,7 @@ int EccSharedSecret(WOLFSSL* ssl, ecc_key* priv_key, ecc_key* pub_key,
     (void)side;
 
     WOLFSSL_ENTER("EccSharedSecret");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef HAVE_PK_CALLBACKS
     if (ssl->ctx->EccSharedSecretCb) {
@@ -4364,7 +4536,7 @@ int EccSharedSecret(WOLFSSL* ssl, ecc_key* priv_key, ecc_key* pub_key,
 #if defined(ECC_TIMING_RESISTANT) && (!defined(HAVE_FIPS) || \
     (!defined(HAVE_FIPS_VERSION) || (HAVE_FIPS_VERSION != 2))) && \
     !defined(HAVE_SELFTEST)
-        ret = wc_ecc_set_rng(priv_key, ssl->rng);
+        ret = wc_ecc_set_rng(priv_key, GetSslRng(ssl));
         if (ret == 0)
 #endif
             ret = wc_ecc_shared_secret(priv_key, pub_key, out, outlen);
@@ -4377,6 +4549,7 @@ int EccSharedSecret(WOLFSSL* ssl, ecc_key* priv_key, ecc_key* pub_key,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("EccSharedSecret", ret);
 
     return ret;
@@ -4389,6 +4562,7 @@ int EccMakeKey(WOLFSSL* ssl, ecc_key* key, ecc_key* peer)
     int ecc_curve = ECC_CURVE_DEF;
 
     WOLFSSL_ENTER("EccMakeKey");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_KEY_GEN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4419,7 +4593,7 @@ int EccMakeKey(WOLFSSL* ssl, ecc_key* key, ecc_key* peer)
     else
 #endif
     {
-        ret = wc_ecc_make_key_ex(ssl->rng, keySz, key, ecc_curve);
+        ret = wc_ecc_make_key_ex(GetSslRng(ssl), keySz, key, ecc_curve);
     }
 
     /* make sure the curve is set for TLS */
@@ -4437,6 +4611,7 @@ int EccMakeKey(WOLFSSL* ssl, ecc_key* key, ecc_key* peer)
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_KEY_GEN, 0, 0);
     WOLFSSL_LEAVE("EccMakeKey", ret);
 
     return ret;
@@ -4511,6 +4686,7 @@ int Ed25519Sign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("Ed25519Sign");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SIGN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4538,6 +4714,7 @@ int Ed25519Sign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SIGN, 0, 0);
     WOLFSSL_LEAVE("Ed25519Sign", ret);
 
     return ret;
@@ -4573,6 +4750,7 @@ int Ed25519Verify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* msg,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("Ed25519Verify");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_VERIFY);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4605,6 +4783,7 @@ int Ed25519Verify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* msg,
         ret = (ret != 0 || ssl->eccVerifyRes == 0) ? VERIFY_SIGN_ERROR : 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_VERIFY, 0, 0);
     WOLFSSL_LEAVE("Ed25519Verify", ret);
 
     return ret;
@@ -4663,6 +4842,7 @@ static int X25519SharedSecret(WOLFSSL* ssl, curve25519_key* priv_key,
     (void)side;
 
     WOLFSSL_ENTER("X25519SharedSecret");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4696,6 +4876,7 @@ static int X25519SharedSecret(WOLFSSL* ssl, curve25519_key* priv_key,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("X25519SharedSecret", ret);
 
     return ret;
@@ -4709,6 +4890,7 @@ static int X25519MakeKey(WOLFSSL* ssl, curve25519_key* key,
     (void)peer;
 
     WOLFSSL_ENTER("X25519MakeKey");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_KEY_GEN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4725,7 +4907,7 @@ static int X25519MakeKey(WOLFSSL* ssl, curve25519_key* key,
     else
 #endif
     {
-        ret = wc_curve25519_make_key(ssl->rng, CURVE25519_KEYSIZE, key);
+        ret = wc_curve25519_make_key(GetSslRng(ssl), CURVE25519_KEYSIZE, key);
     }
 
     if (ret == 0) {
@@ -4742,6 +4924,7 @@ static int X25519MakeKey(WOLFSSL* ssl, curve25519_key* key,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_KEY_GEN, 0, 0);
     WOLFSSL_LEAVE("X25519MakeKey", ret);
 
     return ret;
@@ -4816,6 +4999,7 @@ int Ed448Sign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("Ed448Sign");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SIGN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4843,6 +5027,7 @@ int Ed448Sign(WOLFSSL* ssl, const byte* in, word32 inSz, byte* out,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SIGN, 0, 0);
     WOLFSSL_LEAVE("Ed448Sign", ret);
 
     return ret;
@@ -4878,6 +5063,7 @@ int Ed448Verify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* msg,
     (void)keyBufInfo;
 
     WOLFSSL_ENTER("Ed448Verify");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_VERIFY);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4910,6 +5096,7 @@ int Ed448Verify(WOLFSSL* ssl, const byte* in, word32 inSz, const byte* msg,
         ret = (ret != 0 || ssl->eccVerifyRes == 0) ? VERIFY_SIGN_ERROR : 0;
     }
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_VERIFY, 0, 0);
     WOLFSSL_LEAVE("Ed448Verify", ret);
 
     return ret;
@@ -4966,6 +5153,7 @@ static int X448SharedSecret(WOLFSSL* ssl, curve448_key* priv_key,
     (void)side;
 
     WOLFSSL_ENTER("X448SharedSecret");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -4999,6 +5187,7 @@ static int X448SharedSecret(WOLFSSL* ssl, curve448_key* priv_key,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("X448SharedSecret", ret);
 
     return ret;
@@ -5011,6 +5200,7 @@ static int X448MakeKey(WOLFSSL* ssl, curve448_key* key, curve448_key* peer)
     (void)peer;
 
     WOLFSSL_ENTER("X448MakeKey");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_KEY_GEN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -5027,7 +5217,7 @@ static int X448MakeKey(WOLFSSL* ssl, curve448_key* key, curve448_key* peer)
     else
 #endif
     {
-        ret = wc_curve448_make_key(ssl->rng, CURVE448_KEY_SIZE, key);
+        ret = wc_curve448_make_key(GetSslRng(ssl), CURVE448_KEY_SIZE, key);
     }
 
     if (ret == 0) {
@@ -5044,6 +5234,7 @@ static int X448MakeKey(WOLFSSL* ssl, curve448_key* key, curve448_key* peer)
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_KEY_GEN, 0, 0);
     WOLFSSL_LEAVE("X448MakeKey", ret);
 
     return ret;
@@ -5060,6 +5251,7 @@ int DhGenKeyPair(WOLFSSL* ssl, DhKey* dhKey,
     int ret;
 
     WOLFSSL_ENTER("DhGenKeyPair");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_KEY_GEN);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -5068,7 +5260,7 @@ int DhGenKeyPair(WOLFSSL* ssl, DhKey* dhKey,
         return ret;
 #endif
 
-    ret = wc_DhGenerateKeyPair(dhKey, ssl->rng, priv, privSz, pub, pubSz);
+    ret = wc_DhGenerateKeyPair(dhKey, GetSslRng(ssl), priv, privSz, pub, pubSz);
 
     /* Handle async pending response */
 #ifdef WOLFSSL_ASYNC_CRYPT
@@ -5077,6 +5269,7 @@ int DhGenKeyPair(WOLFSSL* ssl, DhKey* dhKey,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_KEY_GEN, 0, 0);
     WOLFSSL_LEAVE("DhGenKeyPair", ret);
 
     return ret;
@@ -5092,6 +5285,7 @@ int DhAgree(WOLFSSL* ssl, DhKey* dhKey,
     (void)ssl;
 
     WOLFSSL_ENTER("DhAgree");
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
 
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* initialize event */
@@ -5134,6 +5328,7 @@ int DhAgree(WOLFSSL* ssl, DhKey* dhKey,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
     WOLFSSL_LEAVE("DhAgree", ret);
 
     return ret;
@@ -5344,11 +5539,6 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     if (!ssl || !ctx)
         return BAD_FUNC_ARG;
 
-#ifndef SINGLE_THREADED
-    if (ssl->suites == NULL && !writeDup)
-        return BAD_FUNC_ARG;
-#endif
-
     newSSL = ssl->ctx == NULL; /* Assign after null check */
 
 #ifndef NO_PSK
@@ -5357,6 +5547,15 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     }
 #endif
 
+#ifdef WOLFSSL_IO_POOL
+    if (!newSSL) {
+        if ((ret = IOPoolKeepLender(ssl, &ssl->buffers.inputBuffer, ctx)) < 0)
+            return ret;
+        if ((ret = IOPoolKeepLender(ssl, &ssl->buffers.outputBuffer, ctx)) < 0)
+            return ret;
+    }
+#endif
+
     /* decrement previous CTX reference count if exists.
      * This should only happen if switching ctxs!*/
     if (!newSSL) {
@@ -5503,6 +5702,15 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     ssl->options.partialWrite  = ctx->partialWrite;
     ssl->options.quietShutdown = ctx->quietShutdown;
     ssl->options.groupMessages = ctx->groupMessages;
+#ifdef WOLFSSL_KTLS
+    ssl->options.ktls          = ctx->ktls;
+#endif
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+    ssl->dynRecord.cfg         = ctx->dynRecord;
+#endif
+#ifdef WOLFSSL_READ_AHEAD
+    ssl->readAheadSz           = ctx->readAheadSz;
+#endif
 
 #ifndef NO_DH
     #if !defined(WOLFSSL_OLD_PRIME_CHECK) && !defined(HAVE_FIPS) && \
@@ -5549,12 +5757,19 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
         }
 #endif /* NO_PSK */
 
-        if (ctx->suites) {
-#ifndef SINGLE_THREADED
-            *ssl->suites = *ctx->suites;
-#else
+#ifdef WOLFSSL_SHARED_SUITES
+        if (ctx->suites && ctx->suites->setSuites) {
+            /* InitSuites() leaves set suites alone, share the CTX's */
+            FreeSuites(ssl);
             ssl->suites = ctx->suites;
+        }
+        else
 #endif
+        if (AllocateSuites(ssl) != 0) {
+            return MEMORY_E;
+        }
+        else if (ctx->suites) {
+            *ssl->suites = *ctx->suites;
         }
         else {
             XMEMSET(ssl->suites, 0, sizeof(Suites));
@@ -5649,6 +5864,11 @@ int InitHandshakeHashes(WOLFSSL* ssl)
         wc_Sha512SetFlags(&ssl->hsHashes->hashSha512, WC_HASH_FLAG_WILLCOPY);
     #endif
 #endif
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    /* hold messages until the suite decides which hashes are needed */
+    ssl->hsHashes->hashMask = HS_HASH_ALL;
+    ssl->hsHashes->deferred = 1;
+#endif
 
     return ret;
 }
@@ -5680,6 +5900,12 @@ void FreeHandshakeHashes(WOLFSSL* ssl)
             ssl->hsHashes->messages = NULL;
          }
     #endif
+    #ifdef WOLFSSL_LAZY_TRANSCRIPT
+        if (ssl->hsHashes->pending != NULL) {
+            XFREE(ssl->hsHashes->pending, ssl->heap, DYNAMIC_TYPE_HASHES);
+            ssl->hsHashes->pending = NULL;
+        }
+    #endif
 
         XFREE(ssl->hsHashes, ssl->heap, DYNAMIC_TYPE_HASHES);
         ssl->hsHashes = NULL;
@@ -5696,10 +5922,333 @@ void FreeHandshakeHashes(WOLFSSL* ssl)
 
    0 on success */
 int InitSSL(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
+{
+    return InitSSL_ex(ssl, ctx, writeDup, NULL);
+}
+
+#ifdef WC_THREAD_RNG
+/* The RNG for ssl to draw from. On the thread DRBGs that is the calling
+   thread's, looked up on each use as an object may be moved between threads
+   and a forked child gets its DRBG reseeded. NULL on failure */
+WC_RNG* GetSslRng(WOLFSSL* ssl)
+{
+    WC_RNG* rng;
+
+    if (!ssl->options.threadRng)
+        return ssl->rng;
+
+    rng = wc_GetThreadRng();
+    if (rng == NULL) {
+        WOLFSSL_MSG("Thread RNG error");
+    }
+
+    return rng;
+}
+#endif
+
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+#ifndef WOLFSSL_HS_TIMING_NOW
+/* monotonic time in ns, define WOLFSSL_HS_TIMING_NOW() to a function giving
+   it where there is no clock_gettime() */
+static word64 HsTimingNow(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return (word64)ts.tv_sec * 1000000000 + (word64)ts.tv_nsec;
+}
+    #define WOLFSSL_HS_TIMING_NOW() HsTimingNow()
+#endif
+
+/* Start recording the handshake of ssl afresh. 0 on success */
+int HsTimingInit(WOLFSSL* ssl)
+{
+    if (ssl->hsTiming == NULL) {
+        ssl->hsTiming = (HsTiming*)XMALLOC(sizeof(HsTiming), ssl->heap,
+                                           DYNAMIC_TYPE_INFO);
+        if (ssl->hsTiming == NULL)
+            return MEMORY_E;
+    }
+    XMEMSET(ssl->hsTiming, 0, sizeof(HsTiming));
+    ssl->hsTiming->active = 1;
+
+    return 0;
+}
+
+void HsTimingBegin(WOLFSSL* ssl, byte type)
+{
+    HsTiming* t = ssl->hsTiming;
+
+    /* still running when the call is made again after WANT_READ/pending */
+    if (t->open[type] == 0) {
+        t->open[type] = WOLFSSL_HS_TIMING_NOW();
+        if (t->base == 0)
+            t->base = t->open[type];
+    }
+}
+
+void HsTimingEnd(WOLFSSL* ssl, byte type, byte msgType, int ret)
+{
+    HsTiming* t = ssl->hsTiming;
+    word64    now;
+    word64    start;
+
+    if (ret == WANT_READ || ret == WANT_WRITE || ret == WC_PENDING_E ||
+            ret == OCSP_WANT_READ) {
+        return;
+    }
+
+    now = WOLFSSL_HS_TIMING_NOW();
+    if (t->base == 0)
+        t->base = now;
+    start = (t->open[type] != 0) ? t->open[type] : now;
+    t->open[type] = 0;
+    t->total[type] += now - start;
+
+    if (t->eventCnt < WOLFSSL_HS_TIMING_MAX_EVENTS) {
+        WOLFSSL_HS_TIMING_EVENT* ev = &t->events[t->eventCnt++];
+
+        ev->start    = (word32)((start - t->base) / 1000);
+        ev->duration = (word32)((now - start) / 1000);
+        ev->type     = type;
+        ev->msgType  = msgType;
+    }
+    else if (t->dropped < 0xFFFF) {
+        t->dropped++;
+    }
+}
+
+/* histogram bucket of a time in ns */
+static int HsTimingBucket(word64 ns)
+{
+    word64 us = ns / 1000;
+    int    i = 0;
+
+    while (us > 0 && i < WOLFSSL_HST_BUCKETS - 1) {
+        us >>= 1;
+        i++;
+    }
+
+    return i;
+}
+
+/* Handshake finished, stop recording and add the times to the CTX
+   histograms */
+void HsTimingDone(WOLFSSL* ssl)
+{
+    HsTiming*     t = ssl->hsTiming;
+    HsTimingHist* hist = &ssl->ctx->hsHist;
+    int           i;
+
+    t->active = 0;
+    t->total[WOLFSSL_HST_CRYPTO] = t->total[WOLFSSL_HST_SIGN] +
+                                   t->total[WOLFSSL_HST_VERIFY] +
+                                   t->total[WOLFSSL_HST_KEY_GEN] +
+                                   t->total[WOLFSSL_HST_SHARED_SECRET];
+    t->total[WOLFSSL_HST_NETWORK] = t->total[WOLFSSL_HST_IO_READ] +
+                                    t->total[WOLFSSL_HST_IO_WRITE];
+    t->total[WOLFSSL_HST_TOTAL] = WOLFSSL_HS_TIMING_NOW() - t->base;
+
+    if (!hist->on || wc_LockMutex(&hist->lock) != 0)
+        return;
+    for (i = 0; i < WOLFSSL_HST_TYPES; i++)
+        hist->bucket[i][HsTimingBucket(t->total[i])]++;
+    wc_UnLockMutex(&hist->lock);
+}
+#endif /* WOLFSSL_HANDSHAKE_TIMING */
+
+#ifdef WOLFSSL_CTX_STATS
+#ifndef SINGLE_THREADED
+/* shard of the calling thread, -1 until its first count. Without thread local
+   storage all threads share one shard which the atomics keep correct */
+static THREAD_LS_T int ctxStatsShard = -1;
+static unsigned int ctxStatsNextShard = 0;
+#endif
+
+/* counters of the calling thread for ctx, NULL when ctx has none */
+WOLFSSL_STATS* CtxStatsGet(WOLFSSL_CTX* ctx)
+{
+    int shard = 0;
+
+    if (ctx == NULL || ctx->stats == NULL)
+        return NULL;
+#ifndef SINGLE_THREADED
+    shard = ctxStatsShard;
+    if (shard < 0) {
+        shard = (int)(__atomic_fetch_add(&ctxStatsNextShard, 1,
+                              __ATOMIC_RELAXED) % WOLFSSL_CTX_STATS_SHARDS);
+        ctxStatsShard = shard;
+    }
+#endif
+    return &ctx->stats[shard].s;
+}
+
+/* index of the negotiated protocol version in the per version counters */
+static int CtxStatsVersion(const WOLFSSL* ssl)
+{
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls)
+        return (ssl->version.minor == DTLSv1_2_MINOR) ? WOLFSSL_STAT_DTLSV1_2 :
+                                                        WOLFSSL_STAT_DTLSV1;
+#endif
+    if (ssl->version.minor >= TLSv1_3_MINOR)
+        return WOLFSSL_STAT_TLSV1_3;
+    return ssl->version.minor;  /* SSLv3_MINOR through TLSv1_2_MINOR */
+}
+
+/* Handshake finished, count it as full or resumed */
+void CtxStatsHandshakeDone(WOLFSSL* ssl)
+{
+    WOLFSSL_STATS* st = CtxStatsGet(ssl->ctx);
+    int v;
+
+    if (st == NULL)
+        return;
+
+    v = CtxStatsVersion(ssl);
+    if (!ssl->options.resuming) {
+        CTX_STATS_ATOMIC_ADD(&st->handshakes[v], 1);
+    }
+    else {
+        int ticket = IsAtLeastTLSv1_3(ssl->version);
+
+        CTX_STATS_ATOMIC_ADD(&st->resumed[v], 1);
+    #ifdef HAVE_SESSION_TICKET
+        if (ssl->options.side == WOLFSSL_SERVER_END)
+            ticket |= ssl->options.useTicket;
+        else
+            ticket |= (ssl->session.ticketLen > 0);
+    #endif
+        if (ticket)
+            CTX_STATS_ATOMIC_ADD(&st->resumedTicket, 1);
+        else
+            CTX_STATS_ATOMIC_ADD(&st->resumedId, 1);
+    }
+
+#ifdef WOLFSSL_EARLY_DATA
+    if (ssl->earlyDataStatus == WOLFSSL_EARLY_DATA_ACCEPTED)
+        CTX_STATS_ATOMIC_ADD(&st->earlyDataAccepted, 1);
+    else if (ssl->earlyDataStatus == WOLFSSL_EARLY_DATA_REJECTED)
+        CTX_STATS_ATOMIC_ADD(&st->earlyDataRejected, 1);
+#endif
+}
+
+/* reason a handshake ended with error */
+static int CtxStatsFailReason(const WOLFSSL* ssl, int error)
+{
+    if (ssl->alert_history.last_rx.level == alert_fatal)
+        return WOLFSSL_STAT_FAIL_ALERT;
+    if (ssl->options.connReset)
+        return WOLFSSL_STAT_FAIL_IO;
+    /* ASN_PARSE_E through ASN_ALT_NAME_E are certificate decode errors */
+    if (error <= ASN_PARSE_E && error >= ASN_ALT_NAME_E)
+        return WOLFSSL_STAT_FAIL_CERT;
+
+    switch (error) {
+        case VERSION_ERROR:
+            return WOLFSSL_STAT_FAIL_VERSION;
+
+        case MATCH_SUITE_ERROR:
+        case UNSUPPORTED_SUITE:
+            return WOLFSSL_STAT_FAIL_CIPHER;
+
+        case VERIFY_CERT_ERROR:
+        case DOMAIN_NAME_MISMATCH:
+        case IPADDR_MISMATCH:
+        case NO_PEER_CERT:
+        case BAD_CERTIFICATE_STATUS_ERROR:
+        case OCSP_CERT_REVOKED:
+        case OCSP_CERT_UNKNOWN:
+        case OCSP_LOOKUP_FAIL:
+        case OCSP_INVALID_STATUS:
+        case CRL_CERT_REVOKED:
+        case CRL_MISSING:
+        case ASN_NO_SIGNER_E:
+        case ASN_SELF_SIGNED_E:
+        case ASN_PATHLEN_INV_E:
+        case ASN_NAME_INVALID_E:
+            return WOLFSSL_STAT_FAIL_CERT;
+
+        case VERIFY_MAC_ERROR:
+        case DECRYPT_ERROR:
+        case VERIFY_FINISHED_ERROR:
+        case VERIFY_SIGN_ERROR:
+            return WOLFSSL_STAT_FAIL_DECRYPT;
+
+        case FATAL_ERROR:
+            return WOLFSSL_STAT_FAIL_ALERT;
+
+        case SOCKET_ERROR_E:
+        case SOCKET_PEER_CLOSED_E:
+            return WOLFSSL_STAT_FAIL_IO;
+
+        default:
+            return WOLFSSL_STAT_FAIL_OTHER;
+    }
+}
+
+/* Connection released, count a handshake that ended with error. Handshakes
+   never started or left waiting on I/O are not failures */
+void CtxStatsHandshakeFailed(WOLFSSL* ssl)
+{
+    WOLFSSL_STATS* st;
+    int error = ssl->error;
+
+    if (ssl->options.handShakeDone || error >= 0 || error == WANT_READ ||
+            error == WANT_WRITE || error == WC_PENDING_E ||
+            error == OCSP_WANT_READ)
+        return;
+
+    st = CtxStatsGet(ssl->ctx);
+    if (st != NULL)
+        CTX_STATS_ATOMIC_ADD(&st->failures[CtxStatsFailReason(ssl, error)], 1);
+}
+
+/* Count the records in sz bytes of sent output */
+void CtxStatsRecordsOut(WOLFSSL* ssl, const byte* out, word32 sz)
+{
+    WOLFSSL_STATS* st = CtxStatsGet(ssl->ctx);
+    word32 hdrSz = RECORD_HEADER_SZ;
+    word32 idx = 0;
+    word64 records = 0;
+
+    if (st == NULL)
+        return;
+#ifdef WOLFSSL_KTLS
+    /* the kernel makes the records out of the plain text */
+    if (ssl->options.ktlsTx)
+        return;
+#endif
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls)
+        hdrSz = DTLS_RECORD_HEADER_SZ;
+#endif
+
+    /* length is the last two bytes of the header */
+    while (idx + hdrSz <= sz) {
+        word16 len;
+
+        ato16(out + idx + hdrSz - LENGTH_SZ, &len);
+        idx += hdrSz + len;
+        records++;
+    }
+    if (records > 0)
+        CTX_STATS_ATOMIC_ADD(&st->recordsOut, records);
+}
+#endif /* WOLFSSL_CTX_STATS */
+
+/* InitSSL() taking over an already seeded RNG when rng isn't NULL, it is
+   freed with ssl from then on */
+int InitSSL_ex(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup, WC_RNG* rng)
 {
     int  ret;
 
     XMEMSET(ssl, 0, sizeof(WOLFSSL));
+    if (rng != NULL) {
+        ssl->rng = rng;
+        ssl->options.weOwnRng = 1;
+    }
 
 #if defined(WOLFSSL_STATIC_MEMORY)
     if (ctx->heap != NULL) {
@@ -5880,6 +6429,7 @@ int InitSSL(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
 #endif
     ssl->options.useClientOrder = ctx->useClientOrder;
     ssl->options.mutualAuth = ctx->mutualAuth;
+    ssl->options.autoCompact = ctx->autoCompact;
 
 #ifdef WOLFSSL_STATIC_EPHEMERAL
     ssl->staticKE = ctx->staticKE;
@@ -5967,41 +6517,27 @@ int InitSSL(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     }
     XMEMSET(ssl->param, 0, sizeof(WOLFSSL_X509_VERIFY_PARAM));
 #endif
-
-#ifdef SINGLE_THREADED
-        if (ctx->suites == NULL)
-#endif
-        {
-            /* suites */
-            ssl->suites = (Suites*)XMALLOC(sizeof(Suites), ssl->heap,
-                                       DYNAMIC_TYPE_SUITES);
-            if (ssl->suites == NULL) {
-                WOLFSSL_MSG("Suites Memory error");
-                return MEMORY_E;
-            }
-        #ifdef OPENSSL_ALL
-            ssl->suites->stack = NULL;
-        #endif
-#ifdef SINGLE_THREADED
-            ssl->options.ownSuites = 1;
-#endif
-        }
-#ifdef SINGLE_THREADED
-        else {
-            ssl->options.ownSuites = 0;
-        }
-#endif
     }
 
     /* Initialize SSL with the appropriate fields from it's ctx */
-    /* requires valid arrays and suites unless writeDup ing */
+    /* requires valid arrays unless writeDup ing, shares or allocates suites */
     if ((ret =  SetSSL_CTX(ssl, ctx, writeDup)) != WOLFSSL_SUCCESS)
         return ret;
 
     ssl->options.dtls = ssl->version.major == DTLS_MAJOR;
 
 #ifdef SINGLE_THREADED
-    ssl->rng = ctx->rng;   /* CTX may have one, if so use it */
+    if (ssl->rng == NULL)
+        ssl->rng = ctx->rng;   /* CTX may have one, if so use it */
+#endif
+
+#if defined(WC_THREAD_RNG) && !defined(WOLFSSL_ASYNC_CRYPT)
+    /* a device may need an RNG of its own, as do operations run on async
+     * worker threads */
+    if (ssl->rng == NULL && ssl->devId == INVALID_DEVID) {
+        ssl->rng = wc_GetThreadRng();
+        ssl->options.threadRng = (ssl->rng != NULL);
+    }
 #endif
 
     if (ssl->rng == NULL) {
@@ -6040,6 +6576,14 @@ int InitSSL(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     if (ret != 0)
         return ret;
 
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    if (ctx->hsHist.on) {
+        ret = HsTimingInit(ssl);
+        if (ret != 0)
+            return ret;
+    }
+#endif
+
 #if defined(WOLFSSL_DTLS) && !defined(NO_WOLFSSL_SERVER)
     if (ssl->options.dtls && ssl->options.side == WOLFSSL_SERVER_END) {
         ret = wolfSSL_DTLS_SetCookieSecret(ssl, NULL, 0);
@@ -6390,7 +6934,7 @@ void FreeKeyExchange(WOLFSSL* ssl)
 /* Free up all memory used by Suites structure from WOLFSSL */
 void FreeSuites(WOLFSSL* ssl)
 {
-#ifdef SINGLE_THREADED
+#ifdef WOLFSSL_SHARED_SUITES
     if (ssl->options.ownSuites)
 #endif
     {
@@ -6402,26 +6946,82 @@ void FreeSuites(WOLFSSL* ssl)
         XFREE(ssl->suites, ssl->heap, DYNAMIC_TYPE_SUITES);
     }
     ssl->suites = NULL;
+#ifdef WOLFSSL_SHARED_SUITES
+    ssl->options.ownSuites = 0;
+#endif
 }
 
 
-/* In case holding SSL object in array and don't want to free actual ssl */
-void SSL_ResourceFree(WOLFSSL* ssl)
+/* Make sure the WOLFSSL has its own Suites before they are changed, copying
+ * any shared by the CTX. returns 0 on success */
+int AllocateSuites(WOLFSSL* ssl)
 {
-    /* Note: any resources used during the handshake should be released in the
-     * function FreeHandshakeResources(). Be careful with the special cases
-     * like the RNG which may optionally be kept for the whole session. (For
-     * example with the RNG, it isn't used beyond the handshake except when
-     * using stream ciphers where it is retained. */
+    Suites* suites;
 
-    FreeCiphers(ssl);
-    FreeArrays(ssl, 0);
-    FreeKeyExchange(ssl);
-    if (ssl->options.weOwnRng) {
-        wc_FreeRng(ssl->rng);
-        XFREE(ssl->rng, ssl->heap, DYNAMIC_TYPE_RNG);
-    }
-    FreeSuites(ssl);
+#ifdef WOLFSSL_SHARED_SUITES
+    if (ssl->options.ownSuites)
+        return 0;
+#else
+    if (ssl->suites != NULL)
+        return 0;
+#endif
+
+    suites = (Suites*)XMALLOC(sizeof(Suites), ssl->heap, DYNAMIC_TYPE_SUITES);
+    if (suites == NULL) {
+        WOLFSSL_MSG("Suites Memory error");
+        return MEMORY_E;
+    }
+    if (ssl->suites != NULL) {
+        *suites = *ssl->suites;
+    }
+    else {
+        XMEMSET(suites, 0, sizeof(Suites));
+    }
+#if defined(OPENSSL_ALL) || defined(WOLFSSL_NGINX) || defined(WOLFSSL_HAPROXY)
+    suites->stack = NULL;  /* cache belongs to the CTX's suites */
+#endif
+
+    ssl->suites = suites;
+#ifdef WOLFSSL_SHARED_SUITES
+    ssl->options.ownSuites = 1;
+#endif
+    return 0;
+}
+
+
+/* In case holding SSL object in array and don't want to free actual ssl */
+void SSL_ResourceFree(WOLFSSL* ssl)
+{
+    /* Note: any resources used during the handshake should be released in the
+     * function FreeHandshakeResources(). Be careful with the special cases
+     * like the RNG which may optionally be kept for the whole session. (For
+     * example with the RNG, it isn't used beyond the handshake except when
+     * using stream ciphers where it is retained. */
+
+#ifdef WOLFSSL_ASYNC_CRYPT
+    /* take an operation still in flight off the CTX event queue, its event
+     * lives in a key about to be freed */
+    if (ssl->async.dev != NULL && ssl->ctx != NULL &&
+            (ssl->async.dev->event.state == WOLF_EVENT_STATE_PENDING ||
+             ssl->async.dev->event.queue != NULL)) {
+        wolfEventQueue_Cancel(&ssl->ctx->event_queue, &ssl->async.dev->event);
+        ssl->async.dev->event.state = WOLF_EVENT_STATE_READY;
+        ssl->async.dev = NULL;
+    }
+#endif
+
+    FreeCiphers(ssl);
+    FreeArrays(ssl, 0);
+    FreeKeyExchange(ssl);
+    if (ssl->options.weOwnRng) {
+        wc_FreeRng(ssl->rng);
+        XFREE(ssl->rng, ssl->heap, DYNAMIC_TYPE_RNG);
+    }
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    XFREE(ssl->hsTiming, ssl->heap, DYNAMIC_TYPE_INFO);
+    ssl->hsTiming = NULL;
+#endif
+    FreeSuites(ssl);
     FreeHandshakeHashes(ssl);
     XFREE(ssl->buffers.domainName.buffer, ssl->heap, DYNAMIC_TYPE_DOMAIN);
 
@@ -6679,6 +7279,20 @@ void SSL_ResourceFree(WOLFSSL* ssl)
 }
 
 /* Free any handshake resources no longer needed */
+#ifdef WOLFSSL_SSL_POOL
+/* returns 1 when the CTX keeps released objects on its free list */
+static int SSLPoolOn(WOLFSSL_CTX* ctx)
+{
+    int on = 0;
+
+    if (wc_LockMutex(&ctx->sslPool.lock) == 0) {
+        on = ctx->sslPool.maxFree != 0;
+        wc_UnLockMutex(&ctx->sslPool.lock);
+    }
+    return on;
+}
+#endif
+
 void FreeHandshakeResources(WOLFSSL* ssl)
 {
     WOLFSSL_ENTER("FreeHandshakeResources");
@@ -6729,7 +7343,12 @@ void FreeHandshakeResources(WOLFSSL* ssl)
     #endif
 #endif
     ) {
-        if (ssl->options.weOwnRng) {
+        if (ssl->options.weOwnRng
+        #ifdef WOLFSSL_SSL_POOL
+                /* kept seeded for the next user of the object */
+                && !SSLPoolOn(ssl->ctx)
+        #endif
+           ) {
             wc_FreeRng(ssl->rng);
             XFREE(ssl->rng, ssl->heap, DYNAMIC_TYPE_RNG);
             ssl->rng = NULL;
@@ -6898,6 +7517,247 @@ void FreeHandshakeResources(WOLFSSL* ssl)
     #endif
     }
 #endif /* WOLFSSL_STATIC_MEMORY */
+
+    if (ssl->options.autoCompact)
+        CompactResources(ssl);
+}
+
+
+/* Release the rest of the handshake state FreeHandshakeResources() keeps and
+ * the record buffers when nothing is pending in them. Left is what protects
+ * records of the current epoch and what can be queried after the handshake
+ * (SNI, ALPN). Handshake state is kept while renegotiation or post-handshake
+ * authentication may still need it. */
+void CompactResources(WOLFSSL* ssl)
+{
+    int keepHandshake = 0;
+
+    WOLFSSL_ENTER("CompactResources");
+
+#ifdef HAVE_SECURE_RENEGOTIATION
+    if (ssl->secure_renegotiation && ssl->secure_renegotiation->enabled)
+        keepHandshake = 1;
+#endif
+#if defined(WOLFSSL_TLS13) && defined(WOLFSSL_POST_HANDSHAKE_AUTH)
+    if (ssl->options.tls1_3 && ssl->options.postHandshakeAuth)
+        keepHandshake = 1;
+#endif
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls && ssl->options.dtlsHsRetain)
+        keepHandshake = 1;
+#endif
+
+#ifdef HAVE_TLS_EXTENSIONS
+    if (!keepHandshake) {
+        /* extensions only used to negotiate */
+        TLSX_Remove(&ssl->extensions, TLSX_TRUSTED_CA_KEYS, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_STATUS_REQUEST, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_SUPPORTED_GROUPS, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_EC_POINT_FORMATS, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_STATUS_REQUEST_V2, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_QUANTUM_SAFE_HYBRID, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_SESSION_TICKET, ssl->heap);
+    #if !defined(NO_CERTS) && !defined(WOLFSSL_NO_SIGALG)
+        TLSX_Remove(&ssl->extensions, TLSX_SIGNATURE_ALGORITHMS, ssl->heap);
+    #endif
+    #ifdef WOLFSSL_TLS13
+        #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
+        TLSX_Remove(&ssl->extensions, TLSX_PRE_SHARED_KEY, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_PSK_KEY_EXCHANGE_MODES, ssl->heap);
+        #endif
+        #ifdef WOLFSSL_SEND_HRR_COOKIE
+        TLSX_Remove(&ssl->extensions, TLSX_COOKIE, ssl->heap);
+        #endif
+        #if !defined(NO_CERTS) && !defined(WOLFSSL_NO_SIGALG)
+        TLSX_Remove(&ssl->extensions, TLSX_SIGNATURE_ALGORITHMS_CERT,
+                                                                     ssl->heap);
+        #endif
+        TLSX_Remove(&ssl->extensions, TLSX_SUPPORTED_VERSIONS, ssl->heap);
+        TLSX_Remove(&ssl->extensions, TLSX_KEY_SHARE, ssl->heap);
+    #endif
+    }
+#endif /* HAVE_TLS_EXTENSIONS */
+    (void)keepHandshake;
+
+    /* record buffers, unless holding a record or handed out plain text */
+    if (ssl->buffers.outputBuffer.dynamicFlag &&
+                                       ssl->buffers.outputBuffer.length == 0
+#ifdef WOLFSSL_ZERO_COPY
+            && ssl->buffers.zcWriteSz == 0
+#endif
+       ) {
+        ShrinkOutputBuffer(ssl);
+    }
+    if (ssl->buffers.inputBuffer.dynamicFlag &&
+            ssl->options.processReply == doProcessInit &&
+            ssl->buffers.clearOutputBuffer.length == 0) {
+        ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+    }
+}
+
+
+/* Size of the cipher objects allocated for one direction. */
+static word32 CiphersSize(const Ciphers* cipher)
+{
+    word32 sz = 0;
+
+    (void)cipher;
+#ifdef BUILD_ARC4
+    if (cipher->arc4 != NULL)
+        sz += sizeof(Arc4);
+#endif
+#ifdef BUILD_DES3
+    if (cipher->des3 != NULL)
+        sz += sizeof(Des3);
+#endif
+#if defined(BUILD_AES) || defined(BUILD_AESGCM)
+    if (cipher->aes != NULL)
+        sz += sizeof(Aes);
+    #if (defined(BUILD_AESGCM) || defined(HAVE_AESCCM)) && \
+                                                      !defined(WOLFSSL_NO_TLS12)
+    if (cipher->additional != NULL)
+        sz += AEAD_AUTH_DATA_SZ;
+    #endif
+#endif
+#ifdef CIPHER_NONCE
+    if (cipher->nonce != NULL)
+        sz += AEAD_NONCE_SZ;
+#endif
+#ifdef HAVE_CAMELLIA
+    if (cipher->cam != NULL)
+        sz += sizeof(Camellia);
+#endif
+#ifdef HAVE_CHACHA
+    if (cipher->chacha != NULL)
+        sz += sizeof(ChaCha);
+#endif
+#ifdef HAVE_HC128
+    if (cipher->hc128 != NULL)
+        sz += sizeof(HC128);
+#endif
+#ifdef BUILD_RABBIT
+    if (cipher->rabbit != NULL)
+        sz += sizeof(Rabbit);
+#endif
+#ifdef HAVE_IDEA
+    if (cipher->idea != NULL)
+        sz += sizeof(Idea);
+#endif
+#if defined(WOLFSSL_TLS13) && defined(HAVE_NULL_CIPHER)
+    if (cipher->hmac != NULL)
+        sz += sizeof(Hmac);
+#endif
+
+    return sz;
+}
+
+
+/* Approximate memory held by ssl, split by what it is used for. Embedded
+ * parts are counted with the object they make up. */
+void ResourcesFootprint(WOLFSSL* ssl, WOLFSSL_MEM_FOOTPRINT* fp)
+{
+#ifdef HAVE_TLS_EXTENSIONS
+    TLSX* ext;
+#endif
+
+    XMEMSET(fp, 0, sizeof(WOLFSSL_MEM_FOOTPRINT));
+
+    fp->object = sizeof(WOLFSSL) - sizeof(WOLFSSL_SESSION);
+    fp->session = sizeof(WOLFSSL_SESSION);
+#ifdef HAVE_SESSION_TICKET
+    if (ssl->session.isDynamic)
+        fp->session += ssl->session.ticketLen;
+#endif
+#ifdef KEEP_PEER_CERT
+    fp->object -= sizeof(WOLFSSL_X509);
+    fp->peerCert = sizeof(WOLFSSL_X509);
+    if (ssl->peerCert.derCert != NULL)
+        fp->peerCert += sizeof(DerBuffer) + ssl->peerCert.derCert->length;
+#endif
+
+    if (ssl->arrays != NULL) {
+        fp->handshake += sizeof(Arrays);
+        if (ssl->arrays->preMasterSecret != NULL)
+            fp->handshake += ENCRYPT_LEN;
+        if (ssl->arrays->pendingMsg != NULL)
+            fp->handshake += ssl->arrays->pendingMsgSz;
+    }
+    if (ssl->hsHashes != NULL)
+        fp->handshake += sizeof(HS_Hashes);
+    if (ssl->suites != NULL
+#ifdef WOLFSSL_SHARED_SUITES
+            && ssl->options.ownSuites
+#endif
+       ) {
+        fp->handshake += sizeof(Suites);
+    }
+#ifndef NO_RSA
+    if (ssl->peerRsaKey != NULL)
+        fp->handshake += sizeof(RsaKey);
+#endif
+#ifdef HAVE_ECC
+    if (ssl->peerEccKey != NULL)
+        fp->handshake += sizeof(ecc_key);
+    if (ssl->peerEccDsaKey != NULL)
+        fp->handshake += sizeof(ecc_key);
+#endif
+#if defined(HAVE_ECC) || defined(HAVE_CURVE25519) || defined(HAVE_CURVE448)
+    if (ssl->eccTempKey != NULL)
+        fp->handshake += sizeof(ecc_key);
+#endif
+#ifdef HAVE_ED25519
+    if (ssl->peerEd25519Key != NULL)
+        fp->handshake += sizeof(ed25519_key);
+#endif
+#ifdef HAVE_CURVE25519
+    if (ssl->peerX25519Key != NULL)
+        fp->handshake += sizeof(curve25519_key);
+#endif
+#ifdef HAVE_ED448
+    if (ssl->peerEd448Key != NULL)
+        fp->handshake += sizeof(ed448_key);
+#endif
+#ifdef HAVE_CURVE448
+    if (ssl->peerX448Key != NULL)
+        fp->handshake += sizeof(curve448_key);
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    if (ssl->hsTiming != NULL)
+        fp->handshake += sizeof(HsTiming);
+#endif
+
+    fp->ciphers = CiphersSize(&ssl->encrypt) + CiphersSize(&ssl->decrypt);
+#if defined(HAVE_POLY1305) && defined(HAVE_ONE_TIME_AUTH)
+    if (ssl->auth.poly1305 != NULL)
+        fp->ciphers += sizeof(Poly1305);
+#endif
+
+    if (ssl->rng != NULL && ssl->options.weOwnRng) {
+        fp->rng = sizeof(WC_RNG);
+    #if defined(HAVE_HASHDRBG) && !defined(HAVE_FIPS) && \
+        !defined(HAVE_SELFTEST) && \
+        (!defined(WOLFSSL_NO_MALLOC) || defined(WOLFSSL_STATIC_MEMORY))
+        if (ssl->rng->drbg != NULL)
+            fp->rng += sizeof(struct DRBG_internal);
+    #endif
+    }
+
+    if (ssl->buffers.inputBuffer.dynamicFlag) {
+        fp->buffers += ssl->buffers.inputBuffer.bufferSize +
+                       ssl->buffers.inputBuffer.offset;
+    }
+    if (ssl->buffers.outputBuffer.dynamicFlag) {
+        fp->buffers += ssl->buffers.outputBuffer.bufferSize +
+                       ssl->buffers.outputBuffer.offset;
+    }
+
+#ifdef HAVE_TLS_EXTENSIONS
+    for (ext = ssl->extensions; ext != NULL; ext = ext->next)
+        fp->extensions += sizeof(TLSX);
+#endif
+
+    fp->total = fp->object + fp->session + fp->peerCert + fp->handshake +
+                fp->ciphers + fp->rng + fp->buffers + fp->extensions;
 }
 
 
@@ -6911,6 +7771,113 @@ void FreeSSL(WOLFSSL* ssl, void* heap)
     XFREE(ssl, heap, DYNAMIC_TYPE_SSL);
     (void)heap;
 }
+#ifdef WOLFSSL_SSL_POOL
+/* Take a released object off the CTX free list along with its seeded RNG.
+   The RNG is reseeded as the process may have forked since it was released.
+   returns NULL when the free list is empty or off */
+WOLFSSL* SSLPoolGet(WOLFSSL_CTX* ctx, WC_RNG** rng)
+{
+    SSLPool* pool = &ctx->sslPool;
+    WOLFSSL* ssl = NULL;
+
+    *rng = NULL;
+    if (wc_LockMutex(&pool->lock) != 0)
+        return NULL;
+    if (pool->maxFree != 0) {
+        if (pool->head != NULL) {
+            ssl = pool->head;
+            pool->head = ssl->poolNext;
+            pool->freeCnt--;
+            pool->hits++;
+        }
+        else {
+            pool->misses++;
+        }
+    }
+    wc_UnLockMutex(&pool->lock);
+
+    if (ssl != NULL && ssl->rng != NULL) {
+    #ifdef HAVE_HASHDRBG
+        if (wc_RNG_Reseed(ssl->rng) != 0) {
+            /* InitSSL_ex() sets up a new one */
+            wc_FreeRng(ssl->rng);
+            XFREE(ssl->rng, ctx->heap, DYNAMIC_TYPE_RNG);
+            ssl->rng = NULL;
+        }
+    #endif
+        *rng = ssl->rng;
+    }
+    return ssl;
+}
+
+/* Release ssl onto its CTX free list instead of freeing it. Everything but
+   the object and its RNG is freed and the object is wiped.
+   returns 0 when ssl was put on the free list */
+int SSLPoolPut(WOLFSSL* ssl)
+{
+    WOLFSSL_CTX* ctx = ssl->ctx;
+    SSLPool*     pool;
+    WC_RNG*      rng = NULL;
+    int          full;
+    int          ret = -1;
+
+    if (ctx == NULL)
+        return -1;
+    pool = &ctx->sslPool;
+    if (wc_LockMutex(&pool->lock) != 0)
+        return -1;
+    full = pool->maxFree == 0 || pool->freeCnt >= pool->maxFree;
+    wc_UnLockMutex(&pool->lock);
+    if (full)
+        return -1;
+
+    if (ssl->options.weOwnRng) {
+        rng = ssl->rng;
+        ssl->options.weOwnRng = 0;
+    }
+    SSL_ResourceFree(ssl);
+    ForceZero(ssl, sizeof(WOLFSSL));
+    ssl->rng = rng;
+
+    if (wc_LockMutex(&pool->lock) == 0) {
+        if (pool->freeCnt < pool->maxFree) {
+            ssl->poolNext = pool->head;
+            pool->head = ssl;
+            pool->freeCnt++;
+            ret = 0;
+        }
+        wc_UnLockMutex(&pool->lock);
+    }
+    if (ret != 0) {
+        /* filled up meanwhile */
+        if (rng != NULL) {
+            wc_FreeRng(rng);
+            XFREE(rng, ctx->heap, DYNAMIC_TYPE_RNG);
+        }
+        XFREE(ssl, ctx->heap, DYNAMIC_TYPE_SSL);
+    }
+
+    /* drop the reference, frees the CTX and the free list if last */
+    FreeSSL_Ctx(ctx);
+    return 0;
+}
+
+/* Free the objects on the CTX free list */
+void SSLPoolFree(WOLFSSL_CTX* ctx)
+{
+    while (ctx->sslPool.head != NULL) {
+        WOLFSSL* ssl = ctx->sslPool.head;
+
+        ctx->sslPool.head = ssl->poolNext;
+        if (ssl->rng != NULL) {
+            wc_FreeRng(ssl->rng);
+            XFREE(ssl->rng, ctx->heap, DYNAMIC_TYPE_RNG);
+        }
+        XFREE(ssl, ctx->heap, DYNAMIC_TYPE_SSL);
+    }
+    ctx->sslPool.freeCnt = 0;
+}
+#endif /* WOLFSSL_SSL_POOL */
 
 #if !defined(NO_OLD_TLS) || defined(WOLFSSL_DTLS) || \
     !defined(WOLFSSL_NO_TLS12) || \
@@ -7928,6 +8895,154 @@ static int EdDSA_Update(WOLFSSL* ssl, const byte* data, int sz)
 }
 #endif /* (HAVE_ED25519 || HAVE_ED448) && !WOLFSSL_NO_CLIENT_AUTH */
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    #define HS_HASH_ON(ssl, h)  (((ssl)->hsHashes->hashMask & (h)) != 0)
+#else
+    #define HS_HASH_ON(ssl, h)  1
+#endif
+
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+/* Append handshake message data to the pending transcript.
+ *
+ * ssl   The SSL/TLS object.
+ * data  The handshake message data.
+ * sz    The size of the data.
+ * returns 0 on success, MEMORY_E on allocation failure.
+ */
+static int HashDefer(WOLFSSL* ssl, const byte* data, int sz)
+{
+    HS_Hashes* hs = ssl->hsHashes;
+
+    if (sz <= 0)
+        return 0;
+
+    if (hs->pendingSz + (word32)sz > hs->pendingMax) {
+        word32 max = hs->pendingMax * 2;
+        byte*  pending;
+
+        if (max < hs->pendingSz + (word32)sz)
+            max = hs->pendingSz + (word32)sz;
+        if (max < HS_HASH_PENDING_SZ)
+            max = HS_HASH_PENDING_SZ;
+
+        pending = (byte*)XREALLOC(hs->pending, max, ssl->heap,
+                                                           DYNAMIC_TYPE_HASHES);
+        if (pending == NULL)
+            return MEMORY_E;
+        hs->pending    = pending;
+        hs->pendingMax = max;
+    }
+
+    XMEMCPY(hs->pending + hs->pendingSz, data, sz);
+    hs->pendingSz += sz;
+
+    return 0;
+}
+
+/* Stop holding messages and hash the pending ones with the hashes in mask.
+ *
+ * ssl   The SSL/TLS object.
+ * mask  The HS_HASH_* values of the hashes to run from now on.
+ * returns 0 on success, otherwise failure.
+ */
+static int HashCommit(WOLFSSL* ssl, word16 mask)
+{
+    HS_Hashes* hs = ssl->hsHashes;
+    int        ret = 0;
+
+    if (hs == NULL)
+        return BAD_FUNC_ARG;
+    if (!hs->deferred)
+        return 0;
+
+    hs->hashMask = mask;
+    hs->deferred = 0;
+    if (hs->pendingSz > 0)
+        ret = HashRaw(ssl, hs->pending, (int)hs->pendingSz);
+
+    XFREE(hs->pending, ssl->heap, DYNAMIC_TYPE_HASHES);
+    hs->pending    = NULL;
+    hs->pendingSz  = 0;
+    hs->pendingMax = 0;
+
+    return ret;
+}
+
+/* Hashes the transcript needs for the negotiated version and cipher suite.
+ *
+ * The PRF (and TLS v1.3 HKDF) hash is set by the suite. Before TLS v1.2 the
+ * MD5 and SHA-1 hashes are used. A TLS v1.2 CertificateVerify may be signed
+ * with any hash so all are kept when one may be sent or received.
+ */
+static word16 HashesNeeded(WOLFSSL* ssl)
+{
+    word16 mask;
+
+    if (!IsAtLeastTLSv1_2(ssl))
+        return HS_HASH_MD5 | HS_HASH_SHA;
+
+    switch (ssl->specs.mac_algorithm) {
+        case sha384_mac:
+            mask = HS_HASH_SHA384;
+            break;
+        case sha512_mac:
+            mask = HS_HASH_SHA512;
+            break;
+        default:
+            mask = HS_HASH_SHA256;
+            break;
+    }
+
+    if (IsAtLeastTLSv1_3(ssl->version))
+        return mask;
+
+#ifndef WOLFSSL_NO_CLIENT_AUTH
+    if (ssl->options.side == WOLFSSL_SERVER_END) {
+        if (ssl->options.verifyPeer)
+            mask = HS_HASH_ALL;
+    }
+    else if (ssl->buffers.certificate != NULL
+    #if defined(OPENSSL_ALL) || defined(OPENSSL_EXTRA) || \
+        defined(WOLFSSL_NGINX) || defined (WOLFSSL_HAPROXY)
+             || ssl->ctx->CBClientCert != NULL
+    #endif
+            ) {
+        mask = HS_HASH_ALL;
+    }
+#endif
+
+    return mask;
+}
+
+/* The negotiated cipher suite is known: hash the held messages with only the
+ * hashes it needs and update just those from now on.
+ *
+ * ssl  The SSL/TLS object.
+ * returns 0 on success, otherwise failure.
+ */
+int SelectHandshakeHashes(WOLFSSL* ssl)
+{
+    if (ssl == NULL || ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+
+    return HashCommit(ssl, HashesNeeded(ssl));
+}
+
+/* A transcript hash is needed before the cipher suite is negotiated: hash
+ * the held messages with all the hashes.
+ *
+ * ssl  The SSL/TLS object.
+ * returns 0 on success, otherwise failure.
+ */
+int FlushHandshakeHashes(WOLFSSL* ssl)
+{
+    if (ssl == NULL || ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+
+    return HashCommit(ssl, HS_HASH_ALL);
+}
+#endif /* WOLFSSL_LAZY_TRANSCRIPT */
+
 int HashRaw(WOLFSSL* ssl, const byte* data, int sz)
 {
     int ret = 0;
@@ -7939,37 +9054,52 @@ int HashRaw(WOLFSSL* ssl, const byte* data, int sz)
         return BAD_FUNC_ARG;
     }
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if (ssl->hsHashes->deferred)
+        return HashDefer(ssl, data, sz);
+#endif
+
 #ifndef NO_OLD_TLS
     #ifndef NO_SHA
-        wc_ShaUpdate(&ssl->hsHashes->hashSha, data, sz);
+        if (HS_HASH_ON(ssl, HS_HASH_SHA))
+            wc_ShaUpdate(&ssl->hsHashes->hashSha, data, sz);
     #endif
     #ifndef NO_MD5
-        wc_Md5Update(&ssl->hsHashes->hashMd5, data, sz);
+        if (HS_HASH_ON(ssl, HS_HASH_MD5))
+            wc_Md5Update(&ssl->hsHashes->hashMd5, data, sz);
     #endif
 #endif /* NO_OLD_TLS */
 
     if (IsAtLeastTLSv1_2(ssl)) {
     #ifndef NO_SHA256
-        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, data, sz);
-        if (ret != 0)
-            return ret;
+        if (HS_HASH_ON(ssl, HS_HASH_SHA256)) {
+            ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, data, sz);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     #ifdef WOLFSSL_SHA384
-        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, data, sz);
-        if (ret != 0)
-            return ret;
+        if (HS_HASH_ON(ssl, HS_HASH_SHA384)) {
+            ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, data, sz);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     #ifdef WOLFSSL_SHA512
-        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, data, sz);
-        if (ret != 0)
-            return ret;
+        if (HS_HASH_ON(ssl, HS_HASH_SHA512)) {
+            ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, data, sz);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     #if !defined(WOLFSSL_NO_CLIENT_AUTH) && \
                ((defined(HAVE_ED25519) && !defined(NO_ED25519_CLIENT_AUTH)) || \
                 (defined(HAVE_ED448) && !defined(NO_ED448_CLIENT_AUTH)))
-        ret = EdDSA_Update(ssl, data, sz);
-        if (ret != 0)
-            return ret;
+        if (HS_HASH_ON(ssl, HS_HASH_MSGS)) {
+            ret = EdDSA_Update(ssl, data, sz);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     }
 
@@ -8091,6 +9221,10 @@ static void AddHandShakeHeader(byte* output, word32 length,
 
     hs->type = type;
     c32to24(length, hs->length);         /* type and length same for each */
+    if (fragOffset == 0) {
+        HS_TIMING_END(ssl, WOLFSSL_HST_MSG_SEND, type, 0);
+        WC_TRACE(WC_TRACE_HS_SEND, ssl, NULL, type);
+    }
 #ifdef WOLFSSL_DTLS
     if (ssl->options.dtls) {
         DtlsHandShakeHeader* dtls;
@@ -8211,26 +9345,131 @@ retry:
                 ssl->options.isClosed = 1;
                 return -1;
 
-            case WOLFSSL_CBIO_ERR_TIMEOUT:
-            #ifdef WOLFSSL_DTLS
-                if (IsDtlsNotSctpMode(ssl) &&
-                    ssl->options.handShakeState != HANDSHAKE_DONE &&
-                    DtlsMsgPoolTimeout(ssl) == 0 &&
-                    DtlsMsgPoolSend(ssl, 0) == 0) {
+            case WOLFSSL_CBIO_ERR_TIMEOUT:
+            #ifdef WOLFSSL_DTLS
+                if (IsDtlsNotSctpMode(ssl) &&
+                    ssl->options.handShakeState != HANDSHAKE_DONE &&
+                    DtlsMsgPoolTimeout(ssl) == 0 &&
+                    DtlsMsgPoolSend(ssl, 0) == 0) {
+
+                    /* retry read for DTLS during handshake only */
+                    goto retry;
+                }
+            #endif
+                return -1;
+
+            default:
+                WOLFSSL_MSG("Unexpected recv return code");
+                return recvd;
+        }
+    }
+
+    return recvd;
+}
+
+#ifdef WOLFSSL_IO_POOL
+/* Borrow a buffer of IO_POOL_BUF_SZ bytes from the CTX pool, allocating one
+ * when the free list is empty.
+ * returns NULL when the pool is off or size doesn't fit */
+static byte* IOPoolGet(WOLFSSL* ssl, word32 size)
+{
+    IOBufPool* pool = &ssl->ctx->ioPool;
+    byte*      buf = NULL;
+
+    if (pool->maxFree == 0 || size > IO_POOL_BUF_SZ)
+        return NULL;
+
+    if (wc_LockMutex(&pool->lock) != 0)
+        return NULL;
+    if (pool->head != NULL) {
+        buf = (byte*)pool->head;
+        XMEMCPY(&pool->head, buf, sizeof(void*));
+        pool->freeCnt--;
+    }
+    pool->inUse++;
+    wc_UnLockMutex(&pool->lock);
+
+    if (buf == NULL) {
+        buf = (byte*)XMALLOC(IO_POOL_BUF_SZ, ssl->ctx->heap,
+                             DYNAMIC_TYPE_IN_BUFFER);
+        if (buf == NULL && wc_LockMutex(&pool->lock) == 0) {
+            pool->inUse--;
+            wc_UnLockMutex(&pool->lock);
+        }
+    }
+
+    return buf;
+}
+
+/* Give a borrowed buffer back to the CTX that lent it, freed if the pool is
+ * full or off */
+static void IOPoolPut(WOLFSSL_CTX* ctx, byte* buf)
+{
+    IOBufPool* pool = &ctx->ioPool;
+
+    if (wc_LockMutex(&pool->lock) == 0) {
+        if (pool->inUse > 0)
+            pool->inUse--;
+        if (pool->freeCnt < pool->maxFree) {
+            XMEMCPY(buf, &pool->head, sizeof(void*));
+            pool->head = buf;
+            pool->freeCnt++;
+            buf = NULL;
+        }
+        wc_UnLockMutex(&pool->lock);
+    }
+
+    XFREE(buf, ctx->heap, DYNAMIC_TYPE_IN_BUFFER);
+}
+
+/* The connection is moving to ctx. A buffer the current CTX lent still goes
+ * back to it, so keep a reference on that CTX until the buffer is freed. */
+int IOPoolKeepLender(WOLFSSL* ssl, bufferStatic* buf, WOLFSSL_CTX* ctx)
+{
+    int ret;
+
+    if (buf->pool != ssl->ctx || buf->poolRef || ctx == ssl->ctx)
+        return 0;
+    if ((ret = SSL_CTX_RefCount(ssl->ctx, 1)) < 0)
+        return ret;
+    buf->poolRef = 1;
+
+    return 0;
+}
 
-                    /* retry read for DTLS during handshake only */
-                    goto retry;
-                }
-            #endif
-                return -1;
+/* Free the buffers on the free list, buffers lent out are freed when they
+ * come back */
+void IOPoolFree(WOLFSSL_CTX* ctx)
+{
+    while (ctx->ioPool.head != NULL) {
+        byte* buf = (byte*)ctx->ioPool.head;
 
-            default:
-                WOLFSSL_MSG("Unexpected recv return code");
-                return recvd;
-        }
+        XMEMCPY(&ctx->ioPool.head, buf, sizeof(void*));
+        XFREE(buf, ctx->heap, DYNAMIC_TYPE_IN_BUFFER);
     }
+    ctx->ioPool.freeCnt = 0;
+}
+#endif /* WOLFSSL_IO_POOL */
 
-    return recvd;
+/* Release the dynamic memory of an I/O buffer */
+static void FreeIOBuffer(WOLFSSL* ssl, bufferStatic* buf, int type)
+{
+#ifdef WOLFSSL_IO_POOL
+    if (buf->pool != NULL) {
+        WOLFSSL_CTX* ctx = buf->pool;
+        byte poolRef = buf->poolRef;
+
+        buf->pool = NULL;
+        buf->poolRef = 0;
+        IOPoolPut(ctx, buf->buffer - buf->offset);
+        if (poolRef)
+            wolfSSL_CTX_free(ctx);
+        return;
+    }
+#endif
+    XFREE(buf->buffer - buf->offset, ssl->heap, type);
+    (void)ssl;
+    (void)type;
 }
 
 
@@ -8238,8 +9477,7 @@ retry:
 void ShrinkOutputBuffer(WOLFSSL* ssl)
 {
     WOLFSSL_MSG("Shrinking output buffer\n");
-    XFREE(ssl->buffers.outputBuffer.buffer - ssl->buffers.outputBuffer.offset,
-          ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+    FreeIOBuffer(ssl, &ssl->buffers.outputBuffer, DYNAMIC_TYPE_OUT_BUFFER);
     ssl->buffers.outputBuffer.buffer = ssl->buffers.outputBuffer.staticBuffer;
     ssl->buffers.outputBuffer.bufferSize  = STATIC_BUFFER_LEN;
     ssl->buffers.outputBuffer.dynamicFlag = 0;
@@ -8263,8 +9501,7 @@ void ShrinkInputBuffer(WOLFSSL* ssl, int forcedFree)
                ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.idx,
                usedLength);
 
-    XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-          ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+    FreeIOBuffer(ssl, &ssl->buffers.inputBuffer, DYNAMIC_TYPE_IN_BUFFER);
     ssl->buffers.inputBuffer.buffer = ssl->buffers.inputBuffer.staticBuffer;
     ssl->buffers.inputBuffer.bufferSize  = STATIC_BUFFER_LEN;
     ssl->buffers.inputBuffer.dynamicFlag = 0;
@@ -8289,11 +9526,15 @@ int SendBuffered(WOLFSSL* ssl)
 #endif
 
     while (ssl->buffers.outputBuffer.length > 0) {
-        int sent = ssl->CBIOSend(ssl,
-                                      (char*)ssl->buffers.outputBuffer.buffer +
-                                      ssl->buffers.outputBuffer.idx,
-                                      (int)ssl->buffers.outputBuffer.length,
-                                      ssl->IOCB_WriteCtx);
+        int sent;
+
+        HS_TIMING_BEGIN(ssl, WOLFSSL_HST_IO_WRITE);
+        sent = ssl->CBIOSend(ssl, (char*)ssl->buffers.outputBuffer.buffer +
+                                  ssl->buffers.outputBuffer.idx,
+                                  (int)ssl->buffers.outputBuffer.length,
+                                  ssl->IOCB_WriteCtx);
+        HS_TIMING_END(ssl, WOLFSSL_HST_IO_WRITE, 0,
+                      (sent == WOLFSSL_CBIO_ERR_WANT_WRITE) ? WANT_WRITE : 0);
         if (sent < 0) {
             switch (sent) {
 
@@ -8342,8 +9583,11 @@ int SendBuffered(WOLFSSL* ssl)
 
         ssl->buffers.outputBuffer.idx += sent;
         ssl->buffers.outputBuffer.length -= sent;
+        CTX_STATS_ADD(ssl, bytesOut, sent);
     }
 
+    CTX_STATS_RECORDS_OUT(ssl, ssl->buffers.outputBuffer.buffer,
+                          ssl->buffers.outputBuffer.idx);
     ssl->buffers.outputBuffer.idx = 0;
 
     if (ssl->buffers.outputBuffer.dynamicFlag)
@@ -8357,6 +9601,9 @@ int SendBuffered(WOLFSSL* ssl)
 static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
 {
     byte* tmp;
+#ifdef WOLFSSL_IO_POOL
+    int   pooled;
+#endif
 #if WOLFSSL_GENERAL_ALIGNMENT > 0
     byte  hdrSz = ssl->options.dtls ? DTLS_RECORD_HEADER_SZ :
                                       RECORD_HEADER_SZ;
@@ -8376,6 +9623,11 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
     }
 #endif
 
+#ifdef WOLFSSL_IO_POOL
+    tmp = IOPoolGet(ssl, size + ssl->buffers.outputBuffer.length + align);
+    pooled = (tmp != NULL);
+    if (tmp == NULL)
+#endif
     tmp = (byte*)XMALLOC(size + ssl->buffers.outputBuffer.length + align,
                              ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
     WOLFSSL_MSG("growing output buffer\n");
@@ -8403,9 +9655,7 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
                ssl->buffers.outputBuffer.length);
 
     if (ssl->buffers.outputBuffer.dynamicFlag)
-        XFREE(ssl->buffers.outputBuffer.buffer -
-              ssl->buffers.outputBuffer.offset, ssl->heap,
-              DYNAMIC_TYPE_OUT_BUFFER);
+        FreeIOBuffer(ssl, &ssl->buffers.outputBuffer, DYNAMIC_TYPE_OUT_BUFFER);
     ssl->buffers.outputBuffer.dynamicFlag = 1;
 
 #if WOLFSSL_GENERAL_ALIGNMENT > 0
@@ -8418,6 +9668,14 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
     ssl->buffers.outputBuffer.buffer = tmp;
     ssl->buffers.outputBuffer.bufferSize = size +
                                            ssl->buffers.outputBuffer.length;
+#ifdef WOLFSSL_IO_POOL
+    /* all of a pooled buffer can be used */
+    if (pooled) {
+        ssl->buffers.outputBuffer.pool = ssl->ctx;
+        ssl->buffers.outputBuffer.bufferSize = IO_POOL_BUF_SZ -
+                                             ssl->buffers.outputBuffer.offset;
+    }
+#endif
     return 0;
 }
 
@@ -8426,6 +9684,9 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
 int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
 {
     byte* tmp;
+#ifdef WOLFSSL_IO_POOL
+    int   pooled;
+#endif
 #if defined(WOLFSSL_DTLS) || WOLFSSL_GENERAL_ALIGNMENT > 0
     byte  align = ssl->options.dtls ? WOLFSSL_GENERAL_ALIGNMENT : 0;
     byte  hdrSz = DTLS_RECORD_HEADER_SZ;
@@ -8450,6 +9711,11 @@ int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
         return BAD_FUNC_ARG;
     }
 
+#ifdef WOLFSSL_IO_POOL
+    tmp = IOPoolGet(ssl, size + usedLength + align);
+    pooled = (tmp != NULL);
+    if (tmp == NULL)
+#endif
     tmp = (byte*)XMALLOC(size + usedLength + align,
                              ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
     WOLFSSL_MSG("growing input buffer\n");
@@ -8477,8 +9743,7 @@ int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
                     ssl->buffers.inputBuffer.idx, usedLength);
 
     if (ssl->buffers.inputBuffer.dynamicFlag)
-        XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-              ssl->heap,DYNAMIC_TYPE_IN_BUFFER);
+        FreeIOBuffer(ssl, &ssl->buffers.inputBuffer, DYNAMIC_TYPE_IN_BUFFER);
 
     ssl->buffers.inputBuffer.dynamicFlag = 1;
 #if defined(WOLFSSL_DTLS) || WOLFSSL_GENERAL_ALIGNMENT > 0
@@ -8492,6 +9757,14 @@ int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
     ssl->buffers.inputBuffer.bufferSize = size + usedLength;
     ssl->buffers.inputBuffer.idx    = 0;
     ssl->buffers.inputBuffer.length = usedLength;
+#ifdef WOLFSSL_IO_POOL
+    /* all of a pooled buffer can be used */
+    if (pooled) {
+        ssl->buffers.inputBuffer.pool = ssl->ctx;
+        ssl->buffers.inputBuffer.bufferSize = IO_POOL_BUF_SZ -
+                                              ssl->buffers.inputBuffer.offset;
+    }
+#endif
 
     return 0;
 }
@@ -8844,6 +10117,11 @@ static int BuildFinished(WOLFSSL* ssl, Hashes* hashes, const byte* sender)
     if (ssl == NULL)
         return BAD_FUNC_ARG;
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
 #ifndef NO_TLS
     if (ssl->options.tls) {
         ret = BuildTlsFinished(ssl, hashes, sender);
@@ -9696,7 +10974,7 @@ int CheckIPAddr(DecodedCert* dCert, const char* ipasc)
 static void AddSessionCertToChain(WOLFSSL_X509_CHAIN* chain,
     byte* certBuf, word32 certSz)
 {
-   if (chain->count < MAX_CHAIN_DEPTH &&
+   if (chain->count < MAX_SESSION_CHAIN_DEPTH &&
                                certSz < MAX_X509_SIZE) {
         chain->certs[chain->count].length = certSz;
         XMEMCPY(chain->certs[chain->count].buffer, certBuf, certSz);
@@ -12296,7 +13574,9 @@ static int DoCertificate(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     #endif
 #endif /* SESSION_CERTS */
 
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_CERT_VERIFY);
     ret = ProcessPeerCerts(ssl, input, inOutIdx, size);
+    HS_TIMING_END(ssl, WOLFSSL_HST_CERT_VERIFY, 0, ret);
 #ifdef WOLFSSL_EXTRA_ALERTS
     if (ret == BUFFER_ERROR || ret == ASN_PARSE_E)
         SendAlert(ssl, alert_fatal, decode_error);
@@ -13131,6 +14411,8 @@ static int DoHandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     }
 #endif
 
+    WC_TRACE(WC_TRACE_HS_RECV, ssl, NULL, type);
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_MSG_RECV);
     switch (type) {
 
     case hello_request:
@@ -13362,6 +14644,7 @@ static int DoHandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     }
 #endif /* WOLFSSL_ASYNC_CRYPT || WOLFSSL_NONBLOCK_OCSP */
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_MSG_RECV, type, ret);
     WOLFSSL_LEAVE("DoHandShakeMsgType()", ret);
     return ret;
 }
@@ -15357,6 +16640,8 @@ static int DoAlert(WOLFSSL* ssl, byte* input, word32* inOutIdx, int* type,
     ssl->alert_history.last_rx.code = code;
     ssl->alert_history.last_rx.level = level;
     *type = code;
+    CTX_STATS_ADD(ssl, alertsReceived[CTX_STATS_ALERT(code)], 1);
+    WC_TRACE(WC_TRACE_ALERT_RECV, ssl, NULL, (level << 8) | code);
     if (level == alert_fatal) {
         ssl->options.isClosed = 1;  /* Don't send close_notify */
     }
@@ -15409,6 +16694,12 @@ static int GetInputData(WOLFSSL *ssl, word32 size)
     maxLength  = ssl->buffers.inputBuffer.bufferSize - usedLength;
     inSz       = (int)(size - usedLength);      /* from last partial read */
 
+#ifdef WOLFSSL_READ_AHEAD
+    /* already there from an earlier read ahead */
+    if (usedLength >= (int)size && !ssl->options.dtls)
+        return 0;
+#endif
+
 #ifdef WOLFSSL_DTLS
     if (ssl->options.dtls) {
         if (size < ssl->dtls_expected_rx)
@@ -15422,6 +16713,20 @@ static int GetInputData(WOLFSSL *ssl, word32 size)
         return BUFFER_ERROR;
     }
 
+#ifdef WOLFSSL_READ_AHEAD
+    /* take whatever the transport has, so a burst of small records costs one
+     * read, only once the handshake is done as handshake records may not
+     * be processed ahead of our own flight */
+    if (ssl->readAheadSz > size && !ssl->options.dtls &&
+                        ssl->options.handShakeState == HANDSHAKE_DONE) {
+        if (ssl->buffers.inputBuffer.bufferSize < ssl->readAheadSz &&
+                GrowInputBuffer(ssl, ssl->readAheadSz - usedLength,
+                                usedLength) < 0)
+            return MEMORY_E;
+        inSz = maxLength = ssl->buffers.inputBuffer.bufferSize - usedLength;
+    }
+#endif
+
     if (inSz > maxLength) {
         if (GrowInputBuffer(ssl, size + dtlsExtra, usedLength) < 0)
             return MEMORY_E;
@@ -15439,12 +16744,21 @@ static int GetInputData(WOLFSSL *ssl, word32 size)
 
     /* read data from network */
     do {
+        HS_TIMING_BEGIN(ssl, WOLFSSL_HST_IO_READ);
         in = wolfSSLReceive(ssl,
                      ssl->buffers.inputBuffer.buffer +
                      ssl->buffers.inputBuffer.length,
                      inSz);
-        if (in == WANT_READ)
+        HS_TIMING_END(ssl, WOLFSSL_HST_IO_READ, 0, in);
+        if (in == WANT_READ) {
+        #ifdef WOLFSSL_READ_AHEAD
+            /* connection gone idle, give back the read ahead buffer */
+            if (ssl->readAheadSz > 0 && ssl->buffers.inputBuffer.length == 0 &&
+                                         ssl->buffers.inputBuffer.dynamicFlag)
+                ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+        #endif
             return WANT_READ;
+        }
 
         if (in < 0)
             return SOCKET_ERROR_E;
@@ -15454,6 +16768,7 @@ static int GetInputData(WOLFSSL *ssl, word32 size)
 
         ssl->buffers.inputBuffer.length += in;
         inSz -= in;
+        CTX_STATS_ADD(ssl, bytesIn, in);
 
     } while (ssl->buffers.inputBuffer.length < size);
 
@@ -15577,13 +16892,501 @@ static WC_INLINE int VerifyMac(WOLFSSL* ssl, const byte* input, word32 msgSz,
 }
 
 
+#ifdef WOLFSSL_KTLS
+/* Wipe and free the cipher objects of a direction the kernel protects now,
+ * only AES-GCM and ChaCha20-Poly1305 get offloaded */
+static void KtlsFreeCipher(WOLFSSL* ssl, Ciphers* cipher)
+{
+#if defined(BUILD_AES) || defined(BUILD_AESGCM)
+    if (cipher->aes != NULL) {
+        wc_AesFree(cipher->aes);
+        ForceZero(cipher->aes, sizeof(Aes));
+        XFREE(cipher->aes, ssl->heap, DYNAMIC_TYPE_CIPHER);
+        cipher->aes = NULL;
+    }
+    #if (defined(BUILD_AESGCM) || defined(HAVE_AESCCM)) && \
+                                                      !defined(WOLFSSL_NO_TLS12)
+    XFREE(cipher->additional, ssl->heap, DYNAMIC_TYPE_AES_BUFFER);
+    cipher->additional = NULL;
+    #endif
+#endif
+#ifdef CIPHER_NONCE
+    if (cipher->nonce != NULL) {
+        ForceZero(cipher->nonce, AEAD_NONCE_SZ);
+        XFREE(cipher->nonce, ssl->heap, DYNAMIC_TYPE_AES_BUFFER);
+        cipher->nonce = NULL;
+    }
+#endif
+#ifdef HAVE_CHACHA
+    if (cipher->chacha != NULL) {
+        ForceZero(cipher->chacha, sizeof(ChaCha));
+        XFREE(cipher->chacha, ssl->heap, DYNAMIC_TYPE_CIPHER);
+        cipher->chacha = NULL;
+    }
+#endif
+    cipher->setup = 0;
+    (void)ssl;
+}
+
+/* Hand the record protection of one direction over to the kernel, from then
+ * on data is sent and received in plain text on the socket. Only AES-GCM and
+ * ChaCha20-Poly1305 with TLS 1.2 or TLS 1.3 over the default socket callbacks
+ * can be offloaded.
+ * returns 0 on success, BAD_STATE_E when data is still buffered */
+int KtlsSetup(WOLFSSL* ssl, int dir)
+{
+    union {
+        struct tls_crypto_info info;
+        struct tls12_crypto_info_aes_gcm_128 gcm128;
+        struct tls12_crypto_info_aes_gcm_256 gcm256;
+    #ifdef TLS_CIPHER_CHACHA20_POLY1305
+        struct tls12_crypto_info_chacha20_poly1305 chacha;
+    #endif
+    } info;
+    byte*       infoKey = NULL;
+    byte*       infoIv = NULL;
+    byte*       infoSalt = NULL;
+    byte*       infoSeq = NULL;
+    int         infoSz = 0;
+    int         tx = (dir == WOLFSSL_KTLS_TX);
+    byte*       key;
+    byte*       iv;
+    byte*       macSecret = NULL;
+    int         ret;
+
+    WOLFSSL_ENTER("KtlsSetup");
+
+    if (ssl->options.handShakeState != HANDSHAKE_DONE)
+        return BAD_STATE_E;
+    if (tx) {
+        if (ssl->buffers.outputBuffer.length > 0)
+            return BAD_STATE_E;
+        if (ssl->CBIOSend != EmbedSend) {
+            WOLFSSL_MSG("Kernel TLS needs the default send callback");
+            return KTLS_E;
+        }
+    }
+    else {
+        if (ssl->buffers.clearOutputBuffer.length > 0 ||
+                ssl->buffers.inputBuffer.idx < ssl->buffers.inputBuffer.length ||
+                ssl->options.processReply != doProcessInit)
+            return BAD_STATE_E;
+        if (ssl->CBIORecv != EmbedReceive) {
+            WOLFSSL_MSG("Kernel TLS needs the default receive callback");
+            return KTLS_E;
+        }
+    }
+    if (ssl->options.dtls || !IsAtLeastTLSv1_2(ssl) ||
+                                              ssl->options.usingCompression) {
+        WOLFSSL_MSG("Kernel TLS only does TLS 1.2 and TLS 1.3");
+        return KTLS_E;
+    }
+#ifdef HAVE_WRITE_DUP
+    if (ssl->dupWrite) {
+        WOLFSSL_MSG("Kernel TLS not supported with write duplicates");
+        return KTLS_E;
+    }
+#endif
+
+    XMEMSET(&info, 0, sizeof(info));
+
+    switch (ssl->specs.bulk_cipher_algorithm) {
+#ifdef BUILD_AESGCM
+        case wolfssl_aes_gcm:
+            if (ssl->specs.key_size == AES_128_KEY_SIZE) {
+                info.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+                infoKey  = info.gcm128.key;
+                infoIv   = info.gcm128.iv;
+                infoSalt = info.gcm128.salt;
+                infoSeq  = info.gcm128.rec_seq;
+                infoSz   = (int)sizeof(info.gcm128);
+            }
+            else if (ssl->specs.key_size == AES_256_KEY_SIZE) {
+                info.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+                infoKey  = info.gcm256.key;
+                infoIv   = info.gcm256.iv;
+                infoSalt = info.gcm256.salt;
+                infoSeq  = info.gcm256.rec_seq;
+                infoSz   = (int)sizeof(info.gcm256);
+            }
+            break;
+#endif
+#if defined(HAVE_CHACHA) && defined(HAVE_POLY1305) && \
+                                          defined(TLS_CIPHER_CHACHA20_POLY1305)
+        case wolfssl_chacha:
+            if (ssl->options.oldPoly)
+                break;
+            info.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+            infoKey = info.chacha.key;
+            infoIv  = info.chacha.iv;
+            infoSeq = info.chacha.rec_seq;
+            infoSz  = (int)sizeof(info.chacha);
+            break;
+#endif
+        default:
+            break;
+    }
+    if (infoSz == 0) {
+        WOLFSSL_MSG("Cipher suite can not be offloaded to kernel TLS");
+        return KTLS_E;
+    }
+
+    if ((ssl->options.side == WOLFSSL_CLIENT_END) == tx) {
+        key = ssl->keys.client_write_key;
+        iv  = ssl->keys.client_write_IV;
+    #if !defined(WOLFSSL_AEAD_ONLY) || defined(WOLFSSL_TLS13)
+        macSecret = ssl->keys.client_write_MAC_secret;
+    #endif
+    }
+    else {
+        key = ssl->keys.server_write_key;
+        iv  = ssl->keys.server_write_IV;
+    #if !defined(WOLFSSL_AEAD_ONLY) || defined(WOLFSSL_TLS13)
+        macSecret = ssl->keys.server_write_MAC_secret;
+    #endif
+    }
+
+    XMEMCPY(infoKey, key, ssl->specs.key_size);
+    if (infoSalt == NULL) {
+        /* ChaCha20-Poly1305 nonce is the whole IV XOR sequence number */
+        XMEMCPY(infoIv, iv, CHACHA20_IMP_IV_SZ);
+    }
+    else {
+        XMEMCPY(infoSalt, iv, AESGCM_IMP_IV_SZ);
+        if (IsAtLeastTLSv1_3(ssl->version)) {
+            XMEMCPY(infoIv, iv + AESGCM_IMP_IV_SZ, AESGCM_EXP_IV_SZ);
+        }
+    #if defined(BUILD_AESGCM) && !defined(WOLFSSL_NO_TLS12)
+        else if (tx) {
+            /* keep counting explicit nonces from where we left off */
+        #if !defined(NO_PUBLIC_GCM_SET_IV) && \
+            ((defined(HAVE_FIPS) || defined(HAVE_SELFTEST)) && \
+            (!defined(HAVE_FIPS_VERSION) || (HAVE_FIPS_VERSION < 2)))
+            XMEMCPY(infoIv, ssl->keys.aead_exp_IV, AESGCM_EXP_IV_SZ);
+        #else
+            XMEMCPY(infoIv, (byte*)ssl->encrypt.aes->reg + AESGCM_IMP_IV_SZ,
+                                                             AESGCM_EXP_IV_SZ);
+        #endif
+        }
+    #endif
+    }
+
+#ifdef WOLFSSL_TLS13
+    if (IsAtLeastTLSv1_3(ssl->version))
+        info.info.version = TLS_1_3_VERSION;
+    else
+#endif
+        info.info.version = TLS_1_2_VERSION;
+
+    if (tx) {
+        c32toa(ssl->keys.sequence_number_hi, infoSeq);
+        c32toa(ssl->keys.sequence_number_lo, infoSeq + OPAQUE32_LEN);
+    }
+    else {
+        c32toa(ssl->keys.peer_sequence_number_hi, infoSeq);
+        c32toa(ssl->keys.peer_sequence_number_lo, infoSeq + OPAQUE32_LEN);
+    }
+
+    ret = wolfIO_SetKtls(*(int*)(tx ? ssl->IOCB_WriteCtx : ssl->IOCB_ReadCtx),
+                         tx, &info, infoSz);
+    ForceZero(&info, sizeof(info));
+    if (ret != 0)
+        return KTLS_E;
+
+    /* the kernel has its own copy, nothing here may use these anymore */
+    ForceZero(key, MAX_SYM_KEY_SIZE);
+    ForceZero(iv, MAX_WRITE_IV_SZ);
+    if (macSecret != NULL)
+        ForceZero(macSecret, WC_MAX_DIGEST_SIZE);
+
+    if (tx) {
+    #if defined(HAVE_AEAD) || defined(WOLFSSL_SESSION_EXPORT)
+        ForceZero(ssl->keys.aead_exp_IV, AEAD_MAX_EXP_SZ);
+        ForceZero(ssl->keys.aead_enc_imp_IV, AEAD_MAX_IMP_SZ);
+    #endif
+        KtlsFreeCipher(ssl, &ssl->encrypt);
+        ssl->options.ktlsTx = 1;
+        ssl->buffers.plainSz = 0;
+        ssl->buffers.prevSent = 0;
+    }
+    else {
+    #if defined(HAVE_AEAD) || defined(WOLFSSL_SESSION_EXPORT)
+        ForceZero(ssl->keys.aead_dec_imp_IV, AEAD_MAX_IMP_SZ);
+    #endif
+        KtlsFreeCipher(ssl, &ssl->decrypt);
+        ssl->options.ktlsRx = 1;
+    }
+
+    WOLFSSL_LEAVE("KtlsSetup", 0);
+    return 0;
+}
+
+/* Install a direction asked for with wolfSSL_CTX_UseKTLS() or before the
+ * handshake with wolfSSL_UseKTLS() as soon as nothing is buffered for it. When
+ * the kernel can't take it the connection stays in user space. */
+static void KtlsAutoSetup(WOLFSSL* ssl, int dir)
+{
+    if ((ssl->options.ktls & dir) == 0 ||
+                            ssl->options.handShakeState != HANDSHAKE_DONE)
+        return;
+
+    if (KtlsSetup(ssl, dir) == BAD_STATE_E)
+        return; /* try again once buffered data is handled */
+
+    ssl->options.ktls &= ~dir;
+}
+
+/* Read from a socket the kernel decrypts for, type gets the content type of
+ * the record the data belongs to */
+static int KtlsReceive(WOLFSSL* ssl, byte* type, byte* buf, int sz, int peek)
+{
+    int recvd;
+
+    do {
+        recvd = EmbedReceiveRecord(ssl, type, (char*)buf, sz, peek,
+                                   ssl->IOCB_ReadCtx);
+    } while (recvd == WOLFSSL_CBIO_ERR_ISR);
+
+    switch (recvd) {
+        case WOLFSSL_CBIO_ERR_WANT_READ:
+            return WANT_READ;
+
+        case WOLFSSL_CBIO_ERR_CONN_RST:
+            ssl->options.connReset = 1;
+            return SOCKET_ERROR_E;
+
+        case WOLFSSL_CBIO_ERR_CONN_CLOSE:
+            ssl->options.isClosed = 1;
+            return SOCKET_ERROR_E;
+
+        default:
+            if (recvd < 0)
+                return SOCKET_ERROR_E;
+    }
+
+    return recvd;
+}
+
+/* Make room for sz more bytes in the input buffer, keeping space for record
+ * and handshake headers in front of the data as the message trace callbacks
+ * look back for them */
+static int KtlsReserveInput(WOLFSSL* ssl, word32 sz)
+{
+    const word32 hdrSz = RECORD_HEADER_SZ + HANDSHAKE_HEADER_SZ;
+    word32 used = ssl->buffers.inputBuffer.length -
+                  ssl->buffers.inputBuffer.idx;
+    int    ret;
+
+    if (used == 0 && ssl->buffers.inputBuffer.bufferSize >= hdrSz) {
+        ssl->buffers.inputBuffer.idx    = hdrSz;
+        ssl->buffers.inputBuffer.length = hdrSz;
+    }
+
+    if (ssl->buffers.inputBuffer.idx < hdrSz ||
+            ssl->buffers.inputBuffer.bufferSize -
+            ssl->buffers.inputBuffer.length < sz) {
+        ret = GrowInputBuffer(ssl, (int)(hdrSz + sz), (int)used);
+        if (ret != 0)
+            return ret;
+        XMEMMOVE(ssl->buffers.inputBuffer.buffer + hdrSz,
+                 ssl->buffers.inputBuffer.buffer, used);
+        ssl->buffers.inputBuffer.idx    = hdrSz;
+        ssl->buffers.inputBuffer.length = hdrSz + used;
+    }
+
+    return 0;
+}
+
+/* Keep the content of a non application data record that was read into the
+ * caller's buffer until the messages in it are complete */
+static int KtlsBufferControl(WOLFSSL* ssl, byte type, const byte* data, int sz)
+{
+    int ret;
+
+    if (ssl->buffers.inputBuffer.idx < ssl->buffers.inputBuffer.length &&
+                                                    ssl->curRL.type != type) {
+        WOLFSSL_MSG("Record type changed in the middle of a message");
+        return OUT_OF_ORDER_E;
+    }
+
+    if ((ret = KtlsReserveInput(ssl, (word32)sz)) != 0)
+        return ret;
+
+    XMEMCPY(ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.length,
+            data, sz);
+    ssl->buffers.inputBuffer.length += sz;
+    ssl->curRL.type = type;
+
+    return 0;
+}
+
+/* Process the next complete alert or handshake message collected in the input
+ * buffer. Only a TLS 1.3 NewSessionTicket can be taken after the handshake,
+ * the kernel can't follow a key update or renegotiation.
+ * returns 0 when done or more data is needed */
+static int KtlsDoControl(WOLFSSL* ssl)
+{
+    byte*   input = ssl->buffers.inputBuffer.buffer;
+    word32* idx = &ssl->buffers.inputBuffer.idx;
+    word32  avail = ssl->buffers.inputBuffer.length - *idx;
+    byte    msgType;
+    word32  msgSz;
+    int     ret;
+
+    /* the kernel has taken off the record protection already */
+    ssl->keys.padSz = 0;
+
+    switch (ssl->curRL.type) {
+        case alert:
+        {
+            int type;
+
+            if (avail < ALERT_SIZE)
+                return 0;
+
+            ret = DoAlert(ssl, input, idx, &type, *idx + ALERT_SIZE);
+            if (ret == alert_fatal)
+                return FATAL_ERROR;
+            else if (ret < 0)
+                return ret;
+
+            if (type == close_notify)
+                return ssl->error = ZERO_RETURN;
+            if (type == decrypt_error)
+                return FATAL_ERROR;
+
+            return 0;
+        }
+
+        case handshake:
+            if (avail < HANDSHAKE_HEADER_SZ)
+                return 0;
+
+            msgType = input[*idx];
+            ato24(input + *idx + 1, &msgSz);
+            if (msgSz > MAX_HANDSHAKE_SZ) {
+                WOLFSSL_MSG("Handshake message too large");
+                return HANDSHAKE_SIZE_ERROR;
+            }
+            if (avail < HANDSHAKE_HEADER_SZ + msgSz)
+                return 0;
+
+        #ifdef WOLFSSL_TLS13
+            if (IsAtLeastTLSv1_3(ssl->version)) {
+                if (msgType != session_ticket) {
+                    WOLFSSL_MSG("Post-handshake message needs user space "
+                                "record layer");
+                    SendAlert(ssl, alert_fatal, unexpected_message);
+                    return KTLS_E;
+                }
+
+                *idx += HANDSHAKE_HEADER_SZ;
+                return DoTls13HandShakeMsgType(ssl, input, idx, msgType, msgSz,
+                                               *idx + msgSz);
+            }
+        #endif
+
+            /* HelloRequest or ClientHello, decline to renegotiate */
+            WOLFSSL_MSG("Renegotiation not possible with kernel TLS");
+            *idx += HANDSHAKE_HEADER_SZ + msgSz;
+            return SendAlert(ssl, alert_warning, no_renegotiation);
+
+        default:
+            WOLFSSL_ERROR(UNKNOWN_RECORD_TYPE);
+            return UNKNOWN_RECORD_TYPE;
+    }
+}
+
+/* ProcessReply() for a socket the kernel decrypts for, reads one record or
+ * handles one collected message */
+static int KtlsProcessReply(WOLFSSL* ssl)
+{
+    int  ret;
+    byte type;
+
+    for (;;) {
+        if (ssl->buffers.inputBuffer.idx < ssl->buffers.inputBuffer.length) {
+            word32 startIdx = ssl->buffers.inputBuffer.idx;
+
+            if ((ret = KtlsDoControl(ssl)) != 0)
+                return ret;
+
+            if (ssl->buffers.inputBuffer.idx != startIdx) {
+                if (ssl->buffers.inputBuffer.idx ==
+                                            ssl->buffers.inputBuffer.length &&
+                                        ssl->buffers.inputBuffer.dynamicFlag)
+                    ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+                return 0;
+            }
+        }
+
+        if ((ret = KtlsReserveInput(ssl, MAX_RECORD_SIZE)) != 0)
+            return ret;
+
+        ret = KtlsReceive(ssl, &type, ssl->buffers.inputBuffer.buffer +
+                          ssl->buffers.inputBuffer.length,
+                          (int)(ssl->buffers.inputBuffer.bufferSize -
+                          ssl->buffers.inputBuffer.length), 0);
+        if (ret < 0)
+            return ret;
+
+        if (type == application_data) {
+            if (ssl->buffers.inputBuffer.idx <
+                                            ssl->buffers.inputBuffer.length) {
+                WOLFSSL_MSG("Application data in the middle of a message");
+                return OUT_OF_ORDER_E;
+            }
+            ssl->buffers.clearOutputBuffer.buffer =
+                                            ssl->buffers.inputBuffer.buffer +
+                                            ssl->buffers.inputBuffer.length;
+            ssl->buffers.clearOutputBuffer.length = (unsigned int)ret;
+            ssl->buffers.inputBuffer.length += ret;
+            ssl->buffers.inputBuffer.idx = ssl->buffers.inputBuffer.length;
+            return 0;
+        }
+
+        if (ssl->buffers.inputBuffer.idx < ssl->buffers.inputBuffer.length &&
+                                                    ssl->curRL.type != type) {
+            WOLFSSL_MSG("Record type changed in the middle of a message");
+            return OUT_OF_ORDER_E;
+        }
+        ssl->curRL.type = type;
+        ssl->buffers.inputBuffer.length += ret;
+    }
+}
+
+/* Read application data straight into the caller's buffer.
+ * returns the size read, 0 when the caller should go through ProcessReply()
+ * to handle a record of another type or a socket error */
+static int KtlsReceiveData(WOLFSSL* ssl, byte* output, int sz, int peek)
+{
+    byte type;
+    int  ret;
+
+    ret = KtlsReceive(ssl, &type, output, sz, peek);
+    if (ret < 0)
+        return ret == WANT_READ ? WANT_READ : 0;
+    if (type == application_data)
+        return ret;
+
+    /* take the record off the socket when only peeking */
+    if (peek && (ret = KtlsReceive(ssl, &type, output, ret, 0)) < 0)
+        return ret == WANT_READ ? WANT_READ : 0;
+
+    if ((ret = KtlsBufferControl(ssl, type, output, ret)) != 0)
+        ssl->error = ret;
+
+    return 0;
+}
+#endif /* WOLFSSL_KTLS */
+
 /* process input requests, return 0 is done, 1 is call again to complete, and
    negative number is error */
 int ProcessReply(WOLFSSL* ssl)
 {
     int    ret = 0, type, readSz;
     int    atomicUser = 0;
-    word32 startIdx = 0;
+    word32 recEnd;
 #if defined(WOLFSSL_DTLS)
     int    used;
 #endif
@@ -15608,6 +17411,11 @@ int ProcessReply(WOLFSSL* ssl)
         return ssl->error;
     }
 
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsRx)
+        return KtlsProcessReply(ssl);
+#endif
+
 #if defined(WOLFSSL_DTLS) && defined(WOLFSSL_ASYNC_CRYPT)
     /* process any pending DTLS messages - this flow can happen with async */
     if (ssl->dtls_rx_msg_list != NULL) {
@@ -15745,6 +17553,9 @@ int ProcessReply(WOLFSSL* ssl)
 #endif
             if (ret != 0)
                 return ret;
+            CTX_STATS_ADD(ssl, recordsIn, 1);
+            WC_TRACE(WC_TRACE_RECORD_IN, ssl, NULL,
+                     (ssl->curRL.type << 16) | ssl->curSize);
 
 #ifdef WOLFSSL_TLS13
             if (IsAtLeastTLSv1_3(ssl->version) && IsEncryptionOn(ssl, 0) &&
@@ -15809,7 +17620,9 @@ int ProcessReply(WOLFSSL* ssl)
             ssl->keys.padSz = 0;
 
             ssl->options.processReply = verifyEncryptedMessage;
-            startIdx = ssl->buffers.inputBuffer.idx;  /* in case > 1 msg per */
+            /* kept in the SSL, ProcessReply may return WC_PENDING_E and be
+             * re-entered past this point */
+            ssl->buffers.recordIdx = ssl->buffers.inputBuffer.idx;
             FALL_THROUGH;
 
         /* verify digest of encrypted message */
@@ -16041,11 +17854,14 @@ int ProcessReply(WOLFSSL* ssl)
                 ssl->keys.decryptedCur = 1;
 #ifdef WOLFSSL_TLS13
                 if (ssl->options.tls1_3) {
-                    word16 i = (word16)(ssl->buffers.inputBuffer.length -
-                                        ssl->keys.padSz);
+                    word32 i;
+
+                    /* more records may follow this one in the buffer */
+                    recEnd = ssl->buffers.inputBuffer.idx + ssl->curSize;
+                    i = recEnd - ssl->keys.padSz;
 
                     /* sanity check on underflow */
-                    if (ssl->keys.padSz >= ssl->buffers.inputBuffer.length) {
+                    if (ssl->keys.padSz >= recEnd) {
                         WOLFSSL_ERROR(DECRYPT_ERROR);
                         return DECRYPT_ERROR;
                     }
@@ -16057,7 +17873,7 @@ int ProcessReply(WOLFSSL* ssl)
                     }
                     /* Get the real content type from the end of the data. */
                     ssl->curRL.type = ssl->buffers.inputBuffer.buffer[i];
-                    ssl->keys.padSz = ssl->buffers.inputBuffer.length - i;
+                    ssl->keys.padSz = recEnd - i;
                 }
 #endif
             }
@@ -16068,9 +17884,17 @@ int ProcessReply(WOLFSSL* ssl)
         /* the record layer is here */
         case runProcessingOneMessage:
 
+            recEnd = ssl->buffers.inputBuffer.length;
+        #ifdef WOLFSSL_READ_AHEAD
+            /* more records may be buffered after this one */
+            if (!ssl->options.dtls && ssl->readAheadSz > 0 &&
+                        ssl->buffers.recordIdx + ssl->curSize < recEnd)
+                recEnd = ssl->buffers.recordIdx + ssl->curSize;
+        #endif
+
        #if defined(HAVE_ENCRYPT_THEN_MAC) && !defined(WOLFSSL_AEAD_ONLY)
             if (IsEncryptionOn(ssl, 0) && ssl->options.startedETMRead) {
-                if ((ssl->buffers.inputBuffer.length -
+                if ((recEnd -
                         ssl->keys.padSz -
                         MacSize(ssl) -
                         ssl->buffers.inputBuffer.idx > MAX_PLAINTEXT_SZ)
@@ -16088,7 +17912,7 @@ int ProcessReply(WOLFSSL* ssl)
             }
             else
        #endif
-            if (ssl->buffers.inputBuffer.length -
+            if (recEnd -
                     ssl->keys.padSz -
                     ssl->buffers.inputBuffer.idx > MAX_PLAINTEXT_SZ
 #ifdef WOLFSSL_ASYNC_CRYPT
@@ -16132,7 +17956,7 @@ int ProcessReply(WOLFSSL* ssl)
                         ret = DoHandShakeMsg(ssl,
                                             ssl->buffers.inputBuffer.buffer,
                                             &ssl->buffers.inputBuffer.idx,
-                                            ssl->buffers.inputBuffer.length);
+                                            recEnd);
 #else
                         ret = BUFFER_ERROR;
 #endif
@@ -16143,7 +17967,7 @@ int ProcessReply(WOLFSSL* ssl)
                         ret = DoTls13HandShakeMsg(ssl,
                                             ssl->buffers.inputBuffer.buffer,
                                             &ssl->buffers.inputBuffer.idx,
-                                            ssl->buffers.inputBuffer.length);
+                                            recEnd);
     #ifdef WOLFSSL_EARLY_DATA
                         if (ret != 0)
                             return ret;
@@ -16369,7 +18193,7 @@ int ProcessReply(WOLFSSL* ssl)
                     WOLFSSL_MSG("got ALERT!");
                     ret = DoAlert(ssl, ssl->buffers.inputBuffer.buffer,
                                   &ssl->buffers.inputBuffer.idx, &type,
-                                   ssl->buffers.inputBuffer.length);
+                                   recEnd);
                     if (ret == alert_fatal)
                         return FATAL_ERROR;
                     else if (ret < 0)
@@ -16400,12 +18224,18 @@ int ProcessReply(WOLFSSL* ssl)
                 /* If app data was processed then return now to avoid
                  * dropping any app data. */
                 || (ssl->options.dtls && ssl->curRL.type == application_data)
+#endif
+#ifdef WOLFSSL_READ_AHEAD
+                /* app data has to be read before the next record replaces
+                 * it, ReceiveData() picks up any further records */
+                || ssl->buffers.clearOutputBuffer.length > 0
 #endif
                 )
                 return ret;
 
             /* more messages per record */
-            else if ((ssl->buffers.inputBuffer.idx - startIdx) < ssl->curSize) {
+            else if ((ssl->buffers.inputBuffer.idx - ssl->buffers.recordIdx) <
+                                                              ssl->curSize) {
                 WOLFSSL_MSG("More messages in record");
 
                 ssl->options.processReply = runProcessingOneMessage;
@@ -16787,6 +18617,11 @@ int BuildCertHashes(WOLFSSL* ssl, Hashes* hashes)
 
     (void)hashes;
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     if (ssl->options.tls) {
     #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
         ret = wc_Md5GetHash(&ssl->hsHashes->hashMd5, hashes->md5);
@@ -17031,7 +18866,8 @@ int BuildMessage(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
                 if (args->iv == NULL)
                     ERROR_OUT(MEMORY_E, exit_buildmsg);
 
-                ret = wc_RNG_GenerateBlock(ssl->rng, args->iv, args->ivSz);
+                ret = wc_RNG_GenerateBlock(GetSslRng(ssl), args->iv,
+                                           args->ivSz);
                 if (ret != 0)
                     goto exit_buildmsg;
 
@@ -17055,7 +18891,8 @@ int BuildMessage(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
                                         min(args->ivSz, MAX_IV_SZ));
                 args->idx += args->ivSz;
             }
-            XMEMCPY(output + args->idx, input, inSz);
+            if (input != output + args->idx)
+                XMEMCPY(output + args->idx, input, inSz);
             args->idx += inSz;
 
             ssl->options.buildMsgState = BUILD_MSG_HASH;
@@ -18397,14 +20234,11 @@ int IsSCR(WOLFSSL* ssl)
 }
 
 
-int SendData(WOLFSSL* ssl, const void* data, int sz)
+/* Make sure the connection is in a state application data can be sent,
+ * negotiating if needed.
+ * returns 0 when ready, otherwise the value SendData should return */
+static int SendDataReady(WOLFSSL* ssl, int* groupMsgs)
 {
-    int sent = 0,  /* plainText size */
-        sendSz,
-        ret,
-        dtlsExtra = 0;
-    int groupMsgs = 0;
-
     if (ssl->error == WANT_WRITE
     #ifdef WOLFSSL_ASYNC_CRYPT
         || ssl->error == WC_PENDING_E
@@ -18434,7 +20268,7 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
             return WOLFSSL_FATAL_ERROR;
         }
     #ifdef WOLFSSL_EARLY_DATA_GROUP
-        groupMsgs = 1;
+        *groupMsgs = 1;
     #endif
     }
     else
@@ -18453,6 +20287,179 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
         }
     }
 
+    (void)groupMsgs;
+
+    return 0;
+}
+
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+/* Size of the next application data record under the adaptive policy. A burst
+ * starts out with small records, that fit in one TCP segment, so the first
+ * bytes are not held back waiting on a full record. Long enough bursts move
+ * to full size records and going idle starts over with small ones. */
+static int DynRecordSize(WOLFSSL* ssl, int len)
+{
+    DynRecord* dr = &ssl->dynRecord;
+    word32     now;
+
+    if (dr->cfg.smallSz == 0 || ssl->options.dtls)
+        return len;
+
+    now = LowResTimer();
+    if (dr->burstBytes > 0 && dr->cfg.idleSec > 0 &&
+                                     now - dr->lastSend >= dr->cfg.idleSec) {
+        WOLFSSL_MSG("Idle, back to small records");
+        dr->burstBytes = 0;
+        if (dr->fullSize) {
+            dr->fullSize = 0;
+            dr->stats.idleResets++;
+        }
+    }
+    if (dr->burstBytes == 0)
+        dr->burstStart = now;
+    dr->lastSend = now;
+
+    if (!dr->fullSize) {
+        if ((dr->cfg.rampBytes > 0 && dr->burstBytes >= dr->cfg.rampBytes) ||
+            (dr->cfg.rampSec > 0 && now - dr->burstStart >= dr->cfg.rampSec)) {
+            WOLFSSL_MSG("Burst ramped up to full size records");
+            dr->fullSize = 1;
+            dr->stats.rampUps++;
+        }
+        else if (len > dr->cfg.smallSz) {
+            len = dr->cfg.smallSz;
+            dr->stats.smallRecords++;
+        }
+    }
+
+    return len;
+}
+
+/* Account for len bytes of application data put in records */
+static void DynRecordSent(WOLFSSL* ssl, int len)
+{
+    DynRecord* dr = &ssl->dynRecord;
+
+    if (!dr->fullSize)
+        dr->burstBytes += len;
+
+    /* kernel TLS splits a large send into full size records */
+    while (len > 0) {
+        int recSz = min(len, MAX_RECORD_SIZE);
+        int i = 0;
+
+        while (i < WOLFSSL_RECORD_SIZE_BUCKETS - 1 && recSz >= (512 << i))
+            i++;
+        dr->stats.records[i]++;
+        len -= recSz;
+    }
+}
+#endif /* WOLFSSL_DYN_RECORD_SIZE */
+
+#ifdef WOLFSSL_KTLS
+/* Send application data on a socket the kernel encrypts for, the plain text
+ * goes out straight from the caller's buffer */
+static int KtlsSendData(WOLFSSL* ssl, const byte* data, int sz)
+{
+    int sent = 0;
+
+    /* plain text left by a zero copy commit that got WANT_WRITE */
+    if (ssl->buffers.outputBuffer.length > 0) {
+        if ( (ssl->error = SendBuffered(ssl)) < 0) {
+            WOLFSSL_ERROR(ssl->error);
+            return ssl->error;
+        }
+    #ifdef WOLFSSL_ZERO_COPY
+        ssl->buffers.zcWriteSent = 0;
+    #endif
+    }
+
+    /* last time the socket took only part of it */
+    if (ssl->buffers.prevSent > 0) {
+        sent = ssl->buffers.prevSent;
+        ssl->buffers.prevSent = 0;
+        if (sent > sz) {
+            WOLFSSL_MSG("error: write() after WANT_WRITE with short size");
+            return ssl->error = BAD_FUNC_ARG;
+        }
+    }
+
+    while (sent < sz) {
+        int len = sz - sent;
+        int ret;
+
+        /* only one record per attempt */
+        if (ssl->options.partialWrite == 1)
+            len = wolfSSL_GetMaxRecordSize(ssl, len);
+    #ifdef WOLFSSL_DYN_RECORD_SIZE
+        len = DynRecordSize(ssl, len);
+    #endif
+
+        ret = ssl->CBIOSend(ssl, (char*)data + sent, len, ssl->IOCB_WriteCtx);
+        if (ret < 0) {
+            switch (ret) {
+                case WOLFSSL_CBIO_ERR_ISR:
+                    continue;
+
+                case WOLFSSL_CBIO_ERR_WANT_WRITE:
+                    ssl->buffers.prevSent = sent;
+                    ssl->error = WANT_WRITE;
+                    break;
+
+                case WOLFSSL_CBIO_ERR_CONN_RST:
+                case WOLFSSL_CBIO_ERR_CONN_CLOSE:
+                    ssl->options.connReset = 1;
+                    ssl->error = SOCKET_PEER_CLOSED_E;
+                    WOLFSSL_ERROR(ssl->error);
+                    return 0;  /* peer reset or closed */
+
+                default:
+                    ssl->error = SOCKET_ERROR_E;
+                    break;
+            }
+            WOLFSSL_ERROR(ssl->error);
+            return ssl->error;
+        }
+
+        sent += ret;
+        CTX_STATS_ADD(ssl, bytesOut, ret);
+    #ifdef WOLFSSL_DYN_RECORD_SIZE
+        DynRecordSent(ssl, ret);
+    #endif
+
+        if (ssl->options.partialWrite == 1) {
+            WOLFSSL_MSG("Partial Write on, only sending one record");
+            break;
+        }
+    }
+
+    return sent;
+}
+#endif /* WOLFSSL_KTLS */
+
+int SendData(WOLFSSL* ssl, const void* data, int sz)
+{
+    int sent = 0,  /* plainText size */
+        sendSz,
+        ret,
+        dtlsExtra = 0;
+    int groupMsgs = 0;
+
+    if ((ret = SendDataReady(ssl, &groupMsgs)) != 0)
+        return ret;
+
+#ifdef WOLFSSL_ZERO_COPY
+    /* records built here take the place of any zero copy reservation */
+    ssl->buffers.zcWrite = NULL;
+    ssl->buffers.zcWriteSz = 0;
+#endif
+
+#ifdef WOLFSSL_KTLS
+    KtlsAutoSetup(ssl, WOLFSSL_KTLS_TX);
+    if (ssl->options.ktlsTx)
+        return KtlsSendData(ssl, (const byte*)data, sz);
+#endif
+
     /* last time system socket output buffer was full, try again to send */
     if (!groupMsgs && ssl->buffers.outputBuffer.length > 0) {
         WOLFSSL_MSG("output buffer was full, trying to send again");
@@ -18470,6 +20477,9 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
             /* advance sent to previous sent + plain size just sent */
             sent = ssl->buffers.prevSent + ssl->buffers.plainSz;
             WOLFSSL_MSG("sent write buffered data");
+        #ifdef WOLFSSL_ZERO_COPY
+            ssl->buffers.zcWriteSent = 0;
+        #endif
 
             if (sent > sz) {
                 WOLFSSL_MSG("error: write() after WANT_WRITE with short size");
@@ -18497,6 +20507,9 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
         if (sent == sz) break;
 
         len = wolfSSL_GetMaxRecordSize(ssl, sz - sent);
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+        len = DynRecordSize(ssl, len);
+#endif
 
 #if defined(WOLFSSL_DTLS) && !defined(WOLFSSL_NO_DTLS_SIZE_CHECK)
         if (ssl->options.dtls && (len < sz - sent)) {
@@ -18545,42 +20558,399 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
             return BUILD_MSG_ERROR;
         }
 
-        ssl->buffers.outputBuffer.length += sendSz;
+        ssl->buffers.outputBuffer.length += sendSz;
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+        DynRecordSent(ssl, len);
+#endif
+
+        if ( (ssl->error = SendBuffered(ssl)) < 0) {
+            WOLFSSL_ERROR(ssl->error);
+            /* store for next call if WANT_WRITE or user embedSend() that
+               doesn't present like WANT_WRITE */
+            ssl->buffers.plainSz  = len;
+            ssl->buffers.prevSent = sent;
+            if (ssl->error == SOCKET_ERROR_E && (ssl->options.connReset ||
+                                                 ssl->options.isClosed)) {
+                ssl->error = SOCKET_PEER_CLOSED_E;
+                WOLFSSL_ERROR(ssl->error);
+                return 0;  /* peer reset or closed */
+            }
+            return ssl->error;
+        }
+
+        sent += len;
+
+        /* only one message per attempt */
+        if (ssl->options.partialWrite == 1) {
+            WOLFSSL_MSG("Partial Write on, only sending one record");
+            break;
+        }
+    }
+
+    return sent;
+}
+
+#ifdef WOLFSSL_ZERO_COPY
+/* Offset of the plaintext in an application data record built with the
+ * current write cipher, BuildMessage() leaves input in place when it is
+ * already at this offset */
+static int RecordPlainTextOffset(WOLFSSL* ssl)
+{
+    int offset = RECORD_HEADER_SZ;
+
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls)
+        offset += DTLS_RECORD_EXTRA;
+#endif
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx)
+        return 0; /* plain text goes out as is, the kernel adds the rest */
+#endif
+    if (ssl->options.tls1_3)
+        return offset;
+
+#ifndef WOLFSSL_AEAD_ONLY
+    if (ssl->specs.cipher_type == block && ssl->options.tls1_1)
+        offset += ssl->specs.block_size;
+#endif
+#ifdef HAVE_AEAD
+    if (ssl->specs.cipher_type == aead &&
+                            ssl->specs.bulk_cipher_algorithm != wolfssl_chacha)
+        offset += AESGCM_EXP_IV_SZ;
+#endif
+
+    return offset;
+}
+
+/* Reserve room for the next application data record in the output buffer and
+ * hand out the plaintext area so the caller can fill it directly.
+ * returns size of the plaintext area on success */
+int SendDataReserve(WOLFSSL* ssl, byte** data)
+{
+    int ret;
+    int len;
+    int outputSz;
+    int dtlsExtra = 0;
+    int groupMsgs = 0;
+
+    if ((ret = SendDataReady(ssl, &groupMsgs)) != 0)
+        return ret;
+
+#ifdef HAVE_LIBZ
+    if (ssl->options.usingCompression) {
+        WOLFSSL_MSG("Zero copy write not supported with compression");
+        return BAD_STATE_E;
+    }
+#endif
+
+#ifdef WOLFSSL_KTLS
+    KtlsAutoSetup(ssl, WOLFSSL_KTLS_TX);
+#endif
+
+    /* flush anything already sealed, including a committed record that got
+     * WANT_WRITE */
+    if (!groupMsgs && ssl->buffers.outputBuffer.length > 0) {
+        if ( (ssl->error = SendBuffered(ssl)) < 0) {
+            WOLFSSL_ERROR(ssl->error);
+            if (ssl->error == SOCKET_ERROR_E && (ssl->options.connReset ||
+                                                 ssl->options.isClosed)) {
+                ssl->error = SOCKET_PEER_CLOSED_E;
+                WOLFSSL_ERROR(ssl->error);
+                return 0;  /* peer reset or closed */
+            }
+            return ssl->error;
+        }
+        ssl->buffers.zcWriteSent = 0;
+    }
+
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls) {
+        dtlsExtra = DTLS_RECORD_EXTRA;
+    }
+#endif
+
+    len = wolfSSL_GetMaxRecordSize(ssl, MAX_RECORD_SIZE);
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+    len = DynRecordSize(ssl, len);
+#endif
+    outputSz = len + COMP_EXTRA + dtlsExtra + MAX_MSG_EXTRA;
+    if ((ret = CheckAvailableSize(ssl, outputSz)) != 0)
+        return ssl->error = ret;
+
+    ssl->buffers.zcWrite = ssl->buffers.outputBuffer.buffer +
+                           ssl->buffers.outputBuffer.length +
+                           RecordPlainTextOffset(ssl);
+    ssl->buffers.zcWriteSz = len;
+    *data = ssl->buffers.zcWrite;
+
+    return len;
+}
+
+/* Seal the first sz bytes of the area handed out by SendDataReserve() into a
+ * record in place and send it. After WANT_WRITE call again to finish.
+ * asyncOkay If non-zero can return WC_PENDING_E with the reservation kept,
+ *           call again with the same sz, otherwise blocks on crypto
+ * returns sz on success */
+int SendDataCommit(WOLFSSL* ssl, int sz, int asyncOkay)
+{
+    byte* out;
+    int   sendSz;
+    int   outputSz;
+    int   dtlsExtra = 0;
+
+    if (ssl->error == WANT_WRITE
+    #ifdef WOLFSSL_ASYNC_CRYPT
+        || ssl->error == WC_PENDING_E
+    #endif
+    ) {
+        ssl->error = 0;
+    }
+
+    if (ssl->buffers.zcWriteSz == 0) {
+        /* finish sending a record sealed by an earlier commit */
+        if (ssl->buffers.zcWriteSent == 0) {
+            WOLFSSL_MSG("No zero copy write reserved");
+            return BAD_STATE_E;
+        }
+        if ( (ssl->error = SendBuffered(ssl)) < 0) {
+            WOLFSSL_ERROR(ssl->error);
+            return ssl->error;
+        }
+        sz = ssl->buffers.zcWriteSent;
+        ssl->buffers.zcWriteSent = 0;
+        return sz;
+    }
+
+    if (sz < 0 || sz > ssl->buffers.zcWriteSz)
+        return BAD_FUNC_ARG;
+
+    out = ssl->buffers.outputBuffer.buffer + ssl->buffers.outputBuffer.length;
+    if (out + RecordPlainTextOffset(ssl) != ssl->buffers.zcWrite) {
+        WOLFSSL_MSG("Output buffer changed since zero copy reserve");
+        ssl->buffers.zcWrite = NULL;
+        ssl->buffers.zcWriteSz = 0;
+        return BAD_STATE_E;
+    }
+
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls) {
+        dtlsExtra = DTLS_RECORD_EXTRA;
+    }
+#endif
+    outputSz = ssl->buffers.zcWriteSz + COMP_EXTRA + dtlsExtra + MAX_MSG_EXTRA;
+
+    if (sz == 0) {
+        ssl->buffers.zcWrite = NULL;
+        ssl->buffers.zcWriteSz = 0;
+        return 0;
+    }
+
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx) {
+        sendSz = sz;  /* the kernel builds the record */
+    }
+    else
+#endif
+    if (!ssl->options.tls1_3) {
+        sendSz = BuildMessage(ssl, out, outputSz,
+                              out + RecordPlainTextOffset(ssl), sz,
+                              application_data, 0, 0, asyncOkay, CUR_ORDER);
+    }
+    else {
+#ifdef WOLFSSL_TLS13
+        sendSz = BuildTls13Message(ssl, out, outputSz,
+                                   out + RecordPlainTextOffset(ssl), sz,
+                                   application_data, 0, 0, asyncOkay);
+#else
+        sendSz = BUFFER_ERROR;
+#endif
+    }
+    if (sendSz < 0) {
+        ssl->error = sendSz;
+        WOLFSSL_ERROR(ssl->error);
+    #ifdef WOLFSSL_ASYNC_CRYPT
+        /* keep the reservation, commit again to finish sealing it */
+        if (sendSz == WC_PENDING_E)
+            return sendSz;
+    #endif
+    }
+
+    ssl->buffers.zcWrite = NULL;
+    ssl->buffers.zcWriteSz = 0;
+    if (sendSz < 0)
+        return BUILD_MSG_ERROR;
+
+    ssl->buffers.outputBuffer.length += sendSz;
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+    DynRecordSent(ssl, sz);
+#endif
+
+    if ( (ssl->error = SendBuffered(ssl)) < 0) {
+        WOLFSSL_ERROR(ssl->error);
+        /* record is sealed, only the flush is left to do */
+        ssl->buffers.zcWriteSent = sz;
+        ssl->buffers.plainSz  = 0;
+        ssl->buffers.prevSent = 0;
+        if (ssl->error == SOCKET_ERROR_E && (ssl->options.connReset ||
+                                             ssl->options.isClosed)) {
+            ssl->error = SOCKET_PEER_CLOSED_E;
+            WOLFSSL_ERROR(ssl->error);
+            return 0;  /* peer reset or closed */
+        }
+        return ssl->error;
+    }
+
+    return sz;
+}
+
+#ifdef WOLFSSL_SENDFILE
+#ifdef WOLFSSL_KTLS
+/* The kernel encrypts for the socket, let it move the file from the page
+ * cache without the data passing through user space */
+static int KtlsSendFile(WOLFSSL* ssl, int fd, long offset, int sz)
+{
+    int     sent = 0;
+    off_t   off;
+    ssize_t ret;
+
+    while (sent < sz) {
+        off = (off_t)(offset + sent);
+        ret = sendfile(ssl->wfd, fd, &off, (size_t)(sz - sent));
+        if (ret > 0) {
+            sent += (int)ret;
+            continue;
+        }
+        if (ret == 0) {
+            WOLFSSL_MSG("sendfile hit end of file");
+            if (sent == 0) {
+                ssl->error = FREAD_ERROR;
+                WOLFSSL_ERROR(ssl->error);
+                return ssl->error;
+            }
+            break;
+        }
+        if (errno == SOCKET_EINTR)
+            continue;
+        if (sent > 0)
+            break;  /* report what went out, the error comes up again */
+
+        if (errno == SOCKET_EWOULDBLOCK || errno == SOCKET_EAGAIN) {
+            ssl->error = WANT_WRITE;
+        }
+        else if (errno == SOCKET_EPIPE || errno == SOCKET_ECONNRESET) {
+            ssl->options.connReset = 1;
+            ssl->error = SOCKET_PEER_CLOSED_E;
+            WOLFSSL_ERROR(ssl->error);
+            return 0;  /* peer reset or closed */
+        }
+        else {
+            ssl->error = SOCKET_ERROR_E;
+        }
+        WOLFSSL_ERROR(ssl->error);
+        return ssl->error;
+    }
+
+    return sent;
+}
+#endif /* WOLFSSL_KTLS */
+
+/* Send sz bytes of the file fd from offset as application data. Each record
+ * is read with pread() straight into its plaintext slot in the output buffer
+ * and sealed in place, the file position is left alone.
+ * On WANT_WRITE the bytes sent so far are returned, a record that is sealed
+ * but not yet out is not counted and goes first on the next call, which is
+ * made with offset advanced by what was returned.
+ * returns the number of bytes sent on success */
+int SendFileData(WOLFSSL* ssl, int fd, long offset, int sz)
+{
+    int     sent = 0;
+    int     ret;
+    int     want;
+#ifdef WOLFSSL_KTLS
+    int     groupMsgs = 0;
+#endif
+    ssize_t got;
+    byte*   data = NULL;
+
+    WOLFSSL_ENTER("SendFileData");
+
+    if (ssl->buffers.zcWriteSent > 0 && ssl->buffers.zcWriteSz == 0 &&
+                                    ssl->buffers.outputBuffer.length > 0) {
+        /* finish the record sealed by the call that got WANT_WRITE */
+        if (ssl->buffers.zcWriteSent > sz) {
+            WOLFSSL_MSG("sendfile resumed with fewer bytes than pending");
+            return BAD_FUNC_ARG;
+        }
+        ret = SendDataCommit(ssl, 0, 0);
+        if (ret <= 0)
+            return ret;
+        sent = ret;
+    }
 
-        if ( (ssl->error = SendBuffered(ssl)) < 0) {
+#ifdef WOLFSSL_KTLS
+    if (sent < sz) {
+        if ((ret = SendDataReady(ssl, &groupMsgs)) != 0)
+            return sent > 0 ? sent : ret;
+        KtlsAutoSetup(ssl, WOLFSSL_KTLS_TX);
+    }
+    if (sent < sz && ssl->options.ktlsTx) {
+        if (ssl->buffers.outputBuffer.length > 0 &&
+                                    (ret = SendBuffered(ssl)) < 0) {
+            ssl->error = ret;
             WOLFSSL_ERROR(ssl->error);
-            /* store for next call if WANT_WRITE or user embedSend() that
-               doesn't present like WANT_WRITE */
-            ssl->buffers.plainSz  = len;
-            ssl->buffers.prevSent = sent;
-            if (ssl->error == SOCKET_ERROR_E && (ssl->options.connReset ||
-                                                 ssl->options.isClosed)) {
-                ssl->error = SOCKET_PEER_CLOSED_E;
-                WOLFSSL_ERROR(ssl->error);
-                return 0;  /* peer reset or closed */
-            }
-            return ssl->error;
+            return sent > 0 ? sent : ret;
         }
+        ret = KtlsSendFile(ssl, fd, offset + sent, sz - sent);
+        if (ret < 0 || (ret == 0 && ssl->error == SOCKET_PEER_CLOSED_E))
+            return sent > 0 ? sent : ret;
+        sent += ret;
+    }
+#endif
 
-        sent += len;
+    while (sent < sz) {
+        ret = SendDataReserve(ssl, &data);
+        if (ret <= 0)
+            return sent > 0 ? sent : ret;
 
-        /* only one message per attempt */
-        if (ssl->options.partialWrite == 1) {
-            WOLFSSL_MSG("Partial Write on, only sending one record");
-            break;
+        want = min(ret, sz - sent);
+        do {
+            got = pread(fd, data, (size_t)want, (off_t)(offset + sent));
+        } while (got < 0 && errno == EINTR);
+
+        if (got <= 0) {
+            /* drop the reservation, nothing was put in the record */
+            ssl->buffers.zcWrite = NULL;
+            ssl->buffers.zcWriteSz = 0;
+            WOLFSSL_MSG(got == 0 ? "sendfile hit end of file" :
+                                   "sendfile pread failed");
+            if (sent > 0)
+                break;
+            ssl->error = FREAD_ERROR;
+            WOLFSSL_ERROR(ssl->error);
+            return ssl->error;
         }
+
+        /* blocks on async crypto, a retry would read the file over a record
+         * being sealed in place */
+        ret = SendDataCommit(ssl, (int)got, 0);
+        if (ret <= 0)
+            return sent > 0 ? sent : ret;
+        sent += ret;
     }
 
+    WOLFSSL_LEAVE("SendFileData", sent);
+
     return sent;
 }
+#endif /* WOLFSSL_SENDFILE */
+#endif /* WOLFSSL_ZERO_COPY */
 
-/* process input data */
-int ReceiveData(WOLFSSL* ssl, byte* output, int sz, int peek)
+/* Make sure decrypted application data is waiting in clearOutputBuffer,
+ * negotiating and processing records as needed.
+ * returns WOLFSSL_SUCCESS when data is ready, otherwise the value ReceiveData
+ * should hand back to the caller */
+static int WaitForAppData(WOLFSSL* ssl, int peek)
 {
-    int size;
-
-    WOLFSSL_ENTER("ReceiveData()");
-
     /* reset error state */
     if (ssl->error == WANT_READ) {
         ssl->error = 0;
@@ -18603,6 +20973,12 @@ int ReceiveData(WOLFSSL* ssl, byte* output, int sz, int peek)
             && ssl->error != APP_DATA_READY
 #endif
     ) {
+#ifdef WOLFSSL_READ_AHEAD
+        if (ssl->error == ZERO_RETURN) {
+            WOLFSSL_MSG("Zero return, no more data coming");
+            return 0; /* close notify may have come after a batch of records */
+        }
+#endif
         WOLFSSL_MSG("User calling wolfSSL_read in error state, not allowed");
         return ssl->error;
     }
@@ -18704,6 +21080,69 @@ startScr:
     #endif
     }
 
+    return WOLFSSL_SUCCESS;
+}
+
+#ifdef WOLFSSL_READ_AHEAD
+/* Is a whole application data record already in the input buffer, one that
+ * can be decrypted without going to the transport */
+static int HaveBufferedAppData(WOLFSSL* ssl)
+{
+    word32 used;
+    word16 recSz;
+    byte*  hdr;
+
+    if (ssl->options.dtls || ssl->error != 0 ||
+            ssl->options.processReply != doProcessInit ||
+            ssl->options.handShakeState != HANDSHAKE_DONE || IsSCR(ssl))
+        return 0;
+#ifdef WOLFSSL_EARLY_DATA
+    if (ssl->earlyData != no_early_data)
+        return 0;
+#endif
+
+    used = ssl->buffers.inputBuffer.length - ssl->buffers.inputBuffer.idx;
+    if (used < RECORD_HEADER_SZ)
+        return 0;
+
+    hdr = ssl->buffers.inputBuffer.buffer + ssl->buffers.inputBuffer.idx;
+    if (hdr[0] != application_data)
+        return 0;
+    ato16(hdr + 3, &recSz);
+
+    return used >= (word32)RECORD_HEADER_SZ + recSz;
+}
+#endif /* WOLFSSL_READ_AHEAD */
+
+/* process input data */
+int ReceiveData(WOLFSSL* ssl, byte* output, int sz, int peek)
+{
+    int size;
+
+    WOLFSSL_ENTER("ReceiveData()");
+
+#ifdef WOLFSSL_KTLS
+    KtlsAutoSetup(ssl, WOLFSSL_KTLS_RX);
+    if (ssl->options.ktlsRx && ssl->buffers.clearOutputBuffer.length == 0 &&
+            ssl->buffers.inputBuffer.idx == ssl->buffers.inputBuffer.length &&
+            (ssl->error == 0 || ssl->error == WANT_READ)) {
+        ssl->error = 0;
+        size = KtlsReceiveData(ssl, output, sz, peek);
+        if (size == WANT_READ) {
+            ssl->error = size;
+            WOLFSSL_ERROR(ssl->error);
+        }
+        if (size != 0) {
+            WOLFSSL_LEAVE("ReceiveData()", size);
+            return size;
+        }
+    }
+#endif
+
+    size = WaitForAppData(ssl, peek);
+    if (size != WOLFSSL_SUCCESS)
+        return size;
+
     size = min(sz, (int)ssl->buffers.clearOutputBuffer.length);
 
     XMEMCPY(output, ssl->buffers.clearOutputBuffer.buffer, size);
@@ -18711,16 +21150,146 @@ startScr:
     if (peek == 0) {
         ssl->buffers.clearOutputBuffer.length -= size;
         ssl->buffers.clearOutputBuffer.buffer += size;
+
+    #ifdef WOLFSSL_READ_AHEAD
+        /* decrypt any further records that came in with the same read while
+         * the caller has room for them */
+        while (size < sz && ssl->buffers.clearOutputBuffer.length == 0 &&
+                                                    HaveBufferedAppData(ssl)) {
+            int ret = ProcessReply(ssl);
+            int copySz;
+
+            if (ret < 0) {
+                /* reported on the next call, hand back what we have */
+                WOLFSSL_MSG("Error in batched record, returning data so far");
+                ssl->error = ret;
+                break;
+            }
+
+            copySz = min(sz - size, (int)ssl->buffers.clearOutputBuffer.length);
+            XMEMCPY(output + size, ssl->buffers.clearOutputBuffer.buffer,
+                    copySz);
+            ssl->buffers.clearOutputBuffer.length -= copySz;
+            ssl->buffers.clearOutputBuffer.buffer += copySz;
+            size += copySz;
+        }
+    #endif
     }
 
     if (ssl->buffers.clearOutputBuffer.length == 0 &&
-                                           ssl->buffers.inputBuffer.dynamicFlag)
+                                           ssl->buffers.inputBuffer.dynamicFlag
+    #ifdef WOLFSSL_READ_AHEAD
+            /* kept for the next burst, freed once the connection is idle */
+            && ssl->readAheadSz == 0
+    #endif
+            )
        ShrinkInputBuffer(ssl, NO_FORCED_FREE);
 
     WOLFSSL_LEAVE("ReceiveData()", size);
     return size;
 }
 
+#ifdef WOLFSSL_ZERO_COPY
+/* process input data without copying it out, on success data points at the
+ * decrypted record inside the input buffer and stays valid until released
+ * with ReceiveDataZeroCopyDone() */
+int ReceiveDataZeroCopy(WOLFSSL* ssl, byte** data)
+{
+    int ret;
+
+    WOLFSSL_ENTER("ReceiveDataZeroCopy()");
+
+#ifdef WOLFSSL_KTLS
+    KtlsAutoSetup(ssl, WOLFSSL_KTLS_RX);
+#endif
+
+    ret = WaitForAppData(ssl, FALSE);
+    if (ret != WOLFSSL_SUCCESS)
+        return ret;
+
+    *data = ssl->buffers.clearOutputBuffer.buffer;
+    ret = (int)ssl->buffers.clearOutputBuffer.length;
+
+    WOLFSSL_LEAVE("ReceiveDataZeroCopy()", ret);
+    return ret;
+}
+
+/* consume sz bytes handed out by ReceiveDataZeroCopy() */
+int ReceiveDataZeroCopyDone(WOLFSSL* ssl, int sz)
+{
+    if (sz < 0 || (word32)sz > ssl->buffers.clearOutputBuffer.length)
+        return BAD_FUNC_ARG;
+
+    ssl->buffers.clearOutputBuffer.length -= sz;
+    ssl->buffers.clearOutputBuffer.buffer += sz;
+
+    if (ssl->buffers.clearOutputBuffer.length == 0 &&
+                                           ssl->buffers.inputBuffer.dynamicFlag
+    #ifdef WOLFSSL_READ_AHEAD
+            /* kept for the next burst, freed once the connection is idle */
+            && ssl->readAheadSz == 0
+    #endif
+            )
+       ShrinkInputBuffer(ssl, NO_FORCED_FREE);
+
+    return 0;
+}
+#endif /* WOLFSSL_ZERO_COPY */
+
+
+#ifdef WOLFSSL_KTLS
+/* Send an alert record through the kernel, on WANT_WRITE call again to send
+ * the same alert */
+static int KtlsSendAlert(WOLFSSL* ssl, int severity, int type)
+{
+    byte input[ALERT_SIZE];
+    int  ret;
+
+    if (ssl->options.sendAlertState != 0) {
+        severity = ssl->alert_history.last_tx.level;
+        type     = ssl->alert_history.last_tx.code;
+    }
+    else {
+    #ifdef OPENSSL_EXTRA
+        if (ssl->CBIS != NULL) {
+            ssl->CBIS(ssl, SSL_CB_ALERT, type);
+        }
+    #endif
+        ssl->alert_history.last_tx.code = type;
+        ssl->alert_history.last_tx.level = severity;
+        if (severity == alert_fatal) {
+            ssl->options.isClosed = 1;  /* Don't send close_notify */
+        }
+        ssl->options.sendAlertState = 1;
+        CTX_STATS_ADD(ssl, alertsSent[CTX_STATS_ALERT(type)], 1);
+        WC_TRACE(WC_TRACE_ALERT_SEND, ssl, NULL, (severity << 8) | type);
+    }
+
+    /* application data queued ahead of the alert goes first */
+    if (ssl->buffers.outputBuffer.length > 0 &&
+                                          (ret = SendBuffered(ssl)) != 0)
+        return ret;
+
+    input[0] = (byte)severity;
+    input[1] = (byte)type;
+
+    do {
+        ret = EmbedSendRecord(ssl, alert, (char*)input, ALERT_SIZE,
+                              ssl->IOCB_WriteCtx);
+    } while (ret == WOLFSSL_CBIO_ERR_ISR);
+
+    if (ret == WOLFSSL_CBIO_ERR_WANT_WRITE)
+        return WANT_WRITE;
+    if (ret == WOLFSSL_CBIO_ERR_CONN_RST || ret == WOLFSSL_CBIO_ERR_CONN_CLOSE)
+        ssl->options.connReset = 1;
+    if (ret < 0)
+        return SOCKET_ERROR_E;
+
+    ssl->options.sendAlertState = 0;
+
+    return 0;
+}
+#endif /* WOLFSSL_KTLS */
 
 /* send alert message */
 int SendAlert(WOLFSSL* ssl, int severity, int type)
@@ -18754,6 +21323,14 @@ int SendAlert(WOLFSSL* ssl, int severity, int type)
     }
 #endif
 
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx) {
+        ret = KtlsSendAlert(ssl, severity, type);
+        WOLFSSL_LEAVE("SendAlert", ret);
+        return ret;
+    }
+#endif
+
     /* if sendalert is called again for nonblocking */
     if (ssl->options.sendAlertState != 0) {
         ret = SendBuffered(ssl);
@@ -18792,6 +21369,8 @@ int SendAlert(WOLFSSL* ssl, int severity, int type)
     if (severity == alert_fatal) {
         ssl->options.isClosed = 1;  /* Don't send close_notify */
     }
+    CTX_STATS_ADD(ssl, alertsSent[CTX_STATS_ALERT(type)], 1);
+    WC_TRACE(WC_TRACE_ALERT_SEND, ssl, NULL, (severity << 8) | type);
 
     /* send encrypted alert if encryption is on - can be a rehandshake over
      * an existing encrypted channel.
@@ -19280,6 +21859,9 @@ const char* wolfSSL_ERR_reason_error_string(unsigned long e)
 
     case TOO_MUCH_EARLY_DATA:
         return "Too much early data";
+
+    case KTLS_E:
+        return "Kernel TLS offload error";
         
     default :
         return "unknown error number";
@@ -20254,6 +22836,9 @@ int SetCipherList(WOLFSSL_CTX* ctx, Suites* suites, const char* list)
     #endif
         suites->setSuites = 1;
         suites->suiteSz   = (word16)idx;
+    #ifdef WOLFSSL_SUITE_MAP
+        InitSuitesMap(suites);
+    #endif
         InitSuitesHashSigAlgo(suites, haveECDSAsig, haveRSAsig, haveAnon, 1,
                               keySz);
     }
@@ -20281,7 +22866,7 @@ static int MatchSigAlgo(WOLFSSL* ssl, int sigAlgo)
 #endif
 #ifdef WC_RSA_PSS
     /* RSA certificate and PSS sig alg. */
-    if (ssl->suites->sigAlgo == rsa_sa_algo) {
+    if (ssl->options.sigAlgo == rsa_sa_algo) {
     #if defined(WOLFSSL_TLS13)
         /* TLS 1.3 only supports RSA-PSS. */
         if (IsAtLeastTLSv1_3(ssl->version))
@@ -20293,7 +22878,7 @@ static int MatchSigAlgo(WOLFSSL* ssl, int sigAlgo)
     }
 #endif
     /* Signature algorithm matches certificate. */
-    return sigAlgo == ssl->suites->sigAlgo;
+    return sigAlgo == ssl->options.sigAlgo;
 }
 
 #if defined(HAVE_ECC) && defined(WOLFSSL_TLS13) || \
@@ -20335,17 +22920,17 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
         /* TLS 1.3 cipher suites don't have public key algorithms in them.
          * Using the one in the certificate - if any.
          */
-        ssl->suites->sigAlgo = ssl->buffers.keyType;
+        ssl->options.sigAlgo = ssl->buffers.keyType;
     #endif
     }
     else
-        ssl->suites->sigAlgo = ssl->specs.sig_algo;
-    if (ssl->suites->sigAlgo == 0) {
+        ssl->options.sigAlgo = ssl->specs.sig_algo;
+    if (ssl->options.sigAlgo == 0) {
         /* PSK ciphersuite - get digest to use from cipher suite */
-        ssl->suites->hashAlgo = ssl->specs.mac_algorithm;
+        ssl->options.hashAlgo = ssl->specs.mac_algorithm;
         return 0;
     }
-    ssl->suites->hashAlgo = minHash = MinHashAlgo(ssl);
+    ssl->options.hashAlgo = minHash = MinHashAlgo(ssl);
 
     /* No list means go with the defaults. */
     if (hashSigAlgoSz == 0)
@@ -20366,8 +22951,8 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
     #ifdef HAVE_ED25519
         if (ssl->pkCurveOID == ECC_ED25519_OID) {
             /* Matched Ed25519 - set chosen and finished. */
-            ssl->suites->sigAlgo = sigAlgo;
-            ssl->suites->hashAlgo = hashAlgo;
+            ssl->options.sigAlgo = sigAlgo;
+            ssl->options.hashAlgo = hashAlgo;
             ret = 0;
             break;
         }
@@ -20375,8 +22960,8 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
     #ifdef HAVE_ED448
         if (ssl->pkCurveOID == ECC_ED448_OID) {
             /* Matched Ed448 - set chosen and finished. */
-            ssl->suites->sigAlgo = sigAlgo;
-            ssl->suites->hashAlgo = hashAlgo;
+            ssl->options.sigAlgo = sigAlgo;
+            ssl->options.hashAlgo = hashAlgo;
             ret = 0;
             break;
         }
@@ -20399,8 +22984,8 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
                 continue;
 
             /* Matched ECDSA exaclty - set chosen and finished. */
-            ssl->suites->hashAlgo = hashAlgo;
-            ssl->suites->sigAlgo = sigAlgo;
+            ssl->options.hashAlgo = hashAlgo;
+            ssl->options.sigAlgo = sigAlgo;
             ret = 0;
             break;
         }
@@ -20420,9 +23005,9 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
                 continue;
 
             /* Looking for exact match or next highest. */
-            if (ret != 0 || hashAlgo <= ssl->suites->hashAlgo) {
-                ssl->suites->hashAlgo = hashAlgo;
-                ssl->suites->sigAlgo = sigAlgo;
+            if (ret != 0 || hashAlgo <= ssl->options.hashAlgo) {
+                ssl->options.hashAlgo = hashAlgo;
+                ssl->options.sigAlgo = sigAlgo;
             #if defined(WOLFSSL_TLS13) || defined(HAVE_FFDHE)
                 ssl->namedGroup = 0;
             #endif
@@ -20455,16 +23040,16 @@ int PickHashSigAlgo(WOLFSSL* ssl, const byte* hashSigAlgo, word32 hashSigAlgoSz)
         #endif
             #ifdef WOLFSSL_STRONGEST_HASH_SIG
             /* Is hash algorithm weaker than chosen/min? */
-                if (hashAlgo < ssl->suites->hashAlgo)
+                if (hashAlgo < ssl->options.hashAlgo)
                     break;
             #else
                 /* Is hash algorithm stonger than last chosen? */
-                if (ret == 0 && hashAlgo > ssl->suites->hashAlgo)
+                if (ret == 0 && hashAlgo > ssl->options.hashAlgo)
                     break;
             #endif
                 /* The chosen one - but keep looking. */
-                ssl->suites->hashAlgo = hashAlgo;
-                ssl->suites->sigAlgo = sigAlgo;
+                ssl->options.hashAlgo = hashAlgo;
+                ssl->options.sigAlgo = sigAlgo;
                 ret = 0;
                 break;
             default:
@@ -20745,6 +23330,171 @@ int CreateDevPrivateKey(void** pkey, byte* data, word32 length, int hsType,
 }
 #endif
 
+#ifdef WOLFSSL_PRIVKEY_CACHE
+/* Free the private key decoded when loaded into the CTX.
+ *
+ * ctx  The SSL/TLS CTX object.
+ */
+void FreeCtxPrivateKeyCache(WOLFSSL_CTX* ctx)
+{
+    PrivKeyCache* cache = &ctx->privKeyCache;
+
+    if (cache->key != NULL) {
+    #if !defined(NO_RSA) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+        if (cache->type == DYNAMIC_TYPE_RSA)
+            wc_FreeRsaKey((RsaKey*)cache->key);
+    #endif
+    #ifdef HAVE_ECC
+        if (cache->type == DYNAMIC_TYPE_ECC)
+            wc_ecc_free((ecc_key*)cache->key);
+    #endif
+        XFREE(cache->key, ctx->heap, cache->type);
+    }
+    XMEMSET(cache, 0, sizeof(*cache));
+}
+
+/* Decode the RSA or ECC private key of the CTX once, when it is loaded, so
+ * that handshakes copy the decoded key instead of parsing the DER each time.
+ * Keys held by a device and other key types are not cached and are decoded
+ * per handshake by DecodePrivateKey().
+ *
+ * ctx  The SSL/TLS CTX object.
+ */
+void SetCtxPrivateKeyCache(WOLFSSL_CTX* ctx)
+{
+    PrivKeyCache* cache = &ctx->privKeyCache;
+    DerBuffer*    der = ctx->privateKey;
+    void*         key = NULL;
+    int           type = 0;
+    int           ret = NOT_COMPILED_IN;
+    word32        idx = 0;
+
+    FreeCtxPrivateKeyCache(ctx);
+
+    if (der == NULL || der->buffer == NULL || ctx->privateKeyId ||
+            ctx->privateKeyLabel || ctx->privateKeyDevId != INVALID_DEVID) {
+        return;
+    }
+
+#if !defined(NO_RSA) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+    if (ctx->privateKeyType == rsa_sa_algo) {
+        type = DYNAMIC_TYPE_RSA;
+        key = XMALLOC(sizeof(RsaKey), ctx->heap, type);
+        if (key == NULL)
+            return;
+        ret = wc_InitRsaKey_ex((RsaKey*)key, ctx->heap, INVALID_DEVID);
+        if (ret == 0) {
+            ret = wc_RsaPrivateKeyDecode(der->buffer, &idx, (RsaKey*)key,
+                                         der->length);
+        }
+        if (ret == 0) {
+            cache->keySz = wc_RsaEncryptSize((RsaKey*)key);
+            cache->sigSz = (word16)cache->keySz;
+            if (cache->keySz <= 0)
+                ret = RSA_KEY_SIZE_E;
+        }
+    }
+#endif
+#ifdef HAVE_ECC
+    if (ctx->privateKeyType == ecc_dsa_sa_algo) {
+        type = DYNAMIC_TYPE_ECC;
+        key = XMALLOC(sizeof(ecc_key), ctx->heap, type);
+        if (key == NULL)
+            return;
+        ret = wc_ecc_init_ex((ecc_key*)key, ctx->heap, INVALID_DEVID);
+        if (ret == 0) {
+            ret = wc_EccPrivateKeyDecode(der->buffer, &idx, (ecc_key*)key,
+                                         der->length);
+        }
+        if (ret == 0) {
+            cache->keySz = wc_ecc_size((ecc_key*)key);
+            cache->sigSz = (word16)wc_ecc_sig_size((ecc_key*)key);
+        }
+    }
+#endif
+
+    cache->key = key;
+    cache->type = type;
+    if (ret != 0) {
+        WOLFSSL_MSG("Private key not cached");
+        FreeCtxPrivateKeyCache(ctx);
+    }
+    (void)idx;
+}
+
+/* Copy the private key decoded when loaded into the CTX into the handshake
+ * key. The CTX key is only read so connections can do this at the same time.
+ *
+ * ssl     The SSL/TLS object.
+ * length  The length of a signature.
+ * returns 0 on success, otherwise failure.
+ */
+static int CopyCtxPrivateKey(WOLFSSL* ssl, word16* length)
+{
+    PrivKeyCache* cache = &ssl->ctx->privKeyCache;
+    int           ret;
+
+    ssl->hsType = cache->type;
+    ret = AllocKey(ssl, ssl->hsType, &ssl->hsKey);
+    if (ret != 0)
+        return ret;
+
+#if !defined(NO_RSA) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+    if (cache->type == DYNAMIC_TYPE_RSA) {
+        RsaKey* src = (RsaKey*)cache->key;
+        RsaKey* dst = (RsaKey*)ssl->hsKey;
+
+        WOLFSSL_MSG("Using cached RSA private key");
+        if (cache->keySz < ssl->options.minRsaKeySz) {
+            WOLFSSL_MSG("RSA key size too small");
+            return RSA_KEY_SIZE_E;
+        }
+
+        if (mp_copy(&src->n, &dst->n) != MP_OKAY ||
+                mp_copy(&src->e, &dst->e) != MP_OKAY ||
+                mp_copy(&src->d, &dst->d) != MP_OKAY ||
+                mp_copy(&src->p, &dst->p) != MP_OKAY ||
+            #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || \
+                                                          !defined(RSA_LOW_MEM)
+                mp_copy(&src->dP, &dst->dP) != MP_OKAY ||
+                mp_copy(&src->dQ, &dst->dQ) != MP_OKAY ||
+                mp_copy(&src->u, &dst->u) != MP_OKAY ||
+            #endif
+                mp_copy(&src->q, &dst->q) != MP_OKAY) {
+            return MEMORY_E;
+        }
+        dst->type = src->type;
+    }
+#endif
+#ifdef HAVE_ECC
+    if (cache->type == DYNAMIC_TYPE_ECC) {
+        ecc_key* src = (ecc_key*)cache->key;
+        ecc_key* dst = (ecc_key*)ssl->hsKey;
+
+        WOLFSSL_MSG("Using cached ECC private key");
+        if (cache->keySz < ssl->options.minEccKeySz) {
+            WOLFSSL_MSG("ECC key size too small");
+            return ECC_KEY_SIZE_E;
+        }
+
+        if (mp_copy(&src->k, &dst->k) != MP_OKAY ||
+                wc_ecc_copy_point(&src->pubkey, &dst->pubkey) != MP_OKAY) {
+            return MEMORY_E;
+        }
+        dst->type  = src->type;
+        dst->idx   = src->idx;
+        dst->dp    = src->dp;
+        dst->flags = src->flags;
+    }
+#endif
+
+    /* Return the maximum signature length. */
+    *length = cache->sigSz;
+
+    return 0;
+}
+#endif /* WOLFSSL_PRIVKEY_CACHE */
+
 /* Decode the private key - RSA/ECC/Ed25519/Ed448 - and creates a key object.
  * The signature type is set as well.
  * The maximum length of a signature is returned.
@@ -20842,6 +23592,15 @@ int DecodePrivateKey(WOLFSSL *ssl, word16* length)
     }
 #endif
 
+#ifdef WOLFSSL_PRIVKEY_CACHE
+    /* Connection uses the key of the CTX which was decoded when loaded. */
+    if (ssl->ctx->privKeyCache.key != NULL &&
+            ssl->buffers.key == ssl->ctx->privateKey) {
+        ret = CopyCtxPrivateKey(ssl, length);
+        goto exit_dpk;
+    }
+#endif
+
 #ifndef NO_RSA
     if (ssl->buffers.keyType == rsa_sa_algo || ssl->buffers.keyType == 0) {
         ssl->hsType = DYNAMIC_TYPE_RSA;
@@ -21147,7 +23906,7 @@ exit_dpk:
 
         /* then random */
         if (ssl->options.connectState == CONNECT_BEGIN) {
-            ret = wc_RNG_GenerateBlock(ssl->rng, output + idx, RAN_LEN);
+            ret = wc_RNG_GenerateBlock(GetSslRng(ssl), output + idx, RAN_LEN);
             if (ret != 0)
                 return ret;
 
@@ -21708,6 +24467,10 @@ exit_dpk:
 #endif /* HAVE_SECRET_CALLBACK */
 
         ret = CompleteServerHello(ssl);
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+        if (ret == 0)
+            ret = SelectHandshakeHashes(ssl);
+#endif
 
         WOLFSSL_LEAVE("DoServerHello", ret);
         WOLFSSL_END(WC_FUNC_SERVER_HELLO_DO);
@@ -21877,8 +24640,8 @@ exit_dpk:
             *inOutIdx += len;
     #ifdef WC_RSA_PSS
             ssl->pssAlgo = 0;
-            if (ssl->suites->sigAlgo == rsa_pss_sa_algo)
-                ssl->pssAlgo |= 1 << ssl->suites->hashAlgo;
+            if (ssl->options.sigAlgo == rsa_pss_sa_algo)
+                ssl->pssAlgo |= 1 << ssl->options.hashAlgo;
     #endif
         }
 
@@ -23631,7 +26394,7 @@ static int QSH_GenerateSerCliSecret(WOLFSSL* ssl, byte isServer)
             continue;
         }
 
-        if (wc_RNG_GenerateBlock(ssl->rng, buf->buffer + offset, plainSz)
+        if (wc_RNG_GenerateBlock(GetSslRng(ssl), buf->buffer + offset, plainSz)
                                                                          != 0) {
             return -1;
         }
@@ -24041,7 +26804,7 @@ int SendClientKeyExchange(WOLFSSL* ssl)
                         ENCRYPT_LEN - VERSION_SZ);
                     } else {
                     #endif
-                        ret = wc_RNG_GenerateBlock(ssl->rng,
+                        ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
                             &ssl->arrays->preMasterSecret[VERSION_SZ],
                             SECRET_LEN - VERSION_SZ);
                     #if defined(WOLFSSL_RENESAS_TSIP_TLS) && \
@@ -24086,7 +26849,7 @@ int SendClientKeyExchange(WOLFSSL* ssl)
                             ssl->buffers.serverDH_P.length,
                             ssl->buffers.serverDH_G.buffer,
                             ssl->buffers.serverDH_G.length,
-                            NULL, 0, 0, ssl->rng);
+                            NULL, 0, 0, GetSslRng(ssl));
                         if (ret != 0) {
                             goto exit_scke;
                         }
@@ -24200,7 +26963,7 @@ int SendClientKeyExchange(WOLFSSL* ssl)
                             ssl->buffers.serverDH_P.length,
                             ssl->buffers.serverDH_G.buffer,
                             ssl->buffers.serverDH_G.length,
-                            NULL, 0, 0, ssl->rng);
+                            NULL, 0, 0, GetSslRng(ssl));
                         if (ret != 0) {
                             goto exit_scke;
                         }
@@ -24321,7 +27084,7 @@ int SendClientKeyExchange(WOLFSSL* ssl)
             #ifdef HAVE_NTRU
                 case ntru_kea:
                 {
-                    ret = wc_RNG_GenerateBlock(ssl->rng,
+                    ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
                                   ssl->arrays->preMasterSecret, SECRET_LEN);
                     if (ret != 0) {
                         goto exit_scke;
@@ -25126,7 +27889,7 @@ int SendCertificateVerify(WOLFSSL* ssl)
             if (ssl->hsType == DYNAMIC_TYPE_RSA) {
         #ifdef WC_RSA_PSS
                 if (IsAtLeastTLSv1_2(ssl) &&
-                                (ssl->pssAlgo & (1 << ssl->suites->hashAlgo))) {
+                                (ssl->pssAlgo & (1 << ssl->options.hashAlgo))) {
                     args->sigAlgo = rsa_pss_sa_algo;
                 }
                 else
@@ -25141,10 +27904,10 @@ int SendCertificateVerify(WOLFSSL* ssl)
                 args->sigAlgo = ed448_sa_algo;
 
             if (IsAtLeastTLSv1_2(ssl)) {
-                EncodeSigAlg(ssl->suites->hashAlgo, args->sigAlgo,
+                EncodeSigAlg(ssl->options.hashAlgo, args->sigAlgo,
                              args->verify);
                 args->extraSz = HASH_SIG_SIZE;
-                SetDigest(ssl, ssl->suites->hashAlgo);
+                SetDigest(ssl, ssl->options.hashAlgo);
             }
         #ifndef NO_OLD_TLS
             else {
@@ -25163,7 +27926,7 @@ int SendCertificateVerify(WOLFSSL* ssl)
                     ssl->buffers.sig.length = wc_EncodeSignature(
                             ssl->buffers.sig.buffer, ssl->buffers.digest.buffer,
                             ssl->buffers.digest.length,
-                            TypeHash(ssl->suites->hashAlgo));
+                            TypeHash(ssl->options.hashAlgo));
                 }
 
                 /* prepend hdr */
@@ -25261,7 +28024,7 @@ int SendCertificateVerify(WOLFSSL* ssl)
                 ret = RsaSign(ssl,
                     ssl->buffers.sig.buffer, ssl->buffers.sig.length,
                     args->verify + args->extraSz + VERIFY_HEADER, &args->sigSz,
-                    args->sigAlgo, ssl->suites->hashAlgo, key,
+                    args->sigAlgo, ssl->options.hashAlgo, key,
                     ssl->buffers.key
                 );
             }
@@ -25319,7 +28082,7 @@ int SendCertificateVerify(WOLFSSL* ssl)
                     ret = VerifyRsaSign(ssl,
                         args->verifySig, args->sigSz,
                         ssl->buffers.sig.buffer, ssl->buffers.sig.length,
-                        args->sigAlgo, ssl->suites->hashAlgo, key,
+                        args->sigAlgo, ssl->options.hashAlgo, key,
                         ssl->buffers.key
                     );
                     break;
@@ -25720,6 +28483,12 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         WOLFSSL_START(WC_FUNC_SERVER_HELLO_SEND);
         WOLFSSL_ENTER("SendServerHello");
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+        ret = SelectHandshakeHashes(ssl);
+        if (ret != 0)
+            return ret;
+#endif
+
         length = VERSION_SZ + RAN_LEN
                + ID_LEN + ENUM_LEN
                + SUITE_LEN
@@ -25801,7 +28570,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         /* then random and session id */
         if (!ssl->options.resuming) {
             /* generate random part and session id */
-            ret = wc_RNG_GenerateBlock(ssl->rng, output + idx,
+            ret = wc_RNG_GenerateBlock(GetSslRng(ssl), output + idx,
                 RAN_LEN + sizeof(sessIdSz) + sessIdSz);
             if (ret != 0)
                 return ret;
@@ -26163,7 +28932,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                 ssl->buffers.serverDH_P.length,
                                 ssl->buffers.serverDH_G.buffer,
                                 ssl->buffers.serverDH_G.length,
-                                NULL, 0, 0, ssl->rng);
+                                NULL, 0, 0, GetSslRng(ssl));
                             if (ret != 0) {
                                 goto exit_sske;
                             }
@@ -26199,6 +28968,11 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                                           defined(HAVE_CURVE448)
                     case ecc_diffie_hellman_kea:
                     {
+                    #ifdef WOLFSSL_KEYSHARE_POOL
+                        /* take a key pair generated ahead of time if ready */
+                        if (TLSX_KeySharePool_TempKey(ssl) == 0)
+                            break;
+                    #endif
                     #ifdef HAVE_CURVE25519
                         if (ssl->ecdhCurveOID == ECC_X25519_OID) {
                             /* need ephemeral key now, create it if missing */
@@ -26612,7 +29386,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                 ERROR_OUT(NO_PRIVATE_KEY, exit_sske);
                         }
                         else {
-                            switch(ssl->suites->sigAlgo) {
+                            switch(ssl->options.sigAlgo) {
                         #ifndef NO_RSA
                         #ifdef WC_RSA_PSS
                             case rsa_pss_sa_algo:
@@ -26745,12 +29519,12 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
 
                         /* Determine hash type */
                         if (IsAtLeastTLSv1_2(ssl)) {
-                            EncodeSigAlg(ssl->suites->hashAlgo,
-                                         ssl->suites->sigAlgo,
+                            EncodeSigAlg(ssl->options.hashAlgo,
+                                         ssl->options.sigAlgo,
                                          &args->output[args->idx]);
                             args->idx += 2;
 
-                            hashType = HashAlgoToType(ssl->suites->hashAlgo);
+                            hashType = HashAlgoToType(ssl->options.hashAlgo);
                             if (hashType == WC_HASH_TYPE_NONE) {
                                 ERROR_OUT(ALGO_ID_E, exit_sske);
                             }
@@ -26759,7 +29533,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                             /* only using sha and md5 for rsa */
                         #ifndef NO_OLD_TLS
                             hashType = WC_HASH_TYPE_SHA;
-                            if (ssl->suites->sigAlgo == rsa_sa_algo) {
+                            if (ssl->options.sigAlgo == rsa_sa_algo) {
                                 hashType = WC_HASH_TYPE_MD5_SHA;
                             }
                         #else
@@ -26790,8 +29564,8 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         XMEMCPY(args->sigDataBuf+RAN_LEN+RAN_LEN,
                                 args->output + preSigIdx, preSigSz);
 
-                        if (ssl->suites->sigAlgo != ed25519_sa_algo &&
-                                        ssl->suites->sigAlgo != ed448_sa_algo) {
+                        if (ssl->options.sigAlgo != ed25519_sa_algo &&
+                                        ssl->options.sigAlgo != ed448_sa_algo) {
                             ssl->buffers.sig.length =
                                                  wc_HashGetDigestSize(hashType);
                             if ((int)ssl->buffers.sig.length < 0) {
@@ -26817,7 +29591,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         args->sigSz = args->tmpSigSz;
 
                         /* Sign hash to create signature */
-                        switch (ssl->suites->sigAlgo)
+                        switch (ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                             case rsa_sa_algo:
@@ -26835,7 +29609,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                         wc_EncodeSignature(encodedSig,
                                             ssl->buffers.sig.buffer,
                                             ssl->buffers.sig.length,
-                                            TypeHash(ssl->suites->hashAlgo));
+                                            TypeHash(ssl->options.hashAlgo));
 
                                     /* Replace sig buffer with new one */
                                     XFREE(ssl->buffers.sig.buffer, ssl->heap,
@@ -27004,12 +29778,12 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
 
                         /* Determine hash type */
                         if (IsAtLeastTLSv1_2(ssl)) {
-                            EncodeSigAlg(ssl->suites->hashAlgo,
-                                         ssl->suites->sigAlgo,
+                            EncodeSigAlg(ssl->options.hashAlgo,
+                                         ssl->options.sigAlgo,
                                          &args->output[args->idx]);
                             args->idx += 2;
 
-                            hashType = HashAlgoToType(ssl->suites->hashAlgo);
+                            hashType = HashAlgoToType(ssl->options.hashAlgo);
                             if (hashType == WC_HASH_TYPE_NONE) {
                                 ERROR_OUT(ALGO_ID_E, exit_sske);
                             }
@@ -27017,7 +29791,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                             /* only using sha and md5 for rsa */
                         #ifndef NO_OLD_TLS
                             hashType = WC_HASH_TYPE_SHA;
-                            if (ssl->suites->sigAlgo == rsa_sa_algo) {
+                            if (ssl->options.sigAlgo == rsa_sa_algo) {
                                 hashType = WC_HASH_TYPE_MD5_SHA;
                             }
                         #else
@@ -27043,8 +29817,8 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         XMEMCPY(args->sigDataBuf+RAN_LEN+RAN_LEN,
                             args->output + preSigIdx, preSigSz);
 
-                        if (ssl->suites->sigAlgo != ed25519_sa_algo &&
-                                        ssl->suites->sigAlgo != ed448_sa_algo) {
+                        if (ssl->options.sigAlgo != ed25519_sa_algo &&
+                                        ssl->options.sigAlgo != ed448_sa_algo) {
                             ssl->buffers.sig.length =
                                                  wc_HashGetDigestSize(hashType);
                             ssl->buffers.sig.buffer = (byte*)XMALLOC(
@@ -27067,7 +29841,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         args->sigSz = args->tmpSigSz;
 
                         /* Sign hash to create signature */
-                        switch (ssl->suites->sigAlgo)
+                        switch (ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                             case rsa_sa_algo:
@@ -27085,7 +29859,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                         wc_EncodeSignature(encodedSig,
                                             ssl->buffers.sig.buffer,
                                             ssl->buffers.sig.length,
-                                            TypeHash(ssl->suites->hashAlgo));
+                                            TypeHash(ssl->options.hashAlgo));
 
                                     /* Replace sig buffer with new one */
                                     XFREE(ssl->buffers.sig.buffer, ssl->heap,
@@ -27097,7 +29871,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         #endif /* NO_RSA */
                             default:
                                 break;
-                        } /* switch (ssl->suites->sigAlgo) */
+                        } /* switch (ssl->options.sigAlgo) */
                         break;
                     }
                 #endif /* !defined(NO_DH) && !defined(NO_RSA) */
@@ -27143,7 +29917,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                     case ecc_diffie_hellman_kea:
                     {
                         /* Sign hash to create signature */
-                        switch (ssl->suites->sigAlgo)
+                        switch (ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                         #ifdef WC_RSA_PSS
@@ -27158,7 +29932,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                     ssl->buffers.sig.length,
                                     args->output + args->idx,
                                     &args->sigSz,
-                                    ssl->suites->sigAlgo, ssl->suites->hashAlgo,
+                                    ssl->options.sigAlgo, ssl->options.hashAlgo,
                                     key,
                                     ssl->buffers.key
                                 );
@@ -27233,7 +30007,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                     case diffie_hellman_kea:
                     {
                         /* Sign hash to create signature */
-                        switch (ssl->suites->sigAlgo)
+                        switch (ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                         #ifdef WC_RSA_PSS
@@ -27252,7 +30026,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                     ssl->buffers.sig.length,
                                     args->output + args->idx,
                                     &args->sigSz,
-                                    ssl->suites->sigAlgo, ssl->suites->hashAlgo,
+                                    ssl->options.sigAlgo, ssl->options.hashAlgo,
                                     key,
                                     ssl->buffers.key
                                 );
@@ -27261,7 +30035,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                         #endif /* NO_RSA */
                             default:
                                 break;
-                        } /* switch (ssl->suites->sigAlgo) */
+                        } /* switch (ssl->options.sigAlgo) */
 
                         break;
                     }
@@ -27310,7 +30084,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                                           defined(HAVE_CURVE448)
                     case ecc_diffie_hellman_kea:
                     {
-                        switch(ssl->suites->sigAlgo)
+                        switch(ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                         #ifdef WC_RSA_PSS
@@ -27339,7 +30113,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                     args->verifySig, args->sigSz,
                                     ssl->buffers.sig.buffer,
                                     ssl->buffers.sig.length,
-                                    ssl->suites->sigAlgo, ssl->suites->hashAlgo,
+                                    ssl->options.sigAlgo, ssl->options.hashAlgo,
                                     key, ssl->buffers.key
                                 );
                                 break;
@@ -27371,7 +30145,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                 #if !defined(NO_DH) && !defined(NO_RSA)
                     case diffie_hellman_kea:
                     {
-                        switch (ssl->suites->sigAlgo)
+                        switch (ssl->options.sigAlgo)
                         {
                         #ifndef NO_RSA
                         #ifndef WC_RSA_PSS
@@ -27404,13 +30178,13 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                     args->verifySig, args->sigSz,
                                     ssl->buffers.sig.buffer,
                                     ssl->buffers.sig.length,
-                                    ssl->suites->sigAlgo, ssl->suites->hashAlgo,
+                                    ssl->options.sigAlgo, ssl->options.hashAlgo,
                                     key, ssl->buffers.key
                                 );
                                 break;
                             }
                         #endif
-                        } /* switch (ssl->suites->sigAlgo) */
+                        } /* switch (ssl->options.sigAlgo) */
                         break;
                     }
                 #endif /* !defined(NO_DH) && !defined(NO_RSA) */
@@ -27748,36 +30522,88 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
     }
 
 #ifndef NO_WOLFSSL_SERVER
+    /* Use our suite at index i when valid, the peer has it too */
+    static int UseServerSuite(WOLFSSL* ssl, Suites* peerSuites, word16 i)
+    {
+        if (VerifyServerSuite(ssl, i)) {
+            int result;
+            WOLFSSL_MSG("Verified suite validity");
+            ssl->options.cipherSuite0 = ssl->suites->suites[i];
+            ssl->options.cipherSuite  = ssl->suites->suites[i+1];
+            result = SetCipherSpecs(ssl);
+            if (result == 0) {
+                result = PickHashSigAlgo(ssl, peerSuites->hashSigAlgo,
+                                                 peerSuites->hashSigAlgoSz);
+            }
+            return result;
+        }
+        else {
+            WOLFSSL_MSG("Could not verify suite validity, continue");
+        }
+
+        return MATCH_SUITE_ERROR;
+    }
+
     static int CompareSuites(WOLFSSL* ssl, Suites* peerSuites, word16 i,
                              word16 j)
     {
         if (ssl->suites->suites[i]   == peerSuites->suites[j] &&
             ssl->suites->suites[i+1] == peerSuites->suites[j+1] ) {
+            return UseServerSuite(ssl, peerSuites, i);
+        }
 
-            if (VerifyServerSuite(ssl, i)) {
-                int result;
-                WOLFSSL_MSG("Verified suite validity");
-                ssl->options.cipherSuite0 = ssl->suites->suites[i];
-                ssl->options.cipherSuite  = ssl->suites->suites[i+1];
-                result = SetCipherSpecs(ssl);
-                if (result == 0) {
-                    result = PickHashSigAlgo(ssl, peerSuites->hashSigAlgo,
-                                                     peerSuites->hashSigAlgoSz);
+        return MATCH_SUITE_ERROR;
+    }
+
+#ifdef WOLFSSL_SUITE_MAP
+    /* Match with one pass over the preferred list. The other list is looked
+     * up in its suite map. */
+    static int MatchSuiteMap(WOLFSSL* ssl, Suites* peerSuites)
+    {
+        int ret;
+        word16 i, j;
+
+        if (!ssl->suites->mapSet)
+            InitSuitesMap(ssl->suites);
+        InitSuitesMap(peerSuites);
+
+        if (!ssl->options.useClientOrder) {
+            /* Server order */
+            for (i = 0; i < ssl->suites->suiteSz; i += 2) {
+                if (!SuitesMapHas(peerSuites, ssl->suites->suites[i],
+                                              ssl->suites->suites[i+1])) {
+                    continue;
                 }
-                return result;
+                ret = UseServerSuite(ssl, peerSuites, i);
+                if (ret != MATCH_SUITE_ERROR)
+                    return ret;
             }
-            else {
-                WOLFSSL_MSG("Could not verify suite validity, continue");
+        }
+        else {
+            /* Client order */
+            for (j = 0; j < peerSuites->suiteSz; j += 2) {
+                if (!SuitesMapHas(ssl->suites, peerSuites->suites[j],
+                                               peerSuites->suites[j+1])) {
+                    continue;
+                }
+                for (i = 0; i < ssl->suites->suiteSz; i += 2) {
+                    ret = CompareSuites(ssl, peerSuites, i, j);
+                    if (ret != MATCH_SUITE_ERROR)
+                        return ret;
+                }
             }
         }
 
         return MATCH_SUITE_ERROR;
     }
+#endif
 
     int MatchSuite(WOLFSSL* ssl, Suites* peerSuites)
     {
+#ifndef WOLFSSL_SUITE_MAP
         int ret;
         word16 i, j;
+#endif
 
         WOLFSSL_ENTER("MatchSuite");
 
@@ -27788,6 +30614,9 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         if (ssl->suites == NULL)
             return SUITES_ERROR;
 
+#ifdef WOLFSSL_SUITE_MAP
+        return MatchSuiteMap(ssl, peerSuites);
+#else
         if (!ssl->options.useClientOrder) {
             /* Server order */
             for (i = 0; i < ssl->suites->suiteSz; i += 2) {
@@ -27810,6 +30639,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         }
 
         return MATCH_SUITE_ERROR;
+#endif /* WOLFSSL_SUITE_MAP */
     }
 #endif
 
@@ -27994,8 +30824,8 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                     return UNSUPPORTED_SUITE;
                 }
 
-                ret = wc_RNG_GenerateBlock(ssl->rng, ssl->arrays->serverRandom,
-                                                                       RAN_LEN);
+                ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
+                                        ssl->arrays->serverRandom, RAN_LEN);
                 if (ret != 0)
                     return ret;
 
@@ -28098,8 +30928,8 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                 return UNSUPPORTED_SUITE;
             }
 
-            ret = wc_RNG_GenerateBlock(ssl->rng, ssl->arrays->serverRandom,
-                                                                       RAN_LEN);
+            ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
+                                        ssl->arrays->serverRandom, RAN_LEN);
             if (ret != 0)
                 return ret;
 
@@ -29295,7 +32125,7 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         else {
 #ifdef WOLFSSL_TLS13
             /* Client adds to ticket age to obfuscate. */
-            ret = wc_RNG_GenerateBlock(ssl->rng, (byte*)&it.ageAdd,
+            ret = wc_RNG_GenerateBlock(GetSslRng(ssl), (byte*)&it.ageAdd,
                                                              sizeof(it.ageAdd));
             if (ret != 0)
                 return BAD_TICKET_ENCRYPT;
@@ -29926,7 +32756,7 @@ static int DefTicketEncCb(WOLFSSL* ssl, byte key_name[WOLFSSL_TICKET_NAME_SZ],
 
         /* Generate a new IV into buffer to be returned.
          * Don't use the RNG in keyCtx as it's for generating private data. */
-        ret = wc_RNG_GenerateBlock(ssl->rng, iv, WOLFSSL_TICKET_IV_SZ);
+        ret = wc_RNG_GenerateBlock(GetSslRng(ssl), iv, WOLFSSL_TICKET_IV_SZ);
         if (ret != 0) {
             return WOLFSSL_TICKET_RET_REJECT;
         }
@@ -30416,7 +33246,7 @@ static int DefTicketEncCb(WOLFSSL* ssl, byte key_name[WOLFSSL_TICKET_NAME_SZ],
                         }
 
                         /* pre-load PreMasterSecret with RNG data */
-                        ret = wc_RNG_GenerateBlock(ssl->rng,
+                        ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
                             &ssl->arrays->preMasterSecret[VERSION_SZ],
                             SECRET_LEN - VERSION_SZ);
                         if (ret != 0) {
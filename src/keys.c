@@ -3149,7 +3149,7 @@ int SetKeysSide(WOLFSSL* ssl, enum encrypt_side side)
     else
 #endif
     ret = SetKeys(wc_encrypt, wc_decrypt, keys, &ssl->specs, ssl->options.side,
-                  ssl->heap, ssl->devId, ssl->rng, ssl->options.tls1_3);
+                  ssl->heap, ssl->devId, GetSslRng(ssl), ssl->options.tls1_3);
 
 #ifdef HAVE_SECURE_RENEGOTIATION
 #ifdef WOLFSSL_DTLS
@@ -3514,7 +3514,8 @@ static int CleanPreMaster(WOLFSSL* ssl)
     for (i = 0; i < sz; i++)
         ssl->arrays->preMasterSecret[i] = 0;
 
-    ret = wc_RNG_GenerateBlock(ssl->rng, ssl->arrays->preMasterSecret, sz);
+    ret = wc_RNG_GenerateBlock(GetSslRng(ssl), ssl->arrays->preMasterSecret,
+                               sz);
     if (ret != 0)
         return ret;
 
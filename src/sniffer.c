@@ -842,6 +842,12 @@ static int HashCopy(HS_Hashes* d, HsHashes* s)
 #ifdef WOLFSSL_SHA384
     XMEMCPY(&d->hashSha384, &s->hashSha384, sizeof(wc_Sha384));
 #endif
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    /* copied hashes hold the whole transcript */
+    d->pendingSz = 0;
+    d->hashMask = HS_HASH_ALL;
+    d->deferred = 0;
+#endif
 
     return 0;
 }
@@ -546,6 +546,7 @@ WOLFSSL_ABI
 WOLFSSL* wolfSSL_new(WOLFSSL_CTX* ctx)
 {
     WOLFSSL* ssl = NULL;
+    WC_RNG*  rng = NULL;
     int ret = 0;
 
     (void)ret;
@@ -554,9 +555,13 @@ WOLFSSL* wolfSSL_new(WOLFSSL_CTX* ctx)
     if (ctx == NULL)
         return ssl;
 
-    ssl = (WOLFSSL*) XMALLOC(sizeof(WOLFSSL), ctx->heap, DYNAMIC_TYPE_SSL);
+#ifdef WOLFSSL_SSL_POOL
+    ssl = SSLPoolGet(ctx, &rng);
+    if (ssl == NULL)
+#endif
+        ssl = (WOLFSSL*) XMALLOC(sizeof(WOLFSSL), ctx->heap, DYNAMIC_TYPE_SSL);
     if (ssl)
-        if ( (ret = InitSSL(ssl, ctx, 0)) < 0) {
+        if ( (ret = InitSSL_ex(ssl, ctx, 0, rng)) < 0) {
             FreeSSL(ssl, ctx->heap);
             ssl = 0;
         }
@@ -570,8 +575,16 @@ WOLFSSL_ABI
 void wolfSSL_free(WOLFSSL* ssl)
 {
     WOLFSSL_ENTER("SSL_free");
-    if (ssl)
+    if (ssl) {
+        CTX_STATS_FAILED(ssl);
+    #ifdef WOLFSSL_SSL_POOL
+        if (SSLPoolPut(ssl) == 0) {
+            WOLFSSL_LEAVE("SSL_free", 0);
+            return;
+        }
+    #endif
         FreeSSL(ssl, ssl->ctx->heap);
+    }
     WOLFSSL_LEAVE("SSL_free", 0);
 }
 
@@ -699,6 +712,13 @@ WOLFSSL* wolfSSL_write_dup(WOLFSSL* ssl)
         return NULL;
     }
 
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx || ssl->options.ktlsRx) {
+        WOLFSSL_MSG("wolfSSL_write_dup not possible with kernel TLS");
+        return NULL;
+    }
+#endif
+
     dup = (WOLFSSL*) XMALLOC(sizeof(WOLFSSL), ssl->ctx->heap, DYNAMIC_TYPE_SSL);
     if (dup) {
         if ( (ret = InitSSL(dup, ssl->ctx, 1)) < 0) {
@@ -1434,7 +1454,7 @@ WOLFSSL_ABI
 WC_RNG* wolfSSL_GetRNG(WOLFSSL* ssl)
 {
     if (ssl) {
-        return ssl->rng;
+        return GetSslRng(ssl);
     }
 
     return NULL;
@@ -1953,6 +1973,7 @@ int wolfSSL_write(WOLFSSL* ssl, const void* data, int sz)
 {
     int ret;
 
+    WC_TRACE_OBJ(ssl);
     WOLFSSL_ENTER("SSL_write()");
 
     if (ssl == NULL || data == NULL || sz < 0)
@@ -2016,10 +2037,560 @@ int wolfSSL_write(WOLFSSL* ssl, const void* data, int sz)
         return ret;
 }
 
+#ifdef WOLFSSL_ZERO_COPY
+/* Reserve the next application data record in the output buffer. data is set
+ * to the plaintext area of the record, which the application fills directly
+ * before sealing it with wolfSSL_write_zero_copy_commit(). No other I/O may
+ * be done on the SSL in between.
+ * returns the number of bytes available at data on success and
+ *         WOLFSSL_FATAL_ERROR on failure (see wolfSSL_get_error()) */
+int wolfSSL_write_zero_copy_reserve(WOLFSSL* ssl, unsigned char** data)
+{
+    int ret;
+    byte* out = NULL;
+
+    WOLFSSL_ENTER("wolfSSL_write_zero_copy_reserve()");
+
+    if (ssl == NULL || data == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_WRITE_DUP
+    if (ssl->dupWrite && ssl->dupSide == READ_DUP_SIDE) {
+        WOLFSSL_MSG("Read dup side cannot write");
+        return WRITE_DUP_WRITE_E;
+    }
+#endif
+
+#ifdef HAVE_ERRNO_H
+    errno = 0;
+#endif
+
+    ret = SendDataReserve(ssl, &out);
+    if (ret > 0)
+        *data = out;
+
+    WOLFSSL_LEAVE("wolfSSL_write_zero_copy_reserve()", ret);
+
+    if (ret == BAD_STATE_E)
+        return ret;
+    if (ret < 0)
+        return WOLFSSL_FATAL_ERROR;
+    else
+        return ret;
+}
+
+
+/* Seal the first sz bytes written into the area from
+ * wolfSSL_write_zero_copy_reserve() as a record, in place, and send it.
+ * If sending would block the record stays queued, and if async crypto is
+ * pending (WC_PENDING_E) the reservation is kept; in both cases call again
+ * with the same sz to finish. A sz of 0 drops the reservation.
+ * returns sz on success and WOLFSSL_FATAL_ERROR on failure */
+int wolfSSL_write_zero_copy_commit(WOLFSSL* ssl, int sz)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_write_zero_copy_commit()");
+
+    if (ssl == NULL || sz < 0)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_ERRNO_H
+    errno = 0;
+#endif
+
+    ret = SendDataCommit(ssl, sz, 1);
+
+    WOLFSSL_LEAVE("wolfSSL_write_zero_copy_commit()", ret);
+
+    if (ret == BAD_FUNC_ARG || ret == BAD_STATE_E)
+        return ret;
+    if (ret < 0)
+        return WOLFSSL_FATAL_ERROR;
+    else
+        return ret;
+}
+
+#ifdef WOLFSSL_SENDFILE
+/* Send sz bytes of the regular file fd starting at offset as application
+ * data. The records are filled from the file directly, or with kernel TLS the
+ * kernel sends the file itself. The file position of fd is not changed.
+ * A short count is returned when sending would block, call again with offset
+ * and sz adjusted by it.
+ * returns the number of bytes sent and WOLFSSL_FATAL_ERROR on failure */
+int wolfSSL_sendfile(WOLFSSL* ssl, int fd, long offset, int sz)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_sendfile()");
+
+    if (ssl == NULL || fd < 0 || offset < 0 || sz < 0)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_WRITE_DUP
+    if (ssl->dupWrite && ssl->dupSide == READ_DUP_SIDE) {
+        WOLFSSL_MSG("Read dup side cannot write");
+        return WRITE_DUP_WRITE_E;
+    }
+#endif
+
+    if (sz == 0)
+        return 0;
+
+#ifdef HAVE_ERRNO_H
+    errno = 0;
+#endif
+
+    ret = SendFileData(ssl, fd, offset, sz);
+
+    WOLFSSL_LEAVE("wolfSSL_sendfile()", ret);
+
+    if (ret == BAD_FUNC_ARG || ret == BAD_STATE_E)
+        return ret;
+    if (ret < 0)
+        return WOLFSSL_FATAL_ERROR;
+    else
+        return ret;
+}
+#endif /* WOLFSSL_SENDFILE */
+#endif /* WOLFSSL_ZERO_COPY */
+
+#ifdef WOLFSSL_KTLS
+/* Have the kernel do the record layer of new connections once their handshake
+ * is done. dir is a mask of WOLFSSL_KTLS_TX and WOLFSSL_KTLS_RX, 0 turns it
+ * off. A connection stays in user space when the kernel can't take it.
+ * returns WOLFSSL_SUCCESS on success */
+int wolfSSL_CTX_UseKTLS(WOLFSSL_CTX* ctx, int dir)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_UseKTLS");
+
+    if (ctx == NULL || (dir & ~(WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX)) != 0)
+        return BAD_FUNC_ARG;
+
+    ctx->ktls = (byte)dir;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Have the kernel do the record layer of this connection. Before the handshake
+ * is done it gets installed when possible, after the handshake it is
+ * installed now.
+ * returns WOLFSSL_SUCCESS on success, KTLS_E when the kernel can't take the
+ * connection and BAD_STATE_E while data is buffered for the direction */
+int wolfSSL_UseKTLS(WOLFSSL* ssl, int dir)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_UseKTLS");
+
+    if (ssl == NULL || (dir & ~(WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX)) != 0)
+        return BAD_FUNC_ARG;
+
+    if (ssl->options.handShakeState != HANDSHAKE_DONE) {
+        ssl->options.ktls = (word16)dir;
+        return WOLFSSL_SUCCESS;
+    }
+
+    if ((dir & WOLFSSL_KTLS_TX) && !ssl->options.ktlsTx &&
+                            (ret = KtlsSetup(ssl, WOLFSSL_KTLS_TX)) != 0) {
+        WOLFSSL_LEAVE("wolfSSL_UseKTLS", ret);
+        return ret;
+    }
+    if ((dir & WOLFSSL_KTLS_RX) && !ssl->options.ktlsRx &&
+                            (ret = KtlsSetup(ssl, WOLFSSL_KTLS_RX)) != 0) {
+        WOLFSSL_LEAVE("wolfSSL_UseKTLS", ret);
+        return ret;
+    }
+    ssl->options.ktls = 0;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* returns the mask of directions the kernel does the record layer for */
+int wolfSSL_GetKTLS(WOLFSSL* ssl)
+{
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    return (ssl->options.ktlsTx ? WOLFSSL_KTLS_TX : 0) |
+           (ssl->options.ktlsRx ? WOLFSSL_KTLS_RX : 0);
+}
+#endif /* WOLFSSL_KTLS */
+
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+static int SetDynRecordCfg(DynRecordCfg* cfg, word16 smallSz, word32 rampBytes,
+                           word32 rampSec, word32 idleSec)
+{
+    if (smallSz > MAX_RECORD_SIZE)
+        return BAD_FUNC_ARG;
+
+    cfg->smallSz   = smallSz;
+    cfg->rampBytes = rampBytes;
+    cfg->rampSec   = rampSec;
+    cfg->idleSec   = idleSec;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Set the adaptive record size policy for connections made from ctx.
+ * smallSz of 0 turns the policy off */
+int wolfSSL_CTX_SetDynRecordSize(WOLFSSL_CTX* ctx, unsigned short smallSz,
+    unsigned int rampBytes, unsigned int rampSec, unsigned int idleSec)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_SetDynRecordSize");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    return SetDynRecordCfg(&ctx->dynRecord, smallSz, rampBytes, rampSec,
+                           idleSec);
+}
+
+/* Set the adaptive record size policy for ssl, the current burst starts over */
+int wolfSSL_SetDynRecordSize(WOLFSSL* ssl, unsigned short smallSz,
+    unsigned int rampBytes, unsigned int rampSec, unsigned int idleSec)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_SetDynRecordSize");
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = SetDynRecordCfg(&ssl->dynRecord.cfg, smallSz, rampBytes, rampSec,
+                          idleSec);
+    if (ret == WOLFSSL_SUCCESS) {
+        ssl->dynRecord.burstBytes = 0;
+        ssl->dynRecord.fullSize = 0;
+    }
+
+    return ret;
+}
+
+/* Copy out the record size counters of ssl */
+int wolfSSL_GetRecordSizeStats(WOLFSSL* ssl, WOLFSSL_RECORD_SIZE_STATS* stats)
+{
+    if (ssl == NULL || stats == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMCPY(stats, &ssl->dynRecord.stats, sizeof(WOLFSSL_RECORD_SIZE_STATS));
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_DYN_RECORD_SIZE */
+
+#ifdef WOLFSSL_READ_AHEAD
+/* Read as much as the transport has, up to sz bytes, into the input buffer of
+ * connections made from ctx once their handshake is done. 0 turns it off */
+int wolfSSL_CTX_UseReadAhead(WOLFSSL_CTX* ctx, unsigned int sz)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_UseReadAhead");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    ctx->readAheadSz = sz;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Read as much as the transport has, up to sz bytes, into the input buffer
+ * once the handshake is done. 0 turns it off */
+int wolfSSL_UseReadAhead(WOLFSSL* ssl, unsigned int sz)
+{
+    WOLFSSL_ENTER("wolfSSL_UseReadAhead");
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    ssl->readAheadSz = sz;
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_READ_AHEAD */
+
+#ifdef WOLFSSL_IO_POOL
+/* Have connections made from ctx borrow their record buffers from a shared
+ * pool keeping up to maxFree buffers free. 0 turns the pool off */
+int wolfSSL_CTX_UseIOBufferPool(WOLFSSL_CTX* ctx, unsigned int maxFree)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_UseIOBufferPool");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->ioPool.lock) != 0)
+        return BAD_MUTEX_E;
+    ctx->ioPool.maxFree = maxFree;
+    while (ctx->ioPool.freeCnt > maxFree) {
+        byte* buf = (byte*)ctx->ioPool.head;
+
+        XMEMCPY(&ctx->ioPool.head, buf, sizeof(void*));
+        XFREE(buf, ctx->heap, DYNAMIC_TYPE_IN_BUFFER);
+        ctx->ioPool.freeCnt--;
+    }
+    wc_UnLockMutex(&ctx->ioPool.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Get how many pooled buffers are lent out and how many are free */
+int wolfSSL_CTX_GetIOBufferPoolStats(WOLFSSL_CTX* ctx, unsigned int* inUse,
+                                     unsigned int* idle)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->ioPool.lock) != 0)
+        return BAD_MUTEX_E;
+    if (inUse != NULL)
+        *inUse = ctx->ioPool.inUse;
+    if (idle != NULL)
+        *idle = ctx->ioPool.freeCnt;
+    wc_UnLockMutex(&ctx->ioPool.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_IO_POOL */
+
+#ifdef WOLFSSL_SSL_POOL
+/* Keep up to maxFree objects released with wolfSSL_free() for wolfSSL_new()
+ * to reuse. 0 turns the pool off */
+int wolfSSL_CTX_UseSSLPool(WOLFSSL_CTX* ctx, unsigned int maxFree)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_UseSSLPool");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->sslPool.lock) != 0)
+        return BAD_MUTEX_E;
+    ctx->sslPool.maxFree = maxFree;
+    while (ctx->sslPool.freeCnt > maxFree) {
+        WOLFSSL* ssl = ctx->sslPool.head;
+
+        ctx->sslPool.head = ssl->poolNext;
+        if (ssl->rng != NULL) {
+            wc_FreeRng(ssl->rng);
+            XFREE(ssl->rng, ctx->heap, DYNAMIC_TYPE_RNG);
+        }
+        XFREE(ssl, ctx->heap, DYNAMIC_TYPE_SSL);
+        ctx->sslPool.freeCnt--;
+    }
+    wc_UnLockMutex(&ctx->sslPool.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Get how many wolfSSL_new() calls reused a pooled object, how many had to
+ * allocate one and how many objects are waiting on the free list */
+int wolfSSL_CTX_GetSSLPoolStats(WOLFSSL_CTX* ctx, unsigned int* hits,
+                                unsigned int* misses, unsigned int* idle)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->sslPool.lock) != 0)
+        return BAD_MUTEX_E;
+    if (hits != NULL)
+        *hits = ctx->sslPool.hits;
+    if (misses != NULL)
+        *misses = ctx->sslPool.misses;
+    if (idle != NULL)
+        *idle = ctx->sslPool.freeCnt;
+    wc_UnLockMutex(&ctx->sslPool.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_SSL_POOL */
+
+#ifdef WOLFSSL_KEYSHARE_POOL
+/* Keep count single use key pairs of group ready for handshakes of
+ * connections made from ctx. 0 stops keeping key pairs for the group */
+int wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, word16 group, int count)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_UseKeySharePool");
+
+    if (ctx == NULL || count < 0)
+        return BAD_FUNC_ARG;
+
+    ret = TLSX_KeySharePool_Set(ctx, group, count);
+    if (ret != 0)
+        return ret;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Generate up to max key pairs, 0 for as many as the pool is short of.
+ * Returns the number generated */
+int wolfSSL_CTX_RefillKeySharePool(WOLFSSL_CTX* ctx, int max)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_RefillKeySharePool");
+
+    if (ctx == NULL || max < 0)
+        return BAD_FUNC_ARG;
+
+    return TLSX_KeySharePool_Refill(ctx, max);
+}
+
+/* Get the number of key pairs of group ready */
+int wolfSSL_CTX_GetKeySharePoolCount(WOLFSSL_CTX* ctx, word16 group)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    return TLSX_KeySharePool_Count(ctx, group);
+}
+#endif /* WOLFSSL_KEYSHARE_POOL */
+
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+/* Record the handshake events of connections made from ctx from now on and
+ * add their times to the CTX histograms. Turning it on clears the histograms */
+int wolfSSL_CTX_SetHandshakeTiming(WOLFSSL_CTX* ctx, int on)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_SetHandshakeTiming");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->hsHist.lock) != 0)
+        return BAD_MUTEX_E;
+    if (on)
+        XMEMSET(ctx->hsHist.bucket, 0, sizeof(ctx->hsHist.bucket));
+    ctx->hsHist.on = (on != 0);
+    wc_UnLockMutex(&ctx->hsHist.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Record the handshake events of ssl, starting over when already on. Off
+ * drops what was recorded */
+int wolfSSL_SetHandshakeTiming(WOLFSSL* ssl, int on)
+{
+    WOLFSSL_ENTER("wolfSSL_SetHandshakeTiming");
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    if (on)
+        return (HsTimingInit(ssl) == 0) ? WOLFSSL_SUCCESS : MEMORY_E;
+
+    XFREE(ssl->hsTiming, ssl->heap, DYNAMIC_TYPE_INFO);
+    ssl->hsTiming = NULL;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Copy up to *count recorded events into events in the order they ended and
+ * set *count to the number copied. With events NULL *count is set to the
+ * number recorded */
+int wolfSSL_GetHandshakeEvents(WOLFSSL* ssl, WOLFSSL_HS_TIMING_EVENT* events,
+                               unsigned int* count)
+{
+    HsTiming* t;
+
+    if (ssl == NULL || count == NULL)
+        return BAD_FUNC_ARG;
+    t = ssl->hsTiming;
+    if (t == NULL)
+        return WOLFSSL_FAILURE;
+
+    if (events == NULL || *count > t->eventCnt)
+        *count = t->eventCnt;
+    if (events != NULL)
+        XMEMCPY(events, t->events, *count * sizeof(WOLFSSL_HS_TIMING_EVENT));
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Get the time in us the handshake spent in events of type. The sums
+ * WOLFSSL_HST_CRYPTO, WOLFSSL_HST_NETWORK and WOLFSSL_HST_TOTAL are made when
+ * the handshake is done */
+int wolfSSL_GetHandshakeTime(WOLFSSL* ssl, int type, unsigned int* us)
+{
+    if (ssl == NULL || us == NULL || type < 0 || type >= WOLFSSL_HST_TYPES)
+        return BAD_FUNC_ARG;
+    if (ssl->hsTiming == NULL)
+        return WOLFSSL_FAILURE;
+
+    *us = (unsigned int)(ssl->hsTiming->total[type] / 1000);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Copy up to *count buckets of the histogram of type, the count of finished
+ * handshakes by their time in events of type, and set *count to the number
+ * copied. Each finished handshake is counted once in every histogram */
+int wolfSSL_CTX_GetHandshakeHistogram(WOLFSSL_CTX* ctx, int type,
+                                      unsigned int* buckets,
+                                      unsigned int* count)
+{
+    if (ctx == NULL || buckets == NULL || count == NULL || type < 0 ||
+            type >= WOLFSSL_HST_TYPES)
+        return BAD_FUNC_ARG;
+
+    if (*count > WOLFSSL_HST_BUCKETS)
+        *count = WOLFSSL_HST_BUCKETS;
+    if (wc_LockMutex(&ctx->hsHist.lock) != 0)
+        return BAD_MUTEX_E;
+    XMEMCPY(buckets, ctx->hsHist.bucket[type], *count * sizeof(word32));
+    wc_UnLockMutex(&ctx->hsHist.lock);
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_HANDSHAKE_TIMING */
+
+#ifdef WOLFSSL_CTX_STATS
+/* Sum the counters of all shards of ctx into stats. Counters are read one at
+ * a time without stopping other threads so the snapshot isn't a single point
+ * in time, each counter only ever grows between clears */
+int wolfSSL_CTX_GetStats(WOLFSSL_CTX* ctx, WOLFSSL_STATS* stats)
+{
+    word64* out = (word64*)stats;
+    word32  n = sizeof(WOLFSSL_STATS) / sizeof(word64);
+    word32  i, j;
+
+    if (ctx == NULL || stats == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(stats, 0, sizeof(WOLFSSL_STATS));
+    for (j = 0; j < WOLFSSL_CTX_STATS_SHARDS; j++) {
+        word64* in = (word64*)&ctx->stats[j].s;
+
+        for (i = 0; i < n; i++)
+            out[i] += CTX_STATS_ATOMIC_LOAD(&in[i]);
+    }
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Zero the counters of ctx, counts made while clearing may be lost */
+int wolfSSL_CTX_ClearStats(WOLFSSL_CTX* ctx)
+{
+    word32 n = sizeof(WOLFSSL_STATS) / sizeof(word64);
+    word32 i, j;
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    for (j = 0; j < WOLFSSL_CTX_STATS_SHARDS; j++) {
+        word64* in = (word64*)&ctx->stats[j].s;
+
+        for (i = 0; i < n; i++)
+            CTX_STATS_ATOMIC_STORE(&in[i], 0);
+    }
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_CTX_STATS */
+
 static int wolfSSL_read_internal(WOLFSSL* ssl, void* data, int sz, int peek)
 {
     int ret;
 
+    WC_TRACE_OBJ(ssl);
     WOLFSSL_ENTER("wolfSSL_read_internal()");
 
     if (ssl == NULL || data == NULL || sz < 0)
@@ -2102,6 +2673,71 @@ int wolfSSL_read(WOLFSSL* ssl, void* data, int sz)
 }
 
 
+#ifdef WOLFSSL_ZERO_COPY
+/* Read the next chunk of application data without copying it.
+ * data is set to the decrypted plaintext inside the SSL input buffer. It is
+ * valid until wolfSSL_read_zero_copy_done() is called, which must happen
+ * before any other read on this SSL. Calling again before the release hands
+ * back the same data.
+ * returns number of bytes available on success, 0 on close and
+ *         WOLFSSL_FATAL_ERROR on failure (see wolfSSL_get_error()) */
+int wolfSSL_read_zero_copy(WOLFSSL* ssl, const unsigned char** data)
+{
+    int ret;
+    byte* out = NULL;
+
+    WOLFSSL_ENTER("wolfSSL_read_zero_copy()");
+
+    if (ssl == NULL || data == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_WRITE_DUP
+    if (ssl->dupWrite && ssl->dupSide == WRITE_DUP_SIDE) {
+        WOLFSSL_MSG("Write dup side cannot read");
+        return WRITE_DUP_READ_E;
+    }
+#endif
+
+#ifdef HAVE_ERRNO_H
+    errno = 0;
+#endif
+
+#ifdef WOLFSSL_DTLS
+    if (ssl->options.dtls)
+        ssl->dtls_expected_rx = max(MAX_RECORD_SIZE + 100, MAX_MTU);
+#endif
+
+    ret = ReceiveDataZeroCopy(ssl, &out);
+    if (ret > 0)
+        *data = out;
+
+    WOLFSSL_LEAVE("wolfSSL_read_zero_copy()", ret);
+
+    if (ret < 0)
+        return WOLFSSL_FATAL_ERROR;
+    else
+        return ret;
+}
+
+
+/* Release sz bytes of the data returned by wolfSSL_read_zero_copy(). Once all
+ * of it is released the record buffer is recycled.
+ * returns WOLFSSL_SUCCESS on success */
+int wolfSSL_read_zero_copy_done(WOLFSSL* ssl, int sz)
+{
+    WOLFSSL_ENTER("wolfSSL_read_zero_copy_done()");
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    if (ReceiveDataZeroCopyDone(ssl, sz) != 0)
+        return BAD_FUNC_ARG;
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_ZERO_COPY */
+
+
 #ifdef WOLFSSL_MULTICAST
 
 int wolfSSL_mcast_read(WOLFSSL* ssl, word16* id, void* data, int sz)
@@ -2712,6 +3348,13 @@ static int _Rehandshake(WOLFSSL* ssl)
     if (ssl == NULL)
         return BAD_FUNC_ARG;
 
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx || ssl->options.ktlsRx) {
+        WOLFSSL_MSG("Can't renegotiate once kernel TLS is installed");
+        return KTLS_E;
+    }
+#endif
+
     if (ssl->secure_renegotiation == NULL) {
         WOLFSSL_MSG("Secure Renegotiation not forced on by user");
         return SECURE_RENEGOTIATION_E;
@@ -2746,9 +3389,14 @@ static int _Rehandshake(WOLFSSL* ssl)
 #ifndef NO_FORCE_SCR_SAME_SUITE
         /* force same suite */
         if (ssl->suites) {
+            if (AllocateSuites(ssl) != 0)
+                return MEMORY_E;
             ssl->suites->suiteSz = SUITE_LEN;
             ssl->suites->suites[0] = ssl->options.cipherSuite0;
             ssl->suites->suites[1] = ssl->options.cipherSuite;
+        #ifdef WOLFSSL_SUITE_MAP
+            InitSuitesMap(ssl->suites);
+        #endif
         }
 #endif
 
@@ -3078,6 +3726,7 @@ WOLFSSL_ABI
 int wolfSSL_shutdown(WOLFSSL* ssl)
 {
     int  ret = WOLFSSL_FATAL_ERROR;
+    WC_TRACE_OBJ(ssl);
     WOLFSSL_ENTER("SSL_shutdown()");
 
     if (ssl == NULL)
@@ -3308,6 +3957,90 @@ int wolfSSL_FreeHandshakeResources(WOLFSSL* ssl)
     return 0;
 }
 
+/* Release everything an established connection does not need to protect
+ * records: what FreeHandshakeResources() frees, negotiation only extensions
+ * and the record buffers when nothing is pending in them.
+ *
+ * ssl       The SSL/TLS object.
+ * retained  Set to the bytes of memory still held by the connection when not
+ *           NULL.
+ * returns BAD_FUNC_ARG when ssl is NULL, BAD_STATE_E when the handshake is not
+ * done and WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_CompactResources(WOLFSSL* ssl, unsigned int* retained)
+{
+    WOLFSSL_ENTER("wolfSSL_CompactResources");
+
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+    if (ssl->options.handShakeState != HANDSHAKE_DONE)
+        return BAD_STATE_E;
+
+#ifdef WOLFSSL_DTLS
+    if (!ssl->options.dtls || !ssl->options.dtlsHsRetain)
+#endif
+        FreeHandshakeResources(ssl);
+    CompactResources(ssl);
+
+    if (retained != NULL) {
+        WOLFSSL_MEM_FOOTPRINT fp;
+
+        ResourcesFootprint(ssl, &fp);
+        *retained = fp.total;
+    }
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Set whether connections compact their resources when the handshake is done.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * on   1 to compact and 0 to only free the handshake resources.
+ * returns BAD_FUNC_ARG when ctx is NULL and WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_CTX_SetAutoCompact(WOLFSSL_CTX* ctx, int on)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    ctx->autoCompact = (on != 0);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Set whether the connection compacts its resources when the handshake is
+ * done.
+ *
+ * ssl  The SSL/TLS object.
+ * on   1 to compact and 0 to only free the handshake resources.
+ * returns BAD_FUNC_ARG when ssl is NULL and WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_SetAutoCompact(WOLFSSL* ssl, int on)
+{
+    if (ssl == NULL)
+        return BAD_FUNC_ARG;
+
+    ssl->options.autoCompact = (on != 0);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Get the memory held by the connection by what it is used for.
+ *
+ * ssl  The SSL/TLS object.
+ * fp   Filled with the bytes per category and their total.
+ * returns BAD_FUNC_ARG when ssl or fp is NULL and WOLFSSL_SUCCESS otherwise.
+ */
+int wolfSSL_GetMemFootprint(WOLFSSL* ssl, WOLFSSL_MEM_FOOTPRINT* fp)
+{
+    if (ssl == NULL || fp == NULL)
+        return BAD_FUNC_ARG;
+
+    ResourcesFootprint(ssl, fp);
+
+    return WOLFSSL_SUCCESS;
+}
+
 /* Use the client's order of preference when matching cipher suites.
  *
  * ssl  The SSL/TLS context object.
@@ -4063,6 +4796,20 @@ int wolfSSL_pending(WOLFSSL* ssl)
 }
 
 
+/* returns 1 if decrypted data or unprocessed records are buffered, with
+ * read ahead there can be records to read even when the socket is empty */
+int wolfSSL_has_pending(const WOLFSSL* ssl)
+{
+    WOLFSSL_ENTER("wolfSSL_has_pending");
+
+    if (ssl == NULL)
+        return 0;
+
+    return ssl->buffers.clearOutputBuffer.length > 0 ||
+           ssl->buffers.inputBuffer.idx < ssl->buffers.inputBuffer.length;
+}
+
+
 #ifndef WOLFSSL_LEANPSK
 /* turn on handshake group messages for context */
 int wolfSSL_CTX_set_group_messages(WOLFSSL_CTX* ctx)
@@ -5164,6 +5911,9 @@ static int ProcessUserChain(WOLFSSL_CTX* ctx, const unsigned char* buff,
             #ifdef WOLFSSL_TLS13
                 ctx->certChainCnt = cnt;
             #endif
+            #ifdef WOLFSSL_CERT_MSG_CACHE
+                SetCtxCertMsgCache(ctx);
+            #endif
             }
         }
 
@@ -5605,6 +6355,9 @@ int ProcessBuffer(WOLFSSL_CTX* ctx, const unsigned char* buff,
             }
         #endif
             ctx->certificate = der;
+        #ifdef WOLFSSL_CERT_MSG_CACHE
+            SetCtxCertMsgCache(ctx);
+        #endif
         }
     }
     else if (type == PRIVATEKEY_TYPE) {
@@ -5617,6 +6370,9 @@ int ProcessBuffer(WOLFSSL_CTX* ctx, const unsigned char* buff,
             ssl->buffers.weOwnKey = 1;
         }
         else if (ctx) {
+        #ifdef WOLFSSL_PRIVKEY_CACHE
+            FreeCtxPrivateKeyCache(ctx);
+        #endif
             FreeDer(&ctx->privateKey);
             ctx->privateKey = der;
         }
@@ -5974,6 +6730,11 @@ int ProcessBuffer(WOLFSSL_CTX* ctx, const unsigned char* buff,
                    ssl->options.side);
     }
 
+#ifdef WOLFSSL_PRIVKEY_CACHE
+    if (type == PRIVATEKEY_TYPE && ssl == NULL && ctx != NULL)
+        SetCtxPrivateKeyCache(ctx);
+#endif
+
     return WOLFSSL_SUCCESS;
 }
 
@@ -12003,17 +12764,8 @@ int wolfSSL_CTX_set_cipher_list(WOLFSSL_CTX* ctx, const char* list)
 int wolfSSL_set_cipher_list(WOLFSSL* ssl, const char* list)
 {
     WOLFSSL_ENTER("wolfSSL_set_cipher_list");
-#ifdef SINGLE_THREADED
-    if (ssl->ctx->suites == ssl->suites) {
-        ssl->suites = (Suites*)XMALLOC(sizeof(Suites), ssl->heap,
-                                       DYNAMIC_TYPE_SUITES);
-        if (ssl->suites == NULL) {
-            WOLFSSL_MSG("Suites Memory error");
-            return MEMORY_E;
-        }
-        ssl->options.ownSuites = 1;
-    }
-#endif
+    if (AllocateSuites(ssl) != 0)
+        return MEMORY_E;
 
 #ifdef OPENSSL_EXTRA
     return wolfSSL_parse_cipher_list(ssl->ctx, ssl->suites, list);
@@ -12357,7 +13109,7 @@ int wolfSSL_DTLS_SetCookieSecret(WOLFSSL* ssl,
 
     /* If the supplied secret is NULL, randomly generate a new secret. */
     if (secret == NULL) {
-        ret = wc_RNG_GenerateBlock(ssl->rng,
+        ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
                              ssl->buffers.dtlsCookieSecret.buffer, secretSz);
     }
     else
@@ -12505,6 +13257,7 @@ int wolfSSL_DTLS_SetCookieSecret(WOLFSSL* ssl,
         int neededState;
     #endif
 
+        WC_TRACE_OBJ(ssl);
         WOLFSSL_ENTER("SSL_connect()");
 
         #ifdef HAVE_ERRNO_H
@@ -12765,6 +13518,9 @@ int wolfSSL_DTLS_SetCookieSecret(WOLFSSL* ssl,
             FALL_THROUGH;
 
         case SECOND_REPLY_DONE:
+            HS_TIMING_DONE(ssl);
+            CTX_STATS_DONE(ssl);
+            WC_TRACE(WC_TRACE_HS_DONE, ssl, NULL, ssl->options.resuming);
         #ifndef NO_HANDSHAKE_DONE_CB
             if (ssl->hsDoneCb) {
                 int cbret = ssl->hsDoneCb(ssl, ssl->hsDoneCtx);
@@ -12886,6 +13642,7 @@ int wolfSSL_DTLS_SetCookieSecret(WOLFSSL* ssl,
         word16 haveMcast = 0;
 #endif
 
+        WC_TRACE_OBJ(ssl);
         if (ssl == NULL)
             return WOLFSSL_FATAL_ERROR;
 
@@ -13156,6 +13913,9 @@ int wolfSSL_DTLS_SetCookieSecret(WOLFSSL* ssl,
             FALL_THROUGH;
 
         case ACCEPT_THIRD_REPLY_DONE :
+            HS_TIMING_DONE(ssl);
+            CTX_STATS_DONE(ssl);
+            WC_TRACE(WC_TRACE_HS_DONE, ssl, NULL, ssl->options.resuming);
 #ifndef NO_HANDSHAKE_DONE_CB
             if (ssl->hsDoneCb) {
                 int cbret = ssl->hsDoneCb(ssl, ssl->hsDoneCtx);
@@ -14074,7 +14834,7 @@ WOLFSSL_X509* wolfSSL_SESSION_get0_peer(WOLFSSL_SESSION* session)
         int count;
 
         count = wolfSSL_get_chain_count(&session->chain);
-        if (count < 1 || count >= MAX_CHAIN_DEPTH) {
+        if (count < 1 || count > MAX_SESSION_CHAIN_DEPTH) {
             WOLFSSL_MSG("bad count found");
             return NULL;
         }
@@ -14814,6 +15574,9 @@ int wolfSSL_set_compression(WOLFSSL* ssl)
     {
         int ret = WOLFSSL_FAILURE;
 
+    #ifdef WOLFSSL_PRIVKEY_CACHE
+        FreeCtxPrivateKeyCache(ctx);
+    #endif
         FreeDer(&ctx->privateKey);
         if (AllocDer(&ctx->privateKey, (word32)sz, PRIVATEKEY_TYPE,
                                                               ctx->heap) == 0) {
@@ -14836,6 +15599,9 @@ int wolfSSL_set_compression(WOLFSSL* ssl)
         int ret = WOLFSSL_FAILURE;
         word32 sz = (word32)XSTRLEN(label) + 1;
 
+    #ifdef WOLFSSL_PRIVKEY_CACHE
+        FreeCtxPrivateKeyCache(ctx);
+    #endif
         FreeDer(&ctx->privateKey);
         if (AllocDer(&ctx->privateKey, (word32)sz, PRIVATEKEY_TYPE,
                                                               ctx->heap) == 0) {
@@ -18236,6 +19002,11 @@ size_t wolfSSL_get_client_random(const WOLFSSL* ssl, unsigned char* out,
         #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
             wc_Sha512SetFlags(&ssl->hsHashes->hashSha512, WC_HASH_FLAG_WILLCOPY);
         #endif
+#endif
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+            ssl->hsHashes->pendingSz = 0;
+            ssl->hsHashes->hashMask = HS_HASH_ALL;
+            ssl->hsHashes->deferred = 1;
 #endif
         }
 #ifdef SESSION_CERTS
@@ -29656,6 +30427,9 @@ long wolfSSL_CTX_add_extra_chain_cert(WOLFSSL_CTX* ctx, WOLFSSL_X509* x509)
         if (ret == 0) {
             XMEMCPY(ctx->certChain->buffer, chain, idx);
         }
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        SetCtxCertMsgCache(ctx);
+    #endif
     }
 
     /* on success WOLFSSL_X509 memory is responsibility of ctx */
@@ -29730,6 +30504,9 @@ int wolfSSL_CTX_set_read_ahead(WOLFSSL_CTX* ctx, int v)
     }
 
     ctx->readAhead = (byte)v;
+#ifdef WOLFSSL_READ_AHEAD
+    ctx->readAheadSz = v ? WOLFSSL_READ_AHEAD_SZ : 0;
+#endif
 
     return WOLFSSL_SUCCESS;
 }
@@ -31242,6 +32019,10 @@ WOLFSSL_SESSION* wolfSSL_d2i_SSL_SESSION(WOLFSSL_SESSION** sess,
         goto end;
     }
     s->chain.count = data[idx++];
+    if (s->chain.count > MAX_SESSION_CHAIN_DEPTH) {
+        ret = BUFFER_ERROR;
+        goto end;
+    }
     for (j = 0; j < s->chain.count; j++) {
         if (i - idx < OPAQUE16_LEN) {
             ret = BUFFER_ERROR;
@@ -31249,7 +32030,7 @@ WOLFSSL_SESSION* wolfSSL_d2i_SSL_SESSION(WOLFSSL_SESSION** sess,
         }
         ato16(data + idx, &length); idx += OPAQUE16_LEN;
         s->chain.certs[j].length = length;
-        if (i - idx < length) {
+        if (i - idx < length || length > MAX_X509_SIZE) {
             ret = BUFFER_ERROR;
             goto end;
         }
@@ -32291,6 +33072,13 @@ int wolfSSL_RAND_bytes(unsigned char* buf, int num)
         wc_UnLockMutex(&gRandMethodMutex);
     }
 #endif
+#ifdef WC_THREAD_RNG
+    /* the calling thread's DRBG, no lock needed */
+    if ((rng = wc_GetThreadRng()) != NULL) {
+        WOLFSSL_MSG("Using thread RNG");
+    }
+    else
+#endif
 #ifdef HAVE_GLOBAL_RNG
     if (initGlobalRNG) {
         if (wc_LockMutex(&globalRNGMutex) != 0) {
@@ -44016,6 +44804,9 @@ err:
 
         XMEMCPY(ctx->certificate->buffer, x->derCert->buffer,
                 x->derCert->length);
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        SetCtxCertMsgCache(ctx);
+    #endif
 #ifdef KEEP_OUR_CERT
         if (ctx->ourCert != NULL && ctx->ownOurCert) {
             wolfSSL_X509_free(ctx->ourCert);
@@ -45736,6 +46527,9 @@ long wolfSSL_CTX_ctrl(WOLFSSL_CTX* ctx, int cmd, long opt, void* pt)
         }
         /* Clear certificate chain */
         FreeDer(&ctx->certChain);
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        SetCtxCertMsgCache(ctx);
+    #endif
         if (sk) {
             for (i = 0; i < wolfSSL_sk_X509_num(sk); i++) {
                 x509 = wolfSSL_sk_X509_value(sk, i);
@@ -48286,6 +49080,27 @@ int wolfSSL_CTX_AsyncPoll(WOLFSSL_CTX* ctx, WOLF_EVENT** events, int maxEvents,
                                         events, maxEvents, flags, eventCount);
 }
 
+/* eventfd readable while async operations of ctx have completed */
+int wolfSSL_CTX_AsyncGetFd(WOLFSSL_CTX* ctx)
+{
+    if (ctx == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    return wolfEventQueue_GetFd(&ctx->event_queue);
+}
+
+int wolfSSL_CTX_AsyncDrain(WOLFSSL_CTX* ctx, WOLF_EVENT** events,
+    int maxEvents, int* eventCount)
+{
+    if (ctx == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    return wolfEventQueue_Drain(&ctx->event_queue, events, maxEvents,
+                                eventCount);
+}
+
 int wolfSSL_AsyncPoll(WOLFSSL* ssl, WOLF_EVENT_FLAG flags)
 {
     int ret, eventCount = 0;
@@ -48434,6 +49249,11 @@ WOLF_STACK_OF(WOLFSSL_CIPHER) *wolfSSL_get_ciphers_compat(const WOLFSSL *ssl)
     }
 
     if (ssl->suites != NULL) {
+    #ifdef WOLFSSL_SHARED_SUITES
+        /* the stack is cached in the suites, keep it out of the CTX's */
+        if (ssl->suites->stack == NULL && AllocateSuites((WOLFSSL*)ssl) != 0)
+            return NULL;
+    #endif
         if (ssl->suites->suiteSz == 0 &&
                 InitSSL_Suites((WOLFSSL*)ssl) != WOLFSSL_SUCCESS) {
             WOLFSSL_MSG("Suite initialization failure");
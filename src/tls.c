@@ -165,6 +165,11 @@ int BuildTlsHandshakeHash(WOLFSSL* ssl, byte* hash, word32* hashLen)
     if (ssl == NULL || hash == NULL || hashLen == NULL || *hashLen < HSHASH_SZ)
         return BAD_FUNC_ARG;
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     /* for constant timing perform these even if error */
 #ifndef NO_OLD_TLS
     ret |= wc_Md5GetHash(&ssl->hsHashes->hashMd5, hash);
@@ -1313,6 +1318,15 @@ static WC_INLINE word16 TLSX_ToSemaphore(word16 type)
 #define TURN_OFF(semaphore, light) \
     ((semaphore)[(light) / 8] &= (byte) ~(0x01 << ((light) % 8)))
 
+/**
+ * Converts the extension type to a light in the set of types present in a
+ * list. Every node holds the lights of its own type and of the types in the
+ * nodes after it, so a lookup stops at the first node whose light is off.
+ * Types sharing a light only make the lookup walk further.
+ */
+#define TLSX_PRESENT_LIGHT(type) \
+    (TLSX_ToSemaphore(type) % (TLSX_PRESENT_SZ * 8))
+
 /** Creates a new extension. */
 static TLSX* TLSX_New(TLSX_Type type, const void* data, void* heap)
 {
@@ -1325,6 +1339,8 @@ static TLSX* TLSX_New(TLSX_Type type, const void* data, void* heap)
         extension->data = (void*)data;
         extension->resp = 0;
         extension->next = NULL;
+        XMEMSET(extension->present, 0, sizeof(extension->present));
+        TURN_ON(extension->present, TLSX_PRESENT_LIGHT(type));
     }
 
     return extension;
@@ -1344,6 +1360,11 @@ static int TLSX_Push(TLSX** list, TLSX_Type type, const void* data, void* heap)
     /* pushes the new extension on the list. */
     extension->next = *list;
     *list = extension;
+    if (extension->next != NULL) {
+        int i;
+        for (i = 0; i < TLSX_PRESENT_SZ; i++)
+            extension->present[i] |= extension->next->present[i];
+    }
 
     /* remove duplicate extensions, there should be only one of each type. */
     do {
@@ -1381,6 +1402,8 @@ static int TLSX_Prepend(TLSX** list, TLSX_Type type, void* data, void* heap)
 
     /* remove duplicate extensions, there should be only one of each type. */
     while (curr && curr->next) {
+        /* the new extension goes after every node */
+        TURN_ON(curr->present, TLSX_PRESENT_LIGHT(type));
         if (curr->next->type == type) {
             TLSX *next = curr->next;
 
@@ -1392,8 +1415,10 @@ static int TLSX_Prepend(TLSX** list, TLSX_Type type, void* data, void* heap)
         curr = curr->next;
     }
 
-    if (curr)
+    if (curr) {
+        TURN_ON(curr->present, TLSX_PRESENT_LIGHT(type));
         curr->next = extension;
+    }
     else
         *list = extension;
 
@@ -6659,11 +6684,15 @@ static int TLSX_SetSignatureAlgorithmsCert(TLSX** extensions, const void* data,
 /* Create a key share entry using named Diffie-Hellman parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
+ * ssl   The SSL/TLS object, NULL when generating for the CTX pool.
+ * heap  The heap to allocate the key share data with.
+ * devId The device to generate the key with.
+ * rng   The random number generator to use.
  * kse   The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, void* heap, int devId,
+                                 WC_RNG* rng, KeyShareEntry* kse)
 {
     int             ret;
 #ifndef NO_DH
@@ -6678,6 +6707,8 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
     DhKey           dhKey[1];
 #endif
 
+    (void)ssl;
+
     /* TODO: [TLS13] The key size should come from wolfcrypt. */
     /* Pick the parameters from the named group. */
     switch (kse->group) {
@@ -6716,28 +6747,28 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
 #ifdef WOLFSSL_SMALL_STACK
-    dhKey = (DhKey*)XMALLOC(sizeof(DhKey), ssl->heap, DYNAMIC_TYPE_DH);
+    dhKey = (DhKey*)XMALLOC(sizeof(DhKey), heap, DYNAMIC_TYPE_DH);
     if (dhKey == NULL)
         return MEMORY_E;
 #endif
 
-    ret = wc_InitDhKey_ex(dhKey, ssl->heap, ssl->devId);
+    ret = wc_InitDhKey_ex(dhKey, heap, devId);
     if (ret != 0) {
     #ifdef WOLFSSL_SMALL_STACK
-        XFREE(dhKey, ssl->heap, DYNAMIC_TYPE_DH);
+        XFREE(dhKey, heap, DYNAMIC_TYPE_DH);
     #endif
         return ret;
     }
 
     /* Allocate space for the public key */
     dataSz = params->p_len;
-    keyData = (byte*)XMALLOC(dataSz, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    keyData = (byte*)XMALLOC(dataSz, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         ret = MEMORY_E;
         goto end;
     }
     /* Allocate space for the private key */
-    key = (byte*)XMALLOC(keySz, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+    key = (byte*)XMALLOC(keySz, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     if (key == NULL) {
         ret = MEMORY_E;
         goto end;
@@ -6750,7 +6781,7 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
         goto end;
 
 #if defined(WOLFSSL_STATIC_EPHEMERAL) && defined(WOLFSSL_DH_EXTRA)
-    if (ssl->staticKE.dhKey) {
+    if (ssl != NULL && ssl->staticKE.dhKey) {
         DerBuffer* keyDer = ssl->staticKE.dhKey;
         word32 idx = 0;
         WOLFSSL_MSG("Using static DH key");
@@ -6763,7 +6794,7 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
 #endif
     {
         /* Generate a new key pair */
-        ret = wc_DhGenerateKeyPair(dhKey, ssl->rng, (byte*)key, &keySz, keyData,
+        ret = wc_DhGenerateKeyPair(dhKey, rng, (byte*)key, &keySz, keyData,
                                 &dataSz);
     #ifdef WOLFSSL_ASYNC_CRYPT
         /* TODO: Make this function non-blocking */
@@ -6795,18 +6826,21 @@ end:
 
     wc_FreeDhKey(dhKey);
 #ifdef WOLFSSL_SMALL_STACK
-    XFREE(dhKey, ssl->heap, DYNAMIC_TYPE_DH);
+    XFREE(dhKey, heap, DYNAMIC_TYPE_DH);
 #endif
 
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         if (key != NULL)
-            XFREE(key, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            XFREE(key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     }
 #else
     (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6818,11 +6852,15 @@ end:
 /* Create a key share entry using X25519 parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
+ * ssl   The SSL/TLS object, NULL when generating for the CTX pool.
+ * heap  The heap to allocate the key share data with.
+ * devId The device to generate the key with.
+ * rng   The random number generator to use.
  * kse   The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, void* heap, int devId,
+                                 WC_RNG* rng, KeyShareEntry* kse)
 {
     int             ret;
 #ifdef HAVE_CURVE25519
@@ -6830,8 +6868,11 @@ static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
     word32          dataSize = CURVE25519_KEYSIZE;
     curve25519_key* key;
 
+    (void)ssl;
+    (void)devId;
+
     /* Allocate an ECC key to hold private key. */
-    key = (curve25519_key*)XMALLOC(sizeof(curve25519_key), ssl->heap,
+    key = (curve25519_key*)XMALLOC(sizeof(curve25519_key), heap,
                                                       DYNAMIC_TYPE_PRIVATE_KEY);
     if (key == NULL) {
         WOLFSSL_MSG("EccTempKey Memory error");
@@ -6842,12 +6883,12 @@ static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
     ret = wc_curve25519_init(key);
     if (ret != 0)
         goto end;
-    ret = wc_curve25519_make_key(ssl->rng, CURVE25519_KEYSIZE, key);
+    ret = wc_curve25519_make_key(rng, CURVE25519_KEYSIZE, key);
     if (ret != 0)
         goto end;
 
     /* Allocate space for the public key. */
-    keyData = (byte*)XMALLOC(CURVE25519_KEYSIZE, ssl->heap,
+    keyData = (byte*)XMALLOC(CURVE25519_KEYSIZE, heap,
                                                        DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         WOLFSSL_MSG("Key data Memory error");
@@ -6875,12 +6916,15 @@ end:
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         wc_curve25519_free(key);
-        XFREE(key, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+        XFREE(key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     }
 #else
     (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6892,11 +6936,15 @@ end:
 /* Create a key share entry using X448 parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
+ * ssl   The SSL/TLS object, NULL when generating for the CTX pool.
+ * heap  The heap to allocate the key share data with.
+ * devId The device to generate the key with.
+ * rng   The random number generator to use.
  * kse   The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenX448Key(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenX448Key(WOLFSSL *ssl, void* heap, int devId,
+                                 WC_RNG* rng, KeyShareEntry* kse)
 {
     int             ret;
 #ifdef HAVE_CURVE448
@@ -6904,8 +6952,11 @@ static int TLSX_KeyShare_GenX448Key(WOLFSSL *ssl, KeyShareEntry* kse)
     word32          dataSize = CURVE448_KEY_SIZE;
     curve448_key*   key;
 
+    (void)ssl;
+    (void)devId;
+
     /* Allocate an ECC key to hold private key. */
-    key = (curve448_key*)XMALLOC(sizeof(curve448_key), ssl->heap,
+    key = (curve448_key*)XMALLOC(sizeof(curve448_key), heap,
                                                       DYNAMIC_TYPE_PRIVATE_KEY);
     if (key == NULL) {
         WOLFSSL_MSG("EccTempKey Memory error");
@@ -6916,12 +6967,12 @@ static int TLSX_KeyShare_GenX448Key(WOLFSSL *ssl, KeyShareEntry* kse)
     ret = wc_curve448_init(key);
     if (ret != 0)
         goto end;
-    ret = wc_curve448_make_key(ssl->rng, CURVE448_KEY_SIZE, key);
+    ret = wc_curve448_make_key(rng, CURVE448_KEY_SIZE, key);
     if (ret != 0)
         goto end;
 
     /* Allocate space for the public key. */
-    keyData = (byte*)XMALLOC(CURVE448_KEY_SIZE, ssl->heap,
+    keyData = (byte*)XMALLOC(CURVE448_KEY_SIZE, heap,
                                                        DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         WOLFSSL_MSG("Key data Memory error");
@@ -6949,12 +7000,15 @@ end:
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         wc_curve448_free(key);
-        XFREE(key, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+        XFREE(key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     }
 #else
     (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6966,11 +7020,15 @@ end:
 /* Create a key share entry using named elliptic curve parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
+ * ssl   The SSL/TLS object, NULL when generating for the CTX pool.
+ * heap  The heap to allocate the key share data with.
+ * devId The device to generate the key with.
+ * rng   The random number generator to use.
  * kse   The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, void* heap, int devId,
+                                 WC_RNG* rng, KeyShareEntry* kse)
 {
     int      ret;
 #ifdef HAVE_ECC
@@ -6981,6 +7039,8 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
     ecc_key* eccKey;
     word16   curveId;
 
+    (void)ssl;
+
     /* TODO: [TLS13] The key sizes should come from wolfcrypt. */
     /* Translate named group to a curve id. */
     switch (kse->group) {
@@ -7022,7 +7082,7 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
     /* Allocate an ECC key to hold private key. */
-    keyPtr = (byte*)XMALLOC(sizeof(ecc_key), ssl->heap,
+    keyPtr = (byte*)XMALLOC(sizeof(ecc_key), heap,
                                                       DYNAMIC_TYPE_PRIVATE_KEY);
     if (keyPtr == NULL) {
         WOLFSSL_MSG("EccTempKey Memory error");
@@ -7031,12 +7091,12 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
     eccKey = (ecc_key*)keyPtr;
 
     /* Make an ECC key. */
-    ret = wc_ecc_init_ex(eccKey, ssl->heap, ssl->devId);
+    ret = wc_ecc_init_ex(eccKey, heap, devId);
     if (ret != 0)
         goto end;
 
 #ifdef WOLFSSL_STATIC_EPHEMERAL
-    if (ssl->staticKE.ecKey) {
+    if (ssl != NULL && ssl->staticKE.ecKey) {
         DerBuffer* keyDer = ssl->staticKE.ecKey;
         word32 idx = 0;
         WOLFSSL_MSG("Using static ECDH key");
@@ -7046,7 +7106,7 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
 #endif
     {
         /* Generate ephemeral ECC key */
-        ret = wc_ecc_make_key_ex(ssl->rng, keySize, eccKey, curveId);
+        ret = wc_ecc_make_key_ex(rng, keySize, eccKey, curveId);
     #ifdef WOLFSSL_ASYNC_CRYPT
         /* TODO: Make this function non-blocking */
         if (ret == WC_PENDING_E) {
@@ -7058,7 +7118,7 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
         goto end;
 
     /* Allocate space for the public key. */
-    keyData = (byte*)XMALLOC(dataSize, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    keyData = (byte*)XMALLOC(dataSize, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         WOLFSSL_MSG("Key data Memory error");
         ret = MEMORY_E;
@@ -7084,12 +7144,15 @@ end:
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyPtr != NULL)
-            XFREE(keyPtr, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            XFREE(keyPtr, heap, DYNAMIC_TYPE_PRIVATE_KEY);
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     }
 #else
     (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -7098,21 +7161,53 @@ end:
     return ret;
 }
 
-/* Generate a secret/key using the key share entry.
+/* Generate a key pair for the named group of the key share entry.
  *
- * ssl  The SSL/TLS object.
- * kse  The key share entry holding peer data.
+ * ssl   The SSL/TLS object, NULL when generating for the CTX pool.
+ * heap  The heap to allocate the key share data with.
+ * devId The device to generate the key with.
+ * rng   The random number generator to use.
+ * kse   The key share entry object.
+ * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenKey(WOLFSSL *ssl, KeyShareEntry *kse)
+static int TLSX_KeyShare_GenGroupKey(WOLFSSL *ssl, void* heap, int devId,
+                                     WC_RNG* rng, KeyShareEntry *kse)
 {
     /* Named FFHE groups have a bit set to identify them. */
     if ((kse->group & NAMED_DH_MASK) == NAMED_DH_MASK)
-        return TLSX_KeyShare_GenDhKey(ssl, kse);
+        return TLSX_KeyShare_GenDhKey(ssl, heap, devId, rng, kse);
     if (kse->group == WOLFSSL_ECC_X25519)
-        return TLSX_KeyShare_GenX25519Key(ssl, kse);
+        return TLSX_KeyShare_GenX25519Key(ssl, heap, devId, rng, kse);
     if (kse->group == WOLFSSL_ECC_X448)
-        return TLSX_KeyShare_GenX448Key(ssl, kse);
-    return TLSX_KeyShare_GenEccKey(ssl, kse);
+        return TLSX_KeyShare_GenX448Key(ssl, heap, devId, rng, kse);
+    return TLSX_KeyShare_GenEccKey(ssl, heap, devId, rng, kse);
+}
+
+#ifdef WOLFSSL_KEYSHARE_POOL
+static int TLSX_KeySharePool_Take(WOLFSSL* ssl, KeyShareEntry* kse);
+#endif
+
+/* Generate a secret/key using the key share entry.
+ *
+ * ssl  The SSL/TLS object.
+ * kse  The key share entry holding peer data.
+ */
+static int TLSX_KeyShare_GenKey(WOLFSSL *ssl, KeyShareEntry *kse)
+{
+    int ret;
+
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_KEY_GEN);
+#ifdef WOLFSSL_KEYSHARE_POOL
+    /* Use a key pair generated ahead of time when one is ready. */
+    if (TLSX_KeySharePool_Take(ssl, kse) == 0)
+        ret = 0;
+    else
+#endif
+        ret = TLSX_KeyShare_GenGroupKey(ssl, ssl->heap, ssl->devId,
+                                        GetSslRng(ssl), kse);
+    HS_TIMING_END(ssl, WOLFSSL_HST_KEY_GEN, 0, 0);
+
+    return ret;
 }
 
 /* Free the key share dynamic data.
@@ -7153,6 +7248,345 @@ static void TLSX_KeyShare_FreeAll(KeyShareEntry* list, void* heap)
     (void)heap;
 }
 
+#ifdef WOLFSSL_KEYSHARE_POOL
+/* Find the slot of the key share pool kept for a named group.
+ *
+ * pool   The CTX key share pool.
+ * group  The named group.
+ * returns the slot or NULL when the group has none.
+ */
+static KeySharePoolGroup* TLSX_KeySharePool_Find(KeySharePool* pool,
+                                                 word16 group)
+{
+    int i;
+
+    for (i = 0; i < KEYSHARE_POOL_GROUPS; i++) {
+        if (pool->groups[i].group == group && group != 0)
+            return &pool->groups[i];
+    }
+
+    return NULL;
+}
+
+/* Take a key pair of the named group off the CTX key share pool.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * group  The named group.
+ * returns the key share entry holding the key pair or NULL when none ready.
+ */
+static KeyShareEntry* TLSX_KeySharePool_Pop(WOLFSSL_CTX* ctx, word16 group)
+{
+    KeySharePoolGroup* slot;
+    KeyShareEntry*     kse = NULL;
+
+    if (wc_LockMutex(&ctx->ksPool.lock) != 0)
+        return NULL;
+    slot = TLSX_KeySharePool_Find(&ctx->ksPool, group);
+    if (slot != NULL && slot->head != NULL) {
+        kse = slot->head;
+        slot->head = kse->next;
+        slot->count--;
+        kse->next = NULL;
+    }
+    wc_UnLockMutex(&ctx->ksPool.lock);
+
+    return kse;
+}
+
+/* Check whether a key pair generated for the CTX can stand in for one the
+ * connection would generate. Keys for another heap or device and static
+ * ephemeral keys cannot.
+ *
+ * ssl  The SSL/TLS object.
+ * returns 1 when pooled key pairs can be used and 0 otherwise.
+ */
+static int TLSX_KeySharePool_CanUse(WOLFSSL* ssl)
+{
+    if (ssl->heap != ssl->ctx->heap || ssl->devId != ssl->ctx->devId)
+        return 0;
+#ifdef WOLFSSL_STATIC_EPHEMERAL
+    #ifndef NO_DH
+    if (ssl->staticKE.dhKey != NULL)
+        return 0;
+    #endif
+    #ifdef HAVE_ECC
+    if (ssl->staticKE.ecKey != NULL)
+        return 0;
+    #endif
+#endif
+
+    return 1;
+}
+
+/* Move a pre-generated key pair into the key share entry.
+ * Each key pair is handed out once.
+ *
+ * ssl  The SSL/TLS object.
+ * kse  The key share entry object.
+ * returns 0 on success and BAD_STATE_E when no key pair is ready.
+ */
+static int TLSX_KeySharePool_Take(WOLFSSL* ssl, KeyShareEntry* kse)
+{
+    KeyShareEntry* pooled;
+
+    if (!TLSX_KeySharePool_CanUse(ssl))
+        return BAD_STATE_E;
+    pooled = TLSX_KeySharePool_Pop(ssl->ctx, kse->group);
+    if (pooled == NULL)
+        return BAD_STATE_E;
+
+    WOLFSSL_MSG("Using pre-generated key share");
+    kse->key = pooled->key;
+    kse->keyLen = pooled->keyLen;
+    kse->pubKey = pooled->pubKey;
+    kse->pubKeyLen = pooled->pubKeyLen;
+    XFREE(pooled, ssl->heap, DYNAMIC_TYPE_TLSX);
+
+    return 0;
+}
+
+/* Set the ephemeral ECDH key of a TLS v1.2 connection from the CTX key share
+ * pool when a key pair for the negotiated curve is ready.
+ *
+ * ssl  The SSL/TLS object.
+ * returns 0 when the key was set and BAD_STATE_E otherwise.
+ */
+int TLSX_KeySharePool_TempKey(WOLFSSL* ssl)
+{
+    KeyShareEntry* pooled;
+    word16         group;
+    byte           keyType;
+
+    if (ssl->eccTempKey != NULL || ssl->eccTempKeyPresent != 0 ||
+            !TLSX_KeySharePool_CanUse(ssl)) {
+        return BAD_STATE_E;
+    }
+
+    switch (ssl->ecdhCurveOID) {
+    #ifdef HAVE_CURVE25519
+        case ECC_X25519_OID:
+        #if defined(HAVE_PK_CALLBACKS) && defined(HAVE_ECC)
+            if (ssl->ctx->X25519KeyGenCb != NULL)
+                return BAD_STATE_E;
+        #endif
+            group = WOLFSSL_ECC_X25519;
+            keyType = DYNAMIC_TYPE_CURVE25519;
+            break;
+    #endif
+    #ifdef HAVE_CURVE448
+        case ECC_X448_OID:
+        #if defined(HAVE_PK_CALLBACKS) && defined(HAVE_ECC)
+            if (ssl->ctx->X448KeyGenCb != NULL)
+                return BAD_STATE_E;
+        #endif
+            group = WOLFSSL_ECC_X448;
+            keyType = DYNAMIC_TYPE_CURVE448;
+            break;
+    #endif
+    #ifdef HAVE_ECC
+        case ECC_SECP256R1_OID:
+        case ECC_SECP384R1_OID:
+        case ECC_SECP521R1_OID:
+        #ifdef HAVE_PK_CALLBACKS
+            if (ssl->ctx->EccKeyGenCb != NULL)
+                return BAD_STATE_E;
+        #endif
+            if (ssl->ecdhCurveOID == ECC_SECP256R1_OID)
+                group = WOLFSSL_ECC_SECP256R1;
+            else if (ssl->ecdhCurveOID == ECC_SECP384R1_OID)
+                group = WOLFSSL_ECC_SECP384R1;
+            else
+                group = WOLFSSL_ECC_SECP521R1;
+            keyType = DYNAMIC_TYPE_ECC;
+            break;
+    #endif
+        default:
+            return BAD_STATE_E;
+    }
+
+    pooled = TLSX_KeySharePool_Pop(ssl->ctx, group);
+    if (pooled == NULL)
+        return BAD_STATE_E;
+
+    WOLFSSL_MSG("Using pre-generated ECDHE key");
+    ssl->eccTempKey = (ecc_key*)pooled->key;
+    ssl->eccTempKeyPresent = keyType;
+    ssl->namedGroup = 0;
+    /* Public key is exported again when writing ServerKeyExchange. */
+    XFREE(pooled->pubKey, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    XFREE(pooled, ssl->heap, DYNAMIC_TYPE_TLSX);
+
+    return 0;
+}
+
+/* Set the number of key pairs of a named group to keep ready.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * group  The named group.
+ * count  The number of key pairs to keep ready. 0 removes the group.
+ * returns 0 on success, BAD_FUNC_ARG when the group is not supported and
+ * BAD_STATE_E when all slots are used by other groups.
+ */
+int TLSX_KeySharePool_Set(WOLFSSL_CTX* ctx, word16 group, int count)
+{
+    KeySharePoolGroup* slot;
+    KeyShareEntry*     drop = NULL;
+    int                ret = 0;
+    int                i;
+
+    if (!TLSX_KeyShare_IsSupported(group) || count < 0 || count > 0xFFFF)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ctx->ksPool.lock) != 0)
+        return BAD_MUTEX_E;
+    slot = TLSX_KeySharePool_Find(&ctx->ksPool, group);
+    if (slot == NULL && count > 0) {
+        for (i = 0; i < KEYSHARE_POOL_GROUPS; i++) {
+            if (ctx->ksPool.groups[i].group == 0) {
+                slot = &ctx->ksPool.groups[i];
+                slot->group = group;
+                break;
+            }
+        }
+        if (slot == NULL)
+            ret = BAD_STATE_E;
+    }
+    if (slot != NULL) {
+        slot->target = (word16)count;
+        if (count == 0) {
+            drop = slot->head;
+            XMEMSET(slot, 0, sizeof(*slot));
+        }
+        else {
+            /* Drop key pairs beyond the new target. */
+            KeyShareEntry** next = &slot->head;
+
+            for (i = 0; i < count && *next != NULL; i++)
+                next = &(*next)->next;
+            drop = *next;
+            *next = NULL;
+            if (slot->count > count)
+                slot->count = (word16)count;
+        }
+    }
+    wc_UnLockMutex(&ctx->ksPool.lock);
+
+    TLSX_KeyShare_FreeAll(drop, ctx->heap);
+
+    return ret;
+}
+
+/* Generate key pairs until each group of the pool has its target ready.
+ * The lock is not held while generating so connections keep taking keys.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * max  The most key pairs to generate. 0 for no limit.
+ * returns the number of key pairs generated or a negative error.
+ */
+int TLSX_KeySharePool_Refill(WOLFSSL_CTX* ctx, int max)
+{
+    WC_RNG         rng;
+    KeyShareEntry* kse;
+    word16         group;
+    int            made = 0;
+    int            ret;
+    int            i;
+
+#ifndef HAVE_FIPS
+    ret = wc_InitRng_ex(&rng, ctx->heap, ctx->devId);
+#else
+    ret = wc_InitRng(&rng);
+#endif
+    if (ret != 0)
+        return ret;
+
+    for (i = 0; i < KEYSHARE_POOL_GROUPS && (max == 0 || made < max); ) {
+        if (wc_LockMutex(&ctx->ksPool.lock) != 0) {
+            ret = BAD_MUTEX_E;
+            break;
+        }
+        group = ctx->ksPool.groups[i].group;
+        if (ctx->ksPool.groups[i].count >= ctx->ksPool.groups[i].target)
+            group = 0;
+        wc_UnLockMutex(&ctx->ksPool.lock);
+        if (group == 0) {
+            i++;
+            continue;
+        }
+
+        kse = (KeyShareEntry*)XMALLOC(sizeof(KeyShareEntry), ctx->heap,
+                                      DYNAMIC_TYPE_TLSX);
+        if (kse == NULL) {
+            ret = MEMORY_E;
+            break;
+        }
+        XMEMSET(kse, 0, sizeof(*kse));
+        kse->group = group;
+        ret = TLSX_KeyShare_GenGroupKey(NULL, ctx->heap, ctx->devId, &rng, kse);
+        if (ret != 0) {
+            TLSX_KeyShare_FreeAll(kse, ctx->heap);
+            break;
+        }
+
+        /* Slot may have been changed while generating. */
+        if (wc_LockMutex(&ctx->ksPool.lock) != 0) {
+            TLSX_KeyShare_FreeAll(kse, ctx->heap);
+            ret = BAD_MUTEX_E;
+            break;
+        }
+        if (ctx->ksPool.groups[i].group == group &&
+                ctx->ksPool.groups[i].count < ctx->ksPool.groups[i].target) {
+            kse->next = ctx->ksPool.groups[i].head;
+            ctx->ksPool.groups[i].head = kse;
+            ctx->ksPool.groups[i].count++;
+            kse = NULL;
+            made++;
+        }
+        wc_UnLockMutex(&ctx->ksPool.lock);
+        TLSX_KeyShare_FreeAll(kse, ctx->heap);
+    }
+
+    wc_FreeRng(&rng);
+
+    return (ret != 0) ? ret : made;
+}
+
+/* Get the number of key pairs of a named group ready in the pool.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * group  The named group.
+ * returns the number of key pairs ready.
+ */
+int TLSX_KeySharePool_Count(WOLFSSL_CTX* ctx, word16 group)
+{
+    KeySharePoolGroup* slot;
+    int                count = 0;
+
+    if (wc_LockMutex(&ctx->ksPool.lock) != 0)
+        return BAD_MUTEX_E;
+    slot = TLSX_KeySharePool_Find(&ctx->ksPool, group);
+    if (slot != NULL)
+        count = slot->count;
+    wc_UnLockMutex(&ctx->ksPool.lock);
+
+    return count;
+}
+
+/* Free all the key pairs of the CTX key share pool.
+ *
+ * ctx  The SSL/TLS CTX object.
+ */
+void TLSX_KeySharePool_Free(WOLFSSL_CTX* ctx)
+{
+    int i;
+
+    for (i = 0; i < KEYSHARE_POOL_GROUPS; i++) {
+        TLSX_KeyShare_FreeAll(ctx->ksPool.groups[i].head, ctx->heap);
+        XMEMSET(&ctx->ksPool.groups[i], 0, sizeof(ctx->ksPool.groups[i]));
+    }
+}
+#endif /* WOLFSSL_KEYSHARE_POOL */
+
 /* Get the size of the encoded key share extension.
  *
  * list     The linked list of key share extensions.
@@ -7588,7 +8022,7 @@ static int TLSX_KeyShare_ProcessEcc(WOLFSSL* ssl, KeyShareEntry* keyShareEntry)
 #if defined(ECC_TIMING_RESISTANT) && (!defined(HAVE_FIPS) || \
     (!defined(HAVE_FIPS_VERSION) || (HAVE_FIPS_VERSION != 2))) && \
     !defined(HAVE_SELFTEST)
-    ret = wc_ecc_set_rng(keyShareKey, ssl->rng);
+    ret = wc_ecc_set_rng(keyShareKey, GetSslRng(ssl));
     if (ret != 0) {
         return ret;
     }
@@ -7644,6 +8078,7 @@ static int TLSX_KeyShare_Process(WOLFSSL* ssl, KeyShareEntry* keyShareEntry)
 #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
     ssl->session.namedGroup = (byte)keyShareEntry->group;
 #endif
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_SHARED_SECRET);
     /* Use Key Share Data from server. */
     if (keyShareEntry->group & NAMED_DH_MASK)
         ret = TLSX_KeyShare_ProcessDh(ssl, keyShareEntry);
@@ -7653,6 +8088,7 @@ static int TLSX_KeyShare_Process(WOLFSSL* ssl, KeyShareEntry* keyShareEntry)
         ret = TLSX_KeyShare_ProcessX448(ssl, keyShareEntry);
     else
         ret = TLSX_KeyShare_ProcessEcc(ssl, keyShareEntry);
+    HS_TIMING_END(ssl, WOLFSSL_HST_SHARED_SECRET, 0, 0);
 
 #ifdef WOLFSSL_DEBUG_TLS
     WOLFSSL_MSG("KE Secret");
@@ -9230,11 +9666,16 @@ int TLSX_EarlyData_Use(WOLFSSL* ssl, word32 maxSz)
 TLSX* TLSX_Find(TLSX* list, TLSX_Type type)
 {
     TLSX* extension = list;
+    word16 light = TLSX_PRESENT_LIGHT(type);
 
-    while (extension && extension->type != type)
+    /* types not in the rest of the list are found missing straight away */
+    while (extension && !IS_OFF(extension->present, light)) {
+        if (extension->type == type)
+            return extension;
         extension = extension->next;
+    }
 
-    return extension;
+    return NULL;
 }
 
 /** Remove an extension. */
@@ -392,6 +392,11 @@ static int DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
     word32      protocolLen;
     int         digestAlg = 0;
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if (includeMsgs && (ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     switch (hashAlgo) {
     #ifndef NO_SHA256
         case sha256_mac:
@@ -1059,6 +1064,11 @@ static int BuildTls13HandshakeHmac(WOLFSSL* ssl, byte* key, byte* hash,
         return BAD_FUNC_ARG;
     }
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     /* Get the hash of the previous handshake messages. */
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
@@ -1618,6 +1628,8 @@ static void AddTls13Headers(byte* output, word32 length, byte type,
 
     AddTls13RecordHeader(output, length + lengthAdj, handshake, ssl);
     AddTls13HandShakeHeader(output + outputAdj, length, 0, length, type, ssl);
+    HS_TIMING_END(ssl, WOLFSSL_HST_MSG_SEND, type, 0);
+    WC_TRACE(WC_TRACE_HS_SEND, ssl, NULL, type);
 }
 
 
@@ -1641,6 +1653,8 @@ static void AddTls13FragHeaders(byte* output, word32 fragSz, word32 fragOffset,
     AddTls13RecordHeader(output, fragSz + lengthAdj, handshake, ssl);
     AddTls13HandShakeHeader(output + outputAdj, length, fragOffset, fragSz,
                             type, ssl);
+    HS_TIMING_END(ssl, WOLFSSL_HST_MSG_SEND, type, 0);
+    WC_TRACE(WC_TRACE_HS_SEND, ssl, NULL, type);
 }
 #endif /* NO_CERTS */
 
@@ -2586,6 +2600,11 @@ int RestartHandshakeHash(WOLFSSL* ssl)
 #endif
 
     ret = InitHandshakeHashes(ssl);
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    /* cipher suite is fixed by the HelloRetryRequest */
+    if (ret == 0)
+        ret = SelectHandshakeHashes(ssl);
+#endif
     if (ret != 0)
         return ret;
     ret = HashRaw(ssl, header, sizeof(header));
@@ -2893,7 +2912,7 @@ int SendTls13ClientHello(WOLFSSL* ssl)
 
     /* Client Random */
     if (ssl->options.connectState == CONNECT_BEGIN) {
-        ret = wc_RNG_GenerateBlock(ssl->rng, output + idx, RAN_LEN);
+        ret = wc_RNG_GenerateBlock(GetSslRng(ssl), output + idx, RAN_LEN);
         if (ret != 0)
             return ret;
 
@@ -3052,6 +3071,7 @@ int DoTls13ServerHello(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         /* Update counts to reflect change of message type. */
         ssl->msgsReceived.got_hello_retry_request++;
         ssl->msgsReceived.got_server_hello--;
+        CTX_STATS_ADD(ssl, helloRetries, 1);
     }
 
     /* Server random - keep for debugging. */
@@ -3222,6 +3242,11 @@ int DoTls13ServerHello(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
     }
 #endif
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = SelectHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     if (*extMsgType == server_hello) {
         ssl->keys.encryptionOn = 1;
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
@@ -3429,15 +3454,29 @@ static int DoTls13CertificateRequest(WOLFSSL* ssl, const byte* input,
  *
  * ssl         SSL/TLS object.
  * peerSuites  The peer's advertised list of supported cipher suites.
+ * returns 0 on success, otherwise failure.
  */
-static void RefineSuites(WOLFSSL* ssl, Suites* peerSuites)
+static int RefineSuites(WOLFSSL* ssl, Suites* peerSuites)
 {
     byte   suites[WOLFSSL_MAX_SUITE_SZ];
     word16 suiteSz = 0;
-    word16 i, j;
+    word16 i;
+#ifndef WOLFSSL_SUITE_MAP
+    word16 j;
+#endif
 
     XMEMSET(suites, 0, WOLFSSL_MAX_SUITE_SZ);
 
+#ifdef WOLFSSL_SUITE_MAP
+    InitSuitesMap(peerSuites);
+    for (i = 0; i < ssl->suites->suiteSz; i += 2) {
+        if (SuitesMapHas(peerSuites, ssl->suites->suites[i+0],
+                                     ssl->suites->suites[i+1])) {
+            suites[suiteSz++] = ssl->suites->suites[i+0];
+            suites[suiteSz++] = ssl->suites->suites[i+1];
+        }
+    }
+#else
     for (i = 0; i < ssl->suites->suiteSz; i += 2) {
         for (j = 0; j < peerSuites->suiteSz; j += 2) {
             if (ssl->suites->suites[i+0] == peerSuites->suites[j+0] &&
@@ -3447,9 +3486,17 @@ static void RefineSuites(WOLFSSL* ssl, Suites* peerSuites)
             }
         }
     }
+#endif
 
+    if (AllocateSuites(ssl) != 0)
+        return MEMORY_E;
     ssl->suites->suiteSz = suiteSz;
     XMEMCPY(ssl->suites->suites, &suites, sizeof(suites));
+#ifdef WOLFSSL_SUITE_MAP
+    InitSuitesMap(ssl->suites);
+#endif
+
+    return 0;
 }
 
 /* Handle any Pre-Shared Key (PSK) extension.
@@ -4193,7 +4240,9 @@ int DoTls13ClientHello(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
                                                     defined(HAVE_TLS_EXTENSIONS)
     if (TLSX_Find(ssl->extensions, TLSX_PRE_SHARED_KEY) != NULL) {
         /* Refine list for PSK processing. */
-        RefineSuites(ssl, &clSuites);
+        ret = RefineSuites(ssl, &clSuites);
+        if (ret != 0)
+            return ret;
 
         /* Process the Pre-Shared Key extension if present. */
         ret = DoPreSharedKeys(ssl, input + begin, helloSz, &usingPSK);
@@ -4288,10 +4337,16 @@ int SendTls13ServerHello(WOLFSSL* ssl, byte extMsgType)
     WOLFSSL_START(WC_FUNC_SERVER_HELLO_SEND);
     WOLFSSL_ENTER("SendTls13ServerHello");
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = SelectHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     if (extMsgType == hello_retry_request) {
         WOLFSSL_MSG("wolfSSL Doing HelloRetryRequest");
         if ((ret = RestartHandshakeHash(ssl)) < 0)
             return ret;
+        CTX_STATS_ADD(ssl, helloRetries, 1);
     }
 
     /* Protocol version, server random, session id, cipher suite, compression
@@ -4321,7 +4376,8 @@ int SendTls13ServerHello(WOLFSSL* ssl, byte extMsgType)
 
     if (extMsgType == server_hello) {
         /* Generate server random. */
-        if ((ret = wc_RNG_GenerateBlock(ssl->rng, output + idx, RAN_LEN)) != 0)
+        if ((ret = wc_RNG_GenerateBlock(GetSslRng(ssl), output + idx,
+                                        RAN_LEN)) != 0)
             return ret;
     }
     else {
@@ -4508,8 +4564,11 @@ static int SendTls13CertificateRequest(WOLFSSL* ssl, byte* reqCtx,
     WOLFSSL_START(WC_FUNC_CERTIFICATE_REQUEST_SEND);
     WOLFSSL_ENTER("SendTls13CertificateRequest");
 
-    if (ssl->options.side == WOLFSSL_SERVER_END)
+    if (ssl->options.side == WOLFSSL_SERVER_END) {
+        if (AllocateSuites(ssl) != 0)
+            return MEMORY_E;
         InitSuitesHashSigAlgo(ssl->suites, 1, 1, 0, 1, ssl->buffers.keySz);
+    }
 
     ext = TLSX_Find(ssl->extensions, TLSX_SIGNATURE_ALGORITHMS);
     if (ext == NULL)
@@ -4680,6 +4739,12 @@ static WC_INLINE int DecodeTls13SigAlg(byte* input, byte* hashAlgo,
 static WC_INLINE int GetMsgHash(WOLFSSL* ssl, byte* hash)
 {
     int ret = 0;
+
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+#endif
+
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
         case sha256_mac:
@@ -5014,6 +5079,63 @@ static word32 AddCertExt(WOLFSSL* ssl, byte* cert, word32 len, word16 extSz,
     return i;
 }
 
+#ifdef WOLFSSL_CERT_MSG_CACHE
+/* Encode the certificate list of the CTX once, when the certificates are
+ * loaded, with each certificate followed by empty extensions. Sending the
+ * Certificate message is then a copy of the list.
+ *
+ * ctx  The SSL/TLS CTX object.
+ */
+void SetCtxCertMsgCache(WOLFSSL_CTX* ctx)
+{
+    DerBuffer* cert = ctx->certificate;
+    DerBuffer* chain = ctx->certChain;
+    word32     sz;
+    word32     len;
+    word32     idx = 0;
+    byte*      out;
+
+    FreeDer(&ctx->certMsg);
+    if (cert == NULL || cert->length == 0)
+        return;
+
+    /* Leaf certificate and extensions length. */
+    sz = CERT_HEADER_SZ + cert->length + OPAQUE16_LEN;
+    /* Chain has a length before each certificate already. */
+    if (chain != NULL) {
+        while (idx + CERT_HEADER_SZ <= chain->length) {
+            c24to32(chain->buffer + idx, &len);
+            idx += CERT_HEADER_SZ + len;
+            sz += CERT_HEADER_SZ + len + OPAQUE16_LEN;
+        }
+        if (idx != chain->length) {
+            WOLFSSL_MSG("Certificate chain not cached, bad length");
+            return;
+        }
+    }
+
+    if (AllocDer(&ctx->certMsg, sz, CERT_TYPE, ctx->heap) != 0)
+        return;
+    out = ctx->certMsg->buffer;
+
+    c32to24(cert->length, out);
+    out += CERT_HEADER_SZ;
+    XMEMCPY(out, cert->buffer, cert->length);
+    out += cert->length;
+    *out++ = 0;
+    *out++ = 0;
+    if (chain != NULL) {
+        idx = 0;
+        while ((len = NextCert(chain->buffer, chain->length, &idx)) != 0) {
+            XMEMCPY(out, chain->buffer + idx - len, len);
+            out += len;
+            *out++ = 0;
+            *out++ = 0;
+        }
+    }
+}
+#endif /* WOLFSSL_CERT_MSG_CACHE */
+
 /* handle generation TLS v1.3 certificate (11) */
 /* Send the certificate for this end and any CAs that help with validation.
  * This message is always encrypted in TLS v1.3.
@@ -5033,6 +5155,9 @@ static int SendTls13Certificate(WOLFSSL* ssl)
     byte*  p = NULL;
     byte   certReqCtxLen = 0;
     byte*  certReqCtx = NULL;
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    DerBuffer* certMsg = NULL;
+#endif
 
     WOLFSSL_START(WC_FUNC_CERTIFICATE_SEND);
     WOLFSSL_ENTER("SendTls13Certificate");
@@ -5095,6 +5220,23 @@ static int SendTls13Certificate(WOLFSSL* ssl)
         }
         else
             certChainSz = 0;
+
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        /* Send the list encoded when loaded into the CTX when the leaf
+         * certificate has no extensions. */
+        if (extSz == OPAQUE16_LEN && ssl->ctx->certMsg != NULL &&
+                ssl->buffers.certificate == ssl->ctx->certificate &&
+                ssl->buffers.certChain == ssl->ctx->certChain) {
+            certMsg = ssl->ctx->certMsg;
+            /* Leaf certificate length is in the encoded list. */
+            headerSz -= CERT_HEADER_SZ;
+            certSz = 0;
+            extSz = 0;
+            certChainSz = certMsg->length;
+            listSz = certMsg->length;
+            length = headerSz + listSz;
+        }
+    #endif
     }
 
     payloadSz = length;
@@ -5174,6 +5316,19 @@ static int SendTls13Certificate(WOLFSSL* ssl)
             if (ssl->fragOffset == certSz + extSz)
                 FreeDer(&ssl->buffers.certExts);
         }
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        if (certMsg != NULL) {
+            /* Put in as much of the encoded list as fits in the fragment. */
+            word32 copySz = min(certMsg->length - ssl->fragOffset, fragSz);
+
+            XMEMCPY(output + i, certMsg->buffer + ssl->fragOffset, copySz);
+            i += copySz;
+            ssl->fragOffset += copySz;
+            length -= copySz;
+            fragSz -= copySz;
+        }
+        else
+    #endif
         if (certChainSz > 0 && fragSz > 0) {
             /* Put in the CA certificates with empty extensions. */
             while (fragSz > 0) {
@@ -5389,7 +5544,7 @@ static int SendTls13CertificateVerify(WOLFSSL* ssl)
             else {
                 ERROR_OUT(ALGO_ID_E, exit_scv);
             }
-            EncodeSigAlg(ssl->suites->hashAlgo, args->sigAlgo, args->verify);
+            EncodeSigAlg(ssl->options.hashAlgo, args->sigAlgo, args->verify);
 
             if (ssl->hsType == DYNAMIC_TYPE_RSA) {
                 int sigLen = MAX_SIG_DATA_SZ;
@@ -5422,7 +5577,7 @@ static int SendTls13CertificateVerify(WOLFSSL* ssl)
                 }
 
                 ret = CreateRSAEncodedSig(sig->buffer, args->sigData,
-                    args->sigDataSz, args->sigAlgo, ssl->suites->hashAlgo);
+                    args->sigDataSz, args->sigAlgo, ssl->options.hashAlgo);
                 if (ret < 0)
                     goto exit_scv;
                 sig->length = ret;
@@ -5437,7 +5592,7 @@ static int SendTls13CertificateVerify(WOLFSSL* ssl)
                 sig->length = args->sendSz - args->idx - HASH_SIG_SIZE -
                               VERIFY_HEADER;
                 ret = CreateECCEncodedSig(args->sigData,
-                    args->sigDataSz, ssl->suites->hashAlgo);
+                    args->sigDataSz, ssl->options.hashAlgo);
                 if (ret < 0)
                     goto exit_scv;
                 args->sigDataSz = (word16)ret;
@@ -5517,7 +5672,7 @@ static int SendTls13CertificateVerify(WOLFSSL* ssl)
             if (ssl->hsType == DYNAMIC_TYPE_RSA) {
                 ret = RsaSign(ssl, sig->buffer, (word32)sig->length,
                     args->verify + HASH_SIG_SIZE + VERIFY_HEADER, &args->sigLen,
-                    args->sigAlgo, ssl->suites->hashAlgo,
+                    args->sigAlgo, ssl->options.hashAlgo,
                     (RsaKey*)ssl->hsKey,
                     ssl->buffers.key
                 );
@@ -5551,7 +5706,7 @@ static int SendTls13CertificateVerify(WOLFSSL* ssl)
                 /* check for signature faults */
                 ret = VerifyRsaSign(ssl, args->sigData, args->sigLen,
                     sig->buffer, (word32)sig->length, args->sigAlgo,
-                    ssl->suites->hashAlgo, (RsaKey*)ssl->hsKey,
+                    ssl->options.hashAlgo, (RsaKey*)ssl->hsKey,
                     ssl->buffers.key
                 );
             }
@@ -5656,7 +5811,9 @@ static int DoTls13Certificate(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     WOLFSSL_START(WC_FUNC_CERTIFICATE_DO);
     WOLFSSL_ENTER("DoTls13Certificate");
 
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_CERT_VERIFY);
     ret = ProcessPeerCerts(ssl, input, inOutIdx, totalSz);
+    HS_TIMING_END(ssl, WOLFSSL_HST_CERT_VERIFY, 0, ret);
     if (ret == 0) {
 #if !defined(NO_WOLFSSL_CLIENT)
         if (ssl->options.side == WOLFSSL_CLIENT_END)
@@ -6208,6 +6365,8 @@ static int SendTls13Finished(WOLFSSL* ssl)
     input = output + RECORD_HEADER_SZ;
 
     AddTls13HandShakeHeader(input, finishedSz, 0, finishedSz, finished, ssl);
+    HS_TIMING_END(ssl, WOLFSSL_HST_MSG_SEND, finished, 0);
+    WC_TRACE(WC_TRACE_HS_SEND, ssl, NULL, finished);
 
     /* make finished hashes */
     if (ssl->options.handShakeDone) {
@@ -7260,6 +7419,8 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
         return OUT_OF_ORDER_E;
     }
 
+    WC_TRACE(WC_TRACE_HS_RECV, ssl, NULL, type);
+    HS_TIMING_BEGIN(ssl, WOLFSSL_HST_MSG_RECV);
     /* above checks handshake state */
     switch (type) {
 #ifndef NO_WOLFSSL_CLIENT
@@ -7445,6 +7606,7 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     }
 #endif
 
+    HS_TIMING_END(ssl, WOLFSSL_HST_MSG_RECV, type, ret);
     WOLFSSL_LEAVE("DoTls13HandShakeMsgType()", ret);
     return ret;
 }
@@ -7573,6 +7735,7 @@ int DoTls13HandShakeMsg(WOLFSSL* ssl, byte* input, word32* inOutIdx,
  */
 int wolfSSL_connect_TLSv13(WOLFSSL* ssl)
 {
+    WC_TRACE_OBJ(ssl);
     WOLFSSL_ENTER("wolfSSL_connect_TLSv13()");
 
     #ifdef HAVE_ERRNO_H
@@ -7775,6 +7938,9 @@ int wolfSSL_connect_TLSv13(WOLFSSL* ssl)
             FALL_THROUGH;
 
         case FINISHED_DONE:
+            HS_TIMING_DONE(ssl);
+            CTX_STATS_DONE(ssl);
+            WC_TRACE(WC_TRACE_HS_DONE, ssl, NULL, ssl->options.resuming);
         #ifndef NO_HANDSHAKE_DONE_CB
             if (ssl->hsDoneCb != NULL) {
                 int cbret = ssl->hsDoneCb(ssl, ssl->hsDoneCtx);
@@ -7855,7 +8021,7 @@ int wolfSSL_send_hrr_cookie(WOLFSSL* ssl, const unsigned char* secret,
 
     /* If the supplied secret is NULL, randomly generate a new secret. */
     if (secret == NULL) {
-        ret = wc_RNG_GenerateBlock(ssl->rng,
+        ret = wc_RNG_GenerateBlock(GetSslRng(ssl),
                                ssl->buffers.tls13CookieSecret.buffer, secretSz);
         if (ret < 0)
             return ret;
@@ -8006,6 +8172,10 @@ int wolfSSL_update_keys(WOLFSSL* ssl)
 
     if (ssl == NULL || !IsAtLeastTLSv1_3(ssl->version))
         return BAD_FUNC_ARG;
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx || ssl->options.ktlsRx)
+        return KTLS_E;
+#endif
 
     ret = SendTls13KeyUpdate(ssl);
     if (ret == WANT_WRITE)
@@ -8092,6 +8262,10 @@ int wolfSSL_request_certificate(WOLFSSL* ssl)
         return NOT_READY_ERROR;
     if (!ssl->options.postHandshakeAuth)
         return POST_HAND_AUTH_ERROR;
+#ifdef WOLFSSL_KTLS
+    if (ssl->options.ktlsTx || ssl->options.ktlsRx)
+        return KTLS_E;
+#endif
 
     certReqCtx = (CertReqCtx*)XMALLOC(sizeof(CertReqCtx), ssl->heap,
                                                        DYNAMIC_TYPE_TMP_BUFFER);
@@ -8319,6 +8493,7 @@ void wolfSSL_set_psk_server_tls13_callback(WOLFSSL* ssl,
 int wolfSSL_accept_TLSv13(WOLFSSL* ssl)
 {
     word16 havePSK = 0;
+    WC_TRACE_OBJ(ssl);
     WOLFSSL_ENTER("SSL_accept_TLSv13()");
 
 #ifdef HAVE_ERRNO_H
@@ -8599,6 +8774,9 @@ int wolfSSL_accept_TLSv13(WOLFSSL* ssl)
             FALL_THROUGH;
 
         case TLS13_TICKET_SENT :
+            HS_TIMING_DONE(ssl);
+            CTX_STATS_DONE(ssl);
+            WC_TRACE(WC_TRACE_HS_DONE, ssl, NULL, ssl->options.resuming);
 #ifndef NO_HANDSHAKE_DONE_CB
             if (ssl->hsDoneCb) {
                 int cbret = ssl->hsDoneCb(ssl, ssl->hsDoneCtx);
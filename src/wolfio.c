@@ -238,19 +238,11 @@ int BioSend(WOLFSSL* ssl, char *buf, int sz, void *ctx)
 
 #ifdef USE_WOLFSSL_IO
 
-/* The receive embedded callback
- *  return : nb bytes read, or error
+/* Translates a failed or closed receive into a WOLFSSL_CBIO_ERR_* value
+ *  return : recvd when positive, otherwise the callback error
  */
-int EmbedReceive(WOLFSSL *ssl, char *buf, int sz, void *ctx)
+static int TranslateRecvError(int recvd)
 {
-    int recvd;
-#ifndef WOLFSSL_LINUXKM
-    int sd = *(int*)ctx;
-#else
-    struct socket *sd = (struct socket*)ctx;
-#endif
-
-    recvd = wolfIO_Recv(sd, buf, sz, ssl->rflags);
     if (recvd < 0) {
         int err = wolfSSL_LastError(recvd);
         WOLFSSL_MSG("Embed Receive error");
@@ -289,24 +281,11 @@ int EmbedReceive(WOLFSSL *ssl, char *buf, int sz, void *ctx)
     return recvd;
 }
 
-/* The send embedded callback
- *  return : nb bytes sent, or error
+/* Translates a failed send into a WOLFSSL_CBIO_ERR_* value
+ *  return : sent when not negative, otherwise the callback error
  */
-int EmbedSend(WOLFSSL* ssl, char *buf, int sz, void *ctx)
+static int TranslateSendError(int sent)
 {
-    int sent;
-#ifndef WOLFSSL_LINUXKM
-    int sd = *(int*)ctx;
-#else
-    struct socket *sd = (struct socket*)ctx;
-#endif
-
-#ifdef WOLFSSL_MAX_SEND_SZ
-    if (sz > WOLFSSL_MAX_SEND_SZ)
-        sz = WOLFSSL_MAX_SEND_SZ;
-#endif
-
-    sent = wolfIO_Send(sd, buf, sz, ssl->wflags);
     if (sent < 0) {
         int err = wolfSSL_LastError(sent);
         WOLFSSL_MSG("Embed Send error");
@@ -341,6 +320,142 @@ int EmbedSend(WOLFSSL* ssl, char *buf, int sz, void *ctx)
     return sent;
 }
 
+/* The receive embedded callback
+ *  return : nb bytes read, or error
+ */
+int EmbedReceive(WOLFSSL *ssl, char *buf, int sz, void *ctx)
+{
+    int recvd;
+#ifndef WOLFSSL_LINUXKM
+    int sd = *(int*)ctx;
+#else
+    struct socket *sd = (struct socket*)ctx;
+#endif
+
+    recvd = wolfIO_Recv(sd, buf, sz, ssl->rflags);
+
+    return TranslateRecvError(recvd);
+}
+
+/* The send embedded callback
+ *  return : nb bytes sent, or error
+ */
+int EmbedSend(WOLFSSL* ssl, char *buf, int sz, void *ctx)
+{
+    int sent;
+#ifndef WOLFSSL_LINUXKM
+    int sd = *(int*)ctx;
+#else
+    struct socket *sd = (struct socket*)ctx;
+#endif
+
+#ifdef WOLFSSL_MAX_SEND_SZ
+    if (sz > WOLFSSL_MAX_SEND_SZ)
+        sz = WOLFSSL_MAX_SEND_SZ;
+#endif
+
+    sent = wolfIO_Send(sd, buf, sz, ssl->wflags);
+
+    return TranslateSendError(sent);
+}
+
+#ifdef WOLFSSL_KTLS
+
+#ifndef SOL_TLS
+    #define SOL_TLS 282
+#endif
+
+/* Attach the kernel TLS upper layer protocol to a connected TCP socket and
+ * load the record protection state for one direction.
+ *  return : 0 on success, -1 with errno set otherwise
+ */
+int wolfIO_SetKtls(SOCKET_T sd, int tx, const void* info, int infoSz)
+{
+    if (setsockopt(sd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) != 0 &&
+                                                              errno != EEXIST) {
+        WOLFSSL_MSG("Kernel TLS ULP not available");
+        return -1;
+    }
+
+    if (setsockopt(sd, SOL_TLS, tx ? TLS_TX : TLS_RX, info,
+                                                    (socklen_t)infoSz) != 0) {
+        WOLFSSL_MSG("Kernel TLS rejected crypto state");
+        return -1;
+    }
+
+    return 0;
+}
+
+/* The receive callback for a socket with kernel TLS receive installed, type
+ * is set to the content type of the record the data came from
+ *  return : nb bytes read, or error
+ */
+int EmbedReceiveRecord(WOLFSSL* ssl, byte* type, char* buf, int sz, int peek,
+                       void* ctx)
+{
+    int            sd = *(int*)ctx;
+    int            recvd;
+    struct msghdr  msg;
+    struct iovec   iov;
+    struct cmsghdr* cmsg;
+    char           cbuf[CMSG_SPACE(sizeof(byte))];
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    iov.iov_base = buf;
+    iov.iov_len = (size_t)sz;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+
+    *type = application_data;
+    recvd = (int)recvmsg(sd, &msg, ssl->rflags | (peek ? MSG_PEEK : 0));
+    if (recvd > 0) {
+        cmsg = CMSG_FIRSTHDR(&msg);
+        if (cmsg != NULL && cmsg->cmsg_level == SOL_TLS &&
+                                         cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+            *type = *(byte*)CMSG_DATA(cmsg);
+        }
+    }
+
+    return TranslateRecvError(recvd);
+}
+
+/* The send callback for records other than application data on a socket with
+ * kernel TLS transmit installed
+ *  return : nb bytes sent, or error
+ */
+int EmbedSendRecord(WOLFSSL* ssl, byte type, char* buf, int sz, void* ctx)
+{
+    int            sd = *(int*)ctx;
+    int            sent;
+    struct msghdr  msg;
+    struct iovec   iov;
+    struct cmsghdr* cmsg;
+    char           cbuf[CMSG_SPACE(sizeof(byte))];
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    XMEMSET(cbuf, 0, sizeof(cbuf));
+    iov.iov_base = buf;
+    iov.iov_len = (size_t)sz;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(byte));
+    *(byte*)CMSG_DATA(cmsg) = type;
+
+    sent = (int)sendmsg(sd, &msg, ssl->wflags);
+
+    return TranslateSendError(sent);
+}
+
+#endif /* WOLFSSL_KTLS */
+
 
 #ifdef WOLFSSL_DTLS
 
@@ -53,6 +53,9 @@
 #ifdef WOLFSSL_ASNC_CRYPT
     #include <wolfssl/wolfcrypt/async.h>
 #endif
+#ifdef WOLF_EVENT_NOTIFY
+    #include <poll.h>
+#endif
 #ifdef HAVE_ECC
     #include <wolfssl/wolfcrypt/ecc.h>   /* wc_ecc_fp_free */
     #ifndef ECC_ASN963_MAX_BUF_SZ
@@ -3882,6 +3885,2457 @@ static void test_wolfSSL_read_write(void)
 #endif
 }
 
+#ifdef HAVE_IO_TESTS_DEPENDENCIES
+    #define HAVE_TEST_MEMIO
+#endif
+
+#ifdef HAVE_TEST_MEMIO
+/* In memory transport so a client and server can be driven from one thread
+ * and record boundaries can be controlled by the test. */
+#define TEST_MEMIO_BUF_SZ (64 * 1024)
+
+typedef struct test_memio_ctx {
+    byte c_buff[TEST_MEMIO_BUF_SZ]; /* client to server */
+    int  c_len;
+    byte s_buff[TEST_MEMIO_BUF_SZ]; /* server to client */
+    int  s_len;
+    int  reads;                     /* read callback calls with data */
+} test_memio_ctx;
+
+static int test_memio_write_cb(WOLFSSL *ssl, char *data, int sz, void *ctx)
+{
+    test_memio_ctx* test_ctx = (test_memio_ctx*)ctx;
+    byte* buf;
+    int*  len;
+
+    if (wolfSSL_is_server(ssl)) {
+        buf = test_ctx->s_buff;
+        len = &test_ctx->s_len;
+    }
+    else {
+        buf = test_ctx->c_buff;
+        len = &test_ctx->c_len;
+    }
+
+    if (*len + sz > TEST_MEMIO_BUF_SZ)
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+
+    XMEMCPY(buf + *len, data, sz);
+    *len += sz;
+
+    return sz;
+}
+
+static int test_memio_read_cb(WOLFSSL *ssl, char *data, int sz, void *ctx)
+{
+    test_memio_ctx* test_ctx = (test_memio_ctx*)ctx;
+    byte* buf;
+    int*  len;
+    int   read_sz;
+
+    if (wolfSSL_is_server(ssl)) {
+        buf = test_ctx->c_buff;
+        len = &test_ctx->c_len;
+    }
+    else {
+        buf = test_ctx->s_buff;
+        len = &test_ctx->s_len;
+    }
+
+    if (*len == 0)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    read_sz = sz < *len ? sz : *len;
+    XMEMCPY(data, buf, read_sz);
+    XMEMMOVE(buf, buf + read_sz, *len - read_sz);
+    *len -= read_sz;
+    test_ctx->reads++;
+
+    return read_sz;
+}
+
+static int test_memio_do_handshake(WOLFSSL* ssl_c, WOLFSSL* ssl_s,
+                                   int max_rounds)
+{
+    int handshake_complete = 0;
+    int hs_c = 0, hs_s = 0;
+    int ret, err;
+
+    while (!handshake_complete && max_rounds-- > 0) {
+        if (!hs_c) {
+            ret = wolfSSL_connect(ssl_c);
+            if (ret == WOLFSSL_SUCCESS) {
+                hs_c = 1;
+            }
+            else {
+                err = wolfSSL_get_error(ssl_c, ret);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                    err != WOLFSSL_ERROR_WANT_WRITE)
+                    return -1;
+            }
+        }
+        if (!hs_s) {
+            ret = wolfSSL_accept(ssl_s);
+            if (ret == WOLFSSL_SUCCESS) {
+                hs_s = 1;
+            }
+            else {
+                err = wolfSSL_get_error(ssl_s, ret);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                    err != WOLFSSL_ERROR_WANT_WRITE)
+                    return -1;
+            }
+        }
+        handshake_complete = hs_c && hs_s;
+    }
+
+    return handshake_complete ? 0 : -1;
+}
+
+static int test_memio_setup(test_memio_ctx *ctx, WOLFSSL_CTX **ctx_c,
+    WOLFSSL_CTX **ctx_s, WOLFSSL **ssl_c, WOLFSSL **ssl_s,
+    method_provider method_c, method_provider method_s)
+{
+    if (ctx_c != NULL && *ctx_c == NULL) {
+        *ctx_c = wolfSSL_CTX_new(method_c());
+        if (*ctx_c == NULL)
+            return -1;
+        if (wolfSSL_CTX_load_verify_locations(*ctx_c, caCertFile, 0)
+                                                           != WOLFSSL_SUCCESS)
+            return -1;
+        wolfSSL_SetIORecv(*ctx_c, test_memio_read_cb);
+        wolfSSL_SetIOSend(*ctx_c, test_memio_write_cb);
+    }
+
+    if (ctx_s != NULL && *ctx_s == NULL) {
+        *ctx_s = wolfSSL_CTX_new(method_s());
+        if (*ctx_s == NULL)
+            return -1;
+        if (wolfSSL_CTX_use_certificate_file(*ctx_s, svrCertFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS)
+            return -1;
+        if (wolfSSL_CTX_use_PrivateKey_file(*ctx_s, svrKeyFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS)
+            return -1;
+        wolfSSL_SetIORecv(*ctx_s, test_memio_read_cb);
+        wolfSSL_SetIOSend(*ctx_s, test_memio_write_cb);
+    }
+
+    if (ssl_c != NULL) {
+        *ssl_c = wolfSSL_new(*ctx_c);
+        if (*ssl_c == NULL)
+            return -1;
+        wolfSSL_SetIOWriteCtx(*ssl_c, ctx);
+        wolfSSL_SetIOReadCtx(*ssl_c, ctx);
+    }
+    if (ssl_s != NULL) {
+        *ssl_s = wolfSSL_new(*ctx_s);
+        if (*ssl_s == NULL)
+            return -1;
+        wolfSSL_SetIOWriteCtx(*ssl_s, ctx);
+        wolfSSL_SetIOReadCtx(*ssl_s, ctx);
+    #if !defined(NO_DH)
+        wolfSSL_SetTmpDH_file(*ssl_s, dhParamFile, WOLFSSL_FILETYPE_PEM);
+    #endif
+    }
+
+    return 0;
+}
+#endif /* HAVE_TEST_MEMIO */
+
+static void test_wolfSSL_read_zero_copy(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_ZERO_COPY)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "zero copy application data";
+    const unsigned char* data;
+    char buf[sizeof(msg)];
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_read_zero_copy()");
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_read_zero_copy(NULL, &data), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, NULL), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_read_zero_copy_done(NULL, 0), BAD_FUNC_ARG);
+
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+
+        /* data stays put until released */
+        AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, &data), sizeof(msg));
+        AssertIntEQ(XMEMCMP(data, msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, &data), sizeof(msg));
+        AssertIntEQ(wolfSSL_read_zero_copy_done(ssl_s, sizeof(msg) + 1),
+                    BAD_FUNC_ARG);
+
+        /* partial release, remainder available to regular read */
+        AssertIntEQ(wolfSSL_read_zero_copy_done(ssl_s, 4), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, &data), sizeof(msg) - 4);
+        AssertIntEQ(XMEMCMP(data, msg + 4, sizeof(msg) - 4), 0);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg) - 4);
+        AssertIntEQ(XMEMCMP(buf, msg + 4, sizeof(msg) - 4), 0);
+
+        /* nothing pending */
+        AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, &data), WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+                    WOLFSSL_ERROR_WANT_READ);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_write_zero_copy(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_ZERO_COPY)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "sealed in place";
+    unsigned char* data;
+    char buf[sizeof(msg)];
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_write_zero_copy_reserve()");
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_write_zero_copy_reserve(NULL, &data),
+                    BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_write_zero_copy_reserve(ssl_c, NULL),
+                    BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, 1), BAD_STATE_E);
+
+        AssertIntGE(wolfSSL_write_zero_copy_reserve(ssl_c, &data),
+                    (int)sizeof(msg));
+        XMEMCPY(data, msg, sizeof(msg));
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, 16384 + 1),
+                    BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, sizeof(msg)),
+                    sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+
+        /* a regular write drops the reservation */
+        AssertIntGT(wolfSSL_write_zero_copy_reserve(ssl_c, &data), 0);
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, 1), BAD_STATE_E);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+
+        /* sealed record survives WANT_WRITE */
+        AssertIntGT(wolfSSL_write_zero_copy_reserve(ssl_c, &data), 0);
+        XMEMCPY(data, msg, sizeof(msg));
+        test_ctx.c_len = TEST_MEMIO_BUF_SZ;
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, sizeof(msg)),
+                    WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+                    WOLFSSL_ERROR_WANT_WRITE);
+        test_ctx.c_len = 0;
+        AssertIntEQ(wolfSSL_write_zero_copy_commit(ssl_c, sizeof(msg)),
+                    sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_KTLS)
+/* Connected TCP sockets over loopback, kernel TLS only attaches to TCP */
+static int test_ktls_tcp_pair(int sv[2])
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int lfd;
+    int one = 1;
+
+    sv[0] = sv[1] = -1;
+    if ((lfd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return -1;
+    XMEMSET(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(lfd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+            listen(lfd, 1) == 0 &&
+            getsockname(lfd, (struct sockaddr*)&addr, &len) == 0 &&
+            (sv[0] = socket(AF_INET, SOCK_STREAM, 0)) >= 0 &&
+            connect(sv[0], (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        sv[1] = accept(lfd, NULL, NULL);
+    }
+    close(lfd);
+    if (sv[1] < 0) {
+        if (sv[0] >= 0)
+            close(sv[0]);
+        return -1;
+    }
+    /* the handshake loop does not wait out delayed ACKs */
+    (void)setsockopt(sv[0], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    (void)setsockopt(sv[1], IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    return 0;
+}
+
+/* Can the kernel TLS ULP be attached on this system */
+static int test_ktls_available(void)
+{
+    int sv[2];
+    int ret;
+
+    if (test_ktls_tcp_pair(sv) != 0)
+        return 0;
+    ret = setsockopt(sv[0], IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) == 0;
+    close(sv[0]);
+    close(sv[1]);
+
+    return ret;
+}
+#endif
+
+static void test_wolfSSL_ktls(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_KTLS)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "record layer";
+    char buf[sizeof(msg)];
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_UseKTLS()");
+
+    AssertIntEQ(wolfSSL_CTX_UseKTLS(NULL, WOLFSSL_KTLS_TX), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_UseKTLS(NULL, WOLFSSL_KTLS_TX), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_GetKTLS(NULL), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int sv[2];
+
+        /* not a socket, connection stays in user space */
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseKTLS(ctx_c, 0x4), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_UseKTLS(ssl_c, WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_GetKTLS(ssl_c), 0);
+        AssertIntEQ(wolfSSL_UseKTLS(ssl_c, WOLFSSL_KTLS_TX), KTLS_E);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+
+        /* socket without the kernel TLS ULP falls back to user space */
+        AssertIntEQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+        AssertIntEQ(fcntl(sv[0], F_SETFL, O_NONBLOCK), 0);
+        AssertIntEQ(fcntl(sv[1], F_SETFL, O_NONBLOCK), 0);
+        AssertIntEQ(wolfSSL_CTX_UseKTLS(ctx_c,
+                    WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseKTLS(ctx_s,
+                    WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX), WOLFSSL_SUCCESS);
+        wolfSSL_SetIORecv(ctx_c, EmbedReceive);
+        wolfSSL_SetIOSend(ctx_c, EmbedSend);
+        wolfSSL_SetIORecv(ctx_s, EmbedReceive);
+        wolfSSL_SetIOSend(ctx_s, EmbedSend);
+        AssertNotNull(ssl_c = wolfSSL_new(ctx_c));
+        AssertNotNull(ssl_s = wolfSSL_new(ctx_s));
+        AssertIntEQ(wolfSSL_set_fd(ssl_c, sv[0]), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_set_fd(ssl_s, sv[1]), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_UseKTLS(ssl_c, WOLFSSL_KTLS_RX), KTLS_E);
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_GetKTLS(ssl_c), 0);
+        AssertIntEQ(wolfSSL_GetKTLS(ssl_s), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        close(sv[0]);
+        close(sv[1]);
+
+    #if defined(HAVE_AESGCM) && defined(HAVE_ECC)
+        /* TCP connection is offloaded when the kernel has TLS, skipped
+         * otherwise */
+        if (test_ktls_available()) {
+            int j;
+
+            AssertIntEQ(test_ktls_tcp_pair(sv), 0);
+            AssertIntEQ(fcntl(sv[0], F_SETFL, O_NONBLOCK), 0);
+            AssertIntEQ(fcntl(sv[1], F_SETFL, O_NONBLOCK), 0);
+            AssertIntEQ(wolfSSL_CTX_set_cipher_list(ctx_c,
+                        "TLS13-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256"),
+                        WOLFSSL_SUCCESS);
+            AssertNotNull(ssl_c = wolfSSL_new(ctx_c));
+            AssertNotNull(ssl_s = wolfSSL_new(ctx_s));
+            AssertIntEQ(wolfSSL_set_fd(ssl_c, sv[0]), WOLFSSL_SUCCESS);
+            AssertIntEQ(wolfSSL_set_fd(ssl_s, sv[1]), WOLFSSL_SUCCESS);
+            AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+            /* the directions are installed by the first write and read */
+            for (j = 0; j < 2; j++) {
+                AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)),
+                            sizeof(msg));
+                AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)),
+                            sizeof(msg));
+                AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+                AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)),
+                            sizeof(msg));
+                AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)),
+                            sizeof(msg));
+                AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+            }
+            AssertIntEQ(wolfSSL_GetKTLS(ssl_c),
+                        WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX);
+            AssertIntEQ(wolfSSL_GetKTLS(ssl_s),
+                        WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX);
+            /* alerts go out through the kernel too */
+            AssertIntEQ(wolfSSL_shutdown(ssl_c), WOLFSSL_SHUTDOWN_NOT_DONE);
+            AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 0);
+            AssertIntEQ(wolfSSL_get_error(ssl_s, 0), WOLFSSL_ERROR_ZERO_RETURN);
+
+            wolfSSL_free(ssl_c);
+            wolfSSL_free(ssl_s);
+            close(sv[0]);
+            close(sv[1]);
+        }
+    #endif
+
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_READ_AHEAD) && \
+    defined(WOLFSSL_TLS13)
+/* One way transport that holds more than the memio buffers, so a read ahead
+ * can take in more than 64 KB at once. */
+typedef struct test_bulk_pipe {
+    byte buf[200 * 1024];
+    int  len;
+    int  reads;                     /* read callback calls with data */
+} test_bulk_pipe;
+
+static int test_bulk_write_cb(WOLFSSL *ssl, char *data, int sz, void *ctx)
+{
+    test_bulk_pipe* pipe = (test_bulk_pipe*)ctx;
+
+    (void)ssl;
+    if (pipe->len + sz > (int)sizeof(pipe->buf))
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+
+    XMEMCPY(pipe->buf + pipe->len, data, sz);
+    pipe->len += sz;
+
+    return sz;
+}
+
+static int test_bulk_read_cb(WOLFSSL *ssl, char *data, int sz, void *ctx)
+{
+    test_bulk_pipe* pipe = (test_bulk_pipe*)ctx;
+    int read_sz;
+
+    (void)ssl;
+    if (pipe->len == 0)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    read_sz = sz < pipe->len ? sz : pipe->len;
+    XMEMCPY(data, pipe->buf, read_sz);
+    XMEMMOVE(pipe->buf, pipe->buf + read_sz, pipe->len - read_sz);
+    pipe->len -= read_sz;
+    pipe->reads++;
+
+    return read_sz;
+}
+#endif
+
+static void test_wolfSSL_read_ahead(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_READ_AHEAD)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "chatty";
+    char buf[64];
+    static byte big[40000];
+    static byte bigIn[sizeof(big)];
+    size_t i;
+#if defined(WOLFSSL_ASYNC_CRYPT) && defined(WOLFSSL_TLS13) && \
+    defined(WOLFSSL_POST_HANDSHAKE_AUTH) && !defined(NO_RSA)
+    int asyncDevId = INVALID_DEVID;
+#endif
+
+    printf(testingFmt, "wolfSSL_UseReadAhead()");
+
+    AssertIntEQ(wolfSSL_CTX_UseReadAhead(NULL, 4096), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_UseReadAhead(NULL, 4096), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_has_pending(NULL), 0);
+    for (i = 0; i < sizeof(big); i++)
+        big[i] = (byte)i;
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int got, ret;
+        int j;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_UseReadAhead(ssl_s, 64 * 1024), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        /* three records in one read, all returned by one wolfSSL_read */
+        for (j = 0; j < 3; j++)
+            AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        test_ctx.reads = 0;
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 3 * sizeof(msg));
+        AssertIntEQ(test_ctx.reads, 1);
+        AssertIntEQ(XMEMCMP(buf + 2 * sizeof(msg), msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_has_pending(ssl_s), 0);
+
+        /* a short read leaves the rest buffered */
+        for (j = 0; j < 3; j++)
+            AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        test_ctx.reads = 0;
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_has_pending(ssl_s), 1);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 2 * sizeof(msg));
+        AssertIntEQ(test_ctx.reads, 1);
+
+        /* full size records, more than one record's worth buffered */
+        AssertIntEQ(wolfSSL_write(ssl_c, big, sizeof(big)), sizeof(big));
+        got = 0;
+        while (got < (int)sizeof(big)) {
+            ret = wolfSSL_read(ssl_s, bigIn + got, sizeof(bigIn) - got);
+            AssertIntGT(ret, 0);
+            got += ret;
+        }
+        AssertIntEQ(XMEMCMP(big, bigIn, sizeof(big)), 0);
+
+    #ifdef WOLFSSL_ZERO_COPY
+        /* releasing zero copy data keeps the buffer as well */
+        {
+            const unsigned char* data;
+            WOLFSSL_MEM_FOOTPRINT fp;
+
+            AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+            AssertIntEQ(wolfSSL_read_zero_copy(ssl_s, &data), sizeof(msg));
+            AssertIntEQ(wolfSSL_read_zero_copy_done(ssl_s, sizeof(msg)),
+                        WOLFSSL_SUCCESS);
+            AssertIntEQ(wolfSSL_GetMemFootprint(ssl_s, &fp), WOLFSSL_SUCCESS);
+            AssertIntGE(fp.buffers, 64 * 1024);
+        }
+    #endif
+
+        /* idle, gives the buffer back */
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+                    WOLFSSL_ERROR_WANT_READ);
+
+        /* close notify after data */
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_shutdown(ssl_c), WOLFSSL_SHUTDOWN_NOT_DONE);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 0);
+        AssertIntEQ(wolfSSL_get_error(ssl_s, 0), WOLFSSL_ERROR_ZERO_RETURN);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+#ifdef WOLFSSL_TLS13
+    /* more than 64 KB of TLS 1.3 records taken in by one read */
+    {
+        static test_bulk_pipe pipe;
+        static byte bulk[150 * 1000];
+        static byte bulkIn[sizeof(bulk)];
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int got, ret, j;
+
+        for (i = 0; i < sizeof(bulk); i++)
+            bulk[i] = (byte)(i * 3);
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, wolfTLSv1_3_client_method,
+                    wolfTLSv1_3_server_method), 0);
+        AssertIntEQ(wolfSSL_UseReadAhead(ssl_s, 256 * 1024), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        pipe.len = 0;
+        pipe.reads = 0;
+        wolfSSL_SSLSetIOSend(ssl_c, test_bulk_write_cb);
+        wolfSSL_SetIOWriteCtx(ssl_c, &pipe);
+        wolfSSL_SSLSetIORecv(ssl_s, test_bulk_read_cb);
+        wolfSSL_SetIOReadCtx(ssl_s, &pipe);
+        for (j = 0; j < 150; j++) {
+            AssertIntEQ(wolfSSL_write(ssl_c, bulk + j * 1000, 1000), 1000);
+        }
+        AssertIntGT(pipe.len, 64 * 1024);
+
+        got = 0;
+        while (got < (int)sizeof(bulk)) {
+            ret = wolfSSL_read(ssl_s, bulkIn + got, sizeof(bulkIn) - got);
+            AssertIntGT(ret, 0);
+            got += ret;
+        }
+        AssertIntEQ(pipe.reads, 1);
+        AssertIntEQ(XMEMCMP(bulk, bulkIn, sizeof(bulk)), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+#endif
+
+#if defined(WOLFSSL_ASYNC_CRYPT) && defined(WOLFSSL_TLS13) && \
+    defined(WOLFSSL_POST_HANDSHAKE_AUTH) && !defined(NO_RSA)
+    /* the client's post-handshake authentication flight and data are read
+     * ahead together, the CertificateVerify check returns WC_PENDING_E with
+     * records still buffered behind it */
+    {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        WOLFSSL* ssl[2];
+        int done[2] = { 0, 0 };
+        int pending = 0;
+        int rounds = 100000;
+        int ret, err, j;
+
+        AssertIntEQ(wolfAsync_DevOpen(&asyncDevId), 0);
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_c, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_s, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_c, cliCertFile,
+                    WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_c, cliKeyFile,
+                    WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_allow_post_handshake_auth(ctx_c), 0);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s, cliCertFile, 0),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseReadAhead(ctx_s, 64 * 1024),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                    wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+        ssl[0] = ssl_c;
+        ssl[1] = ssl_s;
+
+        while ((!done[0] || !done[1]) && rounds-- > 0) {
+            for (j = 0; j < 2; j++) {
+                if (done[j])
+                    continue;
+                ret = (j == 0) ? wolfSSL_connect(ssl[j])
+                               : wolfSSL_accept(ssl[j]);
+                if (ret == WOLFSSL_SUCCESS) {
+                    done[j] = 1;
+                    continue;
+                }
+                err = wolfSSL_get_error(ssl[j], ret);
+                if (err == WC_PENDING_E) {
+                    while ((ret = wolfSSL_AsyncPoll(ssl[j],
+                                              WOLF_POLL_FLAG_CHECK_HW)) == 0) {
+                    #ifndef WC_NO_ASYNC_THREADING
+                        wc_AsyncThreadYield();
+                    #endif
+                    }
+                    AssertIntGT(ret, 0);
+                }
+                else
+                    AssertTrue(err == WOLFSSL_ERROR_WANT_READ ||
+                               err == WOLFSSL_ERROR_WANT_WRITE);
+            }
+        }
+        AssertIntEQ(done[0], 1);
+        AssertIntEQ(done[1], 1);
+
+        AssertIntEQ(wolfSSL_request_certificate(ssl_s), WOLFSSL_SUCCESS);
+        /* the client answers the request while reading, then sends data */
+        for (j = 0; j < 2; j++) {
+            done[j] = 0;
+            rounds = 100000;
+            if (j == 1) {
+                AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)),
+                            sizeof(msg));
+            }
+            while (rounds-- > 0) {
+                ret = wolfSSL_read(ssl[j], buf, sizeof(buf));
+                if (ret > 0) {
+                    done[j] = ret;
+                    break;
+                }
+                err = wolfSSL_get_error(ssl[j], ret);
+                if (err != WC_PENDING_E) {
+                    AssertIntEQ(err, WOLFSSL_ERROR_WANT_READ);
+                    break;
+                }
+                if (j == 1)
+                    pending++;
+                while ((ret = wolfSSL_AsyncPoll(ssl[j],
+                                          WOLF_POLL_FLAG_CHECK_HW)) == 0) {
+                #ifndef WC_NO_ASYNC_THREADING
+                    wc_AsyncThreadYield();
+                #endif
+                }
+                AssertIntGT(ret, 0);
+            }
+        }
+        AssertIntEQ(done[0], 0);
+        AssertIntEQ(done[1], sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+        AssertIntGT(pending, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+        wolfAsync_DevClose(&asyncDevId);
+    }
+#endif
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_UseIOBufferPool(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_IO_POOL)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "borrowed";
+    char buf[sizeof(msg)];
+    unsigned int inUse, idle;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_CTX_UseIOBufferPool()");
+
+    AssertIntEQ(wolfSSL_CTX_UseIOBufferPool(NULL, 4), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(NULL, &inUse, &idle),
+                BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int pending;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseIOBufferPool(ctx_s, 4), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        /* buffers go back once the record is delivered */
+        AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, &idle),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(inUse, 0);
+        AssertIntGT(idle, 0);
+        AssertIntLE(idle, 4);
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, NULL),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(inUse, 0);
+
+        /* and are held while a record waits to be sent */
+        pending = test_ctx.s_len;
+        test_ctx.s_len = TEST_MEMIO_BUF_SZ;
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)),
+                    WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, NULL),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(inUse, 1);
+        test_ctx.s_len = pending;
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, NULL),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(inUse, 0);
+
+    #if defined(OPENSSL_ALL) || (defined(OPENSSL_EXTRA) && \
+        (defined(HAVE_STUNNEL) || defined(WOLFSSL_NGINX) || \
+         defined(HAVE_LIGHTY) || defined(WOLFSSL_HAPROXY) || \
+         defined(WOLFSSL_OPENSSH)))
+        /* a buffer lent before switching CTX goes back to the one it came
+         * from, which is kept until then */
+        {
+            WOLFSSL_CTX* ctx_s2;
+
+            AssertNotNull(ctx_s2 = wolfSSL_CTX_new(methods[i][1]()));
+            AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s2, svrCertFile,
+                        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+            AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s2, svrKeyFile,
+                        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+            wolfSSL_SetIORecv(ctx_s2, test_memio_read_cb);
+            wolfSSL_SetIOSend(ctx_s2, test_memio_write_cb);
+            AssertIntEQ(wolfSSL_CTX_UseIOBufferPool(ctx_s2, 4),
+                        WOLFSSL_SUCCESS);
+            pending = test_ctx.s_len;
+            test_ctx.s_len = TEST_MEMIO_BUF_SZ;
+            AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)),
+                        WOLFSSL_FATAL_ERROR);
+            AssertPtrEq(wolfSSL_set_SSL_CTX(ssl_s, ctx_s2), ctx_s2);
+            wolfSSL_CTX_free(ctx_s2);
+            test_ctx.s_len = pending;
+            AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+            AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+            AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, NULL),
+                        WOLFSSL_SUCCESS);
+            AssertIntEQ(inUse, 0);
+            AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s2, &inUse,
+                        NULL), WOLFSSL_SUCCESS);
+            AssertIntEQ(inUse, 0);
+        }
+    #endif
+
+        wolfSSL_free(ssl_s);
+        AssertIntEQ(wolfSSL_CTX_UseIOBufferPool(ctx_s, 0), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetIOBufferPoolStats(ctx_s, &inUse, &idle),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(inUse, 0);
+        AssertIntEQ(idle, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CompactResources(void)
+{
+#ifdef HAVE_TEST_MEMIO
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "still talking";
+    char buf[sizeof(msg)];
+    unsigned int compacted, retained;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_CompactResources()");
+
+    AssertIntEQ(wolfSSL_CompactResources(NULL, &retained), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_SetAutoCompact(NULL, 1), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_SetAutoCompact(NULL, 1), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_SetAutoCompact(ctx_s, 1), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CompactResources(ssl_c, &retained), BAD_STATE_E);
+        AssertIntEQ(wolfSSL_KeepHandshakeResources(ssl_c), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        /* client kept everything, server compacted when done */
+        AssertIntEQ(wolfSSL_CompactResources(ssl_s, &retained),
+                    WOLFSSL_SUCCESS);
+        AssertIntGT(retained, 0);
+        AssertIntEQ(wolfSSL_CompactResources(ssl_c, NULL), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CompactResources(ssl_c, &compacted),
+                    WOLFSSL_SUCCESS);
+        AssertIntGT(compacted, 0);
+
+        /* records still protected both ways */
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+
+        /* idle again, nothing left to give back */
+        AssertIntEQ(wolfSSL_CompactResources(ssl_c, &retained),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(retained, compacted);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_GetMemFootprint(void)
+{
+#ifdef HAVE_TEST_MEMIO
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "weigh me";
+    char buf[sizeof(msg)];
+    WOLFSSL_MEM_FOOTPRINT fp, kept;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_GetMemFootprint()");
+
+    AssertIntEQ(wolfSSL_GetMemFootprint(NULL, &fp), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int pending;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_c, NULL), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_KeepHandshakeResources(ssl_c), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_c, &kept), WOLFSSL_SUCCESS);
+        AssertIntGT(kept.object, 0);
+        AssertIntGT(kept.session, 0);
+        AssertIntGT(kept.ciphers, 0);
+        AssertIntEQ(kept.total, kept.object + kept.session + kept.peerCert +
+                    kept.handshake + kept.ciphers + kept.rng + kept.buffers +
+                    kept.extensions);
+        AssertIntEQ(wolfSSL_CompactResources(ssl_c, NULL), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_c, &fp), WOLFSSL_SUCCESS);
+        AssertIntLE(fp.handshake, kept.handshake);
+        AssertIntLE(fp.total, kept.total);
+        AssertIntEQ(fp.object, kept.object);
+
+        /* a record waiting to be sent holds a buffer */
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_s, &kept), WOLFSSL_SUCCESS);
+        AssertIntEQ(kept.buffers, 0);
+        pending = test_ctx.s_len;
+        test_ctx.s_len = TEST_MEMIO_BUF_SZ;
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)),
+                    WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_s, &fp), WOLFSSL_SUCCESS);
+        AssertIntGT(fp.buffers, 0);
+        AssertIntEQ(fp.total, kept.total + fp.buffers);
+        test_ctx.s_len = pending;
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_GetMemFootprint(ssl_s, &fp), WOLFSSL_SUCCESS);
+        AssertIntEQ(fp.buffers, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_sendfile(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_SENDFILE)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    static byte content[40000];
+    static byte buf[sizeof(content)];
+    const int fill = TEST_MEMIO_BUF_SZ - 20000;
+    FILE* f;
+    int fd;
+    int sent, got, ret;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_sendfile()");
+
+    for (i = 0; i < sizeof(content); i++)
+        content[i] = (byte)(i * 7);
+    AssertNotNull(f = tmpfile());
+    AssertIntEQ(fwrite(content, 1, sizeof(content), f), sizeof(content));
+    AssertIntEQ(fflush(f), 0);
+    fd = fileno(f);
+
+    AssertIntEQ(wolfSSL_sendfile(NULL, fd, 0, 1), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, -1, 0, 1), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, -1, 1), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, 0, -1), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, 0, 0), 0);
+
+        /* several records from the middle of the file */
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, 100, 30000), 30000);
+        for (got = 0; got < 30000; got += ret) {
+            ret = wolfSSL_read(ssl_s, buf + got, 30000 - got);
+            AssertIntGT(ret, 0);
+        }
+        AssertIntEQ(XMEMCMP(buf, content + 100, 30000), 0);
+
+        /* stops at the end of the file */
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, sizeof(content) - 10, 100),
+                    10);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 10);
+        AssertIntEQ(XMEMCMP(buf, content + sizeof(content) - 10, 10), 0);
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, sizeof(content), 10),
+                    WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+                    FREAD_ERROR);
+
+        /* room for one record only, the rest waits for the next call */
+        test_ctx.c_len = fill;
+        sent = wolfSSL_sendfile(ssl_c, fd, 0, sizeof(content));
+        AssertIntGT(sent, 0);
+        AssertIntLT(sent, sizeof(content));
+        AssertIntEQ(wolfSSL_get_error(ssl_c, 0), WOLFSSL_ERROR_WANT_WRITE);
+        XMEMMOVE(test_ctx.c_buff, test_ctx.c_buff + fill,
+                 test_ctx.c_len - fill);
+        test_ctx.c_len -= fill;
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, sent, 1), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_sendfile(ssl_c, fd, sent,
+                    (int)sizeof(content) - sent), sizeof(content) - sent);
+        for (got = 0; got < (int)sizeof(content); got += ret) {
+            ret = wolfSSL_read(ssl_s, buf + got, sizeof(buf) - got);
+            AssertIntGT(ret, 0);
+        }
+        AssertIntEQ(XMEMCMP(buf, content, sizeof(content)), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    fclose(f);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfAsync_DevOpen(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_ASYNC_CRYPT) && \
+    defined(WOLFSSL_ASYNC_CRYPT_TEST)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "offloaded";
+    char buf[sizeof(msg)];
+    int asyncDevId = INVALID_DEVID;
+    size_t i;
+
+    printf(testingFmt, "wolfAsync_DevOpen()");
+
+    AssertIntEQ(wolfAsync_DevOpenThreads(NULL, 2), BAD_FUNC_ARG);
+    AssertIntEQ(wolfAsync_DevOpenThreads(&asyncDevId, 2), 0);
+    AssertIntNE(asyncDevId, INVALID_DEVID);
+
+    for (i = 0; i < sizeof(methods) / sizeof(*methods); i++) {
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        test_memio_ctx test_ctx;
+        WOLFSSL* ssl[2];
+        int done[2] = { 0, 0 };
+        int pending[2] = { 0, 0 };
+        int rounds = 100000;
+        int ret, err, j;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                                     methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_c, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_s, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                                     methods[i][0], methods[i][1]), 0);
+        ssl[0] = ssl_c;
+        ssl[1] = ssl_s;
+
+        /* public key operations of both sides go to the worker threads */
+        while ((!done[0] || !done[1]) && rounds-- > 0) {
+            for (j = 0; j < 2; j++) {
+                if (done[j])
+                    continue;
+                ret = (j == 0) ? wolfSSL_connect(ssl[j])
+                               : wolfSSL_accept(ssl[j]);
+                if (ret == WOLFSSL_SUCCESS) {
+                    done[j] = 1;
+                    continue;
+                }
+                err = wolfSSL_get_error(ssl[j], ret);
+                if (err == WC_PENDING_E) {
+                    pending[j]++;
+                    while ((ret = wolfSSL_AsyncPoll(ssl[j],
+                                              WOLF_POLL_FLAG_CHECK_HW)) == 0) {
+                    #ifndef WC_NO_ASYNC_THREADING
+                        wc_AsyncThreadYield();
+                    #endif
+                    }
+                    AssertIntGT(ret, 0);
+                }
+                else
+                    AssertTrue(err == WOLFSSL_ERROR_WANT_READ ||
+                               err == WOLFSSL_ERROR_WANT_WRITE);
+            }
+        }
+        AssertIntEQ(done[0], 1);
+        AssertIntEQ(done[1], 1);
+        AssertIntGT(pending[0], 0);
+        AssertIntGT(pending[1], 0);
+
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    wolfAsync_DevClose(&asyncDevId);
+    AssertIntEQ(asyncDevId, INVALID_DEVID);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_AsyncDrain(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_ASYNC_CRYPT)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    WOLF_EVENT* events[4];
+    int asyncDevId = INVALID_DEVID;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_CTX_AsyncDrain()");
+
+    AssertIntEQ(wolfAsync_DevOpen(&asyncDevId), 0);
+
+    AssertIntEQ(wolfSSL_CTX_AsyncDrain(NULL, events, 4, NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_AsyncGetFd(NULL), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(*methods); i++) {
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        struct test_memio_ctx test_ctx;
+        WOLFSSL* ssl[2];
+        int done[2] = { 0, 0 };
+        int pending[2] = { 0, 0 };
+        int drained = 0;
+        int rounds = 100000;
+        int fd;
+        int count = 0;
+        int ret, err, j, k;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                                     methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_c, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseAsync(ctx_s, asyncDevId), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                                     methods[i][0], methods[i][1]), 0);
+        ssl[0] = ssl_c;
+        ssl[1] = ssl_s;
+
+        fd = wolfSSL_CTX_AsyncGetFd(ctx_c);
+    #ifdef WOLF_EVENT_NOTIFY
+        AssertIntGE(fd, 0);
+        /* same descriptor every time */
+        AssertIntEQ(wolfSSL_CTX_AsyncGetFd(ctx_c), fd);
+    #else
+        AssertIntEQ(fd, NOT_COMPILED_IN);
+    #endif
+
+        /* the client's operations complete on its CTX queue, the server is
+         * driven with wolfSSL_AsyncPoll() */
+        while ((!done[0] || !done[1]) && rounds-- > 0) {
+            for (j = 0; j < 2; j++) {
+                if (done[j] || pending[j])
+                    continue;
+                ret = (j == 0) ? wolfSSL_connect(ssl[j])
+                               : wolfSSL_accept(ssl[j]);
+                if (ret == WOLFSSL_SUCCESS) {
+                    done[j] = 1;
+                    continue;
+                }
+                err = wolfSSL_get_error(ssl[j], ret);
+                if (err == WC_PENDING_E)
+                    pending[j] = 1;
+                else
+                    AssertTrue(err == WOLFSSL_ERROR_WANT_READ ||
+                               err == WOLFSSL_ERROR_WANT_WRITE);
+            }
+
+            if (pending[0]) {
+            #ifdef WOLF_EVENT_NOTIFY
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                if (poll(&pfd, 1, 1000) <= 0)
+                    continue;
+            #endif
+                AssertIntEQ(wolfSSL_CTX_AsyncDrain(ctx_c, events, 4, &count),
+                            0);
+                for (k = 0; k < count; k++) {
+                    AssertPtrEq(events[k]->context, ssl_c);
+                    pending[0] = 0;
+                    drained++;
+                }
+            }
+            if (pending[1]) {
+                ret = wolfSSL_AsyncPoll(ssl_s, WOLF_POLL_FLAG_CHECK_HW);
+                AssertIntGE(ret, 0);
+                if (ret > 0)
+                    pending[1] = 0;
+            }
+        #ifndef WC_NO_ASYNC_THREADING
+            /* let the device threads run */
+            if (pending[0] || pending[1])
+                wc_AsyncThreadYield();
+        #endif
+        }
+        AssertIntEQ(done[0], 1);
+        AssertIntEQ(done[1], 1);
+        AssertIntGT(drained, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    wolfAsync_DevClose(&asyncDevId);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_UseKeySharePool(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_KEYSHARE_POOL) && \
+    defined(HAVE_ECC) && !defined(NO_ECC256) && !defined(NO_ECC_SECP)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    };
+    word16 groups[] = {
+        WOLFSSL_ECC_SECP256R1,
+    #ifdef HAVE_CURVE25519
+        WOLFSSL_ECC_X25519,
+    #endif
+    };
+    const int nGroups = (int)(sizeof(groups) / sizeof(groups[0]));
+    size_t i;
+    int j, ready;
+
+    printf(testingFmt, "wolfSSL_CTX_UseKeySharePool()");
+
+    AssertIntEQ(wolfSSL_CTX_UseKeySharePool(NULL, WOLFSSL_ECC_SECP256R1, 2),
+                BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_RefillKeySharePool(NULL, 0), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetKeySharePoolCount(NULL, WOLFSSL_ECC_SECP256R1),
+                BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, 0x7777, 2),
+                    BAD_FUNC_ARG);
+        for (j = 0; j < nGroups; j++) {
+            AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, groups[j], 2),
+                        WOLFSSL_SUCCESS);
+            AssertIntEQ(wolfSSL_CTX_GetKeySharePoolCount(ctx_s, groups[j]), 0);
+        }
+        AssertIntEQ(wolfSSL_CTX_RefillKeySharePool(ctx_s, 1), 1);
+        AssertIntEQ(wolfSSL_CTX_RefillKeySharePool(ctx_s, 0), 2 * nGroups - 1);
+        AssertIntEQ(wolfSSL_CTX_RefillKeySharePool(ctx_s, 0), 0);
+
+        /* server takes one ready key pair for its ephemeral key */
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        ready = 0;
+        for (j = 0; j < nGroups; j++)
+            ready += wolfSSL_CTX_GetKeySharePoolCount(ctx_s, groups[j]);
+        AssertIntEQ(ready, 2 * nGroups - 1);
+        AssertIntEQ(wolfSSL_CTX_RefillKeySharePool(ctx_s, 0), 1);
+
+        /* shrinking the pool frees the key pairs over the count */
+        AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, groups[0], 1),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetKeySharePoolCount(ctx_s, groups[0]), 1);
+        AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, groups[0], 0),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetKeySharePoolCount(ctx_s, groups[0]), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_private_key_cache(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_PRIVKEY_CACHE) && \
+    !defined(NO_RSA) && defined(HAVE_ECC) && !defined(NO_FILESYSTEM)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    size_t i;
+    int j;
+
+    printf(testingFmt, "wolfSSL_CTX private key cache");
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+
+        /* connections share the key decoded when loaded into the CTX */
+        for (j = 0; j < 3; j++) {
+            test_memio_ctx test_ctx;
+            WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+            XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+            AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                        &ssl_s, methods[i][0], methods[i][1]), 0);
+            AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+            wolfSSL_free(ssl_c);
+            wolfSSL_free(ssl_s);
+
+            /* loading another key replaces the decoded one */
+            if (j == 1) {
+                AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c,
+                            caEccCertFile, 0), WOLFSSL_SUCCESS);
+                AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s,
+                            eccCertFile, WOLFSSL_FILETYPE_PEM),
+                            WOLFSSL_SUCCESS);
+                AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s,
+                            eccKeyFile, WOLFSSL_FILETYPE_PEM),
+                            WOLFSSL_SUCCESS);
+            }
+        }
+
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_cert_msg_cache(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_CERT_MSG_CACHE) && \
+    !defined(NO_RSA) && !defined(NO_FILESYSTEM)
+    const char* chainFile = "./certs/intermediate/server-chain.pem";
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    int j;
+
+    printf(testingFmt, "wolfSSL_CTX certificate message cache");
+
+    AssertIntEQ(test_memio_setup(NULL, &ctx_c, &ctx_s, NULL, NULL,
+                wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+
+    /* leaf only, then leaf and intermediates replacing the encoded list */
+    for (j = 0; j < 3; j++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        if (j == 1) {
+            AssertIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s,
+                        chainFile), WOLFSSL_SUCCESS);
+        }
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, NULL, NULL), 0);
+    #ifdef HAVE_MAX_FRAGMENT
+        /* list sent over several records */
+        if (j == 2)
+            AssertIntEQ(wolfSSL_UseMaxFragment(ssl_c, WOLFSSL_MFL_2_9),
+                        WOLFSSL_SUCCESS);
+    #endif
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+    }
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_UseClientSuites(void)
+{
+#if defined(HAVE_TEST_MEMIO) && !defined(WOLFSSL_NO_TLS12) && \
+    defined(HAVE_ECC) && !defined(NO_RSA) && defined(HAVE_AESGCM) && \
+    defined(WOLFSSL_SHA384) && defined(HAVE_CHACHA) && defined(HAVE_POLY1305)
+    /* server prefers a suite the client doesn't offer */
+    const char* serverList = "ECDHE-RSA-CHACHA20-POLY1305:"
+                             "ECDHE-RSA-AES128-GCM-SHA256:"
+                             "ECDHE-RSA-AES256-GCM-SHA384";
+    const char* clientList = "ECDHE-RSA-AES256-GCM-SHA384:"
+                             "ECDHE-RSA-AES128-GCM-SHA256";
+    const char* expected[] = {
+        "ECDHE-RSA-AES128-GCM-SHA256",
+        "ECDHE-RSA-AES256-GCM-SHA384"
+    };
+    int i;
+
+    printf(testingFmt, "wolfSSL_UseClientSuites()");
+
+    AssertIntEQ(wolfSSL_CTX_UseClientSuites(NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_UseClientSuites(NULL), BAD_FUNC_ARG);
+
+    /* server order, then client order */
+    for (i = 0; i < 2; i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+        AssertIntEQ(wolfSSL_CTX_set_cipher_list(ctx_c, clientList),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_set_cipher_list(ctx_s, serverList),
+                    WOLFSSL_SUCCESS);
+        if (i == 1)
+            AssertIntEQ(wolfSSL_CTX_UseClientSuites(ctx_s), 0);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, NULL, NULL), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        AssertStrEQ(wolfSSL_get_cipher_name(ssl_s), expected[i]);
+        AssertStrEQ(wolfSSL_get_cipher_name(ssl_c), expected[i]);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_shared_suites(void)
+{
+#if defined(HAVE_TEST_MEMIO) && !defined(WOLFSSL_NO_TLS12) && \
+    defined(HAVE_ECC) && !defined(NO_RSA) && defined(HAVE_AESGCM) && \
+    defined(WOLFSSL_SHA384)
+    const char* ctxList = "ECDHE-RSA-AES128-GCM-SHA256:"
+                          "ECDHE-RSA-AES256-GCM-SHA384";
+    const char* sslList = "ECDHE-RSA-AES256-GCM-SHA384";
+    const char* expected[] = {
+        "ECDHE-RSA-AES256-GCM-SHA384",
+        "ECDHE-RSA-AES128-GCM-SHA256"
+    };
+    test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+#if defined(OPENSSL_EXTRA) || defined(WOLFSSL_EITHER_SIDE)
+    WOLFSSL_CTX *ctx_e = NULL;
+#endif
+    int i;
+
+    printf(testingFmt, "wolfSSL_CTX_set_cipher_list() shared suites");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    AssertIntEQ(wolfSSL_CTX_set_cipher_list(ctx_s, ctxList), WOLFSSL_SUCCESS);
+
+    /* changing the first connection's list leaves the CTX's alone */
+    for (i = 0; i < 2; i++) {
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, NULL, NULL), 0);
+        if (i == 0)
+            AssertIntEQ(wolfSSL_set_cipher_list(ssl_s, sslList),
+                        WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        AssertStrEQ(wolfSSL_get_cipher_name(ssl_s), expected[i]);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        ssl_c = ssl_s = NULL;
+    }
+
+#if defined(OPENSSL_EXTRA) || defined(WOLFSSL_EITHER_SIDE)
+    /* either side CTX without a cipher list, its connections allocate
+     * their own suites and wolfSSL_accept() sets them up */
+    AssertNotNull(ctx_e = wolfSSL_CTX_new(wolfSSLv23_method()));
+    AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_e, svrCertFile,
+                WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_e, svrKeyFile,
+                WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    wolfSSL_SetIORecv(ctx_e, test_memio_read_cb);
+    wolfSSL_SetIOSend(ctx_e, test_memio_write_cb);
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_e, &ssl_c, &ssl_s,
+                NULL, NULL), 0);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_e);
+#endif
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_SSL_POOL) && \
+    defined(HAVE_HASHDRBG) && !defined(WC_THREAD_RNG)
+#include <sys/wait.h>
+#endif
+
+static void test_wolfSSL_CTX_UseSSLPool(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_SSL_POOL)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    const char msg[] = "recycled";
+    char buf[sizeof(msg)];
+    unsigned int hits, misses, idle;
+    size_t i;
+    int j;
+
+    printf(testingFmt, "wolfSSL_CTX_UseSSLPool()");
+
+    AssertIntEQ(wolfSSL_CTX_UseSSLPool(NULL, 4), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(NULL, &hits, &misses, &idle),
+                BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL, *ssl_s2 = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_UseSSLPool(ctx_c, 1), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_UseSSLPool(ctx_s, 1), WOLFSSL_SUCCESS);
+
+        /* first connection allocates, the next ones reuse its objects */
+        for (j = 0; j < 3; j++) {
+            XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+            AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                        &ssl_s, NULL, NULL), 0);
+            AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+            AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+            AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+            AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+            AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(ctx_s, &hits, &misses,
+                        &idle), WOLFSSL_SUCCESS);
+            AssertIntEQ(hits, j);
+            AssertIntEQ(misses, 1);
+            AssertIntEQ(idle, 0);
+
+            wolfSSL_free(ssl_c);
+            wolfSSL_free(ssl_s);
+            AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(ctx_s, NULL, NULL,
+                        &idle), WOLFSSL_SUCCESS);
+            AssertIntEQ(idle, 1);
+        }
+
+        /* a second object is only kept when there is room */
+        AssertNotNull(ssl_s = wolfSSL_new(ctx_s));
+        AssertNotNull(ssl_s2 = wolfSSL_new(ctx_s));
+        wolfSSL_free(ssl_s2);
+        wolfSSL_free(ssl_s);
+        AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(ctx_s, &hits, &misses, &idle),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(hits, 3);
+        AssertIntEQ(misses, 2);
+        AssertIntEQ(idle, 1);
+
+        AssertIntEQ(wolfSSL_CTX_UseSSLPool(ctx_s, 0), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(ctx_s, NULL, NULL, &idle),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(idle, 0);
+
+        /* kept objects don't hold on to the CTX, freed with it */
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+#if defined(HAVE_HASHDRBG) && !defined(WC_THREAD_RNG)
+    /* a forked child reusing a pooled object doesn't repeat the parent's
+     * random output */
+    {
+        WOLFSSL_CTX* ctx;
+        WOLFSSL* ssl;
+        byte parentBlock[32];
+        byte childBlock[32];
+        int fds[2];
+        int status;
+        pid_t pid;
+
+        AssertNotNull(ctx = wolfSSL_CTX_new(methods[0][0]()));
+        AssertIntEQ(wolfSSL_CTX_UseSSLPool(ctx, 1), WOLFSSL_SUCCESS);
+        AssertNotNull(ssl = wolfSSL_new(ctx));
+        wolfSSL_free(ssl);
+
+        AssertIntEQ(pipe(fds), 0);
+        pid = fork();
+        AssertIntGE(pid, 0);
+        if (pid == 0) {
+            ssl = wolfSSL_new(ctx);
+            if (ssl == NULL ||
+                    wc_RNG_GenerateBlock(wolfSSL_GetRNG(ssl), childBlock,
+                                         sizeof(childBlock)) != 0 ||
+                    write(fds[1], childBlock, sizeof(childBlock)) !=
+                                                    (int)sizeof(childBlock)) {
+                _exit(1);
+            }
+            _exit(0);
+        }
+        AssertNotNull(ssl = wolfSSL_new(ctx));
+        AssertIntEQ(wolfSSL_CTX_GetSSLPoolStats(ctx, &hits, NULL, NULL),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(hits, 1);
+        AssertIntEQ(wc_RNG_GenerateBlock(wolfSSL_GetRNG(ssl), parentBlock,
+                                         sizeof(parentBlock)), 0);
+        AssertIntEQ(read(fds[0], childBlock, sizeof(childBlock)),
+                    sizeof(childBlock));
+        AssertIntEQ(waitpid(pid, &status, 0), pid);
+        AssertIntEQ(status, 0);
+        AssertIntNE(XMEMCMP(parentBlock, childBlock, sizeof(parentBlock)), 0);
+        close(fds[0]);
+        close(fds[1]);
+
+        wolfSSL_free(ssl);
+        wolfSSL_CTX_free(ctx);
+    }
+#endif
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WC_THREAD_RNG)
+#include <sys/wait.h>
+
+static WC_RNG* test_threadRng = NULL;
+static WOLFSSL* test_threadRngSsl = NULL;
+static WC_RNG* test_threadRngSslRng = NULL;
+
+static THREAD_RETURN WOLFSSL_THREAD test_thread_rng_thread(void* args)
+{
+    func_args* fargs = (func_args*)args;
+    byte block[32];
+
+    test_threadRng = wc_GetThreadRng();
+    test_threadRngSslRng = wolfSSL_GetRNG(test_threadRngSsl);
+    fargs->return_code = (test_threadRng == NULL) ? -1 :
+        wc_RNG_GenerateBlock(test_threadRng, block, sizeof(block));
+
+    return 0;
+}
+#endif
+
+static void test_wc_GetThreadRng(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WC_THREAD_RNG)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    byte parentBlock[32];
+    byte childBlock[32];
+    WOLFSSL_CTX* ctx;
+    WOLFSSL* ssl;
+    WC_RNG* rng;
+    func_args args;
+    THREAD_TYPE thread;
+    int fds[2];
+    int status;
+    pid_t pid;
+    size_t i;
+
+    printf(testingFmt, "wc_GetThreadRng()");
+
+    AssertNotNull(rng = wc_GetThreadRng());
+    AssertPtrEq(wc_GetThreadRng(), rng);
+
+    /* both ends on this thread draw from its DRBG, with async crypt they
+     * keep their own as operations may run on other threads */
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                    methods[i][0], methods[i][1]), 0);
+    #ifndef WOLFSSL_ASYNC_CRYPT
+        AssertPtrEq(wolfSSL_GetRNG(ssl_c), rng);
+        AssertPtrEq(wolfSSL_GetRNG(ssl_s), rng);
+    #else
+        AssertPtrNE(wolfSSL_GetRNG(ssl_c), rng);
+        AssertPtrNE(wolfSSL_GetRNG(ssl_s), rng);
+    #endif
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+#ifdef OPENSSL_EXTRA
+    AssertIntEQ(wolfSSL_RAND_bytes(parentBlock, sizeof(parentBlock)),
+                WOLFSSL_SUCCESS);
+#endif
+
+    /* another thread has its own, also for objects it uses */
+    AssertNotNull(ctx = wolfSSL_CTX_new(methods[0][0]()));
+    AssertNotNull(ssl = wolfSSL_new(ctx));
+    test_threadRngSsl = ssl;
+    XMEMSET(&args, 0, sizeof(args));
+    start_thread(test_thread_rng_thread, &args, &thread);
+    join_thread(thread);
+    AssertIntEQ(args.return_code, 0);
+    AssertNotNull(test_threadRng);
+    AssertPtrNE(test_threadRng, rng);
+#ifndef WOLFSSL_ASYNC_CRYPT
+    AssertPtrEq(test_threadRngSslRng, test_threadRng);
+#endif
+
+    /* a forked child doesn't repeat the parent's output */
+    AssertIntEQ(pipe(fds), 0);
+    pid = fork();
+    AssertIntGE(pid, 0);
+    if (pid == 0) {
+    #ifndef WOLFSSL_ASYNC_CRYPT
+        rng = wolfSSL_GetRNG(ssl);
+    #else
+        rng = wc_GetThreadRng();
+    #endif
+        if (rng == NULL ||
+                wc_RNG_GenerateBlock(rng, childBlock, sizeof(childBlock)) != 0 ||
+                write(fds[1], childBlock, sizeof(childBlock)) !=
+                                                    (int)sizeof(childBlock)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    AssertIntEQ(wc_RNG_GenerateBlock(rng, parentBlock, sizeof(parentBlock)), 0);
+    AssertIntEQ(read(fds[0], childBlock, sizeof(childBlock)),
+                sizeof(childBlock));
+    AssertIntEQ(waitpid(pid, &status, 0), pid);
+    AssertIntEQ(status, 0);
+    AssertIntNE(XMEMCMP(parentBlock, childBlock, sizeof(parentBlock)), 0);
+    close(fds[0]);
+    close(fds[1]);
+
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_HANDSHAKE_TIMING)
+/* count events of type, and of message msgType when not 0 */
+static int test_hs_timing_count(const WOLFSSL_HS_TIMING_EVENT* events,
+                                unsigned int count, int type, int msgType)
+{
+    unsigned int i;
+    int found = 0;
+
+    for (i = 0; i < count; i++) {
+        if (events[i].type == type &&
+                (msgType == 0 || events[i].msgType == msgType)) {
+            found++;
+        }
+    }
+
+    return found;
+}
+#endif
+
+static void test_wolfSSL_HandshakeTiming(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_HANDSHAKE_TIMING)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    /* handshake message types */
+    const int clientHello = 1, serverHello = 2, finished = 20;
+    const char msg[] = "timed";
+    char buf[sizeof(msg)];
+    WOLFSSL_HS_TIMING_EVENT events[64];
+    unsigned int buckets[WOLFSSL_HST_BUCKETS];
+    unsigned int count, total, crypto, certs, sum;
+    size_t i;
+    int j, k;
+
+    printf(testingFmt, "wolfSSL_SetHandshakeTiming()");
+
+    count = WOLFSSL_HST_BUCKETS;
+    AssertIntEQ(wolfSSL_CTX_SetHandshakeTiming(NULL, 1), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_SetHandshakeTiming(NULL, 1), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_GetHandshakeEvents(NULL, events, &count),
+                BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_GetHandshakeTime(NULL, WOLFSSL_HST_TOTAL, &total),
+                BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetHandshakeHistogram(NULL, WOLFSSL_HST_TOTAL,
+                buckets, &count), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+                    methods[i][0], methods[i][1]), 0);
+        /* server connections from the CTX, the client one by itself */
+        AssertIntEQ(wolfSSL_CTX_SetHandshakeTiming(ctx_s, 1), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, NULL, NULL), 0);
+        count = sizeof(events) / sizeof(events[0]);
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_c, events, &count),
+                    WOLFSSL_FAILURE);
+        AssertIntEQ(wolfSSL_SetHandshakeTiming(ssl_c, 1), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_GetHandshakeTime(ssl_c, WOLFSSL_HST_TYPES, &total),
+                    BAD_FUNC_ARG);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        /* client: hello out first, the server's answer checked. The first
+         * event starts the clock, a TLS 1.3 key share is made before */
+        count = sizeof(events) / sizeof(events[0]);
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_c, events, &count),
+                    WOLFSSL_SUCCESS);
+        AssertIntGT(count, 0);
+        AssertIntEQ(events[0].start, 0);
+        for (k = 0; events[k].type != WOLFSSL_HST_MSG_SEND; k++)
+            AssertIntLT(k + 1, count);
+        AssertIntEQ(events[k].msgType, clientHello);
+        for (k = 1; k < (int)count; k++) {
+            /* in the order they ended */
+            AssertIntGE(events[k].start + events[k].duration,
+                        events[k-1].start + events[k-1].duration);
+        }
+        AssertIntEQ(test_hs_timing_count(events, count, WOLFSSL_HST_MSG_RECV,
+                    serverHello), 1);
+        AssertIntEQ(test_hs_timing_count(events, count, WOLFSSL_HST_MSG_SEND,
+                    finished), 1);
+        AssertIntEQ(test_hs_timing_count(events, count,
+                    WOLFSSL_HST_CERT_VERIFY, 0), 1);
+        AssertIntGT(test_hs_timing_count(events, count, WOLFSSL_HST_VERIFY,
+                    0), 0);
+        AssertIntGT(test_hs_timing_count(events, count, WOLFSSL_HST_KEY_GEN,
+                    0), 0);
+        AssertIntGT(test_hs_timing_count(events, count,
+                    WOLFSSL_HST_SHARED_SECRET, 0), 0);
+        AssertIntGT(test_hs_timing_count(events, count, WOLFSSL_HST_IO_WRITE,
+                    0), 0);
+        AssertIntGT(test_hs_timing_count(events, count, WOLFSSL_HST_IO_READ,
+                    0), 0);
+
+        AssertIntEQ(wolfSSL_GetHandshakeTime(ssl_c, WOLFSSL_HST_TOTAL, &total),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_GetHandshakeTime(ssl_c, WOLFSSL_HST_CRYPTO,
+                    &crypto), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_GetHandshakeTime(ssl_c, WOLFSSL_HST_CERT_VERIFY,
+                    &certs), WOLFSSL_SUCCESS);
+        AssertIntGE(total, crypto);
+        AssertIntGE(total, certs);
+
+        /* size query, a short copy */
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_c, NULL, &count),
+                    WOLFSSL_SUCCESS);
+        k = (int)count;
+        count = 1;
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_c, events, &count),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(count, 1);
+
+        /* server: answers the hello and signs */
+        count = sizeof(events) / sizeof(events[0]);
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_s, events, &count),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(test_hs_timing_count(events, count, WOLFSSL_HST_MSG_RECV,
+                    clientHello), 1);
+        AssertIntEQ(test_hs_timing_count(events, count, WOLFSSL_HST_MSG_SEND,
+                    serverHello), 1);
+        AssertIntEQ(test_hs_timing_count(events, count, WOLFSSL_HST_MSG_RECV,
+                    finished), 1);
+        AssertIntGT(test_hs_timing_count(events, count, WOLFSSL_HST_SIGN, 0),
+                    0);
+        AssertIntEQ(test_hs_timing_count(events, count,
+                    WOLFSSL_HST_CERT_VERIFY, 0), 0);
+
+        /* application data isn't recorded */
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_GetHandshakeEvents(ssl_c, NULL, &count),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(count, k);
+
+        /* one handshake in each server histogram, none from the client */
+        for (j = 0; j < WOLFSSL_HST_TYPES; j++) {
+            count = WOLFSSL_HST_BUCKETS;
+            AssertIntEQ(wolfSSL_CTX_GetHandshakeHistogram(ctx_s, j, buckets,
+                        &count), WOLFSSL_SUCCESS);
+            AssertIntEQ(count, WOLFSSL_HST_BUCKETS);
+            for (sum = 0, k = 0; k < (int)count; k++)
+                sum += buckets[k];
+            AssertIntEQ(sum, 1);
+
+            AssertIntEQ(wolfSSL_CTX_GetHandshakeHistogram(ctx_c, j, buckets,
+                        &count), WOLFSSL_SUCCESS);
+            for (sum = 0, k = 0; k < (int)count; k++)
+                sum += buckets[k];
+            AssertIntEQ(sum, 0);
+        }
+
+        AssertIntEQ(wolfSSL_SetHandshakeTiming(ssl_c, 0), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_GetHandshakeTime(ssl_c, WOLFSSL_HST_TOTAL, &total),
+                    WOLFSSL_FAILURE);
+
+        /* turning the CTX on again clears its histograms */
+        AssertIntEQ(wolfSSL_CTX_SetHandshakeTiming(ctx_s, 1), WOLFSSL_SUCCESS);
+        count = WOLFSSL_HST_BUCKETS;
+        AssertIntEQ(wolfSSL_CTX_GetHandshakeHistogram(ctx_s,
+                    WOLFSSL_HST_TOTAL, buckets, &count), WOLFSSL_SUCCESS);
+        for (sum = 0, k = 0; k < (int)count; k++)
+            sum += buckets[k];
+        AssertIntEQ(sum, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_CTX_STATS)
+/* sum of n counters */
+static word64 test_ctx_stats_sum(const word64* counters, int n)
+{
+    word64 sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += counters[i];
+
+    return sum;
+}
+#endif
+
+static void test_wolfSSL_CTX_GetStats(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_CTX_STATS)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    int versions[] = {
+    #ifndef WOLFSSL_NO_TLS12
+        WOLFSSL_STAT_TLSV1_2,
+    #endif
+    #ifdef WOLFSSL_TLS13
+        WOLFSSL_STAT_TLSV1_3,
+    #endif
+    };
+    /* alert codes */
+    const int closeNotify = 0;
+    const char msg[] = "counted";
+    char buf[sizeof(msg)];
+    WOLFSSL_STATS st_c, st_s, zero;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_CTX_GetStats()");
+
+    XMEMSET(&zero, 0, sizeof(zero));
+    AssertIntEQ(wolfSSL_CTX_GetStats(NULL, &st_c), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_ClearStats(NULL), BAD_FUNC_ARG);
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int v = versions[i];
+        int hrr = (v == WOLFSSL_STAT_TLSV1_3);
+        word64 alerts;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                    methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, NULL), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(XMEMCMP(&st_c, &zero, sizeof(zero)), 0);
+
+    #if defined(WOLFSSL_TLS13) && defined(HAVE_SUPPORTED_CURVES)
+        /* no key share in the hello gets a HelloRetryRequest */
+        if (hrr)
+            AssertIntEQ(wolfSSL_NoKeyShares(ssl_c), WOLFSSL_SUCCESS);
+    #else
+        hrr = 0;
+    #endif
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+        AssertIntNE(wolfSSL_shutdown(ssl_c), WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), 0);
+
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_s, &st_s), WOLFSSL_SUCCESS);
+        AssertIntEQ(st_c.handshakes[v], 1);
+        AssertIntEQ(st_s.handshakes[v], 1);
+        AssertIntEQ(test_ctx_stats_sum(st_c.handshakes,
+                    WOLFSSL_STAT_VERSIONS), 1);
+        AssertIntEQ(test_ctx_stats_sum(st_c.resumed, WOLFSSL_STAT_VERSIONS),
+                    0);
+        AssertIntEQ(st_c.helloRetries, hrr);
+        AssertIntEQ(st_s.helloRetries, hrr);
+        /* everything sent was taken in by the peer */
+        AssertIntGT(st_c.bytesOut, 0);
+        AssertIntEQ(st_c.bytesOut, st_s.bytesIn);
+        AssertIntEQ(st_s.bytesOut, st_c.bytesIn);
+        AssertIntGT(st_c.recordsOut, 0);
+        AssertIntEQ(st_c.recordsOut, st_s.recordsIn);
+        AssertIntEQ(st_s.recordsOut, st_c.recordsIn);
+        AssertIntEQ(st_c.alertsSent[closeNotify], 1);
+        AssertIntEQ(st_s.alertsReceived[closeNotify], 1);
+        AssertIntEQ(test_ctx_stats_sum(st_s.alertsSent, WOLFSSL_STAT_ALERTS),
+                    0);
+
+    #ifndef NO_SESSION_CACHE
+    #ifndef HAVE_SESSION_TICKET
+        if (v != WOLFSSL_STAT_TLSV1_3)
+    #endif
+        {
+            /* resumed from the ID in TLS 1.2, from a ticket in TLS 1.3 */
+            WOLFSSL *ssl_c2 = NULL, *ssl_s2 = NULL;
+
+            XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+            AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c2,
+                        &ssl_s2, NULL, NULL), 0);
+            AssertIntEQ(wolfSSL_set_session(ssl_c2, wolfSSL_get_session(ssl_c)),
+                        WOLFSSL_SUCCESS);
+            AssertIntEQ(test_memio_do_handshake(ssl_c2, ssl_s2, 10), 0);
+            wolfSSL_free(ssl_c2);
+            wolfSSL_free(ssl_s2);
+
+            AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+            AssertIntEQ(wolfSSL_CTX_GetStats(ctx_s, &st_s), WOLFSSL_SUCCESS);
+            AssertIntEQ(st_c.handshakes[v], 1);
+            AssertIntEQ(st_c.resumed[v], 1);
+            AssertIntEQ(st_s.resumed[v], 1);
+            AssertIntEQ(st_c.resumedTicket, v == WOLFSSL_STAT_TLSV1_3);
+            AssertIntEQ(st_c.resumedId, v != WOLFSSL_STAT_TLSV1_3);
+            AssertIntEQ(st_s.resumedTicket + st_s.resumedId, 1);
+        }
+    #endif
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        ssl_c = ssl_s = NULL;
+        alerts = test_ctx_stats_sum(st_c.alertsSent, WOLFSSL_STAT_ALERTS);
+
+        /* a certificate for another name fails the client, freeing counts */
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, NULL, NULL), 0);
+        AssertIntEQ(wolfSSL_check_domain_name(ssl_c, "wrong.example.com"),
+                    WOLFSSL_SUCCESS);
+        AssertIntNE(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+        /* server reads what the client left */
+        AssertIntEQ(wolfSSL_accept(ssl_s), WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(test_ctx_stats_sum(st_c.failures,
+                    WOLFSSL_STAT_FAIL_REASONS), 0);
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_s, &st_s), WOLFSSL_SUCCESS);
+        AssertIntEQ(st_c.failures[WOLFSSL_STAT_FAIL_CERT], 1);
+        AssertIntEQ(test_ctx_stats_sum(st_c.failures,
+                    WOLFSSL_STAT_FAIL_REASONS), 1);
+        /* the server hears of it when the client sent an alert */
+        AssertIntEQ(st_s.failures[WOLFSSL_STAT_FAIL_ALERT],
+                    test_ctx_stats_sum(st_c.alertsSent, WOLFSSL_STAT_ALERTS) -
+                    alerts);
+
+        AssertIntEQ(wolfSSL_CTX_ClearStats(ctx_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_GetStats(ctx_c, &st_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(XMEMCMP(&st_c, &zero, sizeof(zero)), 0);
+
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_TRACE)
+/* count events of id about obj, and with arg when not -1 */
+static int test_trace_count(const wc_TraceEvent* events, word32 count,
+                            int id, const void* obj, int arg)
+{
+    word32 i;
+    int found = 0;
+
+    for (i = 0; i < count; i++) {
+        if (events[i].id == id && events[i].obj == obj &&
+                (arg == -1 || events[i].arg == arg)) {
+            found++;
+        }
+    }
+
+    return found;
+}
+#endif
+
+static void test_wolfSSL_Trace(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_TRACE)
+    /* handshake message types */
+    const int clientHello = 1, finished = 20;
+    test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+    wc_TraceEvent events[WOLFSSL_TRACE_EVENTS];
+    byte*  out;
+    word32 count, outSz, i;
+
+    printf(testingFmt, "wolfSSL_Trace_Get()");
+
+    AssertIntEQ(wolfSSL_Trace_Get(events, NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_Trace_Export(NULL, NULL), BAD_FUNC_ARG);
+    AssertStrEQ(wolfSSL_Trace_EventName(0), "unknown");
+    AssertStrEQ(wolfSSL_Trace_EventName(WC_TRACE_IDS), "unknown");
+    AssertStrEQ(wolfSSL_Trace_EventName(WC_TRACE_HS_RECV), "hs recv");
+
+    /* nothing recorded while off */
+    wolfSSL_Trace_Clear();
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_Trace_Get(NULL, &count), 0);
+    AssertIntEQ(count, 0);
+
+    AssertIntEQ(wolfSSL_Trace_ON(), 0);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+    wolfSSL_Trace_OFF();
+
+    /* the ring holds the newest events of the thread */
+    count = sizeof(events) / sizeof(events[0]);
+    AssertIntEQ(wolfSSL_Trace_Get(events, &count), 0);
+    AssertIntGT(count, 0);
+    AssertIntLE(count, WOLFSSL_TRACE_EVENTS);
+    for (i = 1; i < count; i++)
+        AssertTrue(events[i].time >= events[i-1].time);
+    AssertIntEQ(test_trace_count(events, count, WC_TRACE_HS_DONE, ssl_c, -1),
+                1);
+    AssertIntEQ(test_trace_count(events, count, WC_TRACE_HS_DONE, ssl_s, -1),
+                1);
+    AssertIntEQ(test_trace_count(events, count, WC_TRACE_HS_SEND, ssl_c,
+                finished), 1);
+    AssertIntEQ(test_trace_count(events, count, WC_TRACE_HS_RECV, ssl_s,
+                finished), 1);
+    AssertIntGT(test_trace_count(events, count, WC_TRACE_RECORD_IN, ssl_c,
+                -1), 0);
+    AssertIntGT(test_trace_count(events, count, WC_TRACE_LEAVE, ssl_s, -1) +
+                test_trace_count(events, count, WC_TRACE_LEAVE, ssl_c, -1), 0);
+    /* the hello is out of the ring when the handshake took more events */
+    if (count < WOLFSSL_TRACE_EVENTS) {
+        AssertIntEQ(test_trace_count(events, count, WC_TRACE_HS_RECV, ssl_s,
+                    clientHello), 1);
+    }
+
+    /* a short copy is the newest events */
+    i = count;
+    count = 1;
+    AssertIntEQ(wolfSSL_Trace_Get(events, &count), 0);
+    AssertIntEQ(count, 1);
+    AssertIntEQ(wolfSSL_Trace_Get(NULL, &count), 0);
+    AssertIntEQ(count, i);
+
+    /* export is the header and each event with its name */
+    AssertIntEQ(wolfSSL_Trace_Export(NULL, &outSz), 0);
+    AssertIntGE(outSz, WC_TRACE_HDR_SZ + count * WC_TRACE_EVENT_SZ);
+    AssertNotNull(out = (byte*)XMALLOC(outSz, NULL, DYNAMIC_TYPE_TMP_BUFFER));
+    i = outSz - 1;
+    AssertIntEQ(wolfSSL_Trace_Export(out, &i), BUFFER_E);
+    AssertIntEQ(wolfSSL_Trace_Export(out, &outSz), 0);
+    AssertIntEQ(XMEMCMP(out, WC_TRACE_MAGIC, 4), 0);
+    AssertIntEQ(out[7], WC_TRACE_VERSION);
+    AssertIntEQ(((word32)out[8] << 24) | ((word32)out[9] << 16) |
+                ((word32)out[10] << 8) | out[11], count);
+    XFREE(out, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    wolfSSL_Trace_Clear();
+    AssertIntEQ(wolfSSL_Trace_Get(NULL, &count), 0);
+    AssertIntEQ(count, 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_dyn_record_size(void)
+{
+#if defined(HAVE_TEST_MEMIO) && defined(WOLFSSL_DYN_RECORD_SIZE)
+    method_provider methods[][2] = {
+    #ifndef WOLFSSL_NO_TLS12
+        { wolfTLSv1_2_client_method, wolfTLSv1_2_server_method },
+    #endif
+    #ifdef WOLFSSL_TLS13
+        { wolfTLSv1_3_client_method, wolfTLSv1_3_server_method },
+    #endif
+    };
+    static byte msg[16000];
+    static byte buf[sizeof(msg)];
+    WOLFSSL_RECORD_SIZE_STATS stats;
+    size_t i;
+
+    printf(testingFmt, "wolfSSL_SetDynRecordSize()");
+
+    AssertIntEQ(wolfSSL_CTX_SetDynRecordSize(NULL, 1400, 0, 0, 0),
+                BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_SetDynRecordSize(NULL, 1400, 0, 0, 0), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_GetRecordSizeStats(NULL, &stats), BAD_FUNC_ARG);
+    XMEMSET(msg, 0x5a, sizeof(msg));
+
+    for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        test_memio_ctx test_ctx;
+        WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+        WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+        int got = 0;
+        int ret;
+
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                    &ssl_s, methods[i][0], methods[i][1]), 0);
+        AssertIntEQ(wolfSSL_SetDynRecordSize(ssl_c, 16384 + 1, 0, 0, 0),
+                    BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_SetDynRecordSize(ssl_c, 1400, 4000, 0, 0),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10), 0);
+
+        /* three small records, then the rest in one full size record */
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_GetRecordSizeStats(ssl_c, &stats),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(stats.records[2], 3);
+        AssertIntEQ(stats.records[5], 1);
+        AssertIntEQ(stats.smallRecords, 3);
+        AssertIntEQ(stats.rampUps, 1);
+        while (got < (int)sizeof(msg)) {
+            ret = wolfSSL_read(ssl_s, buf + got, sizeof(buf) - got);
+            AssertIntGT(ret, 0);
+            got += ret;
+        }
+        AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+
+        /* new policy starts a new burst */
+        AssertIntEQ(wolfSSL_SetDynRecordSize(ssl_c, 1400, 4000, 0, 0),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_write(ssl_c, msg, 2000), 2000);
+        AssertIntEQ(wolfSSL_GetRecordSizeStats(ssl_c, &stats),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(stats.records[1], 1);
+        AssertIntEQ(stats.records[2], 4);
+        AssertIntEQ(stats.smallRecords, 4);
+        got = 0;
+        while (got < 2000) {
+            ret = wolfSSL_read(ssl_s, buf + got, sizeof(buf) - got);
+            AssertIntGT(ret, 0);
+            got += ret;
+        }
+
+        /* policy off on the server, records only counted */
+        AssertIntEQ(wolfSSL_write(ssl_s, msg, sizeof(msg)), sizeof(msg));
+        AssertIntEQ(wolfSSL_GetRecordSizeStats(ssl_s, &stats),
+                    WOLFSSL_SUCCESS);
+        AssertIntEQ(stats.records[5], 1);
+        AssertIntEQ(stats.smallRecords, 0);
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
 #if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE) && !defined(WOLFSSL_TLS13)
 static void test_wolfSSL_reuse_WOLFSSLobj(void)
 {
@@ -42196,6 +44650,29 @@ void ApiTest(void)
     test_wolfSSL_reuse_WOLFSSLobj();
 #endif
     test_wolfSSL_dtls_export();
+#endif
+#ifdef HAVE_IO_TESTS_DEPENDENCIES
+    test_wolfSSL_read_zero_copy();
+    test_wolfSSL_write_zero_copy();
+    test_wolfSSL_ktls();
+    test_wolfSSL_dyn_record_size();
+    test_wolfSSL_read_ahead();
+    test_wolfSSL_CTX_UseIOBufferPool();
+    test_wolfSSL_CompactResources();
+    test_wolfSSL_GetMemFootprint();
+    test_wolfSSL_sendfile();
+    test_wolfAsync_DevOpen();
+    test_wolfSSL_CTX_AsyncDrain();
+    test_wolfSSL_CTX_UseKeySharePool();
+    test_wolfSSL_CTX_private_key_cache();
+    test_wolfSSL_CTX_cert_msg_cache();
+    test_wolfSSL_UseClientSuites();
+    test_wolfSSL_CTX_shared_suites();
+    test_wolfSSL_CTX_UseSSLPool();
+    test_wc_GetThreadRng();
+    test_wolfSSL_HandshakeTiming();
+    test_wolfSSL_CTX_GetStats();
+    test_wolfSSL_Trace();
 #endif
     AssertIntEQ(test_wolfSSL_SetMinVersion(), WOLFSSL_SUCCESS);
     AssertIntEQ(test_wolfSSL_CTX_SetMinVersion(), WOLFSSL_SUCCESS);
@@ -2177,22 +2177,12 @@ int benchmark_test(void *args)
 
 
 #ifndef WC_NO_RNG
-void bench_rng(void)
+/* requests of reqSz bytes, 0 for the largest allowed */
+static void bench_rng_internal(WC_RNG* myrng, const char* label, long reqSz)
 {
-    int    ret, i, count;
+    int    ret = 0, i, count;
     double start;
     long   pos, len, remain;
-    WC_RNG myrng;
-
-#ifndef HAVE_FIPS
-    ret = wc_InitRng_ex(&myrng, HEAP_HINT, devId);
-#else
-    ret = wc_InitRng(&myrng);
-#endif
-    if (ret < 0) {
-        printf("InitRNG failed %d\n", ret);
-        return;
-    }
 
     bench_stats_start(&count, &start);
     do {
@@ -2204,7 +2194,9 @@ void bench_rng(void)
                 len = remain;
                 if (len > RNG_MAX_BLOCK_LEN)
                     len = RNG_MAX_BLOCK_LEN;
-                ret = wc_RNG_GenerateBlock(&myrng, &bench_plain[pos], (word32)len);
+                if (reqSz > 0 && len > reqSz)
+                    len = reqSz;
+                ret = wc_RNG_GenerateBlock(myrng, &bench_plain[pos], (word32)len);
                 if (ret < 0)
                     goto exit_rng;
 
@@ -2215,9 +2207,53 @@ void bench_rng(void)
         count += i;
     } while (bench_stats_sym_check(start));
 exit_rng:
-    bench_stats_sym_finish("RNG", 0, count, bench_size, start, ret);
+    bench_stats_sym_finish(label, 0, count, bench_size, start, ret);
+}
+
+void bench_rng(void)
+{
+    int    ret;
+    WC_RNG myrng;
+#ifdef WC_RNG_CTR_DRBG
+    /* each DRBG with bulk and nonce sized requests */
+    static const struct {
+        const char* label;
+        int         type;
+        long        reqSz;
+    } rngs[] = {
+        { "RNG SHA-256",     WC_DRBG_HASH, 0  },
+        { "RNG SHA-256 32B", WC_DRBG_HASH, 32 },
+        { "RNG AES-CTR",     WC_DRBG_CTR,  0  },
+        { "RNG AES-CTR 32B", WC_DRBG_CTR,  32 },
+    };
+    size_t j;
+
+    for (j = 0; j < sizeof(rngs) / sizeof(rngs[0]); j++) {
+        ret = wc_InitRngDrbg_ex(&myrng, rngs[j].type, HEAP_HINT, devId);
+        if (ret < 0) {
+            printf("InitRNG failed %d\n", ret);
+            return;
+        }
+
+        bench_rng_internal(&myrng, rngs[j].label, rngs[j].reqSz);
+
+        wc_FreeRng(&myrng);
+    }
+#else
+#ifndef HAVE_FIPS
+    ret = wc_InitRng_ex(&myrng, HEAP_HINT, devId);
+#else
+    ret = wc_InitRng(&myrng);
+#endif
+    if (ret < 0) {
+        printf("InitRNG failed %d\n", ret);
+        return;
+    }
+
+    bench_rng_internal(&myrng, "RNG", 0);
 
     wc_FreeRng(&myrng);
+#endif /* WC_RNG_CTR_DRBG */
 }
 #endif /* WC_NO_RNG */
 
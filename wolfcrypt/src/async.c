@@ -0,0 +1,666 @@
+/* async.c
+ *
+ * Copyright (C) 2006-2021 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+
+#include <wolfssl/wolfcrypt/settings.h>
+
+#if defined(WOLFSSL_ASYNC_CRYPT) && defined(WOLFSSL_ASYNC_CRYPT_TEST)
+
+#include <wolfssl/wolfcrypt/async.h>
+#include <wolfssl/wolfcrypt/error-crypt.h>
+#include <wolfssl/wolfcrypt/logging.h>
+#ifndef NO_RSA
+    #include <wolfssl/wolfcrypt/rsa.h>
+#endif
+#ifdef HAVE_ECC
+    #include <wolfssl/wolfcrypt/ecc.h>
+#endif
+#ifndef NO_DH
+    #include <wolfssl/wolfcrypt/dh.h>
+#endif
+
+#ifdef NO_INLINE
+    #include <wolfssl/wolfcrypt/misc.h>
+#else
+    #define WOLFSSL_MISC_INCLUDED
+    #include <wolfcrypt/src/misc.c>
+#endif
+
+#include <stddef.h>
+#ifndef WC_NO_ASYNC_THREADING
+    #include <unistd.h>
+    #include <sched.h>
+#endif
+
+/* Software async device
+ *
+ * A public key operation on a key whose async device context is marked gets
+ * its arguments captured by wc_AsyncTestInit() and returns WC_PENDING_E.
+ * When the event for it is pushed the device context is queued for the
+ * worker threads. A worker calls the operation again, this time
+ * wc_AsyncTestInit() lets it run synchronously, and marks the device done.
+ * Polling the event picks up the result. The caller then calls again, or
+ * moves on, as the event flags say, just as with an async hardware device.
+ */
+
+/* where a device context is in the software device */
+enum {
+    ASYNC_SW_IDLE = 0,
+    ASYNC_SW_QUEUED,
+    ASYNC_SW_RUNNING,
+    ASYNC_SW_DONE,
+};
+
+#ifndef WC_NO_ASYNC_THREADING
+static pthread_mutex_t asyncLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  asyncWork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  asyncDone = PTHREAD_COND_INITIALIZER;
+static pthread_t       asyncThreads[WC_ASYNC_MAX_THREADS];
+static int             asyncThreadCount = 0;
+static int             asyncStop = 0;
+static WC_ASYNC_DEV*   asyncHead = NULL;
+static WC_ASYNC_DEV*   asyncTail = NULL;
+
+    #define ASYNC_LOCK()      pthread_mutex_lock(&asyncLock)
+    #define ASYNC_UNLOCK()    pthread_mutex_unlock(&asyncLock)
+#else
+    #define ASYNC_LOCK()      do {} while (0)
+    #define ASYNC_UNLOCK()    do {} while (0)
+#endif
+static int             asyncOpenCount = 0;
+
+
+static WC_ASYNC_DEV* AsyncEventDev(WOLF_EVENT* event)
+{
+    return (WC_ASYNC_DEV*)((byte*)event - offsetof(WC_ASYNC_DEV, event));
+}
+
+/* Run the captured operation. The capture is still in place so the
+ * operation goes the synchronous way this time. */
+static int AsyncRun(WC_ASYNC_DEV* dev)
+{
+    int ret = ASYNC_OP_E;
+    WC_ASYNC_TEST* t = &dev->test;
+
+    switch (dev->testType) {
+#ifdef WC_ASYNC_ENABLE_RSA
+        case ASYNC_TEST_RSA_FUNC:
+            ret = wc_RsaFunction(t->rsaFunc.in, t->rsaFunc.inSz,
+                t->rsaFunc.out, t->rsaFunc.outSz, t->rsaFunc.type,
+                t->rsaFunc.key, t->rsaFunc.rng);
+            break;
+    #ifdef WOLFSSL_KEY_GEN
+        case ASYNC_TEST_RSA_MAKE:
+            ret = wc_MakeRsaKey(t->rsaMake.key, t->rsaMake.size,
+                t->rsaMake.e, t->rsaMake.rng);
+            break;
+    #endif
+#endif
+#ifdef WC_ASYNC_ENABLE_ECC
+        case ASYNC_TEST_ECC_MAKE:
+            ret = wc_ecc_make_key_ex2(t->eccMake.rng, t->eccMake.size,
+                t->eccMake.key, t->eccMake.curve_id, t->eccMake.key->flags);
+            break;
+    #ifdef HAVE_ECC_SIGN
+        case ASYNC_TEST_ECC_SIGN:
+            ret = wc_ecc_sign_hash_ex(t->eccSign.in, t->eccSign.inSz,
+                t->eccSign.rng, t->eccSign.key, (mp_int*)t->eccSign.r,
+                (mp_int*)t->eccSign.s);
+            break;
+    #endif
+    #ifdef HAVE_ECC_VERIFY
+        case ASYNC_TEST_ECC_VERIFY:
+            ret = wc_ecc_verify_hash_ex((mp_int*)t->eccVerify.r,
+                (mp_int*)t->eccVerify.s, t->eccVerify.hash,
+                t->eccVerify.hashlen, t->eccVerify.stat, t->eccVerify.key);
+            break;
+    #endif
+    #ifdef HAVE_ECC_DHE
+        case ASYNC_TEST_ECC_SHARED_SEC:
+            ret = wc_ecc_shared_secret_gen(t->eccSharedSec.private_key,
+                (ecc_point*)t->eccSharedSec.public_point,
+                t->eccSharedSec.out, t->eccSharedSec.outLen);
+            break;
+    #endif
+#endif
+#ifdef WC_ASYNC_ENABLE_DH
+        case ASYNC_TEST_DH_GEN:
+            ret = wc_DhGenerateKeyPair(t->dhGen.key, t->dhGen.rng,
+                t->dhGen.priv, t->dhGen.privSz, t->dhGen.pub, t->dhGen.pubSz);
+            break;
+        case ASYNC_TEST_DH_AGREE:
+            ret = wc_DhAgree(t->dhAgree.key, t->dhAgree.agree,
+                t->dhAgree.agreeSz, t->dhAgree.priv, t->dhAgree.privSz,
+                t->dhAgree.otherPub, t->dhAgree.pubSz);
+            break;
+#endif
+        default:
+            WOLFSSL_MSG("Unknown software async operation");
+            break;
+    }
+
+    return ret;
+}
+
+/* record the result, called with the lock held */
+static void AsyncFinish(WC_ASYNC_DEV* dev, int ret)
+{
+    dev->testRet = ret;
+    dev->testType = ASYNC_TEST_NONE;
+    dev->testState = ASYNC_SW_DONE;
+#ifdef WOLF_EVENT_NOTIFY
+    if (dev->event.notify != NULL)
+        wolfEventQueue_Notify(dev->event.notify, &dev->event);
+#endif
+}
+
+#ifndef WC_NO_ASYNC_THREADING
+static void* AsyncWorker(void* arg)
+{
+    WC_ASYNC_DEV* dev;
+    int ret;
+
+    (void)arg;
+
+    ASYNC_LOCK();
+    for (;;) {
+        while (asyncHead == NULL && !asyncStop)
+            pthread_cond_wait(&asyncWork, &asyncLock);
+        if (asyncHead == NULL)
+            break; /* stopping and nothing left to run */
+
+        dev = asyncHead;
+        asyncHead = dev->next;
+        if (asyncHead == NULL)
+            asyncTail = NULL;
+        dev->next = NULL;
+        dev->testState = ASYNC_SW_RUNNING;
+        ASYNC_UNLOCK();
+
+        ret = AsyncRun(dev);
+
+        ASYNC_LOCK();
+        AsyncFinish(dev, ret);
+        pthread_cond_broadcast(&asyncDone);
+    }
+    ASYNC_UNLOCK();
+
+    return NULL;
+}
+#endif /* !WC_NO_ASYNC_THREADING */
+
+/* Hand the captured operation of dev to the workers. Without workers it is
+ * left queued and run when the event is polled. */
+static int AsyncSubmit(WC_ASYNC_DEV* dev)
+{
+    if (dev->testType == ASYNC_TEST_NONE) {
+        WOLFSSL_MSG("No operation captured for async device");
+        return ASYNC_OP_E;
+    }
+
+    ASYNC_LOCK();
+    dev->testState = ASYNC_SW_QUEUED;
+    dev->next = NULL;
+#ifndef WC_NO_ASYNC_THREADING
+    if (asyncThreadCount > 0) {
+        if (asyncTail == NULL)
+            asyncHead = dev;
+        else
+            asyncTail->next = dev;
+        asyncTail = dev;
+        pthread_cond_signal(&asyncWork);
+    }
+#endif
+    ASYNC_UNLOCK();
+
+    return 0;
+}
+
+/* Take dev off the worker queue or wait for a worker to finish with it,
+ * called with the lock held */
+static void AsyncCancel(WC_ASYNC_DEV* dev)
+{
+#ifndef WC_NO_ASYNC_THREADING
+    WC_ASYNC_DEV* prev = NULL;
+    WC_ASYNC_DEV* cur;
+
+    if (dev->testState == ASYNC_SW_QUEUED) {
+        for (cur = asyncHead; cur != NULL; prev = cur, cur = cur->next) {
+            if (cur == dev)
+                break;
+        }
+        if (cur != NULL) {
+            if (prev == NULL)
+                asyncHead = dev->next;
+            else
+                prev->next = dev->next;
+            if (asyncTail == dev)
+                asyncTail = prev;
+        }
+    }
+    while (dev->testState == ASYNC_SW_RUNNING)
+        pthread_cond_wait(&asyncDone, &asyncLock);
+#endif
+
+    dev->next = NULL;
+    dev->testType = ASYNC_TEST_NONE;
+    dev->testState = ASYNC_SW_IDLE;
+}
+
+
+int wolfAsync_HardwareStart(void)
+{
+    return 0;
+}
+
+void wolfAsync_HardwareStop(void)
+{
+}
+
+/* Open the software device with threads workers, 0 is one per online CPU.
+ * The workers are shared by all opens and stop with the last close. */
+int wolfAsync_DevOpenThreads(int* devId, int threads)
+{
+    int ret = 0;
+
+    if (devId == NULL)
+        return BAD_FUNC_ARG;
+
+#ifndef WC_NO_ASYNC_THREADING
+    if (threads <= 0)
+        threads = wc_AsyncGetNumberOfCpus();
+    if (threads > WC_ASYNC_MAX_THREADS)
+        threads = WC_ASYNC_MAX_THREADS;
+
+    ASYNC_LOCK();
+    if (asyncOpenCount == 0) {
+        asyncStop = 0;
+        for (asyncThreadCount = 0; asyncThreadCount < threads;
+                                                        asyncThreadCount++) {
+            if (pthread_create(&asyncThreads[asyncThreadCount], NULL,
+                                                    AsyncWorker, NULL) != 0) {
+                WOLFSSL_MSG("Async worker thread create failed");
+                break;
+            }
+        }
+        if (asyncThreadCount == 0)
+            ret = ASYNC_INIT_E;
+    }
+    if (ret == 0)
+        asyncOpenCount++;
+    ASYNC_UNLOCK();
+#else
+    (void)threads;
+    asyncOpenCount++;
+#endif
+
+    *devId = (ret == 0) ? WOLFSSL_ASYNC_DEVID : INVALID_DEVID;
+
+    return ret;
+}
+
+int wolfAsync_DevOpen(int* devId)
+{
+    return wolfAsync_DevOpenThreads(devId, WC_ASYNC_THREADS);
+}
+
+void wolfAsync_DevClose(int* devId)
+{
+#ifndef WC_NO_ASYNC_THREADING
+    int threads = 0;
+    int i;
+#endif
+
+    if (devId == NULL || *devId == INVALID_DEVID)
+        return;
+
+    ASYNC_LOCK();
+    if (asyncOpenCount > 0 && --asyncOpenCount == 0) {
+    #ifndef WC_NO_ASYNC_THREADING
+        /* workers finish what is queued before they exit */
+        asyncStop = 1;
+        threads = asyncThreadCount;
+        pthread_cond_broadcast(&asyncWork);
+    #endif
+    }
+    ASYNC_UNLOCK();
+
+#ifndef WC_NO_ASYNC_THREADING
+    for (i = 0; i < threads; i++)
+        pthread_join(asyncThreads[i], NULL);
+    if (threads > 0) {
+        ASYNC_LOCK();
+        asyncThreadCount = 0;
+        ASYNC_UNLOCK();
+    }
+#endif
+
+    *devId = INVALID_DEVID;
+}
+
+int wolfAsync_DevCtxInit(WC_ASYNC_DEV* asyncDev, word32 marker, void* heap,
+                         int devId)
+{
+    if (asyncDev == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(asyncDev, 0, sizeof(*asyncDev));
+    asyncDev->heap = heap;
+    if (devId != INVALID_DEVID)
+        asyncDev->marker = marker;
+
+    return 0;
+}
+
+void wolfAsync_DevCtxFree(WC_ASYNC_DEV* asyncDev, word32 marker)
+{
+    if (asyncDev == NULL || asyncDev->marker != marker)
+        return;
+
+    ASYNC_LOCK();
+    if (asyncDev->testState != ASYNC_SW_IDLE)
+        AsyncCancel(asyncDev);
+    ASYNC_UNLOCK();
+
+    asyncDev->marker = WOLFSSL_ASYNC_MARKER_INVALID;
+}
+
+int wolfAsync_DevCopy(WC_ASYNC_DEV* src, WC_ASYNC_DEV* dst)
+{
+    if (src == NULL || dst == NULL)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(dst, 0, sizeof(*dst));
+    dst->marker = src->marker;
+    dst->heap = src->heap;
+
+    return 0;
+}
+
+int wc_AsyncTestInit(WC_ASYNC_DEV* dev, int type)
+{
+    /* the second time round the operation is run by the device */
+    if (dev == NULL || dev->testType != ASYNC_TEST_NONE)
+        return 0;
+
+    dev->testType = type;
+    return 1;
+}
+
+
+int wolfAsync_EventInit(WOLF_EVENT* event, WOLF_EVENT_TYPE type,
+                        void* context, word32 flags)
+{
+    int ret = wolfEvent_Init(event, type, context);
+
+    if (ret == 0) {
+        event->dev.async = AsyncEventDev(event);
+        event->flags = flags;
+    }
+
+    return ret;
+}
+
+int wolfAsync_EventPoll(WOLF_EVENT* event, WOLF_EVENT_FLAG flags)
+{
+    WC_ASYNC_DEV* dev;
+    int run = 0;
+
+    (void)flags;
+
+    if (event == NULL)
+        return BAD_FUNC_ARG;
+    if (event->state != WOLF_EVENT_STATE_PENDING)
+        return 0;
+
+    dev = AsyncEventDev(event);
+
+    ASYNC_LOCK();
+#ifndef WC_NO_ASYNC_THREADING
+    run = (dev->testState == ASYNC_SW_QUEUED && asyncThreadCount == 0);
+#else
+    run = (dev->testState == ASYNC_SW_QUEUED);
+#endif
+    if (run)
+        dev->testState = ASYNC_SW_RUNNING;
+    ASYNC_UNLOCK();
+
+    if (run) {
+        int ret = AsyncRun(dev);
+        ASYNC_LOCK();
+        AsyncFinish(dev, ret);
+        ASYNC_UNLOCK();
+    }
+
+#ifdef WOLF_EVENT_NOTIFY
+    /* the result is picked up when the queue collects the posted event */
+    if (event->notify != NULL)
+        return 0;
+#endif
+
+    ASYNC_LOCK();
+    if (dev->testState == ASYNC_SW_DONE) {
+        event->ret = dev->testRet;
+        event->state = WOLF_EVENT_STATE_DONE;
+        dev->testState = ASYNC_SW_IDLE;
+    }
+    ASYNC_UNLOCK();
+
+    return 0;
+}
+
+int wolfAsync_EventWait(WOLF_EVENT* event)
+{
+    int ret = 0;
+
+    if (event == NULL)
+        return BAD_FUNC_ARG;
+
+#ifndef WC_NO_ASYNC_THREADING
+    {
+        WC_ASYNC_DEV* dev = AsyncEventDev(event);
+
+        ASYNC_LOCK();
+        while (asyncThreadCount > 0 && (dev->testState == ASYNC_SW_QUEUED ||
+                                        dev->testState == ASYNC_SW_RUNNING)) {
+            pthread_cond_wait(&asyncDone, &asyncLock);
+        }
+        ASYNC_UNLOCK();
+    }
+#endif
+#ifdef WOLF_EVENT_NOTIFY
+    /* done, the event is delivered through its queue */
+    if (event->notify != NULL)
+        return 0;
+#endif
+
+    while (ret == 0 && event->state == WOLF_EVENT_STATE_PENDING)
+        ret = wolfAsync_EventPoll(event, WOLF_POLL_FLAG_CHECK_HW);
+
+    return ret;
+}
+
+int wolfAsync_EventPop(WOLF_EVENT* event, WOLF_EVENT_TYPE type)
+{
+    int ret;
+
+    if (event == NULL)
+        return BAD_FUNC_ARG;
+
+    if (event->type != type)
+        ret = WC_NOT_PENDING_E;
+    else if (event->state == WOLF_EVENT_STATE_PENDING)
+        ret = WC_PENDING_E;
+    else if (event->state == WOLF_EVENT_STATE_DONE) {
+        ret = event->ret;
+        event->state = WOLF_EVENT_STATE_READY;
+    }
+    else
+        ret = WC_NOT_PENDING_E;
+
+    return ret;
+}
+
+int wolfAsync_EventQueuePush(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
+{
+    int ret;
+
+    if (queue == NULL || event == NULL)
+        return BAD_FUNC_ARG;
+
+    event->state = WOLF_EVENT_STATE_PENDING;
+#ifdef WOLF_EVENT_NOTIFY
+    event->notify = queue;
+#endif
+    /* on the queue before a worker can post it */
+    ret = wolfEventQueue_Push(queue, event);
+    if (ret == 0) {
+        ret = AsyncSubmit(AsyncEventDev(event));
+        if (ret != 0)
+            wolfEventQueue_Cancel(queue, event);
+    }
+    if (ret != 0) {
+    #ifdef WOLF_EVENT_NOTIFY
+        event->notify = NULL;
+    #endif
+        event->state = WOLF_EVENT_STATE_READY;
+    }
+
+    return ret;
+}
+
+/* Stop the operation of event, it is neither run nor posted after this */
+int wolfAsync_EventCancel(WOLF_EVENT* event)
+{
+    WC_ASYNC_DEV* dev;
+
+    if (event == NULL)
+        return BAD_FUNC_ARG;
+
+    dev = AsyncEventDev(event);
+    ASYNC_LOCK();
+    if (dev->testState == ASYNC_SW_QUEUED ||
+                                        dev->testState == ASYNC_SW_RUNNING) {
+        AsyncCancel(dev);
+    }
+    ASYNC_UNLOCK();
+
+    return 0;
+}
+
+int wolfAsync_EventQueuePoll(WOLF_EVENT_QUEUE* queue, void* context_filter,
+    WOLF_EVENT** events, int maxEvents, WOLF_EVENT_FLAG flags, int* eventCount)
+{
+    return wolfEventQueue_Poll(queue, context_filter, events, maxEvents,
+                               flags, eventCount);
+}
+
+/* queue the pending operation of asyncDev on queue, it completes when the
+ * queue is polled */
+int wc_AsyncHandle(WC_ASYNC_DEV* asyncDev, WOLF_EVENT_QUEUE* queue,
+                   word32 flags)
+{
+    int ret;
+
+    if (asyncDev == NULL || queue == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = wolfAsync_EventInit(&asyncDev->event,
+        WOLF_EVENT_TYPE_ASYNC_WOLFCRYPT, asyncDev, flags);
+    if (ret == 0)
+        ret = wolfAsync_EventQueuePush(queue, &asyncDev->event);
+
+    return ret;
+}
+
+/* block until the operation that returned ret, when WC_PENDING_E, is done
+ * and return its result */
+int wc_AsyncWait(int ret, WC_ASYNC_DEV* asyncDev, word32 flags)
+{
+    WOLF_EVENT* event;
+
+    if (ret != WC_PENDING_E)
+        return ret;
+    if (asyncDev == NULL)
+        return BAD_FUNC_ARG;
+
+    event = &asyncDev->event;
+    ret = wolfAsync_EventInit(event, WOLF_EVENT_TYPE_ASYNC_WOLFCRYPT,
+                              asyncDev, flags);
+    if (ret == 0) {
+        event->state = WOLF_EVENT_STATE_PENDING;
+        ret = AsyncSubmit(asyncDev);
+        if (ret != 0)
+            event->state = WOLF_EVENT_STATE_READY;
+    }
+    if (ret == 0)
+        ret = wolfAsync_EventWait(event);
+    if (ret == 0) {
+        ret = event->ret;
+        event->state = WOLF_EVENT_STATE_READY;
+    }
+
+    return ret;
+}
+
+
+#ifndef WC_NO_ASYNC_THREADING
+int wolfAsync_DevOpenThread(int* devId, void* threadId)
+{
+    (void)threadId;
+    return wolfAsync_DevOpen(devId);
+}
+
+int wc_AsyncGetNumberOfCpus(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cpus > 0) ? (int)cpus : 1;
+}
+
+int wc_AsyncThreadCreate(pthread_t* thread, AsyncThreadFunc_t func,
+                         void* args)
+{
+    if (thread == NULL || func == NULL)
+        return BAD_FUNC_ARG;
+
+    return (pthread_create(thread, NULL, func, args) == 0) ? 0 : ASYNC_INIT_E;
+}
+
+int wc_AsyncThreadJoin(pthread_t* thread)
+{
+    if (thread == NULL)
+        return BAD_FUNC_ARG;
+
+    return (pthread_join(*thread, NULL) == 0) ? 0 : BAD_STATE_E;
+}
+
+void wc_AsyncThreadYield(void)
+{
+    sched_yield();
+}
+#endif /* !WC_NO_ASYNC_THREADING */
+
+#endif /* WOLFSSL_ASYNC_CRYPT && WOLFSSL_ASYNC_CRYPT_TEST */
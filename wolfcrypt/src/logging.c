@@ -28,6 +28,9 @@
 
 #include <wolfssl/wolfcrypt/logging.h>
 #include <wolfssl/wolfcrypt/error-crypt.h>
+#if defined(WOLFSSL_TRACE) && !defined(WOLFSSL_TRACE_NOW)
+    #include <time.h>
+#endif
 #if defined(OPENSSL_EXTRA) && !defined(WOLFCRYPT_ONLY)
 /* avoid adding WANT_READ and WANT_WRITE to error queue */
 #include <wolfssl/error-ssl.h>
@@ -263,6 +266,188 @@ void WOLFSSL_TIME(int count)
 }
 #endif
 
+#ifdef WOLFSSL_TRACE
+#if (WOLFSSL_TRACE_EVENTS & (WOLFSSL_TRACE_EVENTS - 1)) != 0
+    #error WOLFSSL_TRACE_EVENTS must be a power of 2
+#endif
+
+int wc_traceOn = 0;
+
+/* last events of the thread, only the thread writes and reads its ring so
+ * recording takes no lock */
+static THREAD_LS_T wc_TraceEvent traceRing[WOLFSSL_TRACE_EVENTS];
+static THREAD_LS_T word32 traceCnt;        /* events recorded, wraps ring */
+static THREAD_LS_T const void* traceObj;   /* object of the thread's events */
+
+static const char* const traceNames[WC_TRACE_IDS] = {
+    "unknown",
+    "enter",
+    "leave",
+    "error",
+    "hs send",
+    "hs recv",
+    "hs done",
+    "alert send",
+    "alert recv",
+    "record in",
+};
+
+#ifndef WOLFSSL_TRACE_NOW
+/* monotonic time in ns, define WOLFSSL_TRACE_NOW() to a function giving it
+   on platforms without clock_gettime() */
+static word64 TraceNow(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return (word64)ts.tv_sec * 1000000000 + (word64)ts.tv_nsec;
+}
+    #define WOLFSSL_TRACE_NOW() TraceNow()
+#endif
+
+void wc_Trace(word16 id, const void* obj, const char* name, int arg)
+{
+    wc_TraceEvent* ev = &traceRing[traceCnt++ & (WOLFSSL_TRACE_EVENTS - 1)];
+
+    ev->time = WOLFSSL_TRACE_NOW();
+    ev->obj  = (obj != NULL) ? obj : traceObj;
+    ev->name = name;
+    ev->arg  = arg;
+    ev->id   = id;
+}
+
+void wc_TraceSetObj(const void* obj)
+{
+    traceObj = obj;
+}
+
+/* turn the binary trace on for all threads, only if compiled in */
+int wolfSSL_Trace_ON(void)
+{
+    wc_traceOn = 1;
+    return 0;
+}
+
+void wolfSSL_Trace_OFF(void)
+{
+    wc_traceOn = 0;
+}
+
+/* forget the events of the calling thread */
+void wolfSSL_Trace_Clear(void)
+{
+    traceCnt = 0;
+    traceObj = NULL;
+}
+
+/* events in the ring of the calling thread, first is set to the oldest */
+static word32 TraceHeld(word32* first)
+{
+    word32 n = traceCnt;
+
+    if (n > WOLFSSL_TRACE_EVENTS)
+        n = WOLFSSL_TRACE_EVENTS;
+    *first = traceCnt - n;
+
+    return n;
+}
+
+/* Copy the newest up to *count events of the calling thread, oldest first,
+   and set *count to the number copied. events NULL sets *count to the number
+   held. 0 on success */
+int wolfSSL_Trace_Get(wc_TraceEvent* events, word32* count)
+{
+    word32 first, n, i;
+
+    if (count == NULL)
+        return BAD_FUNC_ARG;
+
+    n = TraceHeld(&first);
+    if (events != NULL) {
+        if (n > *count) {
+            first += n - *count;
+            n = *count;
+        }
+        for (i = 0; i < n; i++)
+            events[i] = traceRing[(first + i) & (WOLFSSL_TRACE_EVENTS - 1)];
+    }
+    *count = n;
+
+    return 0;
+}
+
+static word32 TraceNameLen(const char* name)
+{
+    word32 len = (name != NULL) ? (word32)XSTRLEN(name) : 0;
+
+    return (len > 0xffff) ? 0xffff : len;
+}
+
+/* big endian sz byte v at out */
+static void TraceEncode(byte* out, word64 v, int sz)
+{
+    while (sz-- > 0) {
+        out[sz] = (byte)v;
+        v >>= 8;
+    }
+}
+
+/* Write the events of the calling thread, oldest first, with their names so
+   the output can be decoded after the process is gone. out NULL sets *outSz
+   to the size needed. 0 on success, BUFFER_E when *outSz is too small */
+int wolfSSL_Trace_Export(byte* out, word32* outSz)
+{
+    word32 first, n, i, sz = WC_TRACE_HDR_SZ;
+
+    if (outSz == NULL)
+        return BAD_FUNC_ARG;
+
+    n = TraceHeld(&first);
+    for (i = 0; i < n; i++) {
+        const wc_TraceEvent* ev =
+                         &traceRing[(first + i) & (WOLFSSL_TRACE_EVENTS - 1)];
+
+        sz += WC_TRACE_EVENT_SZ + TraceNameLen(ev->name);
+    }
+    if (out == NULL) {
+        *outSz = sz;
+        return 0;
+    }
+    if (*outSz < sz)
+        return BUFFER_E;
+
+    XMEMCPY(out, WC_TRACE_MAGIC, 4);
+    TraceEncode(out + 4, WC_TRACE_VERSION, 4);
+    TraceEncode(out + 8, n, 4);
+    out += WC_TRACE_HDR_SZ;
+    for (i = 0; i < n; i++) {
+        const wc_TraceEvent* ev =
+                         &traceRing[(first + i) & (WOLFSSL_TRACE_EVENTS - 1)];
+        word32 len = TraceNameLen(ev->name);
+
+        TraceEncode(out,      ev->time, 8);
+        TraceEncode(out + 8,  (word64)(size_t)ev->obj, 8);
+        TraceEncode(out + 16, (word32)ev->arg, 4);
+        TraceEncode(out + 20, ev->id, 2);
+        TraceEncode(out + 22, len, 2);
+        if (len > 0)
+            XMEMCPY(out + WC_TRACE_EVENT_SZ, ev->name, len);
+        out += WC_TRACE_EVENT_SZ + len;
+    }
+    *outSz = sz;
+
+    return 0;
+}
+
+const char* wolfSSL_Trace_EventName(int id)
+{
+    if (id <= 0 || id >= WC_TRACE_IDS)
+        return traceNames[0];
+    return traceNames[id];
+}
+#endif /* WOLFSSL_TRACE */
+
 #ifdef DEBUG_WOLFSSL
 
 #if defined(FREESCALE_MQX) || defined(FREESCALE_KSDK_MQX)
@@ -405,6 +590,7 @@ void WOLFSSL_BUFFER(const byte* buffer, word32 length)
 
 void WOLFSSL_ENTER(const char* msg)
 {
+    WC_TRACE(WC_TRACE_ENTER, NULL, msg, 0);
     if (loggingEnabled) {
         char buffer[WOLFSSL_MAX_ERROR_SZ];
         XSNPRINTF(buffer, sizeof(buffer), "wolfSSL Entering %s", msg);
@@ -415,6 +601,7 @@ void WOLFSSL_ENTER(const char* msg)
 
 void WOLFSSL_LEAVE(const char* msg, int ret)
 {
+    WC_TRACE(WC_TRACE_LEAVE, NULL, msg, ret);
     if (loggingEnabled) {
         char buffer[WOLFSSL_MAX_ERROR_SZ];
         XSNPRINTF(buffer, sizeof(buffer), "wolfSSL Leaving %s, return %d",
@@ -453,6 +640,7 @@ void WOLFSSL_ERROR(int error)
     {
         char buffer[WOLFSSL_MAX_ERROR_SZ];
 
+        WC_TRACE(WC_TRACE_ERROR, NULL, NULL, error);
     #if (defined(OPENSSL_EXTRA) && !defined(_WIN32) && \
             !defined(NO_ERROR_QUEUE)) || defined(DEBUG_WOLFSSL_VERBOSE)
         (void)usrCtx; /* a user ctx for future flexibility */
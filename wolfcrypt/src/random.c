@@ -108,6 +108,9 @@ int wc_RNG_GenerateByte(WC_RNG* rng, byte* b)
 #ifndef WC_NO_RNG /* if not FIPS and RNG is disabled then do not compile */
 
 #include <wolfssl/wolfcrypt/sha256.h>
+#ifdef WC_RNG_CTR_DRBG
+    #include <wolfssl/wolfcrypt/aes.h>
+#endif
 
 #ifdef WOLF_CRYPTO_CB
     #include <wolfssl/wolfcrypt/cryptocb.h>
@@ -167,6 +170,10 @@ int wc_RNG_GenerateByte(WC_RNG* rng, byte* b)
     #ifndef EBSNET
         #include <unistd.h>
     #endif
+    #ifdef WOLFSSL_GETRANDOM
+        #include <errno.h>
+        #include <sys/random.h>
+    #endif
 #endif
 
 #if defined(WOLFSSL_SILABS_SE_ACCEL)
@@ -316,6 +323,12 @@ enum {
 typedef struct DRBG_internal DRBG_internal;
 
 static int wc_RNG_HealthTestLocal(int reseed);
+#ifdef WC_RNG_CTR_DRBG
+struct CTR_DRBG_internal;
+static int CTR_DRBG_Reseed(struct CTR_DRBG_internal* drbg, const byte* seed,
+                                                                 word32 seedSz);
+static int CTR_DRBG_HealthTestLocal(int reseed);
+#endif
 
 /* Hash Derivation Function */
 /* Returns: DRBG_SUCCESS or DRBG_FAILURE */
@@ -443,6 +456,12 @@ int wc_RNG_DRBG_Reseed(WC_RNG* rng, const byte* seed, word32 seedSz)
         return BAD_FUNC_ARG;
     }
 
+#ifdef WC_RNG_CTR_DRBG
+    if (rng->drbgType == WC_DRBG_CTR) {
+        return CTR_DRBG_Reseed((struct CTR_DRBG_internal*)rng->drbg, seed,
+                                                                       seedSz);
+    }
+#endif
     return Hash_DRBG_Reseed((DRBG_internal *)rng->drbg, seed, seedSz);
 }
 
@@ -717,20 +736,332 @@ int wc_RNG_TestSeed(const byte* seed, word32 seedSz)
 
     return ret;
 }
+
+#ifdef WC_RNG_CTR_DRBG
+/* CTR_DRBG (SP 800-90A 10.2) with AES-256 and the derivation function.
+ * Output is AES-CTR keystream so bulk requests run at the speed of the
+ * cipher, small requests are served from keystream of an earlier generate
+ * call kept in buf until used. */
+#if !defined(HAVE_AES_CBC) || !defined(WOLFSSL_AES_COUNTER) || \
+    !defined(WOLFSSL_AES_256)
+    #error WC_RNG_CTR_DRBG requires AES-CBC, AES-CTR and 256-bit keys
+#endif
+#if (defined(WOLFSSL_NO_MALLOC) && !defined(WOLFSSL_STATIC_MEMORY)) || \
+    defined(WOLFSSL_USE_FLASHMEM)
+    #error WC_RNG_CTR_DRBG requires dynamic memory
+#endif
+
+#define CTR_DRBG_KEY_SZ    AES_256_KEY_SIZE
+#define CTR_DRBG_SEED_LEN  (CTR_DRBG_KEY_SZ + AES_BLOCK_SIZE)
+#define CTR_DRBG_TEST_SZ   (AES_BLOCK_SIZE * 4)
+
+/* keystream generated ahead for small requests, multiple of the block size */
+#ifndef WC_CTR_DRBG_BUF_SZ
+    #define WC_CTR_DRBG_BUF_SZ 512
+#endif
+
+typedef struct CTR_DRBG_internal {
+    Aes    aes;         /* Key, reg is V + 1 */
+    word32 reseedCtr;
+    word32 lastBlock;
+    word32 bufIdx;      /* first unused byte of buf */
+    byte   matchCount;
+    byte   buf[WC_CTR_DRBG_BUF_SZ];
+} CTR_DRBG_internal;
+
+/* BCC, a CBC-MAC with the chaining value in aes->reg. Input is collected in
+ * blk, holding used bytes, and encrypted a block at a time */
+static int CTR_DRBG_Bcc(Aes* aes, byte* blk, word32* used, const byte* in,
+                                                                  word32 inSz)
+{
+    int ret = 0;
+    word32 n;
+
+    while (ret == 0 && inSz > 0) {
+        n = min(AES_BLOCK_SIZE - *used, inSz);
+        XMEMCPY(blk + *used, in, n);
+        *used += n;
+        in    += n;
+        inSz  -= n;
+
+        if (*used == AES_BLOCK_SIZE) {
+            ret = wc_AesCbcEncrypt(aes, blk, blk, AES_BLOCK_SIZE);
+            *used = 0;
+        }
+    }
+
+    return ret;
+}
+
+/* Block_Cipher_df of inA || inB into CTR_DRBG_SEED_LEN bytes of out, with
+ * its own key schedule so the DRBG's Key is left alone for the update */
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int CTR_DRBG_df(void* heap, byte* out, const byte* inA, word32 inASz,
+                                                  const byte* inB, word32 inBSz)
+{
+    static const byte dfKey[CTR_DRBG_KEY_SZ] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+        0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+    };
+    static const byte pad[AES_BLOCK_SIZE] = { 0x80 };
+#ifdef WOLFSSL_SMALL_STACK
+    Aes*   aes;
+#else
+    Aes    aes[1];
+#endif
+    byte   temp[CTR_DRBG_SEED_LEN];
+    byte   blk[AES_BLOCK_SIZE];
+    byte   hdr[AES_BLOCK_SIZE + 2 * sizeof(word32)]; /* IV || L || N */
+    word32 i, used, val;
+    int    ret;
+
+#ifdef WOLFSSL_SMALL_STACK
+    aes = (Aes*)XMALLOC(sizeof(Aes), heap, DYNAMIC_TYPE_AES);
+    if (aes == NULL)
+        return DRBG_FAILURE;
+#endif
+    ret = wc_AesInit(aes, heap, INVALID_DEVID);
+    if (ret != 0) {
+    #ifdef WOLFSSL_SMALL_STACK
+        XFREE(aes, heap, DYNAMIC_TYPE_AES);
+    #endif
+        return DRBG_FAILURE;
+    }
+
+    ret = wc_AesSetKey(aes, dfKey, sizeof(dfKey), NULL, AES_ENCRYPTION);
+    for (i = 0; ret == 0 && i < CTR_DRBG_SEED_LEN / AES_BLOCK_SIZE; i++) {
+        XMEMSET(hdr, 0, sizeof(hdr));
+    #ifdef LITTLE_ENDIAN_ORDER
+        val = ByteReverseWord32(i);
+        XMEMCPY(hdr, &val, sizeof(word32));
+        val = ByteReverseWord32(inASz + inBSz);
+        XMEMCPY(hdr + AES_BLOCK_SIZE, &val, sizeof(word32));
+        val = ByteReverseWord32(CTR_DRBG_SEED_LEN);
+    #else
+        XMEMCPY(hdr, &i, sizeof(word32));
+        val = inASz + inBSz;
+        XMEMCPY(hdr + AES_BLOCK_SIZE, &val, sizeof(word32));
+        val = CTR_DRBG_SEED_LEN;
+    #endif
+        XMEMCPY(hdr + AES_BLOCK_SIZE + sizeof(word32), &val, sizeof(word32));
+
+        used = 0;
+        ret = wc_AesSetIV(aes, NULL);
+        if (ret == 0)
+            ret = CTR_DRBG_Bcc(aes, blk, &used, hdr, sizeof(hdr));
+        if (ret == 0 && inA != NULL)
+            ret = CTR_DRBG_Bcc(aes, blk, &used, inA, inASz);
+        if (ret == 0 && inB != NULL)
+            ret = CTR_DRBG_Bcc(aes, blk, &used, inB, inBSz);
+        if (ret == 0)
+            ret = CTR_DRBG_Bcc(aes, blk, &used, pad, 1);
+        if (ret == 0 && used != 0)
+            ret = CTR_DRBG_Bcc(aes, blk, &used, pad + 1, AES_BLOCK_SIZE - used);
+        if (ret == 0)
+            XMEMCPY(temp + i * AES_BLOCK_SIZE, blk, AES_BLOCK_SIZE);
+    }
+
+    /* X = Block_Encrypt(K, X) repeatedly is CBC over zeros with X as IV */
+    if (ret == 0) {
+        ret = wc_AesSetKey(aes, temp, CTR_DRBG_KEY_SZ, temp + CTR_DRBG_KEY_SZ,
+                                                               AES_ENCRYPTION);
+    }
+    if (ret == 0) {
+        XMEMSET(out, 0, CTR_DRBG_SEED_LEN);
+        ret = wc_AesCbcEncrypt(aes, out, out, CTR_DRBG_SEED_LEN);
+    }
+
+    ForceZero(temp, sizeof(temp));
+    ForceZero(blk, sizeof(blk));
+    wc_AesFree(aes);
+    ForceZero(aes, sizeof(Aes));
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(aes, heap, DYNAMIC_TYPE_AES);
+#endif
+    (void)heap;
+
+    return (ret == 0) ? DRBG_SUCCESS : DRBG_FAILURE;
+}
+
+/* CTR_DRBG_Update, Key || V from the keystream after V xor'd with data. A
+ * NULL data is all zeros. Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int CTR_DRBG_Update(CTR_DRBG_internal* drbg, const byte* data)
+{
+    byte temp[CTR_DRBG_SEED_LEN];
+    int  ret;
+
+    if (data != NULL)
+        XMEMCPY(temp, data, sizeof(temp));
+    else
+        XMEMSET(temp, 0, sizeof(temp));
+
+    drbg->aes.left = 0;
+    ret = wc_AesCtrEncrypt(&drbg->aes, temp, temp, sizeof(temp));
+    if (ret == 0) {
+        ret = wc_AesSetKey(&drbg->aes, temp, CTR_DRBG_KEY_SZ,
+                                 temp + CTR_DRBG_KEY_SZ, AES_ENCRYPTION);
+    }
+    if (ret == 0)
+        array_add_one((byte*)drbg->aes.reg, AES_BLOCK_SIZE);
+
+    ForceZero(temp, sizeof(temp));
+
+    return (ret == 0) ? DRBG_SUCCESS : DRBG_FAILURE;
+}
+
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int CTR_DRBG_Reseed(CTR_DRBG_internal* drbg, const byte* seed,
+                                                                  word32 seedSz)
+{
+    int  ret;
+    byte seedMaterial[CTR_DRBG_SEED_LEN];
+
+    ret = CTR_DRBG_df(drbg->aes.heap, seedMaterial, seed, seedSz, NULL, 0);
+    if (ret == DRBG_SUCCESS)
+        ret = CTR_DRBG_Update(drbg, seedMaterial);
+    if (ret == DRBG_SUCCESS)
+        drbg->reseedCtr = 1;
+
+    /* keystream from before the reseed is not handed out */
+    ForceZero(drbg->buf, sizeof(drbg->buf));
+    drbg->bufIdx = sizeof(drbg->buf);
+    ForceZero(seedMaterial, sizeof(seedMaterial));
+
+    return ret;
+}
+
+/* Returns: DRBG_SUCCESS, DRBG_NEED_RESEED, DRBG_CONT_FAILURE or
+ * DRBG_FAILURE */
+static int CTR_DRBG_Generate(CTR_DRBG_internal* drbg, byte* out, word32 outSz)
+{
+    int    ret;
+    word32 checkBlock = 0;
+
+    if (drbg->reseedCtr == RESEED_INTERVAL)
+        return DRBG_NEED_RESEED;
+
+    XMEMSET(out, 0, outSz);
+    drbg->aes.left = 0;
+    ret = wc_AesCtrEncrypt(&drbg->aes, out, out, outSz);
+    /* the rest of a partial block is not used */
+    drbg->aes.left = 0;
+    ForceZero(drbg->aes.tmp, sizeof(drbg->aes.tmp));
+    if (ret != 0)
+        return DRBG_FAILURE;
+
+    XMEMCPY(&checkBlock, out, min(outSz, sizeof(word32)));
+    if (drbg->reseedCtr > 1 && checkBlock == drbg->lastBlock) {
+        if (drbg->matchCount == 1)
+            return DRBG_CONT_FAILURE;
+        drbg->matchCount = 1;
+    }
+    else {
+        drbg->matchCount = 0;
+        drbg->lastBlock = checkBlock;
+    }
+
+    ret = CTR_DRBG_Update(drbg, NULL);
+    if (ret == DRBG_SUCCESS)
+        drbg->reseedCtr++;
+
+    return ret;
+}
+
+/* Serve a request from the keystream buffer, refilled with one generate call.
+ * Requests of a buffer or more are generated straight into out.
+ * Returns: as CTR_DRBG_Generate() */
+static int CTR_DRBG_GenerateBuffered(CTR_DRBG_internal* drbg, byte* out,
+                                                                   word32 outSz)
+{
+    int    ret = DRBG_SUCCESS;
+    word32 n = min(outSz, WC_CTR_DRBG_BUF_SZ - drbg->bufIdx);
+
+    /* reseed before anything is taken, it empties the buffer */
+    if (n < outSz && drbg->reseedCtr == RESEED_INTERVAL)
+        return DRBG_NEED_RESEED;
+
+    XMEMCPY(out, drbg->buf + drbg->bufIdx, n);
+    ForceZero(drbg->buf + drbg->bufIdx, n);
+    drbg->bufIdx += n;
+    out   += n;
+    outSz -= n;
+
+    if (outSz >= WC_CTR_DRBG_BUF_SZ) {
+        ret = CTR_DRBG_Generate(drbg, out, outSz);
+    }
+    else if (outSz > 0) {
+        ret = CTR_DRBG_Generate(drbg, drbg->buf, WC_CTR_DRBG_BUF_SZ);
+        if (ret == DRBG_SUCCESS) {
+            XMEMCPY(out, drbg->buf, outSz);
+            ForceZero(drbg->buf, outSz);
+            drbg->bufIdx = outSz;
+        }
+    }
+
+    return ret;
+}
+
+/* Returns: DRBG_SUCCESS or DRBG_FAILURE */
+static int CTR_DRBG_Instantiate(CTR_DRBG_internal* drbg, const byte* seed,
+                                word32 seedSz, const byte* nonce, word32 nonceSz,
+                                void* heap)
+{
+    int  ret;
+    byte seedMaterial[CTR_DRBG_SEED_LEN];
+    byte zeros[CTR_DRBG_KEY_SZ];
+
+    XMEMSET(drbg, 0, sizeof(CTR_DRBG_internal));
+    /* blocking, not handed to a device */
+    if (wc_AesInit(&drbg->aes, heap, INVALID_DEVID) != 0)
+        return DRBG_FAILURE;
+
+    ret = CTR_DRBG_df(heap, seedMaterial, seed, seedSz, nonce, nonceSz);
+    if (ret == DRBG_SUCCESS) {
+        /* Key = 0, V = 0 */
+        XMEMSET(zeros, 0, sizeof(zeros));
+        if (wc_AesSetKey(&drbg->aes, zeros, sizeof(zeros), NULL,
+                                                        AES_ENCRYPTION) != 0) {
+            ret = DRBG_FAILURE;
+        }
+        else {
+            array_add_one((byte*)drbg->aes.reg, AES_BLOCK_SIZE);
+            ret = CTR_DRBG_Update(drbg, seedMaterial);
+        }
+    }
+    if (ret == DRBG_SUCCESS) {
+        drbg->reseedCtr = 1;
+        drbg->bufIdx = sizeof(drbg->buf);
+    }
+
+    ForceZero(seedMaterial, sizeof(seedMaterial));
+
+    return ret;
+}
+
+static void CTR_DRBG_Uninstantiate(CTR_DRBG_internal* drbg)
+{
+    wc_AesFree(&drbg->aes);
+    ForceZero(drbg, sizeof(CTR_DRBG_internal));
+}
+#endif /* WC_RNG_CTR_DRBG */
 #endif /* HAVE_HASHDRBG */
 /* End NIST DRBG Code */
 
 
 static int _InitRng(WC_RNG* rng, byte* nonce, word32 nonceSz,
-                    void* heap, int devId)
+                    void* heap, int devId, int drbgType)
 {
     int ret = 0;
 #ifdef HAVE_HASHDRBG
     word32 seedSz = SEED_SZ + SEED_BLOCK_SZ;
+    word32 drbgSz = sizeof(DRBG_internal);
 #endif
 
     (void)nonce;
     (void)nonceSz;
+    (void)drbgType;
 
     if (rng == NULL)
         return BAD_FUNC_ARG;
@@ -757,6 +1088,13 @@ static int _InitRng(WC_RNG* rng, byte* nonce, word32 nonceSz,
     rng->drbg = NULL;
     rng->status = DRBG_NOT_INIT;
 #endif
+#ifdef WC_RNG_CTR_DRBG
+    if (drbgType != WC_DRBG_HASH && drbgType != WC_DRBG_CTR)
+        return BAD_FUNC_ARG;
+    rng->drbgType = (byte)drbgType;
+    if (drbgType == WC_DRBG_CTR)
+        drbgSz = sizeof(CTR_DRBG_internal);
+#endif
 
 #if defined(HAVE_INTEL_RDSEED) || defined(HAVE_INTEL_RDRAND)
     /* init the intel RD seed and/or rand */
@@ -784,7 +1122,14 @@ static int _InitRng(WC_RNG* rng, byte* nonce, word32 nonceSz,
     if (nonceSz == 0)
         seedSz = MAX_SEED_SZ;
 
-    if (wc_RNG_HealthTestLocal(0) == 0) {
+#ifdef WC_RNG_CTR_DRBG
+    if (drbgType == WC_DRBG_CTR)
+        ret = CTR_DRBG_HealthTestLocal(0);
+    else
+#endif
+        ret = wc_RNG_HealthTestLocal(0);
+
+    if (ret == 0) {
     #ifdef WC_ASYNC_ENABLE_SHA256
         DECLARE_VAR(seed, byte, MAX_SEED_SZ, rng->heap);
         if (seed == NULL)
@@ -794,8 +1139,7 @@ static int _InitRng(WC_RNG* rng, byte* nonce, word32 nonceSz,
     #endif
 
 #if !defined(WOLFSSL_NO_MALLOC) || defined(WOLFSSL_STATIC_MEMORY)
-        rng->drbg =
-                (struct DRBG*)XMALLOC(sizeof(DRBG_internal), rng->heap,
+        rng->drbg = (struct DRBG*)XMALLOC(drbgSz, rng->heap,
                                                           DYNAMIC_TYPE_RNG);
         if (rng->drbg == NULL) {
             ret = MEMORY_E;
@@ -813,6 +1157,13 @@ static int _InitRng(WC_RNG* rng, byte* nonce, word32 nonceSz,
                 rng->status = DRBG_FAILED;
             }
 
+        #ifdef WC_RNG_CTR_DRBG
+            if (ret == DRBG_SUCCESS && drbgType == WC_DRBG_CTR)
+                ret = CTR_DRBG_Instantiate((CTR_DRBG_internal*)rng->drbg,
+                            seed + SEED_BLOCK_SZ, seedSz - SEED_BLOCK_SZ,
+                            nonce, nonceSz, rng->heap);
+            else
+        #endif
             if (ret == DRBG_SUCCESS)
 	      ret = Hash_DRBG_Instantiate((DRBG_internal *)rng->drbg,
                             seed + SEED_BLOCK_SZ, seedSz - SEED_BLOCK_SZ,
@@ -863,7 +1214,8 @@ WC_RNG* wc_rng_new(byte* nonce, word32 nonceSz, void* heap)
 
     rng = (WC_RNG*)XMALLOC(sizeof(WC_RNG), heap, DYNAMIC_TYPE_RNG);
     if (rng) {
-        int error = _InitRng(rng, nonce, nonceSz, heap, INVALID_DEVID) != 0;
+        int error = _InitRng(rng, nonce, nonceSz, heap, INVALID_DEVID,
+                             WC_DRBG_DEFAULT) != 0;
         if (error) {
             XFREE(rng, heap, DYNAMIC_TYPE_RNG);
             rng = NULL;
@@ -890,27 +1242,37 @@ void wc_rng_free(WC_RNG* rng)
 
 int wc_InitRng(WC_RNG* rng)
 {
-    return _InitRng(rng, NULL, 0, NULL, INVALID_DEVID);
+    return _InitRng(rng, NULL, 0, NULL, INVALID_DEVID, WC_DRBG_DEFAULT);
 }
 
 
 int wc_InitRng_ex(WC_RNG* rng, void* heap, int devId)
 {
-    return _InitRng(rng, NULL, 0, heap, devId);
+    return _InitRng(rng, NULL, 0, heap, devId, WC_DRBG_DEFAULT);
 }
 
 
 int wc_InitRngNonce(WC_RNG* rng, byte* nonce, word32 nonceSz)
 {
-    return _InitRng(rng, nonce, nonceSz, NULL, INVALID_DEVID);
+    return _InitRng(rng, nonce, nonceSz, NULL, INVALID_DEVID,
+                    WC_DRBG_DEFAULT);
 }
 
 
 int wc_InitRngNonce_ex(WC_RNG* rng, byte* nonce, word32 nonceSz,
                        void* heap, int devId)
 {
-    return _InitRng(rng, nonce, nonceSz, heap, devId);
+    return _InitRng(rng, nonce, nonceSz, heap, devId, WC_DRBG_DEFAULT);
+}
+
+
+#ifdef WC_RNG_CTR_DRBG
+/* wc_InitRng_ex() with the DRBG chosen, WC_DRBG_HASH or WC_DRBG_CTR */
+int wc_InitRngDrbg_ex(WC_RNG* rng, int drbgType, void* heap, int devId)
+{
+    return _InitRng(rng, NULL, 0, heap, devId, drbgType);
 }
+#endif
 
 
 /* place a generated block in output */
@@ -968,9 +1330,22 @@ int wc_RNG_GenerateBlock(WC_RNG* rng, byte* output, word32 sz)
     if (rng->status != DRBG_OK)
         return RNG_FAILURE_E;
 
-    ret = Hash_DRBG_Generate((DRBG_internal *)rng->drbg, output, sz);
+#ifdef WC_RNG_CTR_DRBG
+    if (rng->drbgType == WC_DRBG_CTR)
+        ret = CTR_DRBG_GenerateBuffered((CTR_DRBG_internal*)rng->drbg, output,
+                                                                           sz);
+    else
+#endif
+        ret = Hash_DRBG_Generate((DRBG_internal *)rng->drbg, output, sz);
     if (ret == DRBG_NEED_RESEED) {
-        if (wc_RNG_HealthTestLocal(1) == 0) {
+    #ifdef WC_RNG_CTR_DRBG
+        if (rng->drbgType == WC_DRBG_CTR)
+            ret = CTR_DRBG_HealthTestLocal(1);
+        else
+    #endif
+            ret = wc_RNG_HealthTestLocal(1);
+
+        if (ret == 0) {
             byte newSeed[SEED_SZ + SEED_BLOCK_SZ];
 
             ret = wc_GenerateSeed(&rng->seed, newSeed,
@@ -981,8 +1356,13 @@ int wc_RNG_GenerateBlock(WC_RNG* rng, byte* output, word32 sz)
                 ret = wc_RNG_TestSeed(newSeed, SEED_SZ + SEED_BLOCK_SZ);
 
             if (ret == DRBG_SUCCESS)
-	      ret = Hash_DRBG_Reseed((DRBG_internal *)rng->drbg, newSeed + SEED_BLOCK_SZ,
-                                       SEED_SZ);
+                ret = wc_RNG_DRBG_Reseed(rng, newSeed + SEED_BLOCK_SZ, SEED_SZ);
+        #ifdef WC_RNG_CTR_DRBG
+            if (ret == DRBG_SUCCESS && rng->drbgType == WC_DRBG_CTR)
+                ret = CTR_DRBG_GenerateBuffered((CTR_DRBG_internal*)rng->drbg,
+                                                                   output, sz);
+            else
+        #endif
             if (ret == DRBG_SUCCESS)
 	      ret = Hash_DRBG_Generate((DRBG_internal *)rng->drbg, output, sz);
 
@@ -1034,6 +1414,11 @@ int wc_FreeRng(WC_RNG* rng)
 
 #ifdef HAVE_HASHDRBG
     if (rng->drbg != NULL) {
+    #ifdef WC_RNG_CTR_DRBG
+        if (rng->drbgType == WC_DRBG_CTR)
+            CTR_DRBG_Uninstantiate((CTR_DRBG_internal*)rng->drbg);
+        else
+    #endif
       if (Hash_DRBG_Uninstantiate((DRBG_internal *)rng->drbg) != DRBG_SUCCESS)
             ret = RNG_FAILURE_E;
 
@@ -1049,6 +1434,172 @@ int wc_FreeRng(WC_RNG* rng)
     return ret;
 }
 
+#ifdef HAVE_HASHDRBG
+/* Reseed rng with fresh entropy, for state that may have been copied such as
+ * by fork(). Returns 0 on success */
+int wc_RNG_Reseed(WC_RNG* rng)
+{
+    int  ret;
+    byte newSeed[SEED_SZ + SEED_BLOCK_SZ];
+
+    if (rng == NULL)
+        return BAD_FUNC_ARG;
+    if (rng->status != DRBG_OK)
+        return RNG_FAILURE_E;
+
+    ret = wc_GenerateSeed(&rng->seed, newSeed, SEED_SZ + SEED_BLOCK_SZ);
+    if (ret == 0)
+        ret = wc_RNG_TestSeed(newSeed, SEED_SZ + SEED_BLOCK_SZ);
+    if (ret == 0)
+        ret = wc_RNG_DRBG_Reseed(rng, newSeed + SEED_BLOCK_SZ, SEED_SZ);
+    ForceZero(newSeed, sizeof(newSeed));
+
+    return ret;
+}
+#endif /* HAVE_HASHDRBG */
+
+#ifdef WC_THREAD_RNG
+#if !defined(HAVE_HASHDRBG) || defined(SINGLE_THREADED) || \
+    !defined(WOLFSSL_PTHREADS)
+    #error WC_THREAD_RNG requires the Hash DRBG and pthreads
+#endif
+
+/* One DRBG per thread shared by everything the thread does, instead of
+ * seeding and health testing a new one each time. A thread takes over the
+ * DRBG of an exited thread before making a new one, they are only released
+ * by wc_ThreadRngCleanup() as objects may still point at them. */
+typedef struct ThreadRng {
+    WC_RNG  rng;
+    struct ThreadRng* next;  /* all thread DRBGs */
+    word32  forkGen;         /* threadRngForkGen when seeded */
+    byte    inUse;           /* held by a running thread */
+    byte    seeded;          /* rng instantiated */
+} ThreadRng;
+
+static pthread_once_t threadRngOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t  threadRngKey;
+static wolfSSL_Mutex  threadRngMutex;
+static ThreadRng*     threadRngList = NULL;
+static int            threadRngKeyInit = 0;
+static volatile word32 threadRngForkGen = 0;
+
+/* thread exit, leave the DRBG to the next new thread */
+static void ThreadRngRelease(void* arg)
+{
+    ThreadRng* t;
+
+    if (wc_LockMutex(&threadRngMutex) != 0)
+        return;
+    for (t = threadRngList; t != NULL; t = t->next) {
+        if (t == (ThreadRng*)arg) {
+            t->inUse = 0;
+            break;
+        }
+    }
+    wc_UnLockMutex(&threadRngMutex);
+}
+
+/* in the child after fork(), its DRBGs are copies of the parent's */
+static void ThreadRngForked(void)
+{
+    threadRngForkGen++;
+}
+
+static void ThreadRngInit(void)
+{
+    if (wc_InitMutex(&threadRngMutex) != 0)
+        return;
+    if (pthread_key_create(&threadRngKey, ThreadRngRelease) != 0)
+        return;
+    (void)pthread_atfork(NULL, NULL, ThreadRngForked);
+    threadRngKeyInit = 1;
+}
+
+/* Reseed with fresh entropy so that a forked child doesn't repeat output */
+static int ThreadRngReseed(ThreadRng* t)
+{
+    int ret;
+
+    ret = wc_RNG_Reseed(&t->rng);
+    if (ret == 0)
+        t->forkGen = threadRngForkGen;
+
+    return ret;
+}
+
+/* Get the DRBG of the calling thread, instantiating it on first use.
+ * Not to be freed by the caller. returns NULL on failure */
+WC_RNG* wc_GetThreadRng(void)
+{
+    ThreadRng* t;
+
+    if (pthread_once(&threadRngOnce, ThreadRngInit) != 0 ||
+            !threadRngKeyInit) {
+        return NULL;
+    }
+
+    t = (ThreadRng*)pthread_getspecific(threadRngKey);
+    if (t == NULL) {
+        if (wc_LockMutex(&threadRngMutex) != 0)
+            return NULL;
+        for (t = threadRngList; t != NULL && t->inUse; t = t->next)
+            ;
+        if (t != NULL)
+            t->inUse = 1;
+        wc_UnLockMutex(&threadRngMutex);
+
+        if (t == NULL) {
+            t = (ThreadRng*)XMALLOC(sizeof(ThreadRng), NULL,
+                                    DYNAMIC_TYPE_RNG);
+            if (t == NULL)
+                return NULL;
+            XMEMSET(t, 0, sizeof(ThreadRng));
+            t->inUse = 1;
+            if (wc_LockMutex(&threadRngMutex) != 0) {
+                XFREE(t, NULL, DYNAMIC_TYPE_RNG);
+                return NULL;
+            }
+            t->next = threadRngList;
+            threadRngList = t;
+            wc_UnLockMutex(&threadRngMutex);
+        }
+        if (pthread_setspecific(threadRngKey, t) != 0) {
+            t->inUse = 0;
+            return NULL;
+        }
+    }
+
+    if (!t->seeded) {
+        if (wc_InitRng(&t->rng) != 0)
+            return NULL;
+        t->forkGen = threadRngForkGen;
+        t->seeded = 1;
+    }
+    else if (t->forkGen != threadRngForkGen && ThreadRngReseed(t) != 0) {
+        return NULL;
+    }
+
+    return &t->rng;
+}
+
+/* Free the state of all thread DRBGs, instantiated again on next use. Only
+ * to be called when no thread is using them, from wolfCrypt_Cleanup() */
+void wc_ThreadRngCleanup(void)
+{
+    ThreadRng* t;
+
+    if (!threadRngKeyInit || wc_LockMutex(&threadRngMutex) != 0)
+        return;
+    for (t = threadRngList; t != NULL; t = t->next) {
+        if (t->seeded) {
+            wc_FreeRng(&t->rng);
+            t->seeded = 0;
+        }
+    }
+    wc_UnLockMutex(&threadRngMutex);
+}
+#endif /* WC_THREAD_RNG */
+
 #ifdef HAVE_HASHDRBG
 int wc_RNG_HealthTest(int reseed, const byte* seedA, word32 seedASz,
                                   const byte* seedB, word32 seedBSz,
@@ -1302,6 +1853,95 @@ static int wc_RNG_HealthTestLocal(int reseed)
     return ret;
 }
 
+#ifdef WC_RNG_CTR_DRBG
+/* Known answer test of the AES-256 CTR_DRBG, same procedure as
+ * wc_RNG_HealthTest() with 64 bytes of output */
+int wc_RNG_CtrHealthTest(int reseed, const byte* seedA, word32 seedASz,
+                                     const byte* seedB, word32 seedBSz,
+                                     byte* output, word32 outputSz)
+{
+    int ret = -1;
+    CTR_DRBG_internal* drbg;
+
+    if (seedA == NULL || output == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    if (reseed != 0 && seedB == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    if (outputSz != CTR_DRBG_TEST_SZ) {
+        return ret;
+    }
+
+    drbg = (CTR_DRBG_internal*)XMALLOC(sizeof(CTR_DRBG_internal), NULL,
+                                                             DYNAMIC_TYPE_RNG);
+    if (drbg == NULL) {
+        return MEMORY_E;
+    }
+
+    if (CTR_DRBG_Instantiate(drbg, seedA, seedASz, NULL, 0, NULL) == 0 &&
+        (!reseed || CTR_DRBG_Reseed(drbg, seedB, seedBSz) == 0) &&
+        /* first block thrown away as prescribed by the NIST DRBGVS */
+        CTR_DRBG_Generate(drbg, output, outputSz) == 0 &&
+        CTR_DRBG_Generate(drbg, output, outputSz) == 0) {
+        ret = 0;
+    }
+
+    CTR_DRBG_Uninstantiate(drbg);
+    XFREE(drbg, NULL, DYNAMIC_TYPE_RNG);
+
+    return ret;
+}
+
+static const byte ctrOutputA_data[] = {
+    0x69, 0xc6, 0x2b, 0xda, 0xbe, 0x9a, 0xcf, 0x04, 0x1a, 0x1a, 0x14, 0xfe,
+    0x5b, 0x86, 0x5a, 0x9e, 0x39, 0xbc, 0x18, 0x26, 0xcc, 0xd1, 0x0c, 0x47,
+    0x71, 0x86, 0xe0, 0x44, 0xc6, 0x24, 0x34, 0x43, 0xab, 0x3a, 0x50, 0x9b,
+    0x28, 0xbd, 0xf9, 0x2d, 0x02, 0x3f, 0xf2, 0x9e, 0x8e, 0xd7, 0xd6, 0x3e,
+    0x71, 0xf0, 0x1e, 0x81, 0x95, 0xd4, 0xaf, 0x10, 0x6e, 0xc9, 0x27, 0x0e,
+    0xe7, 0xb5, 0x2e, 0x82
+};
+
+static const byte ctrOutputB_data[] = {
+    0xf2, 0x48, 0x66, 0x46, 0xdd, 0x46, 0xd3, 0xf2, 0x61, 0x0c, 0x86, 0xed,
+    0xb6, 0x0e, 0x58, 0x20, 0xb3, 0x1b, 0xd7, 0xa8, 0x51, 0xab, 0x72, 0x90,
+    0x85, 0x4e, 0x8d, 0x78, 0x7c, 0xc6, 0x86, 0x3a, 0x61, 0x6f, 0x89, 0xf7,
+    0xda, 0x37, 0x4e, 0xd8, 0xcd, 0x97, 0x2b, 0x24, 0x60, 0x16, 0x19, 0xb1,
+    0x11, 0x6c, 0x5f, 0x8a, 0xc2, 0xde, 0x98, 0xbb, 0x2d, 0x8e, 0x81, 0xa4,
+    0x50, 0xd9, 0xc6, 0x30
+};
+
+/* the Hash DRBG test seeds with CTR_DRBG answers */
+static int CTR_DRBG_HealthTestLocal(int reseed)
+{
+    int  ret;
+    byte check[CTR_DRBG_TEST_SZ];
+
+    if (reseed) {
+        ret = wc_RNG_CtrHealthTest(1, seedA_data, sizeof(seedA_data),
+                                   reseedSeedA_data, sizeof(reseedSeedA_data),
+                                   check, sizeof(check));
+        if (ret == 0 &&
+                ConstantCompare(check, ctrOutputA_data, sizeof(check)) != 0) {
+            ret = -1;
+        }
+    }
+    else {
+        ret = wc_RNG_CtrHealthTest(0, seedB_data, sizeof(seedB_data), NULL, 0,
+                                   check, sizeof(check));
+        if (ret == 0 &&
+                ConstantCompare(check, ctrOutputB_data, sizeof(check)) != 0) {
+            ret = -1;
+        }
+    }
+    ForceZero(check, sizeof(check));
+
+    return ret;
+}
+#endif /* WC_RNG_CTR_DRBG */
+
 #endif /* HAVE_HASHDRBG */
 
 
@@ -2628,6 +3268,24 @@ int wc_GenerateSeed(OS_Seed* os, byte* output, word32 sz)
         }
     #endif /* HAVE_INTEL_RDSEED */
 
+    #ifdef WOLFSSL_GETRANDOM
+        /* no descriptor to open and close per seed, only blocks until the
+         * kernel pool is first initialized */
+        while (sz) {
+            ssize_t len = getrandom(output, sz, 0);
+            if (len == -1) {
+                if (errno == EINTR)
+                    continue;
+                break; /* e.g. ENOSYS on older kernels, use the device */
+            }
+
+            sz     -= (word32)len;
+            output += len;
+        }
+        if (sz == 0)
+            return 0;
+    #endif
+
     #ifndef NO_DEV_URANDOM /* way to disable use of /dev/urandom */
         os->fd = open("/dev/urandom", O_RDONLY);
         if (os->fd == -1)
@@ -34,6 +34,11 @@
 
 #include <wolfssl/wolfcrypt/wolfevent.h>
 
+#ifdef WOLF_EVENT_NOTIFY
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#endif
+
 
 int wolfEvent_Init(WOLF_EVENT* event, WOLF_EVENT_TYPE type, void* context)
 {
@@ -78,12 +83,162 @@ int wolfEventQueue_Init(WOLF_EVENT_QUEUE* queue)
     }
 
     XMEMSET(queue, 0, sizeof(WOLF_EVENT_QUEUE));
+#ifdef WOLF_EVENT_NOTIFY
+    queue->fd = -1;
+#endif
 #ifndef SINGLE_THREADED
     ret = wc_InitMutex(&queue->lock);
 #endif
     return ret;
 }
 
+#ifdef WOLF_EVENT_NOTIFY
+/* Post a completed event. Called by the device thread that ran the
+ * operation, many may post at once while one thread collects under the queue
+ * lock. The eventfd is signaled when the list goes from empty to not. */
+int wolfEventQueue_Notify(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
+{
+    WOLF_EVENT* head;
+    int fd;
+
+    if (queue == NULL || event == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    head = __atomic_load_n(&queue->posted, __ATOMIC_RELAXED);
+    do {
+        event->doneNext = head;
+    } while (!__atomic_compare_exchange_n(&queue->posted, &head, event, 1,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    if (head == NULL) {
+        fd = __atomic_load_n(&queue->fd, __ATOMIC_SEQ_CST);
+        if (fd >= 0) {
+            word64 one = 1;
+            if (write(fd, &one, sizeof(one)) != (ssize_t)sizeof(one)) {
+                WOLFSSL_MSG("Event queue eventfd write failed");
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* assumes queue is locked by caller */
+static void EventQueueAddDone(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
+{
+    WOLF_EVENT* prev = queue->doneTail;
+
+    event->prev = prev;
+    event->next = (prev != NULL) ? prev->next : queue->head;
+    if (event->next != NULL)
+        event->next->prev = event;
+    else
+        queue->tail = event;
+    if (prev != NULL)
+        prev->next = event;
+    else
+        queue->head = event;
+    queue->doneTail = event;
+    event->queue = queue;
+    queue->count++;
+}
+
+/* Take the posted completions and move them, done and in the order they
+ * completed, up to the done events at the head of the queue.
+ * assumes queue is locked by caller */
+static void EventQueueCollect(WOLF_EVENT_QUEUE* queue)
+{
+    WOLF_EVENT* list;
+    WOLF_EVENT* fifo = NULL;
+    WOLF_EVENT* next;
+
+    list = __atomic_exchange_n(&queue->posted, NULL, __ATOMIC_SEQ_CST);
+    while (list != NULL) {
+        next = list->doneNext;
+        list->doneNext = fifo;
+        fifo = list;
+        list = next;
+    }
+
+    for (; fifo != NULL; fifo = next) {
+        next = fifo->doneNext;
+        fifo->doneNext = NULL;
+        fifo->notify = NULL;
+
+        /* picks up the result now that it has been delivered */
+        wolfEvent_Poll(fifo, WOLF_POLL_FLAG_CHECK_HW);
+        if (fifo->state == WOLF_EVENT_STATE_DONE && fifo->queue == queue) {
+            wolfEventQueue_Remove(queue, fifo);
+            EventQueueAddDone(queue, fifo);
+        }
+    }
+}
+
+/* assumes queue is locked by caller */
+static void EventQueueClearFd(WOLF_EVENT_QUEUE* queue)
+{
+    word64 cnt;
+
+    if (queue->fd >= 0 && read(queue->fd, &cnt, sizeof(cnt)) < 0) {
+        /* EAGAIN, nothing was signaled */
+    }
+}
+
+/* assumes queue is locked by caller */
+static void EventQueueSetFd(WOLF_EVENT_QUEUE* queue)
+{
+    word64 one = 1;
+
+    if (queue->fd >= 0 && write(queue->fd, &one, sizeof(one)) < 0) {
+        WOLFSSL_MSG("Event queue eventfd write failed");
+    }
+}
+#endif /* WOLF_EVENT_NOTIFY */
+
+/* Return an eventfd, for epoll or poll, that is readable while completed
+ * events are waiting to be drained with wolfEventQueue_Drain(). */
+int wolfEventQueue_GetFd(WOLF_EVENT_QUEUE* queue)
+{
+#ifdef WOLF_EVENT_NOTIFY
+    int ret;
+
+    if (queue == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    if ((ret = wc_LockMutex(&queue->lock)) != 0) {
+        return ret;
+    }
+
+    if (queue->fd < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            WOLFSSL_MSG("Event queue eventfd create failed");
+            ret = WC_INIT_E;
+        }
+        else {
+            __atomic_store_n(&queue->fd, fd, __ATOMIC_SEQ_CST);
+            /* completions posted before there was a fd to signal */
+            if (queue->doneTail != NULL ||
+                    __atomic_load_n(&queue->posted, __ATOMIC_SEQ_CST) != NULL) {
+                EventQueueSetFd(queue);
+            }
+        }
+    }
+    if (ret == 0) {
+        ret = queue->fd;
+    }
+
+    wc_UnLockMutex(&queue->lock);
+
+    return ret;
+#else
+    (void)queue;
+    return NOT_COMPILED_IN;
+#endif
+}
+
 
 int wolfEventQueue_Push(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
 {
@@ -143,6 +298,7 @@ int wolfEventQueue_Add(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
 
     event->next = NULL; /* added to end */
     event->prev = NULL;
+    event->queue = queue;
     if (queue->tail == NULL)  {
         queue->head = event;
     }
@@ -165,6 +321,11 @@ int wolfEventQueue_Remove(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
         return BAD_FUNC_ARG;
     }
 
+#ifdef WOLF_EVENT_NOTIFY
+    if (event == queue->doneTail) {
+        queue->doneTail = event->prev;
+    }
+#endif
     if (event == queue->head && event == queue->tail) {
         queue->head = NULL;
         queue->tail = NULL;
@@ -183,6 +344,7 @@ int wolfEventQueue_Remove(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
         next->prev = prev;
         prev->next = next;
     }
+    event->queue = NULL;
     queue->count--;
 
     return ret;
@@ -205,6 +367,10 @@ int wolfEventQueue_Poll(WOLF_EVENT_QUEUE* queue, void* context_filter,
     }
 #endif
 
+#ifdef WOLF_EVENT_NOTIFY
+    EventQueueCollect(queue);
+#endif
+
     /* itterate event queue */
     for (event = queue->head; event != NULL; event = event->next)
     {
@@ -247,6 +413,91 @@ int wolfEventQueue_Poll(WOLF_EVENT_QUEUE* queue, void* context_filter,
     return ret;
 }
 
+/* Remove up to maxEvents completed events, oldest first, without polling
+ * the events still pending. */
+int wolfEventQueue_Drain(WOLF_EVENT_QUEUE* queue, WOLF_EVENT** events,
+    int maxEvents, int* eventCount)
+{
+#ifdef WOLF_EVENT_NOTIFY
+    int ret, count = 0;
+
+    if (queue == NULL || events == NULL || maxEvents <= 0) {
+        return BAD_FUNC_ARG;
+    }
+
+    if ((ret = wc_LockMutex(&queue->lock)) != 0) {
+        return ret;
+    }
+
+    /* clear before collecting so a post after the collect signals again */
+    EventQueueClearFd(queue);
+    EventQueueCollect(queue);
+
+    while (count < maxEvents && queue->doneTail != NULL) {
+        WOLF_EVENT* event = queue->head;
+        wolfEventQueue_Remove(queue, event);
+        events[count++] = event;
+    }
+    if (queue->doneTail != NULL) {
+        /* more than fit, stay readable */
+        EventQueueSetFd(queue);
+    }
+
+    wc_UnLockMutex(&queue->lock);
+
+    if (eventCount) {
+        *eventCount = count;
+    }
+
+    return ret;
+#else
+    if (events == NULL || maxEvents <= 0) {
+        return BAD_FUNC_ARG;
+    }
+
+    return wolfEventQueue_Poll(queue, NULL, events, maxEvents,
+                               WOLF_POLL_FLAG_CHECK_HW, eventCount);
+#endif
+}
+
+/* Take event off queue, whether or not it has completed */
+int wolfEventQueue_Cancel(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
+{
+    int ret = 0;
+
+    if (queue == NULL || event == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+#ifdef WOLF_EVENT_NOTIFY
+    /* once the device lets go it no longer posts the event */
+    if (event->type >= WOLF_EVENT_TYPE_ASYNC_FIRST &&
+        event->type <= WOLF_EVENT_TYPE_ASYNC_LAST) {
+        wolfAsync_EventCancel(event);
+    }
+#endif
+
+#ifndef SINGLE_THREADED
+    if ((ret = wc_LockMutex(&queue->lock)) != 0) {
+        return ret;
+    }
+#endif
+
+#ifdef WOLF_EVENT_NOTIFY
+    /* the event may still be in the posted list */
+    EventQueueCollect(queue);
+#endif
+    if (event->queue == queue) {
+        ret = wolfEventQueue_Remove(queue, event);
+    }
+
+#ifndef SINGLE_THREADED
+    wc_UnLockMutex(&queue->lock);
+#endif
+
+    return ret;
+}
+
 int wolfEventQueue_Count(WOLF_EVENT_QUEUE* queue)
 {
     int ret;
@@ -274,6 +525,12 @@ int wolfEventQueue_Count(WOLF_EVENT_QUEUE* queue)
 void wolfEventQueue_Free(WOLF_EVENT_QUEUE* queue)
 {
     if (queue) {
+    #ifdef WOLF_EVENT_NOTIFY
+        if (queue->fd >= 0) {
+            close(queue->fd);
+            queue->fd = -1;
+        }
+    #endif
     #ifndef SINGLE_THREADED
         wc_FreeMutex(&queue->lock);
     #endif
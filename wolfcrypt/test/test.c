@@ -11572,6 +11572,33 @@ static int random_rng_test(void)
     }
 #endif
 
+#ifdef WC_RNG_CTR_DRBG
+    if (ret == 0) {
+        byte block[600];
+        word32 i;
+        /* sizes within, across and above the keystream buffer */
+        const word32 sizes[] = { 1, 15, 16, 17, 511, 513, sizeof(block) };
+
+        rng = &localRng;
+        ret = wc_InitRngDrbg_ex(rng, WC_DRBG_CTR, HEAP_HINT, devId);
+        if (ret != 0) return -6902;
+
+        ret = _rng_test(rng, -6320);
+        for (i = 0; ret == 0 && i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            if (wc_RNG_GenerateBlock(rng, block, sizes[i]) != 0)
+                ret = -6903;
+        }
+
+        wc_FreeRng(rng);
+
+        if (ret == 0 &&
+                wc_InitRngDrbg_ex(rng, WC_DRBG_CTR + 1, HEAP_HINT, devId) !=
+                                                                BAD_FUNC_ARG) {
+            ret = -6904;
+        }
+    }
+#endif
+
     return ret;
 }
 
@@ -11648,6 +11675,47 @@ WOLFSSL_TEST_SUBROUTINE int random_test(void)
     if (XMEMCMP(test2Output, output, sizeof(output)) != 0)
         return -7003;
 
+#ifdef WC_RNG_CTR_DRBG
+    {
+        /* AES-256 CTR_DRBG with the derivation function, same inputs */
+        WOLFSSL_SMALL_STACK_STATIC const byte ctrTest1Output[] =
+        {
+            0xf2, 0x48, 0x66, 0x46, 0xdd, 0x46, 0xd3, 0xf2, 0x61, 0x0c, 0x86,
+            0xed, 0xb6, 0x0e, 0x58, 0x20, 0xb3, 0x1b, 0xd7, 0xa8, 0x51, 0xab,
+            0x72, 0x90, 0x85, 0x4e, 0x8d, 0x78, 0x7c, 0xc6, 0x86, 0x3a, 0x61,
+            0x6f, 0x89, 0xf7, 0xda, 0x37, 0x4e, 0xd8, 0xcd, 0x97, 0x2b, 0x24,
+            0x60, 0x16, 0x19, 0xb1, 0x11, 0x6c, 0x5f, 0x8a, 0xc2, 0xde, 0x98,
+            0xbb, 0x2d, 0x8e, 0x81, 0xa4, 0x50, 0xd9, 0xc6, 0x30
+        };
+        WOLFSSL_SMALL_STACK_STATIC const byte ctrTest2Output[] =
+        {
+            0x69, 0xc6, 0x2b, 0xda, 0xbe, 0x9a, 0xcf, 0x04, 0x1a, 0x1a, 0x14,
+            0xfe, 0x5b, 0x86, 0x5a, 0x9e, 0x39, 0xbc, 0x18, 0x26, 0xcc, 0xd1,
+            0x0c, 0x47, 0x71, 0x86, 0xe0, 0x44, 0xc6, 0x24, 0x34, 0x43, 0xab,
+            0x3a, 0x50, 0x9b, 0x28, 0xbd, 0xf9, 0x2d, 0x02, 0x3f, 0xf2, 0x9e,
+            0x8e, 0xd7, 0xd6, 0x3e, 0x71, 0xf0, 0x1e, 0x81, 0x95, 0xd4, 0xaf,
+            0x10, 0x6e, 0xc9, 0x27, 0x0e, 0xe7, 0xb5, 0x2e, 0x82
+        };
+
+        ret = wc_RNG_CtrHealthTest(0, test1Entropy, sizeof(test1Entropy),
+                                   NULL, 0, output, sizeof(ctrTest1Output));
+        if (ret != 0)
+            return -7007;
+
+        if (XMEMCMP(ctrTest1Output, output, sizeof(ctrTest1Output)) != 0)
+            return -7008;
+
+        ret = wc_RNG_CtrHealthTest(1, test2EntropyA, sizeof(test2EntropyA),
+                                   test2EntropyB, sizeof(test2EntropyB),
+                                   output, sizeof(ctrTest2Output));
+        if (ret != 0)
+            return -7009;
+
+        if (XMEMCMP(ctrTest2Output, output, sizeof(ctrTest2Output)) != 0)
+            return -7010;
+    }
+#endif
+
     /* Basic RNG generate block test */
     if ((ret = random_rng_test()) != 0)
         return ret;
@@ -171,6 +171,7 @@ enum wolfSSL_ErrorCodes {
     NO_CERT_ERROR                = -440,   /* TLS1.3 - no cert set error */
     APP_DATA_READY               = -441,   /* DTLS1.2 application data ready for read */
     TOO_MUCH_EARLY_DATA          = -442,   /* Too much Early data */
+    KTLS_E                       = -443,   /* kernel TLS offload error */
     
     /* add strings to wolfSSL_ERR_reason_error_string in internal.c !!!!! */
 
@@ -1580,6 +1580,28 @@ enum Misc {
     #define MAX_CHAIN_DEPTH 9
 #endif
 
+/* peer certs kept with the session, the lean connection profile only keeps
+ * the peer's own cert */
+#ifndef MAX_SESSION_CHAIN_DEPTH
+    #ifdef WOLFSSL_LEAN_CONN
+        #define MAX_SESSION_CHAIN_DEPTH 1
+    #else
+        #define MAX_SESSION_CHAIN_DEPTH MAX_CHAIN_DEPTH
+    #endif
+#endif
+#if MAX_SESSION_CHAIN_DEPTH < 1 || MAX_SESSION_CHAIN_DEPTH > MAX_CHAIN_DEPTH
+    #error MAX_SESSION_CHAIN_DEPTH must be from 1 to MAX_CHAIN_DEPTH
+#endif
+
+#ifdef WOLFSSL_SENDFILE
+    #ifndef WOLFSSL_ZERO_COPY
+        #error WOLFSSL_SENDFILE needs WOLFSSL_ZERO_COPY
+    #endif
+    #if defined(USE_WINDOWS_API) || defined(WOLFSSL_NO_SOCK)
+        #error WOLFSSL_SENDFILE needs a POSIX pread()
+    #endif
+#endif
+
 /* max size of a certificate message payload */
 /* assumes MAX_CHAIN_DEPTH number of certificates at 2kb per certificate */
 #ifndef MAX_CERTIFICATE_SZ
@@ -1751,6 +1773,13 @@ WOLFSSL_LOCAL int  CreateDevPrivateKey(void** pkey, byte* buffer, word32 length,
                                        void* heap, int devId);
 #endif
 WOLFSSL_LOCAL int  DecodePrivateKey(WOLFSSL *ssl, word16* length);
+#ifdef WOLFSSL_CERT_MSG_CACHE
+WOLFSSL_LOCAL void SetCtxCertMsgCache(WOLFSSL_CTX* ctx);
+#endif
+#ifdef WOLFSSL_PRIVKEY_CACHE
+WOLFSSL_LOCAL void SetCtxPrivateKeyCache(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL void FreeCtxPrivateKeyCache(WOLFSSL_CTX* ctx);
+#endif
 #ifdef HAVE_PK_CALLBACKS
 WOLFSSL_LOCAL int GetPrivateKeySigSize(WOLFSSL* ssl);
 #ifndef NO_ASN
@@ -1759,6 +1788,7 @@ WOLFSSL_LOCAL int GetPrivateKeySigSize(WOLFSSL* ssl);
 #endif
 WOLFSSL_LOCAL void FreeKeyExchange(WOLFSSL* ssl);
 WOLFSSL_LOCAL void FreeSuites(WOLFSSL* ssl);
+WOLFSSL_LOCAL int  AllocateSuites(WOLFSSL* ssl);
 WOLFSSL_LOCAL int  ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx, word32 size);
 WOLFSSL_LOCAL int  MatchDomainName(const char* pattern, int len, const char* str);
 #ifndef NO_CERTS
@@ -1851,6 +1881,14 @@ enum {
        The length (in bytes) of the following TLSPlaintext.fragment.
        The length should not exceed 2^14.
 */
+#ifdef WOLFSSL_READ_AHEAD
+    /* input buffer used by SSL_CTX_set_read_ahead(), room for a full record
+     * and then some */
+    #ifndef WOLFSSL_READ_AHEAD_SZ
+        #define WOLFSSL_READ_AHEAD_SZ (32 * 1024)
+    #endif
+#endif
+
 #if defined(LARGE_STATIC_BUFFERS)
     #define STATIC_BUFFER_LEN RECORD_HEADER_SZ + RECORD_SIZE + COMP_EXTRA + \
              MTU_EXTRA + MAX_MSG_EXTRA
@@ -1867,17 +1905,191 @@ typedef struct {
     word32 bufferSize;   /* current buffer size */
     byte   dynamicFlag;  /* dynamic memory currently in use */
     byte   offset;       /* alignment offset attempt */
+#ifdef WOLFSSL_IO_POOL
+    WOLFSSL_CTX* pool;   /* CTX whose pool lent the dynamic buffer */
+    byte   poolRef;      /* holds a reference on pool, lent before a CTX
+                          * switch */
+#endif
 } bufferStatic;
 
+#ifdef WOLFSSL_IO_POOL
+    #ifdef WOLFSSL_STATIC_MEMORY
+        #error WOLFSSL_IO_POOL does not work with WOLFSSL_STATIC_MEMORY
+    #endif
+    /* size of pooled I/O buffers, a full encrypted record with room for
+     * alignment */
+    #ifndef IO_POOL_BUF_SZ
+        #define IO_POOL_BUF_SZ (RECORD_HEADER_SZ + MAX_TLS_CIPHER_SZ + \
+                                MAX_MSG_EXTRA + 2 * WOLFSSL_GENERAL_ALIGNMENT)
+    #endif
+
+/* CTX wide free list of record sized I/O buffers connections borrow while
+ * a record is in flight, see wolfSSL_CTX_UseIOBufferPool() */
+typedef struct IOBufPool {
+    wolfSSL_Mutex lock;
+    void*  head;         /* free buffers, linked through their first bytes */
+    word32 freeCnt;      /* buffers on the free list */
+    word32 maxFree;      /* most buffers kept on the free list, 0 is off */
+    word32 inUse;        /* buffers lent out to connections */
+} IOBufPool;
+#endif
+
+#ifdef WOLFSSL_SSL_POOL
+    #ifdef WOLFSSL_STATIC_MEMORY
+        #error WOLFSSL_SSL_POOL does not work with WOLFSSL_STATIC_MEMORY
+    #endif
+/* CTX free list of released WOLFSSL objects that wolfSSL_new() reuses with
+ * their RNG still seeded, see wolfSSL_CTX_UseSSLPool() */
+typedef struct SSLPool {
+    wolfSSL_Mutex lock;
+    WOLFSSL* head;       /* free objects, linked through poolNext */
+    word32   freeCnt;    /* objects on the free list */
+    word32   maxFree;    /* most objects kept on the free list, 0 is off */
+    word32   hits;       /* wolfSSL_new() calls served from the free list */
+    word32   misses;     /* wolfSSL_new() calls that had to allocate */
+} SSLPool;
+#endif
+
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    #ifndef WORD64_AVAILABLE
+        #error WOLFSSL_HANDSHAKE_TIMING requires a 64-bit type
+    #endif
+    #ifndef WOLFSSL_HS_TIMING_MAX_EVENTS
+        #define WOLFSSL_HS_TIMING_MAX_EVENTS 48
+    #endif
+/* where the handshake of a connection spent its time, allocated when timing
+ * is on, see wolfSSL_SetHandshakeTiming(). Times are ns */
+typedef struct HsTiming {
+    word64 base;                            /* time of the first event */
+    word64 open[WOLFSSL_HST_IO_WRITE + 1];  /* start of a running event */
+    word64 total[WOLFSSL_HST_TYPES];        /* time per event type */
+    WOLFSSL_HS_TIMING_EVENT events[WOLFSSL_HS_TIMING_MAX_EVENTS];
+    word16 eventCnt;
+    word16 dropped;                         /* events past the array */
+    byte   active;                          /* cleared at end of handshake */
+} HsTiming;
+
+/* CTX histograms of the time finished handshakes spent per event type */
+typedef struct HsTimingHist {
+    wolfSSL_Mutex lock;
+    word32 bucket[WOLFSSL_HST_TYPES][WOLFSSL_HST_BUCKETS];
+    byte   on;                              /* new connections record */
+} HsTimingHist;
+
+    #define HS_TIMING_ON(ssl) \
+        ((ssl) != NULL && (ssl)->hsTiming != NULL && (ssl)->hsTiming->active)
+    /* an event of type runs until its end, an end without a begin is an
+     * event without duration. Ends with ret of WANT_READ/WRITE or pending
+     * leave the event running to the end of the call made again. Public key
+     * operations end with 0, with async crypto they time the submit and the
+     * wait is part of processing the message */
+    #define HS_TIMING_BEGIN(ssl, type) \
+        do { if (HS_TIMING_ON(ssl)) HsTimingBegin((ssl), (type)); } while (0)
+    #define HS_TIMING_END(ssl, type, msgType, ret) \
+        do { if (HS_TIMING_ON(ssl)) \
+                 HsTimingEnd((ssl), (type), (msgType), (ret)); } while (0)
+    #define HS_TIMING_DONE(ssl) \
+        do { if (HS_TIMING_ON(ssl)) HsTimingDone(ssl); } while (0)
+#else
+    #define HS_TIMING_BEGIN(ssl, type)
+    #define HS_TIMING_END(ssl, type, msgType, ret)
+    #define HS_TIMING_DONE(ssl)
+#endif
+
+#ifdef WOLFSSL_CTX_STATS
+    #if !defined(SINGLE_THREADED) && !defined(__GNUC__)
+        #error WOLFSSL_CTX_STATS requires the GCC __atomic builtins
+    #endif
+    #ifndef WOLFSSL_CTX_STATS_SHARDS
+        #ifdef SINGLE_THREADED
+            #define WOLFSSL_CTX_STATS_SHARDS 1
+        #else
+            #define WOLFSSL_CTX_STATS_SHARDS 8
+        #endif
+    #endif
+/* CTX counters, one shard per thread (round robin past the shard count) so
+ * threads don't bounce the same lines, summed by wolfSSL_CTX_GetStats() */
+typedef struct CtxStatsShard {
+    WOLFSSL_STATS s;
+    word64 pad[8];        /* keeps the next shard off the last line */
+} CtxStatsShard;
+
+    #ifdef SINGLE_THREADED
+        #define CTX_STATS_ATOMIC_ADD(p, n)  (*(p) += (n))
+        #define CTX_STATS_ATOMIC_LOAD(p)    (*(p))
+        #define CTX_STATS_ATOMIC_STORE(p, n) (*(p) = (n))
+    #else
+        #define CTX_STATS_ATOMIC_ADD(p, n) \
+            (void)__atomic_fetch_add((p), (n), __ATOMIC_RELAXED)
+        #define CTX_STATS_ATOMIC_LOAD(p) \
+            __atomic_load_n((p), __ATOMIC_RELAXED)
+        #define CTX_STATS_ATOMIC_STORE(p, n) \
+            __atomic_store_n((p), (n), __ATOMIC_RELAXED)
+    #endif
+    /* add n to a field of the counters of the thread for the CTX of ssl */
+    #define CTX_STATS_ADD(ssl, field, n) \
+        do { WOLFSSL_STATS* st_ = CtxStatsGet((ssl)->ctx); \
+             if (st_ != NULL) \
+                 CTX_STATS_ATOMIC_ADD(&st_->field, (word64)(n)); } while (0)
+    /* counter of an alert code, codes past the array share the last */
+    #define CTX_STATS_ALERT(code) \
+        (((word32)(code) < WOLFSSL_STAT_ALERTS) ? (word32)(code) : \
+                                                  WOLFSSL_STAT_ALERTS - 1)
+    #define CTX_STATS_DONE(ssl)     CtxStatsHandshakeDone(ssl)
+    #define CTX_STATS_FAILED(ssl)   CtxStatsHandshakeFailed(ssl)
+    #define CTX_STATS_RECORDS_OUT(ssl, out, sz) \
+        CtxStatsRecordsOut((ssl), (out), (sz))
+#else
+    #define CTX_STATS_ADD(ssl, field, n)
+    #define CTX_STATS_DONE(ssl)
+    #define CTX_STATS_FAILED(ssl)
+    #define CTX_STATS_RECORDS_OUT(ssl, out, sz)
+#endif
+
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    #if defined(NO_CERTS) || !defined(WOLFSSL_TLS13)
+        #error WOLFSSL_CERT_MSG_CACHE requires certificates and TLS 1.3
+    #endif
+#endif
+
+#ifdef WOLFSSL_PRIVKEY_CACHE
+    #ifdef NO_CERTS
+        #error WOLFSSL_PRIVKEY_CACHE requires certificate support
+    #endif
+/* CTX private key decoded once when loaded, connections copy it into their
+ * handshake key, see SetCtxPrivateKeyCache() */
+typedef struct PrivKeyCache {
+    void*  key;          /* RsaKey or ecc_key, NULL when not cached */
+    int    type;         /* DYNAMIC_TYPE_RSA or DYNAMIC_TYPE_ECC */
+    int    keySz;        /* key size in bytes */
+    word16 sigSz;        /* maximum signature length */
+} PrivKeyCache;
+#endif
+
 /* Cipher Suites holder */
+/* Suites set on the CTX with a cipher list are shared read only by its WOLFSSL
+ * objects, which take their own copy before changing them. Always so when
+ * single threaded. */
+#if defined(SINGLE_THREADED) && !defined(WOLFSSL_SHARED_SUITES)
+    #define WOLFSSL_SHARED_SUITES
+#endif
+#ifdef WOLFSSL_SUITE_MAP
+/* Rows of the suite map, one for each common first cipher suite byte. */
+#define SUITE_MAP_ROWS  4
+#define SUITE_MAP_SZ    (SUITE_MAP_ROWS * 256 / WOLFSSL_BIT_SIZE)
+#endif
+
 struct Suites {
     word16 suiteSz;                 /* suite length in bytes        */
     word16 hashSigAlgoSz;           /* SigAlgo extension length in bytes */
     byte   suites[WOLFSSL_MAX_SUITE_SZ];
     byte   hashSigAlgo[WOLFSSL_MAX_SIGALGO]; /* sig/algo to offer */
     byte   setSuites;               /* user set suites from default */
-    byte   hashAlgo;                /* selected hash algorithm */
-    byte   sigAlgo;                 /* selected sig algorithm */
+#ifdef WOLFSSL_SUITE_MAP
+    byte   map[SUITE_MAP_SZ];       /* bit per suite held, by first byte */
+    byte   mapOther;                /* holds suites without a map row */
+    byte   mapSet;                  /* map matches suites */
+#endif
 #if defined(OPENSSL_ALL) || defined(WOLFSSL_NGINX) || defined(WOLFSSL_HAPROXY)
     WOLF_STACK_OF(WOLFSSL_CIPHER)* stack; /* stack of available cipher suites */
 #endif
@@ -1890,6 +2102,10 @@ WOLFSSL_LOCAL void InitSuitesHashSigAlgo(Suites* suites, int haveECDSAsig,
 WOLFSSL_LOCAL void InitSuites(Suites*, ProtocolVersion, int, word16, word16,
                               word16, word16, word16, word16, word16, word16, int);
 WOLFSSL_LOCAL int  MatchSuite(WOLFSSL* ssl, Suites* peerSuites);
+#ifdef WOLFSSL_SUITE_MAP
+WOLFSSL_LOCAL void InitSuitesMap(Suites* suites);
+WOLFSSL_LOCAL int  SuitesMapHas(const Suites* suites, byte first, byte second);
+#endif
 WOLFSSL_LOCAL int  SetCipherList(WOLFSSL_CTX*, Suites*, const char* list);
 
 #ifndef PSK_TYPES_DEFINED
@@ -2275,11 +2491,15 @@ typedef enum {
     TLSX_RENEGOTIATION_INFO         = 0xff01
 } TLSX_Type;
 
+/* Bytes in the set of extension types held by a list from a node onwards. */
+#define TLSX_PRESENT_SZ 8
+
 typedef struct TLSX {
     TLSX_Type    type; /* Extension Type  */
     void*        data; /* Extension Data  */
     word32       val;  /* Extension Value */
     byte         resp; /* IsResponse Flag */
+    byte         present[TLSX_PRESENT_SZ]; /* Types in this and next nodes */
     struct TLSX* next; /* List Behavior   */
 } TLSX;
 
@@ -2601,6 +2821,10 @@ WOLFSSL_LOCAL int TLSX_ValidateQSHScheme(TLSX** extensions, word16 name);
 
 #endif /* HAVE_QSH */
 
+#if defined(WOLFSSL_KEYSHARE_POOL) && !defined(WOLFSSL_TLS13)
+    #error WOLFSSL_KEYSHARE_POOL requires WOLFSSL_TLS13
+#endif
+
 #ifdef WOLFSSL_TLS13
 /* Cookie extension information - cookie data. */
 typedef struct Cookie {
@@ -2632,6 +2856,35 @@ WOLFSSL_LOCAL int TLSX_KeyShare_Empty(WOLFSSL* ssl);
 WOLFSSL_LOCAL int TLSX_KeyShare_Establish(WOLFSSL* ssl);
 WOLFSSL_LOCAL int TLSX_KeyShare_DeriveSecret(WOLFSSL* ssl);
 
+#ifdef WOLFSSL_KEYSHARE_POOL
+    /* number of named groups a CTX can keep key shares ready for */
+    #ifndef KEYSHARE_POOL_GROUPS
+        #define KEYSHARE_POOL_GROUPS 4
+    #endif
+
+/* Single use key pairs ready for one named group */
+typedef struct KeySharePoolGroup {
+    KeyShareEntry* head;    /* generated key pairs, ke unused */
+    word16         group;   /* NamedGroup, 0 when slot unused */
+    word16         count;   /* key pairs on the list */
+    word16         target;  /* key pairs to keep ready */
+} KeySharePoolGroup;
+
+/* CTX wide ephemeral key pairs generated ahead of the handshake, see
+ * wolfSSL_CTX_UseKeySharePool() */
+typedef struct KeySharePool {
+    wolfSSL_Mutex     lock;
+    KeySharePoolGroup groups[KEYSHARE_POOL_GROUPS];
+} KeySharePool;
+
+WOLFSSL_LOCAL int TLSX_KeySharePool_Set(WOLFSSL_CTX* ctx, word16 group,
+                                        int count);
+WOLFSSL_LOCAL int TLSX_KeySharePool_Refill(WOLFSSL_CTX* ctx, int max);
+WOLFSSL_LOCAL int TLSX_KeySharePool_Count(WOLFSSL_CTX* ctx, word16 group);
+WOLFSSL_LOCAL int TLSX_KeySharePool_TempKey(WOLFSSL* ssl);
+WOLFSSL_LOCAL void TLSX_KeySharePool_Free(WOLFSSL_CTX* ctx);
+#endif /* WOLFSSL_KEYSHARE_POOL */
+
 
 #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
 /* Ticket nonce - for deriving PSK.
@@ -2735,6 +2988,25 @@ typedef struct {
 } StaticKeyExchangeInfo_t;
 #endif
 
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+/* adaptive application data record size, see wolfSSL_CTX_SetDynRecordSize */
+typedef struct DynRecordCfg {
+    word32 rampBytes;    /* full size records after this many burst bytes */
+    word32 rampSec;      /* or after this many seconds of sending */
+    word32 idleSec;      /* back to small records after this idle time */
+    word16 smallSz;      /* plain text size of small records, 0 is off */
+} DynRecordCfg;
+
+typedef struct DynRecord {
+    DynRecordCfg cfg;
+    WOLFSSL_RECORD_SIZE_STATS stats;
+    word32 burstBytes;   /* plain text sent since the burst started */
+    word32 burstStart;   /* LowResTimer() at start of burst */
+    word32 lastSend;     /* LowResTimer() at last record sent */
+    byte   fullSize;     /* burst has ramped up to full size records */
+} DynRecord;
+#endif
+
 
 /* wolfSSL context type */
 struct WOLFSSL_CTX {
@@ -2763,6 +3035,9 @@ struct WOLFSSL_CTX {
     #endif
 #ifdef WOLFSSL_TLS13
     int         certChainCnt;
+#endif
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    DerBuffer*  certMsg;          /* TLS 1.3 certificate list encoded */
 #endif
     DerBuffer*  privateKey;
     byte        privateKeyType:6;
@@ -2770,6 +3045,9 @@ struct WOLFSSL_CTX {
     byte        privateKeyLabel:1;
     int         privateKeySz;
     int         privateKeyDevId;
+#ifdef WOLFSSL_PRIVKEY_CACHE
+    PrivKeyCache privKeyCache;    /* privateKey decoded, read only */
+#endif
     WOLFSSL_CERT_MANAGER* cm;      /* our cert manager, ctx owns SSL will use */
 #endif
 #ifdef KEEP_OUR_CERT
@@ -2809,6 +3087,7 @@ struct WOLFSSL_CTX {
     byte        noPskDheKe:1;     /* Don't use (EC)DHE with PSK */
 #endif
     byte        mutualAuth:1;     /* Mutual authentication required */
+    byte        autoCompact:1;    /* compact resources after handshake */
 #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_POST_HANDSHAKE_AUTH)
     byte        postHandshakeAuth:1;  /* Post-handshake auth supported. */
 #endif
@@ -2824,6 +3103,9 @@ struct WOLFSSL_CTX {
 #ifdef HAVE_ENCRYPT_THEN_MAC
     byte        disallowEncThenMac:1;  /* Don't do Encrypt-Then-MAC */
 #endif
+#ifdef WOLFSSL_KTLS
+    byte        ktls:2;           /* kernel TLS directions to offload */
+#endif
 #ifdef WOLFSSL_STATIC_MEMORY
     byte        onHeap:1; /* whether the ctx/method is put on heap hint */
 #endif
@@ -2875,6 +3157,27 @@ struct WOLFSSL_CTX {
     void*              verifyCertCbArg;
 #endif /* OPENSSL_ALL */
     word32          timeout;            /* session timeout */
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+    DynRecordCfg    dynRecord;          /* adaptive record size policy */
+#endif
+#ifdef WOLFSSL_READ_AHEAD
+    word32          readAheadSz;        /* input buffer size to read into */
+#endif
+#ifdef WOLFSSL_IO_POOL
+    IOBufPool       ioPool;             /* shared record buffers */
+#endif
+#ifdef WOLFSSL_SSL_POOL
+    SSLPool         sslPool;            /* released objects for reuse */
+#endif
+#ifdef WOLFSSL_KEYSHARE_POOL
+    KeySharePool    ksPool;             /* pre-generated ephemeral keys */
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    HsTimingHist    hsHist;             /* times of finished handshakes */
+#endif
+#ifdef WOLFSSL_CTX_STATS
+    CtxStatsShard*  stats;              /* operational counters, sharded */
+#endif
 #if defined(HAVE_ECC) || defined(HAVE_CURVE25519) || defined(HAVE_ED448)
     word32          ecdhCurveOID;       /* curve Ecc_Sum */
 #endif
@@ -3264,7 +3567,7 @@ typedef struct x509_buffer {
 /* wolfSSL X509_CHAIN, for no dynamic memory SESSION_CACHE */
 struct WOLFSSL_X509_CHAIN {
     int         count;                    /* total number in chain */
-    x509_buffer certs[MAX_CHAIN_DEPTH];   /* only allow max depth 4 for now */
+    x509_buffer certs[MAX_SESSION_CHAIN_DEPTH];
 };
 
 
@@ -3415,6 +3718,15 @@ typedef struct Buffers {
                                               when got WANT_WRITE            */
     int             plainSz;               /* plain text bytes in buffer to send
                                               when got WANT_WRITE            */
+    word32          recordIdx;             /* start of the record being
+                                              processed in inputBuffer       */
+#ifdef WOLFSSL_ZERO_COPY
+    byte*           zcWrite;               /* plain text area handed out by
+                                              zero copy write reserve        */
+    int             zcWriteSz;             /* size of zcWrite, 0 if none     */
+    int             zcWriteSent;           /* committed plain text bytes left
+                                              to flush after WANT_WRITE      */
+#endif
     byte            weOwnCert;             /* SSL own cert flag */
     byte            weOwnCertChain;        /* SSL own cert chain flag */
     byte            weOwnKey;              /* SSL own key  flag */
@@ -3554,6 +3866,9 @@ typedef struct Options {
     word16            saveArrays:1;       /* save array Memory for user get keys
                                            or psk */
     word16            weOwnRng:1;         /* will be true unless CTX owns */
+#ifdef WC_THREAD_RNG
+    word16            threadRng:1;        /* rng is the calling thread's */
+#endif
     word16            haveEMS:1;          /* using extended master secret */
 #ifdef HAVE_POLY1305
     word16            oldPoly:1;        /* set when to use old rfc way of poly*/
@@ -3580,6 +3895,7 @@ typedef struct Options {
     word16            userCurves:1;       /* indicates user called wolfSSL_UseSupportedCurve */
 #endif
     word16            keepResources:1;    /* Keep resources after handshake */
+    word16            autoCompact:1;      /* Compact resources after handshake */
     word16            useClientOrder:1;   /* Use client's cipher order */
     word16            mutualAuth:1;       /* Mutual authentication is rquired */
 #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_POST_HANDSHAKE_AUTH)
@@ -3607,7 +3923,7 @@ typedef struct Options {
         word16        dhKeyTested:1;      /* Set when key has been tested. */
     #endif
 #endif
-#ifdef SINGLE_THREADED
+#ifdef WOLFSSL_SHARED_SUITES
     word16            ownSuites:1;        /* if suites are malloced in ssl object */
 #endif
 #ifdef HAVE_ENCRYPT_THEN_MAC
@@ -3616,11 +3932,18 @@ typedef struct Options {
     word16            startedETMRead:1;       /* Doing Encrypt-Then-MAC read */
     word16            startedETMWrite:1;      /* Doing Encrypt-Then-MAC write */
 #endif
+#ifdef WOLFSSL_KTLS
+    word16            ktls:2;             /* kernel TLS directions wanted */
+    word16            ktlsTx:1;           /* kernel TLS transmit installed */
+    word16            ktlsRx:1;           /* kernel TLS receive installed */
+#endif
 
     /* need full byte values for this section */
     byte            processReply;           /* nonblocking resume */
     byte            cipherSuite0;           /* first byte, normally 0 */
     byte            cipherSuite;            /* second byte, actual suite */
+    byte            hashAlgo;               /* selected hash algorithm */
+    byte            sigAlgo;                /* selected sig algorithm */
     byte            serverState;
     byte            clientState;
     byte            handShakeState;
@@ -3986,8 +4309,33 @@ typedef struct HS_Hashes {
     int             length;             /* length of handshake messages' data */
     int             prevLen;            /* length of messages but last */
 #endif
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+    byte*           pending;            /* messages held until hash known */
+    word32          pendingSz;          /* length of held messages */
+    word32          pendingMax;         /* size of pending buffer */
+    word16          hashMask;           /* HS_HASH_* of the running hashes */
+    byte            deferred;           /* holding messages, none selected */
+#endif
 } HS_Hashes;
 
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+/* Transcript hashes that are updated once the negotiated suite is known. */
+enum HsHashMask {
+    HS_HASH_MD5    = 0x0001,
+    HS_HASH_SHA    = 0x0002,
+    HS_HASH_SHA256 = 0x0004,
+    HS_HASH_SHA384 = 0x0008,
+    HS_HASH_SHA512 = 0x0010,
+    HS_HASH_MSGS   = 0x0020,            /* EdDSA message cache */
+    HS_HASH_ALL    = 0x003F
+};
+
+/* initial size of the buffer holding messages, grown as needed */
+#ifndef HS_HASH_PENDING_SZ
+    #define HS_HASH_PENDING_SZ 512
+#endif
+#endif
+
 
 #ifndef WOLFSSL_NO_TLS12
 /* Persistable BuildMessage arguments */
@@ -4097,6 +4445,18 @@ struct WOLFSSL {
     Ciphers         encrypt;
     Ciphers         decrypt;
     Buffers         buffers;
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+    DynRecord       dynRecord;          /* adaptive record size state */
+#endif
+#ifdef WOLFSSL_READ_AHEAD
+    word32          readAheadSz;        /* input buffer size to read into */
+#endif
+#ifdef WOLFSSL_SSL_POOL
+    WOLFSSL*        poolNext;           /* next object on the CTX free list */
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+    HsTiming*       hsTiming;           /* handshake events, NULL when off */
+#endif
     WOLFSSL_SESSION session;
 #ifdef HAVE_EXT_CACHE
     WOLFSSL_SESSION* extSession;
@@ -4418,7 +4778,31 @@ struct WOLFSSL {
 WOLFSSL_LOCAL int  SSL_CTX_RefCount(WOLFSSL_CTX* ctx, int incr);
 WOLFSSL_LOCAL int  SetSSL_CTX(WOLFSSL*, WOLFSSL_CTX*, int);
 WOLFSSL_LOCAL int  InitSSL(WOLFSSL*, WOLFSSL_CTX*, int);
+WOLFSSL_LOCAL int  InitSSL_ex(WOLFSSL*, WOLFSSL_CTX*, int, WC_RNG* rng);
 WOLFSSL_LOCAL void FreeSSL(WOLFSSL*, void* heap);
+#ifdef WOLFSSL_SSL_POOL
+WOLFSSL_LOCAL WOLFSSL* SSLPoolGet(WOLFSSL_CTX* ctx, WC_RNG** rng);
+WOLFSSL_LOCAL int  SSLPoolPut(WOLFSSL* ssl);
+WOLFSSL_LOCAL void SSLPoolFree(WOLFSSL_CTX* ctx);
+#endif
+#ifdef WC_THREAD_RNG
+WOLFSSL_LOCAL WC_RNG* GetSslRng(WOLFSSL* ssl);
+#else
+    #define GetSslRng(ssl) ((ssl)->rng)
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+WOLFSSL_LOCAL int  HsTimingInit(WOLFSSL* ssl);
+WOLFSSL_LOCAL void HsTimingBegin(WOLFSSL* ssl, byte type);
+WOLFSSL_LOCAL void HsTimingEnd(WOLFSSL* ssl, byte type, byte msgType, int ret);
+WOLFSSL_LOCAL void HsTimingDone(WOLFSSL* ssl);
+#endif
+#ifdef WOLFSSL_CTX_STATS
+WOLFSSL_LOCAL WOLFSSL_STATS* CtxStatsGet(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL void CtxStatsHandshakeDone(WOLFSSL* ssl);
+WOLFSSL_LOCAL void CtxStatsHandshakeFailed(WOLFSSL* ssl);
+WOLFSSL_LOCAL void CtxStatsRecordsOut(WOLFSSL* ssl, const byte* out,
+                                      word32 sz);
+#endif
 WOLFSSL_API   void SSL_ResourceFree(WOLFSSL*);   /* Micrium uses */
 
 
@@ -4540,6 +4924,13 @@ WOLFSSL_LOCAL int SendChangeCipher(WOLFSSL*);
 WOLFSSL_LOCAL int SendTicket(WOLFSSL*);
 WOLFSSL_LOCAL int DoClientTicket(WOLFSSL*, const byte*, word32);
 WOLFSSL_LOCAL int SendData(WOLFSSL*, const void*, int);
+#ifdef WOLFSSL_ZERO_COPY
+WOLFSSL_LOCAL int SendDataReserve(WOLFSSL*, byte**);
+WOLFSSL_LOCAL int SendDataCommit(WOLFSSL*, int, int);
+#endif
+#ifdef WOLFSSL_SENDFILE
+WOLFSSL_LOCAL int SendFileData(WOLFSSL*, int, long, int);
+#endif
 #ifdef WOLFSSL_TLS13
 WOLFSSL_LOCAL int SendTls13ServerHello(WOLFSSL*, byte);
 #endif
@@ -4557,6 +4948,13 @@ WOLFSSL_LOCAL int SendCertificateStatus(WOLFSSL*);
 WOLFSSL_LOCAL int SendServerKeyExchange(WOLFSSL*);
 WOLFSSL_LOCAL int SendBuffered(WOLFSSL*);
 WOLFSSL_LOCAL int ReceiveData(WOLFSSL*, byte*, int, int);
+#ifdef WOLFSSL_ZERO_COPY
+WOLFSSL_LOCAL int ReceiveDataZeroCopy(WOLFSSL*, byte**);
+WOLFSSL_LOCAL int ReceiveDataZeroCopyDone(WOLFSSL*, int);
+#endif
+#ifdef WOLFSSL_KTLS
+WOLFSSL_LOCAL int KtlsSetup(WOLFSSL*, int);
+#endif
 WOLFSSL_LOCAL int SendFinished(WOLFSSL*);
 WOLFSSL_LOCAL int SendAlert(WOLFSSL*, int, int);
 WOLFSSL_LOCAL int ProcessReply(WOLFSSL*);
@@ -4574,8 +4972,15 @@ WOLFSSL_LOCAL int IsAtLeastTLSv1_3(const ProtocolVersion pv);
 WOLFSSL_LOCAL int TLSv1_3_Capable(WOLFSSL* ssl);
 
 WOLFSSL_LOCAL void FreeHandshakeResources(WOLFSSL* ssl);
+WOLFSSL_LOCAL void CompactResources(WOLFSSL* ssl);
+WOLFSSL_LOCAL void ResourcesFootprint(WOLFSSL* ssl, WOLFSSL_MEM_FOOTPRINT* fp);
 WOLFSSL_LOCAL void ShrinkInputBuffer(WOLFSSL* ssl, int forcedFree);
 WOLFSSL_LOCAL void ShrinkOutputBuffer(WOLFSSL* ssl);
+#ifdef WOLFSSL_IO_POOL
+WOLFSSL_LOCAL void IOPoolFree(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL int IOPoolKeepLender(WOLFSSL* ssl, bufferStatic* buf,
+                                  WOLFSSL_CTX* ctx);
+#endif
 
 WOLFSSL_LOCAL int VerifyClientSuite(WOLFSSL* ssl);
 
@@ -4812,6 +5217,10 @@ WOLFSSL_LOCAL int SetDhExternal(WOLFSSL_DH *dh);
 
 WOLFSSL_LOCAL int InitHandshakeHashes(WOLFSSL* ssl);
 WOLFSSL_LOCAL void FreeHandshakeHashes(WOLFSSL* ssl);
+#ifdef WOLFSSL_LAZY_TRANSCRIPT
+WOLFSSL_LOCAL int SelectHandshakeHashes(WOLFSSL* ssl);
+WOLFSSL_LOCAL int FlushHandshakeHashes(WOLFSSL* ssl);
+#endif
 
 
 #ifndef WOLFSSL_NO_TLS12
@@ -960,6 +960,154 @@ WOLFSSL_ABI WOLFSSL_API int  wolfSSL_connect(WOLFSSL*);
 WOLFSSL_ABI WOLFSSL_API int  wolfSSL_write(WOLFSSL*, const void*, int);
 WOLFSSL_ABI WOLFSSL_API int  wolfSSL_read(WOLFSSL*, void*, int);
 WOLFSSL_API int  wolfSSL_peek(WOLFSSL*, void*, int);
+#ifdef WOLFSSL_ZERO_COPY
+WOLFSSL_API int  wolfSSL_read_zero_copy(WOLFSSL*, const unsigned char**);
+WOLFSSL_API int  wolfSSL_read_zero_copy_done(WOLFSSL*, int);
+WOLFSSL_API int  wolfSSL_write_zero_copy_reserve(WOLFSSL*, unsigned char**);
+WOLFSSL_API int  wolfSSL_write_zero_copy_commit(WOLFSSL*, int);
+#endif
+#ifdef WOLFSSL_SENDFILE
+WOLFSSL_API int  wolfSSL_sendfile(WOLFSSL*, int fd, long offset, int sz);
+#endif
+#ifdef WOLFSSL_KTLS
+enum {
+    WOLFSSL_KTLS_TX = 0x01,  /* kernel encrypts outgoing records */
+    WOLFSSL_KTLS_RX = 0x02   /* kernel decrypts incoming records */
+};
+WOLFSSL_API int  wolfSSL_CTX_UseKTLS(WOLFSSL_CTX* ctx, int dir);
+WOLFSSL_API int  wolfSSL_UseKTLS(WOLFSSL* ssl, int dir);
+WOLFSSL_API int  wolfSSL_GetKTLS(WOLFSSL* ssl);
+#endif
+#ifdef WOLFSSL_DYN_RECORD_SIZE
+#define WOLFSSL_RECORD_SIZE_BUCKETS 6
+typedef struct WOLFSSL_RECORD_SIZE_STATS {
+    /* records sent by plain text size:
+     * < 512, < 1K, < 2K, < 4K, < 8K and up to 16K */
+    unsigned long records[WOLFSSL_RECORD_SIZE_BUCKETS];
+    unsigned long smallRecords;  /* records cut short by the policy */
+    unsigned long rampUps;       /* bursts that grew to full size records */
+    unsigned long idleResets;    /* times idle dropped back to small records */
+} WOLFSSL_RECORD_SIZE_STATS;
+
+WOLFSSL_API int  wolfSSL_CTX_SetDynRecordSize(WOLFSSL_CTX* ctx,
+    unsigned short smallSz, unsigned int rampBytes, unsigned int rampSec,
+    unsigned int idleSec);
+WOLFSSL_API int  wolfSSL_SetDynRecordSize(WOLFSSL* ssl,
+    unsigned short smallSz, unsigned int rampBytes, unsigned int rampSec,
+    unsigned int idleSec);
+WOLFSSL_API int  wolfSSL_GetRecordSizeStats(WOLFSSL* ssl,
+    WOLFSSL_RECORD_SIZE_STATS* stats);
+#endif
+#ifdef WOLFSSL_READ_AHEAD
+WOLFSSL_API int  wolfSSL_CTX_UseReadAhead(WOLFSSL_CTX* ctx, unsigned int sz);
+WOLFSSL_API int  wolfSSL_UseReadAhead(WOLFSSL* ssl, unsigned int sz);
+#endif
+#ifdef WOLFSSL_IO_POOL
+WOLFSSL_API int  wolfSSL_CTX_UseIOBufferPool(WOLFSSL_CTX* ctx,
+    unsigned int maxFree);
+WOLFSSL_API int  wolfSSL_CTX_GetIOBufferPoolStats(WOLFSSL_CTX* ctx,
+    unsigned int* inUse, unsigned int* idle);
+#endif
+#ifdef WOLFSSL_SSL_POOL
+WOLFSSL_API int  wolfSSL_CTX_UseSSLPool(WOLFSSL_CTX* ctx, unsigned int maxFree);
+WOLFSSL_API int  wolfSSL_CTX_GetSSLPoolStats(WOLFSSL_CTX* ctx,
+    unsigned int* hits, unsigned int* misses, unsigned int* idle);
+#endif
+#ifdef WOLFSSL_KEYSHARE_POOL
+WOLFSSL_API int  wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, word16 group,
+    int count);
+WOLFSSL_API int  wolfSSL_CTX_RefillKeySharePool(WOLFSSL_CTX* ctx, int max);
+WOLFSSL_API int  wolfSSL_CTX_GetKeySharePoolCount(WOLFSSL_CTX* ctx,
+    word16 group);
+#endif
+#ifdef WOLFSSL_HANDSHAKE_TIMING
+/* what a handshake timing event measured */
+enum {
+    WOLFSSL_HST_MSG_SEND = 0,   /* handshake message written, no duration */
+    WOLFSSL_HST_MSG_RECV,       /* handshake message processed */
+    WOLFSSL_HST_SIGN,           /* signature made */
+    WOLFSSL_HST_VERIFY,         /* peer signature verified */
+    WOLFSSL_HST_KEY_GEN,        /* ephemeral key pair generated */
+    WOLFSSL_HST_SHARED_SECRET,  /* key agreement or RSA key transport */
+    WOLFSSL_HST_CERT_VERIFY,    /* peer certificate chain processed */
+    WOLFSSL_HST_IO_READ,        /* waiting on the receive callback */
+    WOLFSSL_HST_IO_WRITE,       /* waiting on the send callback */
+    /* sums only, no events of these types */
+    WOLFSSL_HST_CRYPTO,         /* sign, verify, key gen and shared secret */
+    WOLFSSL_HST_NETWORK,        /* receive and send waits */
+    WOLFSSL_HST_TOTAL,          /* first event to end of handshake */
+    WOLFSSL_HST_TYPES,
+
+    /* histogram bucket 0 is under 1us, bucket n is [2^(n-1), 2^n) us and the
+     * last bucket has everything longer */
+    WOLFSSL_HST_BUCKETS = 24
+};
+
+typedef struct WOLFSSL_HS_TIMING_EVENT {
+    unsigned int  start;     /* us since the first event of the handshake */
+    unsigned int  duration;  /* us */
+    unsigned char type;      /* WOLFSSL_HST_* */
+    unsigned char msgType;   /* handshake message type of MSG_SEND/MSG_RECV */
+} WOLFSSL_HS_TIMING_EVENT;
+
+WOLFSSL_API int  wolfSSL_CTX_SetHandshakeTiming(WOLFSSL_CTX* ctx, int on);
+WOLFSSL_API int  wolfSSL_SetHandshakeTiming(WOLFSSL* ssl, int on);
+WOLFSSL_API int  wolfSSL_GetHandshakeEvents(WOLFSSL* ssl,
+    WOLFSSL_HS_TIMING_EVENT* events, unsigned int* count);
+WOLFSSL_API int  wolfSSL_GetHandshakeTime(WOLFSSL* ssl, int type,
+    unsigned int* us);
+WOLFSSL_API int  wolfSSL_CTX_GetHandshakeHistogram(WOLFSSL_CTX* ctx,
+    int type, unsigned int* buckets, unsigned int* count);
+#endif
+#ifdef WOLFSSL_CTX_STATS
+    #ifndef WORD64_AVAILABLE
+        #error WOLFSSL_CTX_STATS requires a 64-bit type
+    #endif
+/* indexes of the per version counters and failure reasons */
+enum {
+    WOLFSSL_STAT_SSLV3 = 0,
+    WOLFSSL_STAT_TLSV1,
+    WOLFSSL_STAT_TLSV1_1,
+    WOLFSSL_STAT_TLSV1_2,
+    WOLFSSL_STAT_TLSV1_3,
+    WOLFSSL_STAT_DTLSV1,
+    WOLFSSL_STAT_DTLSV1_2,
+    WOLFSSL_STAT_VERSIONS,
+
+    WOLFSSL_STAT_FAIL_VERSION = 0,  /* no common protocol version */
+    WOLFSSL_STAT_FAIL_CIPHER,       /* no common cipher suite */
+    WOLFSSL_STAT_FAIL_CERT,         /* peer certificate rejected */
+    WOLFSSL_STAT_FAIL_DECRYPT,      /* MAC, decryption, signature, finished */
+    WOLFSSL_STAT_FAIL_ALERT,        /* fatal alert from the peer */
+    WOLFSSL_STAT_FAIL_IO,           /* socket error or peer closed */
+    WOLFSSL_STAT_FAIL_OTHER,
+    WOLFSSL_STAT_FAIL_REASONS,
+
+    WOLFSSL_STAT_ALERTS = 128       /* alert codes counted, last has rest */
+};
+
+/* snapshot of the operational counters of a CTX, see wolfSSL_CTX_GetStats() */
+typedef struct WOLFSSL_STATS {
+    word64 handshakes[WOLFSSL_STAT_VERSIONS];  /* full handshakes done */
+    word64 resumed[WOLFSSL_STAT_VERSIONS];     /* resumed handshakes done */
+    word64 resumedTicket;          /* resumed with a ticket or TLS 1.3 PSK */
+    word64 resumedId;              /* resumed with a session ID */
+    word64 helloRetries;           /* HelloRetryRequests sent or received */
+    word64 earlyDataAccepted;
+    word64 earlyDataRejected;
+    word64 failures[WOLFSSL_STAT_FAIL_REASONS]; /* handshakes not finished */
+    word64 alertsSent[WOLFSSL_STAT_ALERTS];     /* by alert code */
+    word64 alertsReceived[WOLFSSL_STAT_ALERTS];
+    word64 bytesIn;                /* read from the receive callback */
+    word64 bytesOut;               /* written by the send callback */
+    word64 recordsIn;
+    word64 recordsOut;
+} WOLFSSL_STATS;
+
+WOLFSSL_API int  wolfSSL_CTX_GetStats(WOLFSSL_CTX* ctx,
+    WOLFSSL_STATS* stats);
+WOLFSSL_API int  wolfSSL_CTX_ClearStats(WOLFSSL_CTX* ctx);
+#endif
 WOLFSSL_ABI WOLFSSL_API int  wolfSSL_accept(WOLFSSL*);
 WOLFSSL_API int  wolfSSL_CTX_mutual_auth(WOLFSSL_CTX* ctx, int req);
 WOLFSSL_API int  wolfSSL_mutual_auth(WOLFSSL* ssl, int req);
@@ -1096,6 +1244,7 @@ WOLFSSL_API int wolfSSL_set_post_handshake_auth(WOLFSSL*, int);
 WOLFSSL_API void wolfSSL_SetCertCbCtx(WOLFSSL*, void*);
 
 WOLFSSL_ABI WOLFSSL_API int  wolfSSL_pending(WOLFSSL*);
+WOLFSSL_API int  wolfSSL_has_pending(const WOLFSSL*);
 
 WOLFSSL_API void wolfSSL_load_error_strings(void);
 WOLFSSL_API int  wolfSSL_library_init(void);
@@ -3011,6 +3160,25 @@ WOLFSSL_API void wolfSSL_FreeArrays(WOLFSSL*);
 
 WOLFSSL_API int wolfSSL_KeepHandshakeResources(WOLFSSL* ssl);
 WOLFSSL_API int wolfSSL_FreeHandshakeResources(WOLFSSL* ssl);
+WOLFSSL_API int wolfSSL_CompactResources(WOLFSSL* ssl, unsigned int* retained);
+WOLFSSL_API int wolfSSL_CTX_SetAutoCompact(WOLFSSL_CTX* ctx, int on);
+WOLFSSL_API int wolfSSL_SetAutoCompact(WOLFSSL* ssl, int on);
+
+/* memory held by a connection, in bytes */
+typedef struct WOLFSSL_MEM_FOOTPRINT {
+    unsigned int object;      /* WOLFSSL object less the parts below */
+    unsigned int session;     /* session copy, with peer chain and ticket */
+    unsigned int peerCert;    /* decoded peer certificate */
+    unsigned int handshake;   /* handshake state not freed yet */
+    unsigned int ciphers;     /* bulk cipher and MAC contexts */
+    unsigned int rng;         /* random number generator */
+    unsigned int buffers;     /* dynamic input and output buffers */
+    unsigned int extensions;  /* TLS extension list */
+    unsigned int total;
+} WOLFSSL_MEM_FOOTPRINT;
+
+WOLFSSL_API int wolfSSL_GetMemFootprint(WOLFSSL* ssl,
+                                        WOLFSSL_MEM_FOOTPRINT* fp);
 
 WOLFSSL_API int wolfSSL_CTX_UseClientSuites(WOLFSSL_CTX* ctx);
 WOLFSSL_API int wolfSSL_UseClientSuites(WOLFSSL* ssl);
@@ -3986,6 +4154,9 @@ WOLFSSL_API void* wolfSSL_get_jobject(WOLFSSL* ssl);
 WOLFSSL_API int wolfSSL_AsyncPoll(WOLFSSL* ssl, WOLF_EVENT_FLAG flags);
 WOLFSSL_API int wolfSSL_CTX_AsyncPoll(WOLFSSL_CTX* ctx, WOLF_EVENT** events, int maxEvents,
     WOLF_EVENT_FLAG flags, int* eventCount);
+WOLFSSL_API int wolfSSL_CTX_AsyncGetFd(WOLFSSL_CTX* ctx);
+WOLFSSL_API int wolfSSL_CTX_AsyncDrain(WOLFSSL_CTX* ctx, WOLF_EVENT** events,
+    int maxEvents, int* eventCount);
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
 #ifdef OPENSSL_EXTRA
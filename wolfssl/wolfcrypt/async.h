@@ -0,0 +1,261 @@
+/* async.h
+ *
+ * Copyright (C) 2006-2021 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/* Software asynchronous crypto device.
+ *
+ * With WOLFSSL_ASYNC_CRYPT_TEST and no async hardware the public key
+ * operations of keys initialized with a device id from wolfAsync_DevOpen()
+ * return WC_PENDING_E and are run by a pool of worker threads. Completion is
+ * picked up with wolfEventQueue_Poll() (wolfSSL_AsyncPoll()) or waited for
+ * with wc_AsyncWait(). Without threading (WC_NO_ASYNC_THREADING) the
+ * operation is run when the event is polled.
+ */
+
+#ifndef WOLF_CRYPT_ASYNC_H
+#define WOLF_CRYPT_ASYNC_H
+
+#include <wolfssl/wolfcrypt/types.h>
+
+#ifdef WOLFSSL_ASYNC_CRYPT
+
+#include <wolfssl/wolfcrypt/wolfevent.h>
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/* operations the software device runs, symmetric ciphers and hashes are
+ * cheaper done inline than handed to another thread */
+#ifdef WOLFSSL_ASYNC_CRYPT_TEST
+    #ifndef NO_RSA
+        #define WC_ASYNC_ENABLE_RSA
+        #ifdef WOLFSSL_KEY_GEN
+            #define WC_ASYNC_ENABLE_RSA_KEYGEN
+        #endif
+    #endif
+    #ifdef HAVE_ECC
+        #define WC_ASYNC_ENABLE_ECC
+    #endif
+    #ifndef NO_DH
+        #define WC_ASYNC_ENABLE_DH
+    #endif
+#endif
+
+/* default number of worker threads, 0 is one per online CPU */
+#ifndef WC_ASYNC_THREADS
+    #define WC_ASYNC_THREADS 0
+#endif
+#ifndef WC_ASYNC_MAX_THREADS
+    #define WC_ASYNC_MAX_THREADS 64
+#endif
+
+/* operations a caller should keep in flight per device, used by benchmark */
+#ifndef WOLF_ASYNC_MAX_PENDING
+    #define WOLF_ASYNC_MAX_PENDING 8
+#endif
+
+/* device id handed out by wolfAsync_DevOpen() */
+#ifndef WOLFSSL_ASYNC_DEVID
+    #define WOLFSSL_ASYNC_DEVID 0x0A5C
+#endif
+
+/* marks the type of object an async device context belongs to */
+enum {
+    WOLFSSL_ASYNC_MARKER_INVALID = 0x0,
+    WOLFSSL_ASYNC_MARKER_ARC4    = 0xBEEF0001,
+    WOLFSSL_ASYNC_MARKER_AES     = 0xBEEF0002,
+    WOLFSSL_ASYNC_MARKER_3DES    = 0xBEEF0003,
+    WOLFSSL_ASYNC_MARKER_RNG     = 0xBEEF0004,
+    WOLFSSL_ASYNC_MARKER_HMAC    = 0xBEEF0005,
+    WOLFSSL_ASYNC_MARKER_RSA     = 0xBEEF0006,
+    WOLFSSL_ASYNC_MARKER_ECC     = 0xBEEF0007,
+    WOLFSSL_ASYNC_MARKER_SHA512  = 0xBEEF0008,
+    WOLFSSL_ASYNC_MARKER_SHA     = 0xBEEF0009,
+    WOLFSSL_ASYNC_MARKER_SHA256  = 0xBEEF000A,
+    WOLFSSL_ASYNC_MARKER_SHA224  = 0xBEEF000B,
+    WOLFSSL_ASYNC_MARKER_SHA384  = 0xBEEF000C,
+    WOLFSSL_ASYNC_MARKER_MD5     = 0xBEEF000D,
+    WOLFSSL_ASYNC_MARKER_DH      = 0xBEEF000E,
+    WOLFSSL_ASYNC_MARKER_SHA3    = 0xBEEF000F,
+};
+
+/* event flags */
+enum {
+    WC_ASYNC_FLAG_NONE       = 0x00000000,
+    WC_ASYNC_FLAG_CALL_AGAIN = 0x00000001, /* call the function again to
+                                              collect the result */
+};
+
+struct RsaKey;
+struct ecc_key;
+struct DhKey;
+struct WC_RNG;
+
+/* operations captured by wc_AsyncTestInit() */
+enum {
+    ASYNC_TEST_NONE = 0,
+    ASYNC_TEST_RSA_FUNC,
+    ASYNC_TEST_RSA_MAKE,
+    ASYNC_TEST_ECC_MAKE,
+    ASYNC_TEST_ECC_SIGN,
+    ASYNC_TEST_ECC_VERIFY,
+    ASYNC_TEST_ECC_SHARED_SEC,
+    ASYNC_TEST_DH_GEN,
+    ASYNC_TEST_DH_AGREE,
+};
+
+/* arguments of the captured call, run again by a worker with the capture
+ * already taken so that it goes the synchronous way */
+typedef union WC_ASYNC_TEST {
+#ifdef WC_ASYNC_ENABLE_RSA
+    struct {
+        const byte* in;
+        word32      inSz;
+        byte*       out;
+        word32*     outSz;
+        int         type;
+        struct RsaKey* key;
+        struct WC_RNG* rng;
+    } rsaFunc;
+    struct {
+        struct WC_RNG* rng;
+        struct RsaKey* key;
+        int         size;
+        long        e;
+    } rsaMake;
+#endif
+#ifdef WC_ASYNC_ENABLE_ECC
+    struct {
+        struct WC_RNG* rng;
+        struct ecc_key* key;
+        int         size;
+        int         curve_id;
+    } eccMake;
+    struct {
+        const byte* in;
+        word32      inSz;
+        struct WC_RNG* rng;
+        struct ecc_key* key;
+        void*       r;      /* mp_int* */
+        void*       s;      /* mp_int* */
+    } eccSign;
+    struct {
+        void*       r;      /* mp_int* */
+        void*       s;      /* mp_int* */
+        const byte* hash;
+        word32      hashlen;
+        int*        stat;
+        struct ecc_key* key;
+    } eccVerify;
+    struct {
+        struct ecc_key* private_key;
+        void*       public_point; /* ecc_point* */
+        byte*       out;
+        word32*     outLen;
+    } eccSharedSec;
+#endif
+#ifdef WC_ASYNC_ENABLE_DH
+    struct {
+        struct DhKey* key;
+        struct WC_RNG* rng;
+        byte*       priv;
+        word32*     privSz;
+        byte*       pub;
+        word32*     pubSz;
+    } dhGen;
+    struct {
+        struct DhKey* key;
+        byte*       agree;
+        word32*     agreeSz;
+        const byte* priv;
+        word32      privSz;
+        const byte* otherPub;
+        word32      pubSz;
+    } dhAgree;
+#endif
+    void* unused;
+} WC_ASYNC_TEST;
+
+typedef struct WC_ASYNC_DEV {
+    word32              marker;  /* WOLFSSL_ASYNC_MARKER_*, set when a device
+                                    id was given */
+    void*               heap;
+    WOLF_EVENT          event;
+    WC_ASYNC_TEST       test;    /* captured call */
+    struct WC_ASYNC_DEV* next;   /* worker queue */
+    int                 testType;
+    int                 testRet;
+    byte                testState;
+} WC_ASYNC_DEV;
+
+
+/* Device */
+WOLFSSL_API int  wolfAsync_HardwareStart(void);
+WOLFSSL_API void wolfAsync_HardwareStop(void);
+WOLFSSL_API int  wolfAsync_DevOpen(int* devId);
+WOLFSSL_API int  wolfAsync_DevOpenThreads(int* devId, int threads);
+WOLFSSL_API void wolfAsync_DevClose(int* devId);
+WOLFSSL_API int  wolfAsync_DevCtxInit(WC_ASYNC_DEV* asyncDev, word32 marker,
+                                      void* heap, int devId);
+WOLFSSL_API void wolfAsync_DevCtxFree(WC_ASYNC_DEV* asyncDev, word32 marker);
+WOLFSSL_API int  wolfAsync_DevCopy(WC_ASYNC_DEV* src, WC_ASYNC_DEV* dst);
+
+/* Events */
+WOLFSSL_API int  wolfAsync_EventInit(WOLF_EVENT* event, WOLF_EVENT_TYPE type,
+                                     void* context, word32 flags);
+WOLFSSL_API int  wolfAsync_EventWait(WOLF_EVENT* event);
+WOLFSSL_API int  wolfAsync_EventPoll(WOLF_EVENT* event, WOLF_EVENT_FLAG flags);
+WOLFSSL_API int  wolfAsync_EventPop(WOLF_EVENT* event, WOLF_EVENT_TYPE type);
+WOLFSSL_API int  wolfAsync_EventCancel(WOLF_EVENT* event);
+WOLFSSL_API int  wolfAsync_EventQueuePush(WOLF_EVENT_QUEUE* queue,
+                                          WOLF_EVENT* event);
+WOLFSSL_API int  wolfAsync_EventQueuePoll(WOLF_EVENT_QUEUE* queue,
+                                          void* context_filter,
+                                          WOLF_EVENT** events, int maxEvents,
+                                          WOLF_EVENT_FLAG flags,
+                                          int* eventCount);
+
+WOLFSSL_API int  wc_AsyncHandle(WC_ASYNC_DEV* asyncDev,
+                                WOLF_EVENT_QUEUE* queue, word32 flags);
+WOLFSSL_API int  wc_AsyncWait(int ret, WC_ASYNC_DEV* asyncDev, word32 flags);
+
+#ifndef WC_NO_ASYNC_THREADING
+typedef void* (*AsyncThreadFunc_t)(void*);
+
+WOLFSSL_API int  wolfAsync_DevOpenThread(int* devId, void* threadId);
+WOLFSSL_API int  wc_AsyncGetNumberOfCpus(void);
+WOLFSSL_API int  wc_AsyncThreadCreate(pthread_t* thread,
+                                      AsyncThreadFunc_t func, void* args);
+WOLFSSL_API int  wc_AsyncThreadJoin(pthread_t* thread);
+WOLFSSL_API void wc_AsyncThreadYield(void);
+#endif
+
+#ifdef WOLFSSL_ASYNC_CRYPT_TEST
+WOLFSSL_API int  wc_AsyncTestInit(WC_ASYNC_DEV* dev, int type);
+#endif
+
+#ifdef __cplusplus
+    }  /* extern "C" */
+#endif
+
+#endif /* WOLFSSL_ASYNC_CRYPT */
+
+#endif /* WOLF_CRYPT_ASYNC_H */
@@ -89,6 +89,70 @@ enum wc_FuncNum {
 };
 #endif
 
+#ifdef WOLFSSL_TRACE
+    #ifndef WORD64_AVAILABLE
+        #error WOLFSSL_TRACE requires a 64-bit type
+    #endif
+    #if !defined(SINGLE_THREADED) && !defined(HAVE_THREAD_LS)
+        #error WOLFSSL_TRACE requires thread local storage
+    #endif
+    #ifndef WOLFSSL_TRACE_EVENTS
+        #define WOLFSSL_TRACE_EVENTS 256  /* per thread, a power of 2 */
+    #endif
+
+/* binary trace event ids */
+enum wc_TraceIds {
+    WC_TRACE_ENTER = 1,     /* name is the function */
+    WC_TRACE_LEAVE,         /* name is the function, arg its return */
+    WC_TRACE_ERROR,         /* arg is the error */
+    WC_TRACE_HS_SEND,       /* arg is the handshake message type */
+    WC_TRACE_HS_RECV,       /* arg is the handshake message type */
+    WC_TRACE_HS_DONE,       /* arg is 1 when resumed */
+    WC_TRACE_ALERT_SEND,    /* arg is level << 8 | code */
+    WC_TRACE_ALERT_RECV,    /* arg is level << 8 | code */
+    WC_TRACE_RECORD_IN,     /* arg is content type << 16 | length */
+    WC_TRACE_IDS
+};
+
+/* an event in the trace ring of a thread */
+typedef struct wc_TraceEvent {
+    word64      time;   /* ns, monotonic */
+    const void* obj;    /* connection (WOLFSSL*) of the event */
+    const char* name;   /* static string or NULL */
+    int         arg;
+    word16      id;     /* WC_TRACE_* */
+} wc_TraceEvent;
+
+/* header of wolfSSL_Trace_Export() output, events follow as
+ * time(8) obj(8) arg(4) id(2) name length(2) name, all big endian */
+#define WC_TRACE_MAGIC      "wTRC"
+#define WC_TRACE_VERSION    1
+#define WC_TRACE_HDR_SZ     12  /* magic(4) version(4) count(4) */
+#define WC_TRACE_EVENT_SZ   24  /* an event without its name */
+
+WOLFSSL_API int  wolfSSL_Trace_ON(void);
+WOLFSSL_API void wolfSSL_Trace_OFF(void);
+WOLFSSL_API void wolfSSL_Trace_Clear(void);
+WOLFSSL_API int  wolfSSL_Trace_Get(wc_TraceEvent* events, word32* count);
+WOLFSSL_API int  wolfSSL_Trace_Export(byte* out, word32* outSz);
+WOLFSSL_API const char* wolfSSL_Trace_EventName(int id);
+
+extern WOLFSSL_LOCAL int wc_traceOn;
+WOLFSSL_LOCAL void wc_Trace(word16 id, const void* obj, const char* name,
+                            int arg);
+WOLFSSL_LOCAL void wc_TraceSetObj(const void* obj);
+
+    /* record an event, obj NULL is the current object of the thread */
+    #define WC_TRACE(id, obj, name, arg) \
+        do { if (wc_traceOn) wc_Trace((id), (obj), (name), (arg)); } while (0)
+    /* object the events of the thread are about from now on */
+    #define WC_TRACE_OBJ(obj) \
+        do { if (wc_traceOn) wc_TraceSetObj(obj); } while (0)
+#else
+    #define WC_TRACE(id, obj, name, arg)
+    #define WC_TRACE_OBJ(obj)
+#endif
+
 typedef void (*wolfSSL_Logging_cb)(const int logLevel,
                                    const char *const logMessage);
 
@@ -160,6 +224,18 @@ WOLFSSL_API void wolfSSL_Debugging_OFF(void);
     WOLFSSL_API void WOLFSSL_MSG(const char* msg);
     WOLFSSL_API void WOLFSSL_BUFFER(const byte* buffer, word32 length);
 
+#elif defined(WOLFSSL_TRACE)
+
+    /* binary trace only. Message text isn't traced, some is built on the
+     * stack, the enter and leave events around it locate it */
+    #define WOLFSSL_ENTER(m)    WC_TRACE(WC_TRACE_ENTER, NULL, (m), 0)
+    #define WOLFSSL_LEAVE(m, r) WC_TRACE(WC_TRACE_LEAVE, NULL, (m), (r))
+    #define WOLFSSL_STUB(m)
+    #define WOLFSSL_IS_DEBUG_ON() 0
+
+    #define WOLFSSL_MSG(m)
+    #define WOLFSSL_BUFFER(b, l)
+
 #else
 
     #define WOLFSSL_ENTER(m)
@@ -186,6 +262,13 @@ WOLFSSL_API void wolfSSL_Debugging_OFF(void);
     #endif
     WOLFSSL_API void WOLFSSL_ERROR_MSG(const char* msg);
 
+#elif defined(WOLFSSL_TRACE)
+    /* e is evaluated whether tracing is on or not */
+    #define WOLFSSL_ERROR(e) \
+        do { int wcTraceErr = (e); \
+             WC_TRACE(WC_TRACE_ERROR, NULL, NULL, wcTraceErr); \
+             (void)wcTraceErr; } while (0)
+    #define WOLFSSL_ERROR_MSG(m)
 #else
     #define WOLFSSL_ERROR(e)
     #define WOLFSSL_ERROR_MSG(m)
@@ -149,6 +149,24 @@ typedef struct OS_Seed {
     #define WC_RNG_TYPE_DEFINED
 #endif
 
+/* DRBG mechanisms, WC_DRBG_CTR (AES-256 CTR_DRBG) with WC_RNG_CTR_DRBG */
+enum {
+    WC_DRBG_HASH = 0,
+    WC_DRBG_CTR  = 1
+};
+
+/* used by wc_InitRng() and the other initializers without a type */
+#ifndef WC_DRBG_DEFAULT
+    #ifdef WC_RNG_CTR_DRBG_DEFAULT
+        #define WC_DRBG_DEFAULT WC_DRBG_CTR
+    #else
+        #define WC_DRBG_DEFAULT WC_DRBG_HASH
+    #endif
+#endif
+#if defined(WC_RNG_CTR_DRBG_DEFAULT) && !defined(WC_RNG_CTR_DRBG)
+    #define WC_RNG_CTR_DRBG
+#endif
+
 #ifdef HAVE_HASHDRBG
 struct DRBG_internal {
     word32 reseedCtr;
@@ -177,6 +195,9 @@ struct WC_RNG {
     struct DRBG_internal drbg_data;
 #endif
     byte status;
+#ifdef WC_RNG_CTR_DRBG
+    byte drbgType;   /* WC_DRBG_HASH or WC_DRBG_CTR, drbg to cast to */
+#endif
 #endif
 #ifdef WOLFSSL_ASYNC_CRYPT
     WC_ASYNC_DEV asyncDev;
@@ -216,9 +237,17 @@ WOLFSSL_API int  wc_InitRng_ex(WC_RNG* rng, void* heap, int devId);
 WOLFSSL_API int  wc_InitRngNonce(WC_RNG* rng, byte* nonce, word32 nonceSz);
 WOLFSSL_API int  wc_InitRngNonce_ex(WC_RNG* rng, byte* nonce, word32 nonceSz,
                                     void* heap, int devId);
+#ifdef WC_RNG_CTR_DRBG
+WOLFSSL_API int  wc_InitRngDrbg_ex(WC_RNG* rng, int drbgType, void* heap,
+                                   int devId);
+#endif
 WOLFSSL_ABI WOLFSSL_API int wc_RNG_GenerateBlock(WC_RNG*, byte*, word32 sz);
 WOLFSSL_API int  wc_RNG_GenerateByte(WC_RNG*, byte*);
 WOLFSSL_API int  wc_FreeRng(WC_RNG*);
+#ifdef WC_THREAD_RNG
+WOLFSSL_API WC_RNG* wc_GetThreadRng(void);
+WOLFSSL_LOCAL void  wc_ThreadRngCleanup(void);
+#endif
 #else
 #include <wolfssl/wolfcrypt/error-crypt.h>
 #define wc_InitRng(rng) NOT_COMPILED_IN
@@ -240,6 +269,7 @@ WOLFSSL_API int  wc_FreeRng(WC_RNG*);
 #ifdef HAVE_HASHDRBG
     WOLFSSL_LOCAL int wc_RNG_DRBG_Reseed(WC_RNG* rng, const byte* entropy,
                                         word32 entropySz);
+    WOLFSSL_LOCAL int wc_RNG_Reseed(WC_RNG* rng);
     WOLFSSL_API int wc_RNG_TestSeed(const byte* seed, word32 seedSz);
     WOLFSSL_API int wc_RNG_HealthTest(int reseed,
                                         const byte* entropyA, word32 entropyASz,
@@ -251,6 +281,12 @@ WOLFSSL_API int  wc_FreeRng(WC_RNG*);
                                         const byte* entropyB, word32 entropyBSz,
                                         byte* output, word32 outputSz,
                                         void* heap, int devId);
+#ifdef WC_RNG_CTR_DRBG
+    WOLFSSL_API int wc_RNG_CtrHealthTest(int reseed,
+                                        const byte* entropyA, word32 entropyASz,
+                                        const byte* entropyB, word32 entropyBSz,
+                                        byte* output, word32 outputSz);
+#endif
 #endif /* HAVE_HASHDRBG */
 
 #ifdef __cplusplus
@@ -2087,6 +2087,15 @@ extern void uITRON4_free(void *p) ;
     #if !defined(ECC_CACHE_CURVE)
         #define ECC_CACHE_CURVE
     #endif
+
+    /* software device workers post completions to the event queue without
+     * taking its lock and wake the application through an eventfd */
+    #if defined(WOLFSSL_ASYNC_CRYPT_TEST) && defined(__linux__) && \
+        defined(__GNUC__) && !defined(WC_NO_ASYNC_THREADING) && \
+        !defined(SINGLE_THREADED) && !defined(WOLF_EVENT_NO_NOTIFY)
+        #undef  WOLF_EVENT_NOTIFY
+        #define WOLF_EVENT_NOTIFY
+    #endif
 #endif /* WOLFSSL_ASYNC_CRYPT */
 #ifndef WC_ASYNC_DEV_SIZE
     #define WC_ASYNC_DEV_SIZE 0
@@ -69,6 +69,11 @@ struct WOLF_EVENT {
 #endif
 #ifndef WC_NO_ASYNC_THREADING
     pthread_t           threadId;
+#endif
+    struct WOLF_EVENT_QUEUE* queue; /* queue the event is on */
+#ifdef WOLF_EVENT_NOTIFY
+    struct WOLF_EVENT_QUEUE* notify; /* completion posted to this queue */
+    WOLF_EVENT*         doneNext;   /* completion list */
 #endif
     int                 ret;    /* Async return code */
     unsigned int        flags;
@@ -80,13 +85,20 @@ enum WOLF_POLL_FLAGS {
     WOLF_POLL_FLAG_CHECK_HW = 0x01,
 };
 
-typedef struct {
+typedef struct WOLF_EVENT_QUEUE {
     WOLF_EVENT*         head;     /* head of queue */
     WOLF_EVENT*         tail;     /* tail of queue */
 #ifndef SINGLE_THREADED
     wolfSSL_Mutex       lock;     /* queue lock */
 #endif
     int                 count;
+#ifdef WOLF_EVENT_NOTIFY
+    WOLF_EVENT*         posted;   /* completions not yet collected, pushed
+                                   * without the lock, newest first */
+    WOLF_EVENT*         doneTail; /* last of the done events at the head */
+    int                 fd;       /* eventfd readable while events are done,
+                                   * -1 until wolfEventQueue_GetFd() */
+#endif
 } WOLF_EVENT_QUEUE;
 
 
@@ -102,8 +114,16 @@ WOLFSSL_API int wolfEventQueue_Push(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event);
 WOLFSSL_API int wolfEventQueue_Pop(WOLF_EVENT_QUEUE* queue, WOLF_EVENT** event);
 WOLFSSL_API int wolfEventQueue_Poll(WOLF_EVENT_QUEUE* queue, void* context_filter,
     WOLF_EVENT** events, int maxEvents, WOLF_EVENT_FLAG flags, int* eventCount);
+WOLFSSL_API int wolfEventQueue_Drain(WOLF_EVENT_QUEUE* queue,
+    WOLF_EVENT** events, int maxEvents, int* eventCount);
+WOLFSSL_API int wolfEventQueue_Cancel(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event);
 WOLFSSL_API int wolfEventQueue_Count(WOLF_EVENT_QUEUE* queue);
 WOLFSSL_API void wolfEventQueue_Free(WOLF_EVENT_QUEUE* queue);
+WOLFSSL_API int wolfEventQueue_GetFd(WOLF_EVENT_QUEUE* queue);
+#ifdef WOLF_EVENT_NOTIFY
+/* called by the device, lock free, when an event on queue completes */
+WOLFSSL_API int wolfEventQueue_Notify(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event);
+#endif
 
 /* the queue mutex must be locked prior to calling these */
 WOLFSSL_API int wolfEventQueue_Add(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event);
@@ -48,6 +48,10 @@
     #endif
 #endif
 
+#if defined(WOLFSSL_KTLS) && !defined(USE_WOLFSSL_IO)
+    #error Kernel TLS (WOLFSSL_KTLS) needs the default socket I/O callbacks
+#endif
+
 
 #if defined(USE_WOLFSSL_IO) || defined(HAVE_HTTP_CLIENT)
 
@@ -176,6 +180,14 @@
     #include <sys/filio.h>
 #endif
 
+#ifdef WOLFSSL_KTLS
+    #include <netinet/tcp.h>
+    #include <linux/tls.h>
+    #ifdef WOLFSSL_SENDFILE
+        #include <sys/sendfile.h>
+    #endif
+#endif
+
 #ifdef USE_WINDOWS_API
     /* no epipe yet */
     #ifndef WSAEPIPE
@@ -429,6 +441,16 @@ WOLFSSL_API int BioReceive(WOLFSSL* ssl, char* buf, int sz, void* ctx);
                                                   unsigned short port, int fam);
         #endif /* WOLFSSL_SESSION_EXPORT */
     #endif /* WOLFSSL_DTLS */
+
+    #ifdef WOLFSSL_KTLS
+        WOLFSSL_LOCAL int wolfIO_SetKtls(SOCKET_T sd, int tx, const void* info,
+                                         int infoSz);
+        WOLFSSL_LOCAL int EmbedReceiveRecord(WOLFSSL* ssl, unsigned char* type,
+                                             char* buf, int sz, int peek,
+                                             void* ctx);
+        WOLFSSL_LOCAL int EmbedSendRecord(WOLFSSL* ssl, unsigned char type,
+                                          char* buf, int sz, void* ctx);
+    #endif /* WOLFSSL_KTLS */
 #endif /* USE_WOLFSSL_IO */
 
 #ifdef HAVE_OCSP